@@ -67,6 +67,7 @@ CERES_SRCS = ["internal/ceres/" + filename for filename in [
     "eigensparse.cc",
     "evaluator.cc",
     "file.cc",
+    "first_order_function.cc",
     "function_sample.cc",
     "gradient_checker.cc",
     "gradient_checking_cost_function.cc",
@@ -89,11 +90,15 @@ CERES_SRCS = ["internal/ceres/" + filename for filename in [
     "local_parameterization.cc",
     "loss_function.cc",
     "low_rank_inverse_hessian.cc",
+    "matrix_free_jacobian.cc",
+    "memory_mapped_buffer.cc",
     "minimizer.cc",
     "normal_prior.cc",
+    "parallel_dense_ops.cc",
     "parallel_for_cxx.cc",
     "parallel_for_openmp.cc",
     "parallel_utils.cc",
+    "parallel_vector_ops.cc",
     "parameter_block_ordering.cc",
     "partitioned_matrix_view.cc",
     "polynomial.cc",
@@ -122,6 +127,8 @@ CERES_SRCS = ["internal/ceres/" + filename for filename in [
     "suitesparse.cc",
     "thread_pool.cc",
     "thread_token_provider.cc",
+    "tiny_solver_batch.cc",
+    "trace.cc",
     "triplet_sparse_matrix.cc",
     "trust_region_minimizer.cc",
     "trust_region_preprocessor.cc",
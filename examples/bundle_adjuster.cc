@@ -76,6 +76,10 @@ DEFINE_string(dogleg, "traditional_dogleg", "Options are: traditional_dogleg,"
 DEFINE_bool(inner_iterations, false, "Use inner iterations to non-linearly "
             "refine each successful trust region step.");
 
+DEFINE_bool(batched_inner_iterations, false, "Solve the inner iteration "
+            "subproblems directly instead of through per parameter block "
+            "solvers.");
+
 DEFINE_string(blocks_for_inner_iterations, "automatic", "Options are: "
               "automatic, cameras, points, cameras,points, points,cameras");
 
@@ -262,6 +266,8 @@ void SetMinimizerOptions(Solver::Options* options) {
   CHECK(
       StringToDoglegType(CERES_GET_FLAG(FLAGS_dogleg), &options->dogleg_type));
   options->use_inner_iterations = CERES_GET_FLAG(FLAGS_inner_iterations);
+  options->use_batched_inner_iterations =
+      CERES_GET_FLAG(FLAGS_batched_inner_iterations);
 }
 
 void SetSolverOptionsFromFlags(BALProblem* bal_problem,
@@ -62,5 +62,6 @@
 #include "ceres/solver.h"
 #include "ceres/types.h"
 #include "ceres/version.h"
+#include "ceres/visibility_clustering.h"
 
 #endif  // CERES_PUBLIC_CERES_H_
@@ -31,6 +31,11 @@
 #ifndef CERES_PUBLIC_CUBIC_INTERPOLATION_H_
 #define CERES_PUBLIC_CUBIC_INTERPOLATION_H_
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 #include "Eigen/Core"
 #include "ceres/internal/port.h"
 #include "glog/logging.h"
@@ -155,6 +160,36 @@ class CubicInterpolator {
     }
   }
 
+  // Evaluate the interpolated function value and/or its derivative
+  // at num_points points. f and dfdx if not NULL are arrays of size
+  // num_points * DATA_DIMENSION, and the values for the i^th point
+  // are stored starting at f[i * DATA_DIMENSION] and
+  // dfdx[i * DATA_DIMENSION] respectively.
+  void Evaluate(const double* x,
+                const int num_points,
+                double* f,
+                double* dfdx) const {
+    for (int i = 0; i < num_points; ++i) {
+      const int offset = i * Grid::DATA_DIMENSION;
+      Evaluate(x[i],
+               f != NULL ? f + offset : NULL,
+               dfdx != NULL ? dfdx + offset : NULL);
+    }
+  }
+
+  // Batched versions of the two Evaluate overloads above for
+  // interfacing with automatic differentiation.
+  void Evaluate(const double* x, const int num_points, double* f) const {
+    Evaluate(x, num_points, f, NULL);
+  }
+
+  template <typename JetT>
+  void Evaluate(const JetT* x, const int num_points, JetT* f) const {
+    for (int i = 0; i < num_points; ++i) {
+      Evaluate(x[i], f + i * Grid::DATA_DIMENSION);
+    }
+  }
+
  private:
   const Grid& grid_;
 };
@@ -343,10 +378,261 @@ class BiCubicInterpolator {
     }
   }
 
+  // Evaluate the interpolated function value and/or its derivatives
+  // at the num_points points (r[i], c[i]). f, dfdr and dfdc if not
+  // NULL are arrays of size num_points * DATA_DIMENSION, and the
+  // values for the i^th point are stored starting at
+  // f[i * DATA_DIMENSION] etc.
+  void Evaluate(const double* r,
+                const double* c,
+                const int num_points,
+                double* f,
+                double* dfdr,
+                double* dfdc) const {
+    for (int i = 0; i < num_points; ++i) {
+      const int offset = i * Grid::DATA_DIMENSION;
+      Evaluate(r[i],
+               c[i],
+               f != NULL ? f + offset : NULL,
+               dfdr != NULL ? dfdr + offset : NULL,
+               dfdc != NULL ? dfdc + offset : NULL);
+    }
+  }
+
+  // Batched versions of the two Evaluate overloads above for
+  // interfacing with automatic differentiation.
+  void Evaluate(const double* r,
+                const double* c,
+                const int num_points,
+                double* f) const {
+    Evaluate(r, c, num_points, f, NULL, NULL);
+  }
+
+  template <typename JetT>
+  void Evaluate(const JetT* r,
+                const JetT* c,
+                const int num_points,
+                JetT* f) const {
+    for (int i = 0; i < num_points; ++i) {
+      Evaluate(r[i], c[i], f + i * Grid::DATA_DIMENSION);
+    }
+  }
+
  private:
   const Grid& grid_;
 };
 
+// CachedBiCubicInterpolator computes exactly the same interpolating
+// function as BiCubicInterpolator, but instead of fetching the 16
+// grid values around the point being evaluated and interpolating
+// them on every call, it precomputes the coefficients of the bicubic
+// polynomial
+//
+//   f(r, c) = sum_{i,j = 0}^{3} a_ij (r - row)^i (c - col)^j
+//
+// for every cell [row, row + 1) x [col, col + 1) of the grid at
+// construction time. Evaluation then only requires clamping (r, c)
+// to the grid and evaluating a polynomial, which is considerably
+// cheaper when the same grid is evaluated many times, e.g., an image
+// in a photometric error.
+//
+// The price is memory: 16 * DATA_DIMENSION doubles are stored per
+// grid cell. The grid is only read in the constructor, and the
+// interpolator does not hold a reference to it.
+//
+// Since the grid interface does not expose its extent, the rows and
+// columns of the grid, i.e., the values of row and col for which
+// Grid::GetValue does not clamp, are passed to the constructor,
+// using the same convention as Grid2D.
+//
+// Example usage:
+//
+//  Grid2D<double, 1>  grid(data, 0, 3, 0, 4);
+//  CachedBiCubicInterpolator<Grid2D<double, 1>> interpolator(
+//      grid, 0, 3, 0, 4);
+//  double f, dfdr, dfdc;
+//  interpolator.Evaluate(1.2, 2.5, &f, &dfdr, &dfdc);
+template <typename Grid>
+class CachedBiCubicInterpolator {
+ public:
+  CachedBiCubicInterpolator(const Grid& grid,
+                            const int row_begin,
+                            const int row_end,
+                            const int col_begin,
+                            const int col_end)
+      : row_begin_(row_begin),
+        row_end_(row_end),
+        col_begin_(col_begin),
+        col_end_(col_end),
+        num_cell_cols_(col_end - col_begin + 1) {
+    // The + casts the enum into an int before doing the
+    // comparison. It is needed to prevent
+    // "-Wunnamed-type-template-args" related errors.
+    CHECK_GE(+Grid::DATA_DIMENSION, 1);
+    CHECK_LT(row_begin, row_end);
+    CHECK_LT(col_begin, col_end);
+
+    // Outside of the cells [row_begin - 1, row_end - 1] x [col_begin -
+    // 1, col_end - 1] the grid values are clamped and the
+    // interpolating function is constant along rows and/or columns,
+    // so only these cells need to be stored. See Evaluate.
+    const int num_cell_rows = row_end - row_begin + 1;
+    coefficients_.resize(num_cell_rows * num_cell_cols_ * kCellSize);
+
+    // Catmull-Rom basis. Row i contains the weights of p0, .., p3 in
+    // the coefficient of x^i of the cubic Hermite spline, see
+    // CubicHermiteSpline.
+    Eigen::Matrix4d basis;
+    // clang-format off
+    basis <<  0.0,  1.0,  0.0,  0.0,
+             -0.5,  0.0,  0.5,  0.0,
+              1.0, -2.5,  2.0, -0.5,
+             -0.5,  1.5, -1.5,  0.5;
+    // clang-format on
+
+    Eigen::Matrix4d values[Grid::DATA_DIMENSION];
+    double value[Grid::DATA_DIMENSION];
+    for (int i = 0; i < num_cell_rows; ++i) {
+      const int row = row_begin - 1 + i;
+      for (int j = 0; j < num_cell_cols_; ++j) {
+        const int col = col_begin - 1 + j;
+        for (int k = 0; k < 4; ++k) {
+          for (int l = 0; l < 4; ++l) {
+            grid.GetValue(row - 1 + k, col - 1 + l, value);
+            for (int d = 0; d < Grid::DATA_DIMENSION; ++d) {
+              values[d](k, l) = value[d];
+            }
+          }
+        }
+
+        double* cell = &coefficients_[(i * num_cell_cols_ + j) * kCellSize];
+        for (int d = 0; d < Grid::DATA_DIMENSION; ++d) {
+          Eigen::Map<Eigen::Matrix<double, 4, 4, Eigen::RowMajor>>(
+              cell + 16 * d) = basis * values[d] * basis.transpose();
+        }
+      }
+    }
+  }
+
+  // Evaluate the interpolated function value and/or its
+  // derivative. Uses the nearest point on the grid boundary if r or
+  // c is out of bounds.
+  void Evaluate(
+      double r, double c, double* f, double* dfdr, double* dfdc) const {
+    int row = std::floor(r);
+    int col = std::floor(c);
+    double x = r - row;
+    double y = c - col;
+
+    // The interpolating function in the cells before the first and
+    // after the last stored row (column) is constant along the rows
+    // (columns), and equal to its value on the boundary of the
+    // nearest stored cell.
+    if (row < row_begin_ - 1) {
+      row = row_begin_ - 1;
+      x = 0.0;
+    } else if (row > row_end_ - 1) {
+      row = row_end_ - 1;
+      x = 1.0;
+    }
+    if (col < col_begin_ - 1) {
+      col = col_begin_ - 1;
+      y = 0.0;
+    } else if (col > col_end_ - 1) {
+      col = col_end_ - 1;
+      y = 1.0;
+    }
+
+    const double* cell =
+        &coefficients_[((row - row_begin_ + 1) * num_cell_cols_ + col -
+                        col_begin_ + 1) *
+                       kCellSize];
+    for (int d = 0; d < Grid::DATA_DIMENSION; ++d, cell += 16) {
+      // Use Horner's rule to evaluate the polynomial along the
+      // columns for each power of x, and then along the rows.
+      double g[4], dgdc[4];
+      for (int i = 0; i < 4; ++i) {
+        const double* a = cell + 4 * i;
+        g[i] = a[0] + y * (a[1] + y * (a[2] + y * a[3]));
+        dgdc[i] = a[1] + y * (2.0 * a[2] + 3.0 * a[3] * y);
+      }
+
+      if (f != NULL) {
+        f[d] = g[0] + x * (g[1] + x * (g[2] + x * g[3]));
+      }
+      if (dfdr != NULL) {
+        dfdr[d] = g[1] + x * (2.0 * g[2] + 3.0 * g[3] * x);
+      }
+      if (dfdc != NULL) {
+        dfdc[d] = dgdc[0] + x * (dgdc[1] + x * (dgdc[2] + x * dgdc[3]));
+      }
+    }
+  }
+
+  // The following two Evaluate overloads are needed for interfacing
+  // with automatic differentiation. The first is for when a scalar
+  // evaluation is done, and the second one is for when Jets are used.
+  void Evaluate(const double& r, const double& c, double* f) const {
+    Evaluate(r, c, f, NULL, NULL);
+  }
+
+  template <typename JetT>
+  void Evaluate(const JetT& r, const JetT& c, JetT* f) const {
+    double frc[Grid::DATA_DIMENSION];
+    double dfdr[Grid::DATA_DIMENSION];
+    double dfdc[Grid::DATA_DIMENSION];
+    Evaluate(r.a, c.a, frc, dfdr, dfdc);
+    for (int i = 0; i < Grid::DATA_DIMENSION; ++i) {
+      f[i].a = frc[i];
+      f[i].v = dfdr[i] * r.v + dfdc[i] * c.v;
+    }
+  }
+
+  // Batched evaluation, see BiCubicInterpolator.
+  void Evaluate(const double* r,
+                const double* c,
+                const int num_points,
+                double* f,
+                double* dfdr,
+                double* dfdc) const {
+    for (int i = 0; i < num_points; ++i) {
+      const int offset = i * Grid::DATA_DIMENSION;
+      Evaluate(r[i],
+               c[i],
+               f != NULL ? f + offset : NULL,
+               dfdr != NULL ? dfdr + offset : NULL,
+               dfdc != NULL ? dfdc + offset : NULL);
+    }
+  }
+
+  void Evaluate(const double* r,
+                const double* c,
+                const int num_points,
+                double* f) const {
+    Evaluate(r, c, num_points, f, NULL, NULL);
+  }
+
+  template <typename JetT>
+  void Evaluate(const JetT* r,
+                const JetT* c,
+                const int num_points,
+                JetT* f) const {
+    for (int i = 0; i < num_points; ++i) {
+      Evaluate(r[i], c[i], f + i * Grid::DATA_DIMENSION);
+    }
+  }
+
+ private:
+  static constexpr int kCellSize = 16 * Grid::DATA_DIMENSION;
+
+  const int row_begin_;
+  const int row_end_;
+  const int col_begin_;
+  const int col_end_;
+  const int num_cell_cols_;
+  std::vector<double> coefficients_;
+};
+
 // An object that implements an infinite two dimensional grid needed
 // by the BiCubicInterpolator where the source of the function values
 // is an grid of type T on the grid
@@ -431,6 +717,228 @@ struct Grid2D {
   const int num_values_;
 };
 
+// An object that implements an infinite two dimensional grid needed
+// by the BiCubicInterpolator, which stores a copy of the values of
+// another grid on
+//
+//   [(row_begin,   col_begin), ..., (row_begin,   col_end - 1)]
+//   [                          ...                            ]
+//   [(row_end - 1, col_begin), ..., (row_end - 1, col_end - 1)]
+//
+// as values of type T in square tiles of kTileSize x kTileSize grid
+// points. Values outside this interval are taken from the nearest
+// edge, as in Grid2D.
+//
+// In a row or column major layout, the 4 x 4 neighbourhood read by
+// BiCubicInterpolator spans four rows (columns) of the grid, which
+// for large images, e.g., 4K or 8K images, lie in four different
+// cache lines that are evicted long before the neighbouring rows are
+// needed again. With a tiled layout the neighbourhood lies in at most
+// four tiles, which for small T fit in a handful of cache lines.
+//
+// This is not a general replacement for Grid2D. The tiled index
+// arithmetic costs more than the row major one, so TiledGrid2D is
+// only faster for lookups spread uniformly over grids that are much
+// larger than the last level cache, e.g., 16K x 16K images. For
+// grids that fit in the cache, e.g., 4K images, and for lookups that
+// already reuse cache lines in a row major layout, e.g., the pixels
+// of a patch, it is slower than Grid2D. Measure before using it, see
+// cubic_interpolation_benchmark.cc.
+//
+// The values of the vector valued functions are stored interleaved.
+//
+// Example usage:
+//
+//  Grid2D<uint8_t, 1> image(data, 0, num_rows, 0, num_cols);
+//  TiledGrid2D<uint8_t, 1> tiled_image(image, 0, num_rows, 0, num_cols);
+//  BiCubicInterpolator<TiledGrid2D<uint8_t, 1>> interpolator(tiled_image);
+template <typename T, int kDataDimension = 1, int kTileSize = 8>
+class TiledGrid2D {
+ public:
+  enum { DATA_DIMENSION = kDataDimension };
+
+  template <typename Grid>
+  TiledGrid2D(const Grid& grid,
+              const int row_begin,
+              const int row_end,
+              const int col_begin,
+              const int col_end)
+      : row_begin_(row_begin),
+        row_end_(row_end),
+        col_begin_(col_begin),
+        col_end_(col_end),
+        num_tile_cols_((col_end - col_begin + kTileSize - 1) / kTileSize) {
+    static_assert(kTileSize > 0, "The tile size must be positive.");
+    static_assert(Grid::DATA_DIMENSION == kDataDimension,
+                  "The grid must have the same data dimension.");
+    CHECK_LT(row_begin, row_end);
+    CHECK_LT(col_begin, col_end);
+
+    const int num_tile_rows =
+        (row_end - row_begin + kTileSize - 1) / kTileSize;
+    values_.resize(num_tile_rows * num_tile_cols_ * kTileSize * kTileSize *
+                   kDataDimension);
+    double value[kDataDimension];
+    for (int r = row_begin; r < row_end; ++r) {
+      for (int c = col_begin; c < col_end; ++c) {
+        grid.GetValue(r, c, value);
+        T* tiled_value = &values_[Index(r - row_begin, c - col_begin)];
+        for (int i = 0; i < kDataDimension; ++i) {
+          tiled_value[i] = static_cast<T>(value[i]);
+        }
+      }
+    }
+  }
+
+  EIGEN_STRONG_INLINE void GetValue(const int r, const int c, double* f) const {
+    const int row_idx =
+        std::min(std::max(row_begin_, r), row_end_ - 1) - row_begin_;
+    const int col_idx =
+        std::min(std::max(col_begin_, c), col_end_ - 1) - col_begin_;
+    const T* value = &values_[Index(row_idx, col_idx)];
+    for (int i = 0; i < kDataDimension; ++i) {
+      f[i] = static_cast<double>(value[i]);
+    }
+  }
+
+  int row_begin() const { return row_begin_; }
+  int row_end() const { return row_end_; }
+  int col_begin() const { return col_begin_; }
+  int col_end() const { return col_end_; }
+
+ private:
+  // The offset of the value at (row_idx, col_idx) relative to
+  // (row_begin_, col_begin_). The indices are non-negative, so they
+  // are treated as unsigned, which for tile sizes that are powers of
+  // two reduces the divisions and remainders to shifts and masks.
+  EIGEN_STRONG_INLINE int Index(const unsigned int row_idx,
+                                const unsigned int col_idx) const {
+    const unsigned int tile_size = kTileSize;
+    const unsigned int tile =
+        (row_idx / tile_size) * num_tile_cols_ + col_idx / tile_size;
+    return ((tile * tile_size + row_idx % tile_size) * tile_size +
+            col_idx % tile_size) *
+           kDataDimension;
+  }
+
+  int row_begin_;
+  int row_end_;
+  int col_begin_;
+  int col_end_;
+  int num_tile_cols_;
+  std::vector<T> values_;
+};
+
+// A multi-resolution pyramid of TiledGrid2D objects for coarse to
+// fine solves, e.g., of direct image alignment problems, where the
+// problem is first solved on the coarsest level and the solution is
+// used to initialize the solve on the next finer level.
+//
+// Level 0 is a tiled copy of the input grid on
+//
+//   [row_begin, row_end) x [col_begin, col_end).
+//
+// Every other level has half the number of rows and columns of the
+// previous level (rounded up), starting at the same (row_begin,
+// col_begin), and each of its values is the average of a 2 x 2 block
+// of the previous level. For integral types T, the averages are
+// rounded to the nearest integer.
+//
+// Each level can be used with BiCubicInterpolator and
+// CachedBiCubicInterpolator. ToLevel maps a point on level 0 to the
+// corresponding point on another level; since it is affine, it can
+// be applied to Jets.
+//
+// Example usage:
+//
+//  Grid2D<uint8_t, 1> image(data, 0, num_rows, 0, num_cols);
+//  TiledGrid2DPyramid<uint8_t, 1> pyramid(
+//      image, 0, num_rows, 0, num_cols, 4);
+//  BiCubicInterpolator<TiledGrid2D<uint8_t, 1>> coarsest(pyramid.level(3));
+template <typename T, int kDataDimension = 1, int kTileSize = 8>
+class TiledGrid2DPyramid {
+ public:
+  typedef TiledGrid2D<T, kDataDimension, kTileSize> Level;
+
+  template <typename Grid>
+  TiledGrid2DPyramid(const Grid& grid,
+                     const int row_begin,
+                     const int row_end,
+                     const int col_begin,
+                     const int col_end,
+                     const int num_levels) {
+    CHECK_GE(num_levels, 1);
+    levels_.reserve(num_levels);
+    levels_.emplace_back(grid, row_begin, row_end, col_begin, col_end);
+    for (int i = 1; i < num_levels; ++i) {
+      const Level& previous = levels_.back();
+      const int num_rows = previous.row_end() - row_begin;
+      const int num_cols = previous.col_end() - col_begin;
+      levels_.emplace_back(DownsampledGrid(previous),
+                           row_begin,
+                           row_begin + (num_rows + 1) / 2,
+                           col_begin,
+                           col_begin + (num_cols + 1) / 2);
+    }
+  }
+
+  int num_levels() const { return static_cast<int>(levels_.size()); }
+  const Level& level(const int i) const { return levels_[i]; }
+
+  // Map the point (r, c) on level 0 to the point (level_r, level_c)
+  // on the given level. The grid points are assumed to be pixel
+  // centers, i.e., the value at a grid point of level i + 1 is
+  // located at the center of the 2 x 2 block of grid points of level
+  // i that it is the average of.
+  template <typename U>
+  void ToLevel(
+      const int level, const U& r, const U& c, U* level_r, U* level_c) const {
+    const double scale = 1.0 / (1 << level);
+    const double row_begin = levels_[0].row_begin();
+    const double col_begin = levels_[0].col_begin();
+    *level_r = (r - row_begin + 0.5) * scale - 0.5 + row_begin;
+    *level_c = (c - col_begin + 0.5) * scale - 0.5 + col_begin;
+  }
+
+ private:
+  // A grid whose value at (r, c) is the average of the values of
+  // level at (2 r, 2 c), (2 r + 1, 2 c), (2 r, 2 c + 1) and
+  // (2 r + 1, 2 c + 1), relative to (row_begin, col_begin).
+  class DownsampledGrid {
+   public:
+    enum { DATA_DIMENSION = kDataDimension };
+
+    explicit DownsampledGrid(const Level& level) : level_(level) {}
+
+    void GetValue(const int r, const int c, double* f) const {
+      const int row = 2 * r - level_.row_begin();
+      const int col = 2 * c - level_.col_begin();
+      double value[kDataDimension];
+      for (int i = 0; i < kDataDimension; ++i) {
+        f[i] = 0.0;
+      }
+      for (int j = 0; j < 2; ++j) {
+        for (int k = 0; k < 2; ++k) {
+          level_.GetValue(row + j, col + k, value);
+          for (int i = 0; i < kDataDimension; ++i) {
+            f[i] += 0.25 * value[i];
+          }
+        }
+      }
+      if (std::is_integral<T>::value) {
+        for (int i = 0; i < kDataDimension; ++i) {
+          f[i] = std::round(f[i]);
+        }
+      }
+    }
+
+   private:
+    const Level& level_;
+  };
+
+  std::vector<Level> levels_;
+};
+
 }  // namespace ceres
 
 #endif  // CERES_PUBLIC_CUBIC_INTERPOLATOR_H_
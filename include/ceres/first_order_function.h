@@ -49,6 +49,79 @@ class CERES_EXPORT FirstOrderFunction {
   virtual int NumParameters() const = 0;
 };
 
+// A FirstOrderFunction whose evaluation can be split into independent
+// partitions, so that GradientProblemSolver can evaluate it using
+// multiple threads (see GradientProblemSolver::Options::num_threads).
+//
+// The objective function is the sum of the costs of the partitions.
+// The parameter vector is split into NumPartitions() contiguous
+// ranges, and partition i is responsible for computing the gradient
+// entries in the range [PartitionStart(i), PartitionStart(i + 1)),
+// i.e., the derivatives of the full objective function with respect
+// to these parameters.
+//
+// Example usage:
+//
+// The following evaluates f(x) = sum_i (x_i - 1)^2 in shards of
+// kShardSize parameters.
+//
+//   class ShardedQuadratic : public ceres::PartitionedFirstOrderFunction {
+//    public:
+//     int NumParameters() const final { return kNumParameters; }
+//     int NumPartitions() const final {
+//       return (kNumParameters + kShardSize - 1) / kShardSize;
+//     }
+//     int PartitionStart(int partition) const final {
+//       return std::min(partition * kShardSize, kNumParameters);
+//     }
+//     bool EvaluatePartition(int partition,
+//                            const double* parameters,
+//                            double* cost,
+//                            double* gradient) const final {
+//       *cost = 0.0;
+//       for (int i = PartitionStart(partition);
+//            i < PartitionStart(partition + 1);
+//            ++i) {
+//         *cost += (parameters[i] - 1.0) * (parameters[i] - 1.0);
+//         if (gradient != nullptr) {
+//           gradient[i] = 2.0 * (parameters[i] - 1.0);
+//         }
+//       }
+//       return true;
+//     }
+//   };
+class CERES_EXPORT PartitionedFirstOrderFunction : public FirstOrderFunction {
+ public:
+  virtual ~PartitionedFirstOrderFunction() {}
+
+  virtual int NumPartitions() const = 0;
+
+  // Start of the range of parameters whose gradient entries are
+  // computed by the partition. PartitionStart(0) must be 0,
+  // PartitionStart(NumPartitions()) must be NumParameters() and the
+  // starts must be non-decreasing, otherwise the partitions are not
+  // evaluated in parallel.
+  virtual int PartitionStart(int partition) const = 0;
+
+  // cost is never null, and *cost must be set to the contribution of
+  // the partition to the objective function. gradient may be null. If
+  // it is not, it points to the full gradient vector, the entries in
+  // the range of the partition are zero, and only they may be written
+  // to.
+  //
+  // EvaluatePartition is called concurrently for different partitions
+  // and must be thread safe.
+  virtual bool EvaluatePartition(int partition,
+                                 const double* parameters,
+                                 double* cost,
+                                 double* gradient) const = 0;
+
+  // Evaluates the partitions one after the other and sums their cost.
+  bool Evaluate(const double* const parameters,
+                double* cost,
+                double* gradient) const override;
+};
+
 }  // namespace ceres
 
 #endif  // CERES_PUBLIC_FIRST_ORDER_FUNCTION_H_
@@ -113,6 +113,23 @@ class CERES_EXPORT GradientProblemSolver {
     // 20(5), 863-874, 1974.
     bool use_approximate_eigenvalue_bfgs_scaling = false;
 
+    // The LBFGS search direction is the product of the low rank
+    // inverse Hessian approximation with the gradient. By default it
+    // is computed using the two loop recursion of Nocedal, which makes
+    // 4 * max_lbfgs_rank passes over vectors of the size of the
+    // problem. If use_compact_lbfgs_representation is true, the
+    // compact representation of Byrd, Nocedal & Schnabel is used
+    // instead, which computes the product using two matrix-vector
+    // products with the LBFGS history, plus one more to update the
+    // approximation. For problems with millions of parameters, where
+    // the computation is limited by memory bandwidth, this is
+    // significantly faster.
+    //
+    // Byrd, R. H.; Nocedal, J.; Schnabel, R. B. (1994).
+    // "Representations of Quasi-Newton Matrices and their use in
+    // Limited Memory Methods". Mathematical Programming 63 (4).
+    bool use_compact_lbfgs_representation = false;
+
     // Degree of the polynomial used to approximate the objective
     // function. Valid values are BISECTION, QUADRATIC and CUBIC.
     //
@@ -219,6 +236,11 @@ class CERES_EXPORT GradientProblemSolver {
     //
     double parameter_tolerance = 1e-8;
 
+    // Number of threads used by Ceres to evaluate the objective
+    // function when it is a PartitionedFirstOrderFunction, and to
+    // compute the LBFGS search direction.
+    int num_threads = 1;
+
     // Logging options ---------------------------------------------------------
 
     LoggingType logging_type = PER_MINIMIZER_ITERATION;
@@ -261,6 +261,46 @@ class CERES_EXPORT Problem {
                                    double* const* const parameter_blocks,
                                    int num_parameter_blocks);
 
+  // Add a batch of residual blocks to the problem. This is equivalent
+  // to calling
+  //
+  //   AddResidualBlock(cost_functions[i], loss_functions[i], ...)
+  //
+  // for each i in order, but it is considerably faster for large
+  // batches, since the validation of the residual blocks and their
+  // construction is done using num_threads threads, and the storage
+  // for the residual blocks is reserved up front.
+  //
+  // parameter_blocks is the concatenation of the parameter blocks of
+  // all the residual blocks, i.e., the parameter blocks of residual
+  // block i are the next
+  // cost_functions[i]->parameter_block_sizes().size() entries after
+  // those of residual block i - 1.
+  //
+  // loss_functions may be empty, in which case none of the residual
+  // blocks have a loss function. Otherwise it must have the same size
+  // as cost_functions, and it may contain nullptr entries.
+  //
+  // If residual_blocks is not nullptr, the ids of the new residual
+  // blocks are appended to it in the same order as cost_functions.
+  //
+  // Example:
+  //
+  //   std::vector<CostFunction*> cost_functions;
+  //   std::vector<double*> parameter_blocks;
+  //   for (const Observation& observation : observations) {
+  //     cost_functions.push_back(new ReprojectionError(observation));
+  //     parameter_blocks.push_back(cameras[observation.camera]);
+  //     parameter_blocks.push_back(points[observation.point]);
+  //   }
+  //   problem.AddResidualBlocks(cost_functions, {}, parameter_blocks, 8,
+  //                             nullptr);
+  void AddResidualBlocks(const std::vector<CostFunction*>& cost_functions,
+                         const std::vector<LossFunction*>& loss_functions,
+                         const std::vector<double*>& parameter_blocks,
+                         int num_threads,
+                         std::vector<ResidualBlockId>* residual_blocks);
+
   // Add a parameter block with appropriate size to the problem.
   // Repeated calls with the same arguments are ignored. Repeated
   // calls with the same double pointer but a different size results
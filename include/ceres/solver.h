@@ -44,6 +44,7 @@
 #include "ceres/ordered_groups.h"
 #include "ceres/problem.h"
 #include "ceres/types.h"
+#include "ceres/visibility_clustering.h"
 
 namespace ceres {
 
@@ -143,6 +144,23 @@ class CERES_EXPORT Solver {
     // 20(5), 863-874, 1974.
     bool use_approximate_eigenvalue_bfgs_scaling = false;
 
+    // The LBFGS search direction is the product of the low rank
+    // inverse Hessian approximation with the gradient. By default it
+    // is computed using the two loop recursion of Nocedal, which makes
+    // 4 * max_lbfgs_rank passes over vectors of the size of the
+    // problem. If use_compact_lbfgs_representation is true, the
+    // compact representation of Byrd, Nocedal & Schnabel is used
+    // instead, which computes the product using two matrix-vector
+    // products with the LBFGS history, plus one more to update the
+    // approximation. For problems with millions of parameters, where
+    // the computation is limited by memory bandwidth, this is
+    // significantly faster.
+    //
+    // Byrd, R. H.; Nocedal, J.; Schnabel, R. B. (1994).
+    // "Representations of Quasi-Newton Matrices and their use in
+    // Limited Memory Methods". Mathematical Programming 63 (4).
+    bool use_compact_lbfgs_representation = false;
+
     // Degree of the polynomial used to approximate the objective
     // function. Valid values are BISECTION, QUADRATIC and CUBIC.
     //
@@ -270,7 +288,8 @@ class CERES_EXPORT Solver {
     double max_solver_time_in_seconds = 1e9;
 
     // Number of threads used by Ceres for evaluating the cost and
-    // jacobians.
+    // jacobians. They are also used by the dense linear solvers if
+    // use_tiled_dense_factorization is true.
     int num_threads = 1;
 
     // Trust region minimizer settings.
@@ -295,6 +314,21 @@ class CERES_EXPORT Solver {
     double min_lm_diagonal = 1e-6;
     double max_lm_diagonal = 1e32;
 
+    // Every unsuccessful LEVENBERG_MARQUARDT step changes the damping
+    // and requires the linear system to be solved again, which for
+    // the dense solvers means a new O(n^3) factorization.
+    //
+    // If use_lm_eigendecomposition is true, the scaled normal
+    // equations are instead eigendecomposed once per Jacobian
+    // evaluation, after which the step for any damping value costs
+    // O(n^2). The eigendecomposition is several times more expensive
+    // than a Cholesky factorization, so this pays off for problems
+    // where steps are frequently rejected.
+    //
+    // Only supported with the DENSE_QR and DENSE_NORMAL_CHOLESKY
+    // linear solvers.
+    bool use_lm_eigendecomposition = false;
+
     // Sometimes due to numerical conditioning problems or linear
     // solver flakiness, the trust region strategy may return a
     // numerically invalid step that can be fixed by reducing the
@@ -338,6 +372,31 @@ class CERES_EXPORT Solver {
     // preconditioner_type is CLUSTER_JACOBI or CLUSTER_TRIDIAGONAL.
     VisibilityClusteringType visibility_clustering_type = CANONICAL_VIEWS;
 
+    // Clustering the cameras is the most expensive part of
+    // constructing a CLUSTER_JACOBI or CLUSTER_TRIDIAGONAL
+    // preconditioner. If visibility_clustering is not NULL, Solve
+    // reuses the clustering stored in it, if it was computed for the
+    // same preconditioner type, and writes the clustering it used back
+    // to it.
+    //
+    // Cameras that are not in the stored clustering, e.g., cameras
+    // added to the problem since the last call to Solve, join the
+    // cluster of the clustered camera they share the most points
+    // with, or a new cluster if they share none. Only the
+    // similarities of these cameras are computed. Cameras removed
+    // from the problem are dropped from the clustering.
+    //
+    // This makes a sequence of solves on a slowly growing problem,
+    // e.g., in incremental structure from motion, pay for clustering
+    // the cameras only once, at the price of a clustering that slowly
+    // degrades as cameras are added. Clear the clustering to cluster
+    // the cameras from scratch.
+    //
+    // Only used with ITERATIVE_SCHUR and the CLUSTER_JACOBI or
+    // CLUSTER_TRIDIAGONAL preconditioners. The user retains ownership
+    // of the object.
+    VisibilityClustering* visibility_clustering = nullptr;
+
     // Subset preconditioner is a preconditioner for problems with
     // general sparsity. Given a subset of residual blocks of a
     // problem, it uses the corresponding subset of the rows of the
@@ -376,6 +435,18 @@ class CERES_EXPORT Solver {
     // performance.
     DenseLinearAlgebraLibraryType dense_linear_algebra_library_type = EIGEN;
 
+    // If true and dense_linear_algebra_library_type is EIGEN, the
+    // DENSE_QR, DENSE_NORMAL_CHOLESKY and DENSE_SCHUR solvers use
+    // tiled factorizations whose tile updates are distributed over
+    // num_threads threads, for systems with more than 128 columns and
+    // num_threads > 1.
+    //
+    // On a single thread these are a few percent slower than Eigen's
+    // own factorizations, and how well they scale depends on the
+    // machine, so compare the linear solver time with and without
+    // this option before enabling it.
+    bool use_tiled_dense_factorization = false;
+
     // Ceres supports using multiple sparse linear algebra libraries
     // for sparse matrix ordering and factorizations. Currently,
     // SUITE_SPARSE and CX_SPARSE are the valid choices, depending on
@@ -520,6 +591,43 @@ class CERES_EXPORT Solver {
     // This settings only affects the SPARSE_NORMAL_CHOLESKY solver.
     bool dynamic_sparsity = false;
 
+    // If use_matrix_free_jacobian is true, the Jacobian is never
+    // stored. Instead, every product with it evaluates the Jacobians
+    // of the residual blocks again, one residual block at a time, and
+    // discards them. This reduces the memory used by the solver from
+    // O(number of non-zeros in the Jacobian) to O(number of
+    // parameters + number of residuals), at the cost of evaluating
+    // the Jacobian a few times per iteration of the linear solver.
+    //
+    // This is useful for problems whose Jacobian does not fit in
+    // memory, and for problems whose cost functions are cheap to
+    // evaluate compared to the cost of moving the Jacobian through
+    // the memory hierarchy.
+    //
+    // Only supported with the CGNR linear solver with the JACOBI or
+    // IDENTITY preconditioners, and not together with
+    // Problem::Options::evaluation_callback.
+    bool use_matrix_free_jacobian = false;
+
+    // If memory_mapped_storage_directory is not empty, the values of
+    // the Jacobian and of the Schur complement used by SPARSE_SCHUR
+    // and ITERATIVE_SCHUR are stored in temporary files in this
+    // directory, mapped into memory, instead of on the heap. The
+    // operating system then pages them to and from disk as needed,
+    // so problems whose Jacobian does not fit in RAM can still be
+    // solved, at a cost in speed that depends on how much of it does.
+    //
+    // The Jacobian is only stored this way when it is block sparse,
+    // i.e., not for DENSE_QR, DENSE_NORMAL_CHOLESKY, dynamic_sparsity
+    // or use_matrix_free_jacobian.
+    //
+    // The files are deleted as soon as they are created, so they do
+    // not outlive the solve. Disk space for them is reserved up
+    // front, and if a file cannot be created, e.g., because the disk
+    // is full, Solve returns FAILURE with the reason in
+    // Solver::Summary::message. Only supported on POSIX systems.
+    std::string memory_mapped_storage_directory;
+
     // TODO(sameeragarwal): Further expand the documentation for the
     // following two options.
 
@@ -627,6 +735,24 @@ class CERES_EXPORT Solver {
     // iterations is disabled.
     double inner_iteration_tolerance = 1e-3;
 
+    // By default, each parameter block optimized by the inner
+    // iterations gets its own Program, Evaluator and trust region
+    // minimizer. If use_batched_inner_iterations is true, the inner
+    // iterations instead evaluate the residual blocks of each
+    // parameter block directly, and solve the small dense normal
+    // equations that result using a Levenberg-Marquardt loop with the
+    // same tolerances. This avoids the setup cost of the per parameter
+    // block solvers, which dominates the cost of inner iterations for
+    // problems like bundle adjustment, where the parameter blocks are
+    // small and numerous.
+    //
+    // "Batched" refers to doing away with the per parameter block
+    // solver objects. Each parameter block is still solved on its own,
+    // starting from a fresh evaluation of its residual blocks; the
+    // Jacobian evaluated by the outer minimizer is not reused, and the
+    // small linear systems are not solved together.
+    bool use_batched_inner_iterations = false;
+
     // Minimum number of iterations for which the linear solver should
     // run, even if the convergence criterion is satisfied.
     int min_linear_solver_iterations = 0;
@@ -673,6 +799,40 @@ class CERES_EXPORT Solver {
     std::string trust_region_problem_dump_directory = "/tmp";
     DumpFormatType trust_region_problem_dump_format_type = TEXTFILE;
 
+    // If true, the solver records a hierarchical trace of the time
+    // spent in preprocessing, residual and Jacobian evaluation, Schur
+    // elimination, factorization, preconditioner updates, conjugate
+    // gradients iterations etc. The trace is summarized per
+    // minimizer iteration in Solver::Summary::trace_report.
+    //
+    // The trace only contains the work done by this call to Solve,
+    // even if other calls to Solve run concurrently. When tracing is
+    // disabled, its cost is negligible.
+    bool enable_tracing = false;
+
+    // If enable_tracing is true and trace_filename is non-empty, the
+    // trace is written to trace_filename in the Chrome trace event
+    // format, which can be viewed using chrome://tracing or Perfetto.
+    std::string trace_filename;
+
+    // If enable_tracing is true, also sample the hardware performance
+    // counters (cycles, instructions, cache misses and branch misses)
+    // of each thread at the start and end of every traced event. This
+    // is only supported on Linux, and is silently skipped if
+    // perf_event_open is not permitted.
+    bool trace_hardware_counters = false;
+
+    // If true, the evaluator accumulates the time spent in and the
+    // number of calls to the residual blocks for each type of
+    // CostFunction in the problem. The statistics are reported in
+    // Solver::Summary::cost_function_statistics and in
+    // Solver::Summary::FullReport.
+    //
+    // The profiling reads a clock before and after the evaluation of
+    // each residual block, which for problems with cheap cost
+    // functions can noticeably slow down the evaluation.
+    bool profile_cost_functions = false;
+
     // Finite differences options ----------------------------------------------
 
     // Check all jacobians computed by each residual block with finite
@@ -800,6 +960,16 @@ class CERES_EXPORT Solver {
     // was not numerically valid.
     int num_unsuccessful_steps = -1;
 
+    // Number of minimizer iterations in which the step was computed
+    // by reusing the solution of the linear system (and with it the
+    // factorization) from an earlier iteration instead of solving a
+    // new one. This is the case for the DOGLEG trust region strategy
+    // after an unsuccessful step, since the Jacobian has not changed
+    // and only the trust region radius is different, and for
+    // LEVENBERG_MARQUARDT when Options::use_lm_eigendecomposition is
+    // true.
+    int num_reused_linear_solves = -1;
+
     // Number of times inner iterations were performed.
     int num_inner_iteration_steps = -1;
 
@@ -829,6 +999,40 @@ class CERES_EXPORT Solver {
     // Some total of all time spent inside Ceres when Solve is called.
     double total_time_in_seconds = -1.0;
 
+    // If Solver::Options::enable_tracing is true, a table of the
+    // number of calls, the time and the hardware counters (if
+    // sampled) of each traced event for each minimizer iteration.
+    std::string trace_report;
+
+    // Evaluation statistics for all the residual blocks whose cost
+    // functions have the same type.
+    struct CostFunctionStatistics {
+      // The name of the type of the CostFunction, e.g.,
+      // "ceres::AutoDiffCostFunction<MyFunctor, 2, 3>".
+      std::string cost_function_type;
+
+      // Number of residual blocks, and the total number of residuals
+      // and of entries in the Jacobian blocks of these residual
+      // blocks. Jacobian blocks of constant parameter blocks are not
+      // evaluated, and are not counted.
+      int num_residual_blocks = 0;
+      int num_residuals = 0;
+      int num_jacobian_entries = 0;
+
+      // Number of residual block evaluations without and with
+      // Jacobians, and the time spent in them.
+      int num_residual_evaluations = 0;
+      double residual_evaluation_time_in_seconds = 0.0;
+      int num_jacobian_evaluations = 0;
+      double jacobian_evaluation_time_in_seconds = 0.0;
+    };
+
+    // If Solver::Options::profile_cost_functions is true, the
+    // evaluation statistics for each type of CostFunction in the
+    // reduced problem, sorted by the total evaluation time, in
+    // decreasing order.
+    std::vector<CostFunctionStatistics> cost_function_statistics;
+
     // Time (in seconds) spent in the linear solver computing the
     // trust region step.
     double linear_solver_time_in_seconds = -1.0;
@@ -124,11 +124,73 @@ namespace ceres {
 //
 //   int NumParameters() const;
 //
+// Dynamically sized matrices are allocated on the heap, and are
+// reallocated every time the size of the problem changes. If upper
+// bounds on the dynamic sizes are known, the Function can define
+//
+//   enum {
+//     MAX_NUM_RESIDUALS = <int>,
+//     MAX_NUM_PARAMETERS = <int>,
+//   };
+//
+// in which case all the storage of the solver, including that of the
+// default linear solver and of Parameters, is allocated inline with
+// these maximum sizes, and solving never allocates memory, whatever
+// the size of the problem. Either enum can be omitted, and they must
+// be equal to NUM_RESIDUALS and NUM_PARAMETERS respectively if those
+// are not Eigen::Dynamic.
+
+namespace internal {
+
+template <typename T>
+struct TinySolverVoid {
+  typedef void type;
+};
+
+// Function::MAX_NUM_RESIDUALS if it is defined, otherwise
+// Function::NUM_RESIDUALS.
+template <typename Function, typename Enable = void>
+struct TinySolverMaxNumResiduals {
+  enum { value = Function::NUM_RESIDUALS };
+};
+
+template <typename Function>
+struct TinySolverMaxNumResiduals<
+    Function,
+    typename TinySolverVoid<decltype(Function::MAX_NUM_RESIDUALS)>::type> {
+  enum { value = Function::MAX_NUM_RESIDUALS };
+};
+
+// Function::MAX_NUM_PARAMETERS if it is defined, otherwise
+// Function::NUM_PARAMETERS.
+template <typename Function, typename Enable = void>
+struct TinySolverMaxNumParameters {
+  enum { value = Function::NUM_PARAMETERS };
+};
+
+template <typename Function>
+struct TinySolverMaxNumParameters<
+    Function,
+    typename TinySolverVoid<decltype(Function::MAX_NUM_PARAMETERS)>::type> {
+  enum { value = Function::MAX_NUM_PARAMETERS };
+};
+
+// The default linear solver for Function, whose storage is bounded by
+// Function::MAX_NUM_PARAMETERS if it is defined.
+template <typename Function>
+using TinySolverDefaultLinearSolver = Eigen::LDLT<
+    Eigen::Matrix<typename Function::Scalar,
+                  Function::NUM_PARAMETERS,
+                  Function::NUM_PARAMETERS,
+                  Eigen::ColMajor,
+                  internal::TinySolverMaxNumParameters<Function>::value,
+                  internal::TinySolverMaxNumParameters<Function>::value>>;
+
+}  // namespace internal
+
 template <typename Function,
           typename LinearSolver =
-              Eigen::LDLT<Eigen::Matrix<typename Function::Scalar,
-                                        Function::NUM_PARAMETERS,
-                                        Function::NUM_PARAMETERS>>>
+              internal::TinySolverDefaultLinearSolver<Function>>
 class TinySolver {
  public:
   // This class needs to have an Eigen aligned operator new as it contains
@@ -137,10 +199,21 @@ class TinySolver {
 
   enum {
     NUM_RESIDUALS = Function::NUM_RESIDUALS,
-    NUM_PARAMETERS = Function::NUM_PARAMETERS
+    NUM_PARAMETERS = Function::NUM_PARAMETERS,
+    MAX_NUM_RESIDUALS = internal::TinySolverMaxNumResiduals<Function>::value,
+    MAX_NUM_PARAMETERS = internal::TinySolverMaxNumParameters<Function>::value
   };
+  static_assert(NUM_RESIDUALS == Eigen::Dynamic ||
+                    MAX_NUM_RESIDUALS == NUM_RESIDUALS,
+                "MAX_NUM_RESIDUALS must be equal to a static NUM_RESIDUALS.");
+  static_assert(NUM_PARAMETERS == Eigen::Dynamic ||
+                    MAX_NUM_PARAMETERS == NUM_PARAMETERS,
+                "MAX_NUM_PARAMETERS must be equal to a static NUM_PARAMETERS.");
+
   typedef typename Function::Scalar Scalar;
-  typedef typename Eigen::Matrix<Scalar, NUM_PARAMETERS, 1> Parameters;
+  typedef typename Eigen::
+      Matrix<Scalar, NUM_PARAMETERS, 1, Eigen::ColMajor, MAX_NUM_PARAMETERS, 1>
+          Parameters;
 
   enum Status {
     GRADIENT_TOO_SMALL,            // eps > max(J'*f(x))
@@ -307,9 +380,25 @@ class TinySolver {
   LinearSolver linear_solver_;
   Scalar cost_;
   Parameters dx_, x_new_, g_, jacobi_scaling_, lm_diagonal_, lm_step_;
-  Eigen::Matrix<Scalar, NUM_RESIDUALS, 1> error_, f_x_new_;
-  Eigen::Matrix<Scalar, NUM_RESIDUALS, NUM_PARAMETERS> jacobian_;
-  Eigen::Matrix<Scalar, NUM_PARAMETERS, NUM_PARAMETERS> jtj_, jtj_regularized_;
+  Eigen::Matrix<Scalar, NUM_RESIDUALS, 1, Eigen::ColMajor, MAX_NUM_RESIDUALS, 1>
+      error_, f_x_new_;
+  // Eigen requires matrices with a single row and multiple columns to
+  // be row major; for them the row and column major layouts coincide.
+  Eigen::Matrix<Scalar,
+                NUM_RESIDUALS,
+                NUM_PARAMETERS,
+                (NUM_RESIDUALS == 1 && NUM_PARAMETERS != 1) ? Eigen::RowMajor
+                                                            : Eigen::ColMajor,
+                MAX_NUM_RESIDUALS,
+                MAX_NUM_PARAMETERS>
+      jacobian_;
+  Eigen::Matrix<Scalar,
+                NUM_PARAMETERS,
+                NUM_PARAMETERS,
+                Eigen::ColMajor,
+                MAX_NUM_PARAMETERS,
+                MAX_NUM_PARAMETERS>
+      jtj_, jtj_regularized_;
 
   // The following definitions are needed for template metaprogramming.
   template <bool Condition, typename T>
@@ -349,6 +438,10 @@ class TinySolver {
   Initialize(const Function& /* function */) {}
 
   void Initialize(int num_residuals, int num_parameters) {
+    assert(MAX_NUM_RESIDUALS == Eigen::Dynamic ||
+           num_residuals <= MAX_NUM_RESIDUALS);
+    assert(MAX_NUM_PARAMETERS == Eigen::Dynamic ||
+           num_parameters <= MAX_NUM_PARAMETERS);
     dx_.resize(num_parameters);
     x_new_.resize(num_parameters);
     g_.resize(num_parameters);
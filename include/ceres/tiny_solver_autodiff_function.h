@@ -35,6 +35,7 @@
 #ifndef CERES_PUBLIC_TINY_SOLVER_AUTODIFF_FUNCTION_H_
 #define CERES_PUBLIC_TINY_SOLVER_AUTODIFF_FUNCTION_H_
 
+#include <cassert>
 #include <memory>
 #include <type_traits>
 
@@ -102,11 +103,23 @@ namespace ceres {
 //   TinySolver<AutoDiffFunctionWithDynamicResiduals> solver;
 //   solver.Solve(f, &x);
 //
+// If the number of residuals is dynamic, but bounded, the bound can be
+// passed as kMaxNumResiduals, in which case neither the function nor
+// TinySolver allocate memory:
+//
+//   typedef TinySolverAutoDiffFunction<MyFunctorWithDynamicResiduals,
+//                                      Eigen::Dynamic,
+//                                      3,
+//                                      double,
+//                                      /* kMaxNumResiduals = */ 16>
+//       AutoDiffFunctionWithBoundedResiduals;
+//
 // WARNING: The cost function adapter is not thread safe.
 template <typename CostFunctor,
           int kNumResiduals,
           int kNumParameters,
-          typename T = double>
+          typename T = double,
+          int kMaxNumResiduals = kNumResiduals>
 class TinySolverAutoDiffFunction {
  public:
   // This class needs to have an Eigen aligned operator new as it contains
@@ -122,6 +135,8 @@ class TinySolverAutoDiffFunction {
   enum {
     NUM_PARAMETERS = kNumParameters,
     NUM_RESIDUALS = kNumResiduals,
+    MAX_NUM_PARAMETERS = kNumParameters,
+    MAX_NUM_RESIDUALS = kMaxNumResiduals,
   };
 
   // This is similar to AutoDifferentiate(), but since there is only one
@@ -182,13 +197,17 @@ class TinySolverAutoDiffFunction {
   using JetType = Jet<T, kNumParameters>;
   mutable JetType jet_parameters_[kNumParameters];
   // Eigen::Matrix serves as static or dynamic container.
-  mutable Eigen::Matrix<JetType, kNumResiduals, 1> jet_residuals_;
+  mutable Eigen::
+      Matrix<JetType, kNumResiduals, 1, Eigen::ColMajor, kMaxNumResiduals, 1>
+          jet_residuals_;
 
   // The number of residuals is dynamically sized and the number of
   // parameters is statically sized.
   template <int R>
   typename std::enable_if<(R == Eigen::Dynamic), void>::type Initialize(
       const CostFunctor& function) {
+    assert(kMaxNumResiduals == Eigen::Dynamic ||
+           function.NumResiduals() <= kMaxNumResiduals);
     jet_residuals_.resize(function.NumResiduals());
     num_residuals_ = function.NumResiduals();
   }
@@ -0,0 +1,151 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// WARNING WARNING WARNING
+// WARNING WARNING WARNING  Tiny solver is experimental and will change.
+// WARNING WARNING WARNING
+//
+// TinySolverBatch solves a large number of small independent problems,
+// e.g., triangulating every track or estimating the pose of every
+// camera in a frame, using TinySolver on the threads of a
+// ceres::Context.
+//
+// Each thread owns a TinySolver, so that once the solvers have been
+// initialized, solving allocates no memory, exactly like solving the
+// problems one after the other with a single TinySolver. The problems
+// are described by the same Function objects as for TinySolver, e.g.,
+// TinySolverAutoDiffFunction or TinySolverCostFunctionAdapter.
+//
+// Example usage:
+//
+//   typedef TinySolverAutoDiffFunction<Triangulation, 4, 3> Function;
+//   std::vector<Triangulation> functors = ...;
+//   std::vector<Function> functions(functors.begin(), functors.end());
+//   std::vector<Function::Parameters> points = ...;
+//   std::vector<TinySolverBatch<Function>::Summary> summaries(
+//       functions.size());
+//
+//   TinySolverBatch<Function> solver(/* num_threads = */ 8);
+//   solver.Solve(functions.data(), functions.size(), points.data(),
+//                summaries.data());
+//
+// Since the functions are evaluated concurrently, functions[i] and
+// functions[j] must not share mutable state for i != j. In particular
+// TinySolverAutoDiffFunction stores the Jets used for evaluation, so
+// each problem needs its own TinySolverAutoDiffFunction.
+
+#ifndef CERES_PUBLIC_TINY_SOLVER_BATCH_H_
+#define CERES_PUBLIC_TINY_SOLVER_BATCH_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Eigen/Core"
+#include "ceres/context.h"
+#include "ceres/internal/port.h"
+#include "ceres/tiny_solver.h"
+
+namespace ceres {
+namespace internal {
+
+// Calls function(thread_id, i) for every i in [0, num_items) using at
+// most num_threads threads of the thread pool of context, where
+// thread_id in [0, num_threads) is distinct for concurrent calls.
+CERES_EXPORT void TinySolverBatchParallelFor(
+    Context* context,
+    int num_items,
+    int num_threads,
+    const std::function<void(int thread_id, int i)>& function);
+
+}  // namespace internal
+
+template <typename Function,
+          typename LinearSolver =
+              internal::TinySolverDefaultLinearSolver<Function>>
+class TinySolverBatch {
+ public:
+  typedef TinySolver<Function, LinearSolver> Solver;
+  typedef typename Solver::Scalar Scalar;
+  typedef typename Solver::Parameters Parameters;
+  typedef typename Solver::Options Options;
+  typedef typename Solver::Summary Summary;
+
+  // If context is NULL, the solver creates its own context, and hence
+  // its own thread pool. Otherwise the threads of context are used,
+  // and context must outlive the solver.
+  explicit TinySolverBatch(int num_threads = 1, Context* context = NULL)
+      : num_threads_(num_threads),
+        context_(context),
+        solvers_(num_threads) {
+    assert(num_threads > 0);
+    if (context_ == NULL) {
+      owned_context_.reset(Context::Create());
+      context_ = owned_context_.get();
+    }
+  }
+
+  // Solve the num_problems problems functions[i] starting at
+  // x_and_min[i], and store the minimizers in x_and_min[i] and, if
+  // summaries is not NULL, the solver summaries in summaries[i]. All
+  // problems are solved with the same options.
+  void Solve(const Function* functions,
+             const int num_problems,
+             Parameters* x_and_min,
+             Summary* summaries) {
+    for (Solver& solver : solvers_) {
+      solver.options = options;
+    }
+
+    internal::TinySolverBatchParallelFor(
+        context_,
+        num_problems,
+        num_threads_,
+        [&](const int thread_id, const int i) {
+          const Summary& summary =
+              solvers_[thread_id].Solve(functions[i], &x_and_min[i]);
+          if (summaries != NULL) {
+            summaries[i] = summary;
+          }
+        });
+  }
+
+  Options options;
+
+ private:
+  const int num_threads_;
+  Context* context_;
+  std::unique_ptr<Context> owned_context_;
+  std::vector<Solver, Eigen::aligned_allocator<Solver>> solvers_;
+};
+
+}  // namespace ceres
+
+#endif  // CERES_PUBLIC_TINY_SOLVER_BATCH_H_
@@ -71,14 +71,25 @@ namespace ceres {
 //
 //   TinySolverCostFunctionAdapter cost_function_adapter(*cost_function);
 //
+// If upper bounds on the dynamic sizes are known, they can be passed
+// as kMaxNumResiduals and kMaxNumParameters, in which case neither the
+// adapter nor TinySolver allocate memory:
+//
+//   TinySolverCostFunctionAdapter<Eigen::Dynamic, Eigen::Dynamic, 16, 4>
+//   cost_function_adapter(*cost_function);
+//
 template <int kNumResiduals = Eigen::Dynamic,
-          int kNumParameters = Eigen::Dynamic>
+          int kNumParameters = Eigen::Dynamic,
+          int kMaxNumResiduals = kNumResiduals,
+          int kMaxNumParameters = kNumParameters>
 class TinySolverCostFunctionAdapter {
  public:
   typedef double Scalar;
   enum ComponentSizeType {
     NUM_PARAMETERS = kNumParameters,
-    NUM_RESIDUALS = kNumResiduals
+    NUM_RESIDUALS = kNumResiduals,
+    MAX_NUM_PARAMETERS = kMaxNumParameters,
+    MAX_NUM_RESIDUALS = kMaxNumResiduals
   };
 
   // This struct needs to have an Eigen aligned operator new as it contains
@@ -98,6 +109,12 @@ class TinySolverCostFunctionAdapter {
       if (NUM_PARAMETERS != Eigen::Dynamic) {
         CHECK_EQ(parameter_block_size, NUM_PARAMETERS);
       }
+      if (MAX_NUM_RESIDUALS != Eigen::Dynamic) {
+        CHECK_LE(cost_function_.num_residuals(), MAX_NUM_RESIDUALS);
+      }
+      if (MAX_NUM_PARAMETERS != Eigen::Dynamic) {
+        CHECK_LE(parameter_block_size, MAX_NUM_PARAMETERS);
+      }
 
       row_major_jacobian_.resize(cost_function_.num_residuals(),
                                  parameter_block_size);
@@ -133,7 +150,12 @@ class TinySolverCostFunctionAdapter {
 
  private:
   const CostFunction& cost_function_;
-  mutable Eigen::Matrix<double, NUM_RESIDUALS, NUM_PARAMETERS, Eigen::RowMajor>
+  mutable Eigen::Matrix<double,
+                        NUM_RESIDUALS,
+                        NUM_PARAMETERS,
+                        Eigen::RowMajor,
+                        MAX_NUM_RESIDUALS,
+                        MAX_NUM_PARAMETERS>
       row_major_jacobian_;
 };
 
@@ -0,0 +1,74 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#ifndef CERES_PUBLIC_VISIBILITY_CLUSTERING_H_
+#define CERES_PUBLIC_VISIBILITY_CLUSTERING_H_
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ceres/internal/disable_warnings.h"
+#include "ceres/internal/port.h"
+#include "ceres/types.h"
+
+namespace ceres {
+
+// The camera clustering and the sparsity of a CLUSTER_JACOBI or
+// CLUSTER_TRIDIAGONAL preconditioner. See
+// Solver::Options::visibility_clustering.
+//
+// Clusters are identified by integers in [0, num_clusters), and
+// cameras by their parameter blocks.
+struct CERES_EXPORT VisibilityClustering {
+  // The preconditioner type the clustering was computed for. A
+  // clustering is only reused by a preconditioner of the same type.
+  PreconditionerType preconditioner_type = CLUSTER_JACOBI;
+  int num_clusters = 0;
+
+  // The cluster of each camera.
+  std::unordered_map<const double*, int> cluster_membership;
+
+  // The pairs of clusters (i, j), i <= j, including the self pairs
+  // (i, i), whose camera pairs are present in the preconditioner.
+  std::vector<std::pair<int, int>> cluster_pairs;
+
+  // The pairs of cameras whose cells are present in the
+  // preconditioner, i.e., its block sparsity. Written by Solve, but
+  // not read, since it also depends on the points seen by the
+  // cameras.
+  std::vector<std::pair<const double*, const double*>> block_pairs;
+};
+
+}  // namespace ceres
+
+#include "ceres/internal/reenable_warnings.h"
+
+#endif  // CERES_PUBLIC_VISIBILITY_CLUSTERING_H_
@@ -290,11 +290,38 @@ static void BM_SnavelyReprojectionAutoDiff(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_SnavelyReprojectionAutoDiff, kNotDynamic)->Arg(0)->Arg(1);
 BENCHMARK_TEMPLATE(BM_SnavelyReprojectionAutoDiff, kDynamic)->Arg(0)->Arg(1);
 
-template <Dynamic kIsDynamic>
+enum Interpolation { kNotCached, kCached };
+
+// Creates the interpolator of the target image used by
+// BM_PhotometricAutoDiff.
+template <Interpolation kInterpolation>
+struct ImageInterpolatorFactory {
+  using Grid = Grid2D<uint8_t, 1>;
+  using Interpolator = BiCubicInterpolator<Grid>;
+
+  static Interpolator* Create(const Grid& grid, int num_rows, int num_cols) {
+    return new Interpolator(grid);
+  }
+};
+
+template <>
+struct ImageInterpolatorFactory<kCached> {
+  using Grid = Grid2D<uint8_t, 1>;
+  using Interpolator = CachedBiCubicInterpolator<Grid>;
+
+  static Interpolator* Create(const Grid& grid, int num_rows, int num_cols) {
+    return new Interpolator(grid, 0, num_rows, 0, num_cols);
+  }
+};
+
+template <Dynamic kIsDynamic, Interpolation kInterpolation>
 static void BM_PhotometricAutoDiff(benchmark::State& state) {
   constexpr int PATCH_SIZE = 8;
 
-  using FunctorType = PhotometricError<PATCH_SIZE>;
+  using InterpolatorFactory = ImageInterpolatorFactory<kInterpolation>;
+  using FunctorType =
+      PhotometricError<PATCH_SIZE,
+                       typename InterpolatorFactory::Interpolator>;
   using ImageType = Eigen::Matrix<uint8_t, 128, 128, Eigen::RowMajor>;
 
   // Prepare parameter / residual / jacobian blocks.
@@ -318,25 +345,28 @@ static void BM_PhotometricAutoDiff(benchmark::State& state) {
   std::uniform_real_distribution<double> uniform01(0.0, 1.0);
   std::uniform_int_distribution<unsigned int> uniform0255(0, 255);
 
-  FunctorType::Patch<double> intensities_host =
-      FunctorType::Patch<double>::NullaryExpr(
-          [&]() { return uniform0255(gen); });
+  using Patch = typename FunctorType::template Patch<double>;
+  using PatchVectors = typename FunctorType::template PatchVectors<double>;
+
+  Patch intensities_host =
+      Patch::NullaryExpr([&]() { return uniform0255(gen); });
 
   // Set bearing vector's z component to 1, i.e. pointing away from the camera,
   // to ensure they are (likely) in the domain of the projection function (given
   // a small rotation between host and target frame).
-  FunctorType::PatchVectors<double> bearings_host =
-      FunctorType::PatchVectors<double>::NullaryExpr(
-          [&]() { return uniform01(gen); });
+  PatchVectors bearings_host =
+      PatchVectors::NullaryExpr([&]() { return uniform01(gen); });
   bearings_host.row(2).array() = 1;
   bearings_host.colwise().normalize();
 
   ImageType image = ImageType::NullaryExpr(
       [&]() { return static_cast<uint8_t>(uniform0255(gen)); });
-  FunctorType::Grid grid(image.data(), 0, image.rows(), 0, image.cols());
-  FunctorType::Interpolator image_target(grid);
+  typename FunctorType::Grid grid(
+      image.data(), 0, image.rows(), 0, image.cols());
+  std::unique_ptr<typename FunctorType::Interpolator> image_target(
+      InterpolatorFactory::Create(grid, image.rows(), image.cols()));
 
-  FunctorType::Intrinsics intrinsics;
+  typename FunctorType::Intrinsics intrinsics;
   intrinsics << 128, 128, 1, -1, 0.5, 0.5;
 
   std::unique_ptr<ceres::CostFunction> cost_function =
@@ -345,7 +375,7 @@ static void BM_PhotometricAutoDiff(benchmark::State& state) {
                                                        FunctorType::POSE_SIZE,
                                                        FunctorType::POSE_SIZE,
                                                        FunctorType::POINT_SIZE>(
-          intensities_host, bearings_host, image_target, intrinsics);
+          intensities_host, bearings_host, *image_target, intrinsics);
 
   for (auto _ : state) {
     cost_function->Evaluate(
@@ -353,8 +383,18 @@ static void BM_PhotometricAutoDiff(benchmark::State& state) {
   }
 }
 
-BENCHMARK_TEMPLATE(BM_PhotometricAutoDiff, kNotDynamic)->Arg(0)->Arg(1);
-BENCHMARK_TEMPLATE(BM_PhotometricAutoDiff, kDynamic)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_PhotometricAutoDiff, kNotDynamic, kNotCached)
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_TEMPLATE(BM_PhotometricAutoDiff, kDynamic, kNotCached)
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_TEMPLATE(BM_PhotometricAutoDiff, kNotDynamic, kCached)
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_TEMPLATE(BM_PhotometricAutoDiff, kDynamic, kCached)
+    ->Arg(0)
+    ->Arg(1);
 
 template <Dynamic kIsDynamic>
 static void BM_RelativePoseAutoDiff(benchmark::State& state) {
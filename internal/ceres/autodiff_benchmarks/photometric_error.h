@@ -76,14 +76,18 @@ namespace ceres {
 // [4] H. Matsuki, L. von Stumberg, V. Usenko, J. Stückler and D. Cremers,
 // "Omnidirectional DSO: Direct Sparse Odometry With Fisheye Cameras," in IEEE
 // Robotics and Automation Letters, vol. 3, no. 4, pp. 3693-3700, Oct. 2018.
-template <int PATCH_SIZE_ = 8>
+//
+// The target image is interpolated with Interpolator_, which can be a
+// BiCubicInterpolator or a CachedBiCubicInterpolator of the Grid.
+template <int PATCH_SIZE_ = 8,
+          typename Interpolator_ = BiCubicInterpolator<Grid2D<uint8_t, 1>>>
 struct PhotometricError {
   static constexpr int PATCH_SIZE = PATCH_SIZE_;
   static constexpr int POSE_SIZE = 7;
   static constexpr int POINT_SIZE = 1;
 
   using Grid = Grid2D<uint8_t, 1>;
-  using Interpolator = BiCubicInterpolator<Grid>;
+  using Interpolator = Interpolator_;
   using Intrinsics = Eigen::Array<double, 6, 1>;
 
   template <typename T>
@@ -159,7 +163,8 @@ struct PhotometricError {
         (R_t_h * bearings_host_).colwise() + idist * t_t_h;
 
     // Project points and interpolate image.
-    Patch<T> intensities_target;
+    Patch<T> rows;
+    Patch<T> cols;
     for (int i = 0; i < p_target_scaled.cols(); ++i) {
       Eigen::Matrix<T, 2, 1> uv;
       if (!Project(uv, Eigen::Matrix<T, 3, 1>(p_target_scaled.col(i)))) {
@@ -172,9 +177,14 @@ struct PhotometricError {
 
       // Mind the order of u and v: Evaluate takes (row, column), but u is
       // left-to-right and v top-to-bottom image axis.
-      image_target_.Evaluate(uv[1], uv[0], &intensities_target[i]);
+      rows[i] = uv[1];
+      cols[i] = uv[0];
     }
 
+    Patch<T> intensities_target;
+    image_target_.Evaluate(
+        rows.data(), cols.data(), PATCH_SIZE, intensities_target.data());
+
     // Residual is intensity difference between host and target frame.
     residuals = intensities_target - intensities_host_;
 
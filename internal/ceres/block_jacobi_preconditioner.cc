@@ -30,24 +30,55 @@
 
 #include "ceres/block_jacobi_preconditioner.h"
 
+#include <algorithm>
+
 #include "ceres/block_random_access_diagonal_matrix.h"
 #include "ceres/block_sparse_matrix.h"
 #include "ceres/block_structure.h"
 #include "ceres/casts.h"
 #include "ceres/internal/eigen.h"
+#include "ceres/matrix_free_jacobian.h"
+#include "ceres/parallel_for.h"
 
 namespace ceres {
 namespace internal {
 
 BlockJacobiPreconditioner::BlockJacobiPreconditioner(
-    const BlockSparseMatrix& A) {
+    const BlockSparseMatrix& A)
+    : BlockJacobiPreconditioner(A, Preconditioner::Options()) {}
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(
+    const BlockSparseMatrix& A, const Preconditioner::Options& options)
+    : context_(options.context), num_threads_(options.num_threads) {
   const CompressedRowBlockStructure* bs = A.block_structure();
-  std::vector<int> blocks(bs->cols.size());
-  for (int i = 0; i < blocks.size(); ++i) {
+  const int num_col_blocks = bs->cols.size();
+  std::vector<int> blocks(num_col_blocks);
+  for (int i = 0; i < num_col_blocks; ++i) {
     blocks[i] = bs->cols[i].size;
   }
 
   m_.reset(new BlockRandomAccessDiagonalMatrix(blocks));
+
+  // Bucket the cells of A by their column block, so that each
+  // diagonal block of A'A can be computed independently.
+  cell_offsets_.resize(num_col_blocks + 1, 0);
+  for (const CompressedRow& row : bs->rows) {
+    for (const Cell& cell : row.cells) {
+      ++cell_offsets_[cell.block_id + 1];
+    }
+  }
+  for (int i = 0; i < num_col_blocks; ++i) {
+    cell_offsets_[i + 1] += cell_offsets_[i];
+  }
+
+  cells_.resize(cell_offsets_.back());
+  std::vector<int> next_cell(cell_offsets_.begin(), cell_offsets_.end() - 1);
+  for (const CompressedRow& row : bs->rows) {
+    for (const Cell& cell : row.cells) {
+      cells_[next_cell[cell.block_id]++] =
+          std::make_pair(row.block.size, cell.position);
+    }
+  }
 }
 
 BlockJacobiPreconditioner::~BlockJacobiPreconditioner() {}
@@ -56,44 +87,88 @@ bool BlockJacobiPreconditioner::UpdateImpl(const BlockSparseMatrix& A,
                                            const double* D) {
   const CompressedRowBlockStructure* bs = A.block_structure();
   const double* values = A.values();
-  m_->SetZero();
-  for (int i = 0; i < bs->rows.size(); ++i) {
-    const int row_block_size = bs->rows[i].block.size;
-    const std::vector<Cell>& cells = bs->rows[i].cells;
-    for (int j = 0; j < cells.size(); ++j) {
-      const int block_id = cells[j].block_id;
-      const int col_block_size = bs->cols[block_id].size;
+  const int num_col_blocks = bs->cols.size();
 
-      int r, c, row_stride, col_stride;
-      CellInfo* cell_info =
-          m_->GetCell(block_id, block_id, &r, &c, &row_stride, &col_stride);
-      MatrixRef m(cell_info->values, row_stride, col_stride);
-      ConstMatrixRef b(
-          values + cells[j].position, row_block_size, col_block_size);
-      m.block(r, c, col_block_size, col_block_size) += b.transpose() * b;
+  // Compute and regularize the i^th diagonal block of A'A.
+  auto update_block = [&](const int i) {
+    const int col_block_size = bs->cols[i].size;
+    int r, c, row_stride, col_stride;
+    CellInfo* cell_info =
+        m_->GetCell(i, i, &r, &c, &row_stride, &col_stride);
+    MatrixRef m(cell_info->values, row_stride, col_stride);
+    auto block = m.block(r, c, col_block_size, col_block_size);
+    block.setZero();
+    for (int j = cell_offsets_[i]; j < cell_offsets_[i + 1]; ++j) {
+      ConstMatrixRef b(values + cells_[j].second,
+                       cells_[j].first,
+                       col_block_size);
+      block.noalias() += b.transpose() * b;
+    }
+
+    if (D != NULL) {
+      block.diagonal() +=
+          ConstVectorRef(D + bs->cols[i].position, col_block_size)
+              .array()
+              .square()
+              .matrix();
+    }
+  };
+
+  if (context_ == NULL || num_threads_ == 1 || num_col_blocks <= 1) {
+    for (int i = 0; i < num_col_blocks; ++i) {
+      update_block(i);
     }
+  } else {
+    ParallelFor(context_,
+                0,
+                num_col_blocks,
+                std::min(num_threads_, num_col_blocks),
+                update_block);
+  }
+
+  m_->Invert(context_, num_threads_);
+  return true;
+}
+
+void BlockJacobiPreconditioner::RightMultiply(const double* x,
+                                              double* y) const {
+  m_->RightMultiply(x, y);
+}
+
+MatrixFreeBlockJacobiPreconditioner::MatrixFreeBlockJacobiPreconditioner(
+    const MatrixFreeJacobian& A, const Preconditioner::Options& options)
+    : context_(options.context),
+      num_threads_(options.num_threads),
+      m_(new BlockRandomAccessDiagonalMatrix(A.column_block_sizes())) {}
+
+MatrixFreeBlockJacobiPreconditioner::~MatrixFreeBlockJacobiPreconditioner() {}
+
+bool MatrixFreeBlockJacobiPreconditioner::UpdateImpl(
+    const MatrixFreeJacobian& A, const double* D) {
+  if (!A.BlockDiagonalJtJ(m_.get())) {
+    return false;
   }
 
   if (D != NULL) {
-    // Add the diagonal.
+    const std::vector<int>& blocks = A.column_block_sizes();
     int position = 0;
-    for (int i = 0; i < bs->cols.size(); ++i) {
-      const int block_size = bs->cols[i].size;
+    for (int i = 0; i < blocks.size(); ++i) {
       int r, c, row_stride, col_stride;
-      CellInfo* cell_info = m_->GetCell(i, i, &r, &c, &row_stride, &col_stride);
+      CellInfo* cell_info =
+          m_->GetCell(i, i, &r, &c, &row_stride, &col_stride);
       MatrixRef m(cell_info->values, row_stride, col_stride);
-      m.block(r, c, block_size, block_size).diagonal() +=
-          ConstVectorRef(D + position, block_size).array().square().matrix();
-      position += block_size;
+      m.block(r, c, blocks[i], blocks[i]).diagonal() +=
+          ConstVectorRef(D + position, blocks[i]).array().square().matrix();
+      position += blocks[i];
     }
   }
 
-  m_->Invert();
+  m_->Invert(context_, num_threads_);
   return true;
 }
 
-void BlockJacobiPreconditioner::RightMultiply(const double* x,
-                                              double* y) const {
+void MatrixFreeBlockJacobiPreconditioner::RightMultiply(const double* x,
+                                                        double* y) const {
   m_->RightMultiply(x, y);
 }
 
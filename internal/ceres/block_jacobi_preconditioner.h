@@ -32,6 +32,8 @@
 #define CERES_INTERNAL_BLOCK_JACOBI_PRECONDITIONER_H_
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "ceres/block_random_access_diagonal_matrix.h"
 #include "ceres/internal/port.h"
@@ -41,6 +43,7 @@ namespace ceres {
 namespace internal {
 
 class BlockSparseMatrix;
+class MatrixFreeJacobian;
 struct CompressedRowBlockStructure;
 
 // A block Jacobi preconditioner. This is intended for use with
@@ -53,11 +56,19 @@ struct CompressedRowBlockStructure;
 // update the matrix by running Update(A, D). The values of the matrix A are
 // inspected to construct the preconditioner. The vector D is applied as the
 // D^TD diagonal term.
+//
+// Each diagonal block of A^TA is accumulated and regularized by a
+// single task, so if a ContextImpl and more than one thread are passed
+// via Preconditioner::Options, Update runs in parallel over the column
+// blocks of A without any locking. The blocks are then inverted in
+// parallel batches by BlockRandomAccessDiagonalMatrix::Invert.
 class CERES_EXPORT_INTERNAL BlockJacobiPreconditioner
     : public BlockSparseMatrixPreconditioner {
  public:
   // A must remain valid while the BlockJacobiPreconditioner is.
   explicit BlockJacobiPreconditioner(const BlockSparseMatrix& A);
+  BlockJacobiPreconditioner(const BlockSparseMatrix& A,
+                            const Preconditioner::Options& options);
   BlockJacobiPreconditioner(const BlockJacobiPreconditioner&) = delete;
   void operator=(const BlockJacobiPreconditioner&) = delete;
 
@@ -72,6 +83,41 @@ class CERES_EXPORT_INTERNAL BlockJacobiPreconditioner
  private:
   bool UpdateImpl(const BlockSparseMatrix& A, const double* D) final;
 
+  ContextImpl* context_;
+  int num_threads_;
+
+  // The cells of A grouped by column block. The cells in column block
+  // i are cells_[cell_offsets_[i], cell_offsets_[i + 1]), each stored
+  // as a (row block size, position in the values array of A) pair.
+  std::vector<int> cell_offsets_;
+  std::vector<std::pair<int, int>> cells_;
+
+  std::unique_ptr<BlockRandomAccessDiagonalMatrix> m_;
+};
+
+// The same preconditioner for a MatrixFreeJacobian. Every Update
+// evaluates the Jacobian once to compute the diagonal blocks of A^TA.
+class CERES_EXPORT_INTERNAL MatrixFreeBlockJacobiPreconditioner
+    : public TypedPreconditioner<MatrixFreeJacobian> {
+ public:
+  MatrixFreeBlockJacobiPreconditioner(const MatrixFreeJacobian& A,
+                                      const Preconditioner::Options& options);
+  MatrixFreeBlockJacobiPreconditioner(
+      const MatrixFreeBlockJacobiPreconditioner&) = delete;
+  void operator=(const MatrixFreeBlockJacobiPreconditioner&) = delete;
+
+  virtual ~MatrixFreeBlockJacobiPreconditioner();
+
+  // Preconditioner interface
+  void RightMultiply(const double* x, double* y) const final;
+  int num_rows() const final { return m_->num_rows(); }
+  int num_cols() const final { return m_->num_rows(); }
+
+ private:
+  bool UpdateImpl(const MatrixFreeJacobian& A, const double* D) final;
+
+  ContextImpl* context_;
+  int num_threads_;
   std::unique_ptr<BlockRandomAccessDiagonalMatrix> m_;
 };
 
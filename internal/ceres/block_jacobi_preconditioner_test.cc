@@ -36,6 +36,7 @@
 #include "Eigen/Dense"
 #include "ceres/block_random_access_diagonal_matrix.h"
 #include "ceres/block_sparse_matrix.h"
+#include "ceres/context_impl.h"
 #include "ceres/linear_least_squares_problems.h"
 #include "gtest/gtest.h"
 
@@ -62,10 +63,15 @@ class BlockJacobiPreconditionerTest : public ::testing::Test {
                      .asDiagonal();
   }
 
-  void VerifyDiagonalBlocks(const int problem_id) {
+  void VerifyDiagonalBlocks(const int problem_id, const int num_threads) {
     SetUpFromProblemId(problem_id);
 
-    BlockJacobiPreconditioner pre(*A);
+    ContextImpl context;
+    context.EnsureMinimumThreads(num_threads);
+    Preconditioner::Options options;
+    options.context = &context;
+    options.num_threads = num_threads;
+    BlockJacobiPreconditioner pre(*A, options);
     pre.Update(*A, D.get());
     BlockRandomAccessDiagonalMatrix* m =
         const_cast<BlockRandomAccessDiagonalMatrix*>(&pre.matrix());
@@ -93,9 +99,21 @@ class BlockJacobiPreconditionerTest : public ::testing::Test {
   Matrix dense_ata;
 };
 
-TEST_F(BlockJacobiPreconditionerTest, SmallProblem) { VerifyDiagonalBlocks(2); }
+TEST_F(BlockJacobiPreconditionerTest, SmallProblem) {
+  VerifyDiagonalBlocks(2, 1);
+}
 
-TEST_F(BlockJacobiPreconditionerTest, LargeProblem) { VerifyDiagonalBlocks(3); }
+TEST_F(BlockJacobiPreconditionerTest, LargeProblem) {
+  VerifyDiagonalBlocks(3, 1);
+}
+
+TEST_F(BlockJacobiPreconditionerTest, SmallProblemMultithreaded) {
+  VerifyDiagonalBlocks(2, 4);
+}
+
+TEST_F(BlockJacobiPreconditionerTest, LargeProblemMultithreaded) {
+  VerifyDiagonalBlocks(3, 4);
+}
 
 }  // namespace internal
 }  // namespace ceres
@@ -124,7 +124,9 @@ void BuildJacobianLayout(const Program& program,
 
 BlockJacobianWriter::BlockJacobianWriter(const Evaluator::Options& options,
                                          Program* program)
-    : program_(program) {
+    : program_(program),
+      memory_mapped_storage_directory_(
+          options.memory_mapped_storage_directory) {
   CHECK_GE(options.num_eliminate_blocks, 0)
       << "num_eliminate_blocks must be greater than 0.";
 
@@ -148,7 +150,7 @@ BlockEvaluatePreparer* BlockJacobianWriter::CreateEvaluatePreparers(
   return preparers;
 }
 
-SparseMatrix* BlockJacobianWriter::CreateJacobian() const {
+SparseMatrix* BlockJacobianWriter::CreateJacobian(std::string* error) const {
   CompressedRowBlockStructure* bs = new CompressedRowBlockStructure;
 
   const vector<ParameterBlock*>& parameter_blocks =
@@ -204,9 +206,8 @@ SparseMatrix* BlockJacobianWriter::CreateJacobian() const {
     sort(row->cells.begin(), row->cells.end(), CellLessThan);
   }
 
-  BlockSparseMatrix* jacobian = new BlockSparseMatrix(bs);
-  CHECK(jacobian != nullptr);
-  return jacobian;
+  return BlockSparseMatrix::Create(bs, memory_mapped_storage_directory_, error)
+      .release();
 }
 
 }  // namespace internal
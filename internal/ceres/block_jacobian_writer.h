@@ -38,6 +38,7 @@
 #ifndef CERES_INTERNAL_BLOCK_JACOBIAN_WRITER_H_
 #define CERES_INTERNAL_BLOCK_JACOBIAN_WRITER_H_
 
+#include <string>
 #include <vector>
 
 #include "ceres/evaluator.h"
@@ -61,7 +62,7 @@ class BlockJacobianWriter {
   // This makes the final Write() a nop.
   BlockEvaluatePreparer* CreateEvaluatePreparers(int num_threads);
 
-  SparseMatrix* CreateJacobian() const;
+  SparseMatrix* CreateJacobian(std::string* error) const;
 
   void Write(int /* residual_id */,
              int /* residual_offset */,
@@ -74,6 +75,7 @@ class BlockJacobianWriter {
 
  private:
   Program* program_;
+  std::string memory_mapped_storage_directory_;
 
   // Stores the position of each residual / parameter jacobian.
   //
@@ -37,6 +37,8 @@
 
 #include "Eigen/Dense"
 #include "ceres/internal/port.h"
+#include "ceres/invert_psd_matrix.h"
+#include "ceres/parallel_for.h"
 #include "ceres/stl_util.h"
 #include "ceres/triplet_sparse_matrix.h"
 #include "ceres/types.h"
@@ -119,15 +121,50 @@ void BlockRandomAccessDiagonalMatrix::SetZero() {
   }
 }
 
-void BlockRandomAccessDiagonalMatrix::Invert() {
-  double* values = tsm_->mutable_values();
-  for (int i = 0; i < blocks_.size(); ++i) {
-    const int block_size = blocks_[i];
-    MatrixRef block(values, block_size, block_size);
-    block = block.selfadjointView<Eigen::Upper>().llt().solve(
-        Matrix::Identity(block_size, block_size));
-    values += block_size * block_size;
+void BlockRandomAccessDiagonalMatrix::Invert() { Invert(NULL, 1); }
+
+void BlockRandomAccessDiagonalMatrix::Invert(ContextImpl* context,
+                                             const int num_threads) {
+  // Split the blocks into chunks of consecutive blocks of the same
+  // size. The blocks are stored contiguously, so each chunk can be
+  // inverted with a single call to the batched inversion kernel.
+  const int kMaxChunkSize = 16 * kInvertPSDMatricesBatchSize;
+  const int num_blocks = blocks_.size();
+  std::vector<int> chunk_starts;
+  for (int i = 0; i < num_blocks; ++i) {
+    if (chunk_starts.empty() || blocks_[i] != blocks_[chunk_starts.back()] ||
+        i - chunk_starts.back() == kMaxChunkSize) {
+      chunk_starts.push_back(i);
+    }
+  }
+  const int num_chunks = chunk_starts.size();
+  chunk_starts.push_back(num_blocks);
+
+  auto invert_chunk = [&](const int chunk) {
+    const int start = chunk_starts[chunk];
+    const int end = chunk_starts[chunk + 1];
+    const int block_size = blocks_[start];
+    if (InvertPSDMatricesBatched(
+            block_size, end - start, layout_[start]->values)) {
+      return;
+    }
+
+    for (int i = start; i < end; ++i) {
+      MatrixRef block(layout_[i]->values, block_size, block_size);
+      block =
+          InvertPSDMatrix<Eigen::Dynamic>(/*assume_full_rank=*/true, block);
+    }
+  };
+
+  if (context == NULL || num_threads == 1 || num_chunks <= 1) {
+    for (int i = 0; i < num_chunks; ++i) {
+      invert_chunk(i);
+    }
+    return;
   }
+
+  ParallelFor(
+      context, 0, num_chunks, std::min(num_threads, num_chunks), invert_chunk);
 }
 
 void BlockRandomAccessDiagonalMatrix::RightMultiply(const double* x,
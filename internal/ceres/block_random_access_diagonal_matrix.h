@@ -44,6 +44,8 @@
 namespace ceres {
 namespace internal {
 
+class ContextImpl;
+
 // A thread safe block diagonal matrix implementation of
 // BlockRandomAccessMatrix.
 class CERES_EXPORT_INTERNAL BlockRandomAccessDiagonalMatrix
@@ -74,6 +76,11 @@ class CERES_EXPORT_INTERNAL BlockRandomAccessDiagonalMatrix
   // Invert the matrix assuming that each block is positive definite.
   void Invert();
 
+  // Same as Invert(), but the blocks are inverted in parallel using
+  // up to num_threads threads from context. If context is NULL, the
+  // blocks are inverted on the calling thread.
+  void Invert(ContextImpl* context, int num_threads);
+
   // y += S * x
   void RightMultiply(const double* x, double* y) const;
 
@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -51,17 +52,54 @@ using std::vector;
 
 BlockRandomAccessSparseMatrix::BlockRandomAccessSparseMatrix(
     const vector<int>& blocks, const set<pair<int, int>>& block_pairs)
+    : BlockRandomAccessSparseMatrix(blocks) {
+  std::string error;
+  CHECK(Init(block_pairs, "", &error)) << error;
+}
+
+BlockRandomAccessSparseMatrix::BlockRandomAccessSparseMatrix(
+    const vector<int>& blocks, const vector<pair<int, int>>& block_pairs)
+    : BlockRandomAccessSparseMatrix(blocks) {
+  DCHECK(std::is_sorted(block_pairs.begin(), block_pairs.end()));
+  DCHECK(std::adjacent_find(block_pairs.begin(), block_pairs.end()) ==
+         block_pairs.end());
+  std::string error;
+  CHECK(Init(block_pairs, "", &error)) << error;
+}
+
+std::unique_ptr<BlockRandomAccessSparseMatrix>
+BlockRandomAccessSparseMatrix::Create(const vector<int>& blocks,
+                                      const set<pair<int, int>>& block_pairs,
+                                      const std::string& storage_directory,
+                                      std::string* error) {
+  std::unique_ptr<BlockRandomAccessSparseMatrix> matrix(
+      new BlockRandomAccessSparseMatrix(blocks));
+  if (!matrix->Init(block_pairs, storage_directory, error)) {
+    return nullptr;
+  }
+  return matrix;
+}
+
+BlockRandomAccessSparseMatrix::BlockRandomAccessSparseMatrix(
+    const vector<int>& blocks)
     : kMaxRowBlocks(10 * 1000 * 1000), blocks_(blocks) {
   CHECK_LT(blocks.size(), kMaxRowBlocks);
 
-  // Build the row/column layout vector and count the number of scalar
-  // rows/columns.
-  int num_cols = 0;
+  // Build the row/column layout vector.
   block_positions_.reserve(blocks_.size());
-  for (int i = 0; i < blocks_.size(); ++i) {
-    block_positions_.push_back(num_cols);
-    num_cols += blocks_[i];
+  for (int i = 0, position = 0; i < blocks_.size(); ++i) {
+    block_positions_.push_back(position);
+    position += blocks_[i];
   }
+}
+
+template <typename BlockPairs>
+bool BlockRandomAccessSparseMatrix::Init(
+    const BlockPairs& block_pairs,
+    const std::string& storage_directory,
+    std::string* error) {
+  const int num_cols =
+      blocks_.empty() ? 0 : block_positions_.back() + blocks_.back();
 
   // Count the number of scalar non-zero entries and build the layout
   // object for looking into the values array of the
@@ -76,7 +114,11 @@ BlockRandomAccessSparseMatrix::BlockRandomAccessSparseMatrix(
   VLOG(1) << "Matrix Size [" << num_cols << "," << num_cols << "] "
           << num_nonzeros;
 
-  tsm_.reset(new TripletSparseMatrix(num_cols, num_cols, num_nonzeros));
+  tsm_ = TripletSparseMatrix::Create(
+      num_cols, num_cols, num_nonzeros, storage_directory, error);
+  if (tsm_ == nullptr) {
+    return false;
+  }
   tsm_->set_num_nonzeros(num_nonzeros);
   int* rows = tsm_->mutable_rows();
   int* cols = tsm_->mutable_cols();
@@ -110,6 +152,7 @@ BlockRandomAccessSparseMatrix::BlockRandomAccessSparseMatrix(
       }
     }
   }
+  return true;
 }
 
 // Assume that the user does not hold any locks on any cell blocks
@@ -34,6 +34,7 @@
 #include <cstdint>
 #include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -60,6 +61,23 @@ class CERES_EXPORT_INTERNAL BlockRandomAccessSparseMatrix
   BlockRandomAccessSparseMatrix(
       const std::vector<int>& blocks,
       const std::set<std::pair<int, int>>& block_pairs);
+
+  // Same as above, except that block_pairs is a sorted vector with no
+  // duplicate pairs.
+  BlockRandomAccessSparseMatrix(
+      const std::vector<int>& blocks,
+      const std::vector<std::pair<int, int>>& block_pairs);
+
+  // Same as the constructor, except that if storage_directory is not
+  // empty, the values of the cells are stored in a memory mapped file
+  // in storage_directory instead of on the heap. Returns nullptr and
+  // sets error if the file cannot be created.
+  static std::unique_ptr<BlockRandomAccessSparseMatrix> Create(
+      const std::vector<int>& blocks,
+      const std::set<std::pair<int, int>>& block_pairs,
+      const std::string& storage_directory,
+      std::string* error);
+
   BlockRandomAccessSparseMatrix(const BlockRandomAccessSparseMatrix&) = delete;
   void operator=(const BlockRandomAccessSparseMatrix&) = delete;
 
@@ -94,6 +112,16 @@ class CERES_EXPORT_INTERNAL BlockRandomAccessSparseMatrix
   TripletSparseMatrix* mutable_matrix() { return tsm_.get(); }
 
  private:
+  // Set up the block layout, without creating the cells.
+  explicit BlockRandomAccessSparseMatrix(const std::vector<int>& blocks);
+
+  // Create the cells for block_pairs. Returns false and sets error if
+  // their values cannot be allocated.
+  template <typename BlockPairs>
+  bool Init(const BlockPairs& block_pairs,
+            const std::string& storage_directory,
+            std::string* error);
+
   int64_t IntPairToLong(int row, int col) const {
     return row * kMaxRowBlocks + col;
   }
@@ -32,6 +32,7 @@
 
 #include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "ceres/internal/eigen.h"
@@ -179,5 +180,44 @@ TEST_F(BlockRandomAccessSparseMatrixTest, LongToIntPair) {
   CheckLongToIntPair();
 }
 
+#ifndef _WIN32
+TEST(BlockRandomAccessSparseMatrix, MemoryMappedStorage) {
+  vector<int> blocks = {2, 3};
+  set<pair<int, int>> block_pairs = {{0, 0}, {0, 1}, {1, 1}};
+  std::string error;
+  std::unique_ptr<BlockRandomAccessSparseMatrix> m =
+      BlockRandomAccessSparseMatrix::Create(
+          blocks, block_pairs, testing::TempDir(), &error);
+  ASSERT_TRUE(m != nullptr) << error;
+  EXPECT_EQ(m->matrix()->num_nonzeros(), 4 + 6 + 9);
+
+  int row;
+  int col;
+  int row_stride;
+  int col_stride;
+  CellInfo* cell = m->GetCell(0, 1, &row, &col, &row_stride, &col_stride);
+  ASSERT_TRUE(cell != nullptr);
+  MatrixRef(cell->values, row_stride, col_stride)
+      .block(row, col, 2, 3)
+      .setConstant(2.0);
+
+  Matrix dense;
+  m->matrix()->ToDenseMatrix(&dense);
+  EXPECT_EQ(dense.block(0, 2, 2, 3), Matrix::Constant(2, 3, 2.0));
+}
+
+TEST(BlockRandomAccessSparseMatrix, MemoryMappedStorageInMissingDirectory) {
+  vector<int> blocks = {2, 3};
+  set<pair<int, int>> block_pairs = {{0, 0}, {1, 1}};
+  std::string error;
+  EXPECT_TRUE(BlockRandomAccessSparseMatrix::Create(
+                  blocks,
+                  block_pairs,
+                  testing::TempDir() + "/ceres_does_not_exist",
+                  &error) == nullptr);
+  EXPECT_FALSE(error.empty());
+}
+#endif  // _WIN32
+
 }  // namespace internal
 }  // namespace ceres
@@ -32,10 +32,13 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "ceres/block_structure.h"
 #include "ceres/internal/eigen.h"
+#include "ceres/memory_mapped_buffer.h"
 #include "ceres/random.h"
 #include "ceres/small_blas.h"
 #include "ceres/triplet_sparse_matrix.h"
@@ -50,9 +53,32 @@ BlockSparseMatrix::~BlockSparseMatrix() {}
 
 BlockSparseMatrix::BlockSparseMatrix(
     CompressedRowBlockStructure* block_structure)
+    : BlockSparseMatrix(block_structure, "") {
+  std::string error;
+  CHECK(Reserve(num_nonzeros_, &error)) << error;
+}
+
+std::unique_ptr<BlockSparseMatrix> BlockSparseMatrix::Create(
+    CompressedRowBlockStructure* block_structure,
+    const std::string& storage_directory,
+    std::string* error) {
+  std::unique_ptr<BlockSparseMatrix> matrix(
+      new BlockSparseMatrix(block_structure, storage_directory));
+  if (!matrix->Reserve(matrix->num_nonzeros_, error)) {
+    return nullptr;
+  }
+  return matrix;
+}
+
+BlockSparseMatrix::BlockSparseMatrix(
+    CompressedRowBlockStructure* block_structure,
+    const std::string& storage_directory)
     : num_rows_(0),
       num_cols_(0),
       num_nonzeros_(0),
+      max_num_nonzeros_(0),
+      storage_directory_(storage_directory),
+      values_(nullptr),
       block_structure_(block_structure) {
   CHECK(block_structure_ != nullptr);
 
@@ -78,15 +104,45 @@ BlockSparseMatrix::BlockSparseMatrix(
   CHECK_GE(num_rows_, 0);
   CHECK_GE(num_cols_, 0);
   CHECK_GE(num_nonzeros_, 0);
-  VLOG(2) << "Allocating values array with " << num_nonzeros_ * sizeof(double)
-          << " bytes.";  // NOLINT
-  values_.reset(new double[num_nonzeros_]);
-  max_num_nonzeros_ = num_nonzeros_;
-  CHECK(values_ != nullptr);
+}
+
+bool BlockSparseMatrix::Reserve(const int max_num_nonzeros,
+                                std::string* error) {
+  if (values_ != nullptr && max_num_nonzeros <= max_num_nonzeros_) {
+    return true;
+  }
+
+  VLOG(2) << "Allocating values array with "
+          << max_num_nonzeros * sizeof(double) << " bytes.";  // NOLINT
+  std::unique_ptr<double[]> new_heap_values;
+  std::unique_ptr<MemoryMappedBuffer> new_mapped_values;
+  double* new_values = AllocateValues(storage_directory_,
+                                      max_num_nonzeros,
+                                      &new_heap_values,
+                                      &new_mapped_values,
+                                      error);
+  if (new_values == nullptr) {
+    return false;
+  }
+
+  if (values_ != nullptr) {
+    std::copy(values_, values_ + num_nonzeros_, new_values);
+  }
+  heap_values_ = std::move(new_heap_values);
+  mapped_values_ = std::move(new_mapped_values);
+  values_ = new_values;
+  max_num_nonzeros_ = max_num_nonzeros;
+  if (mapped_values_ != nullptr) {
+    // The Evaluator, the matrix-vector products and the
+    // SchurEliminator all walk the row blocks in order, which is the
+    // order in which they are laid out in the values array.
+    mapped_values_->AdviseSequentialAccess();
+  }
+  return true;
 }
 
 void BlockSparseMatrix::SetZero() {
-  std::fill(values_.get(), values_.get() + num_nonzeros_, 0.0);
+  std::fill(values_, values_ + num_nonzeros_, 0.0);
 }
 
 void BlockSparseMatrix::RightMultiply(const double* x, double* y) const {
@@ -102,7 +158,7 @@ void BlockSparseMatrix::RightMultiply(const double* x, double* y) const {
       int col_block_size = block_structure_->cols[col_block_id].size;
       int col_block_pos = block_structure_->cols[col_block_id].position;
       MatrixVectorMultiply<Eigen::Dynamic, Eigen::Dynamic, 1>(
-          values_.get() + cells[j].position,
+          values_ + cells[j].position,
           row_block_size,
           col_block_size,
           x + col_block_pos,
@@ -124,7 +180,7 @@ void BlockSparseMatrix::LeftMultiply(const double* x, double* y) const {
       int col_block_size = block_structure_->cols[col_block_id].size;
       int col_block_pos = block_structure_->cols[col_block_id].position;
       MatrixTransposeVectorMultiply<Eigen::Dynamic, Eigen::Dynamic, 1>(
-          values_.get() + cells[j].position,
+          values_ + cells[j].position,
           row_block_size,
           col_block_size,
           x + row_block_pos,
@@ -144,7 +200,7 @@ void BlockSparseMatrix::SquaredColumnNorm(double* x) const {
       int col_block_size = block_structure_->cols[col_block_id].size;
       int col_block_pos = block_structure_->cols[col_block_id].position;
       const MatrixRef m(
-          values_.get() + cells[j].position, row_block_size, col_block_size);
+          values_ + cells[j].position, row_block_size, col_block_size);
       VectorRef(x + col_block_pos, col_block_size) += m.colwise().squaredNorm();
     }
   }
@@ -161,7 +217,7 @@ void BlockSparseMatrix::ScaleColumns(const double* scale) {
       int col_block_size = block_structure_->cols[col_block_id].size;
       int col_block_pos = block_structure_->cols[col_block_id].position;
       MatrixRef m(
-          values_.get() + cells[j].position, row_block_size, col_block_size);
+          values_ + cells[j].position, row_block_size, col_block_size);
       m *= ConstVectorRef(scale + col_block_pos, col_block_size).asDiagonal();
     }
   }
@@ -184,7 +240,7 @@ void BlockSparseMatrix::ToDenseMatrix(Matrix* dense_matrix) const {
       int col_block_pos = block_structure_->cols[col_block_id].position;
       int jac_pos = cells[j].position;
       m.block(row_block_pos, col_block_pos, row_block_size, col_block_size) +=
-          MatrixRef(values_.get() + jac_pos, row_block_size, col_block_size);
+          MatrixRef(values_ + jac_pos, row_block_size, col_block_size);
     }
   }
 }
@@ -193,7 +249,8 @@ void BlockSparseMatrix::ToTripletSparseMatrix(
     TripletSparseMatrix* matrix) const {
   CHECK(matrix != nullptr);
 
-  matrix->Reserve(num_nonzeros_);
+  std::string error;
+  CHECK(matrix->Reserve(num_nonzeros_, &error)) << error;
   matrix->Resize(num_rows_, num_cols_);
   matrix->SetZero();
 
@@ -288,6 +345,9 @@ void BlockSparseMatrix::AppendRows(const BlockSparseMatrix& m) {
   const CompressedRowBlockStructure* m_bs = m.block_structure();
   CHECK_EQ(m_bs->cols.size(), block_structure_->cols.size());
 
+  std::string error;
+  CHECK(Reserve(num_nonzeros_ + m.num_nonzeros(), &error)) << error;
+
   const int old_num_nonzeros = num_nonzeros_;
   const int old_num_row_blocks = block_structure_->rows.size();
   block_structure_->rows.resize(old_num_row_blocks + m_bs->rows.size());
@@ -307,16 +367,9 @@ void BlockSparseMatrix::AppendRows(const BlockSparseMatrix& m) {
     }
   }
 
-  if (num_nonzeros_ > max_num_nonzeros_) {
-    double* new_values = new double[num_nonzeros_];
-    std::copy(values_.get(), values_.get() + old_num_nonzeros, new_values);
-    values_.reset(new_values);
-    max_num_nonzeros_ = num_nonzeros_;
-  }
-
   std::copy(m.values(),
             m.values() + m.num_nonzeros(),
-            values_.get() + old_num_nonzeros);
+            values_ + old_num_nonzeros);
 }
 
 void BlockSparseMatrix::DeleteRowBlocks(const int delta_row_blocks) {
@@ -35,10 +35,12 @@
 #define CERES_INTERNAL_BLOCK_SPARSE_MATRIX_H_
 
 #include <memory>
+#include <string>
 
 #include "ceres/block_structure.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/internal/port.h"
+#include "ceres/memory_mapped_buffer.h"
 #include "ceres/sparse_matrix.h"
 
 namespace ceres {
@@ -64,6 +66,16 @@ class CERES_EXPORT_INTERNAL BlockSparseMatrix : public SparseMatrix {
   // CompressedRowBlockStructure objects.
   explicit BlockSparseMatrix(CompressedRowBlockStructure* block_structure);
 
+  // Same as the constructor, except that if storage_directory is not
+  // empty, the values array is stored in a memory mapped file in
+  // storage_directory instead of on the heap. This allows the
+  // operating system to page it out to disk. Returns nullptr and sets
+  // error if the file cannot be created.
+  static std::unique_ptr<BlockSparseMatrix> Create(
+      CompressedRowBlockStructure* block_structure,
+      const std::string& storage_directory,
+      std::string* error);
+
   BlockSparseMatrix();
   BlockSparseMatrix(const BlockSparseMatrix&) = delete;
   void operator=(const BlockSparseMatrix&) = delete;
@@ -83,15 +95,24 @@ class CERES_EXPORT_INTERNAL BlockSparseMatrix : public SparseMatrix {
   int num_rows()         const final { return num_rows_;     }
   int num_cols()         const final { return num_cols_;     }
   int num_nonzeros()     const final { return num_nonzeros_; }
-  const double* values() const final { return values_.get(); }
-  double* mutable_values()     final { return values_.get(); }
+  const double* values() const final { return values_;       }
+  double* mutable_values()     final { return values_;       }
   // clang-format on
 
   void ToTripletSparseMatrix(TripletSparseMatrix* matrix) const;
   const CompressedRowBlockStructure* block_structure() const;
 
+  // Make room for max_num_nonzeros values, so that appending rows
+  // with up to max_num_nonzeros - num_nonzeros() values does not
+  // allocate. Returns false and sets error if the values are memory
+  // mapped and the new file cannot be created, in which case the
+  // matrix is unchanged.
+  bool Reserve(int max_num_nonzeros, std::string* error);
+
   // Append the contents of m to the bottom of this matrix. m must
-  // have the same column blocks structure as this matrix.
+  // have the same column blocks structure as this matrix. Dies if
+  // more values need to be allocated and this fails, which callers
+  // can rule out by calling Reserve first.
   void AppendRows(const BlockSparseMatrix& m);
 
   // Delete the bottom delta_rows_blocks.
@@ -128,11 +149,19 @@ class CERES_EXPORT_INTERNAL BlockSparseMatrix : public SparseMatrix {
       const RandomMatrixOptions& options);
 
  private:
+  // Set up the sizes of the matrix, without allocating the values.
+  BlockSparseMatrix(CompressedRowBlockStructure* block_structure,
+                    const std::string& storage_directory);
+
   int num_rows_;
   int num_cols_;
   int num_nonzeros_;
   int max_num_nonzeros_;
-  std::unique_ptr<double[]> values_;
+  std::string storage_directory_;
+  // values_ is owned by exactly one of heap_values_ and mapped_values_.
+  std::unique_ptr<double[]> heap_values_;
+  std::unique_ptr<MemoryMappedBuffer> mapped_values_;
+  double* values_;
   std::unique_ptr<CompressedRowBlockStructure> block_structure_;
 };
 
@@ -30,6 +30,7 @@
 
 #include "ceres/block_sparse_matrix.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -185,6 +186,42 @@ TEST_F(BlockSparseMatrixTest, AppendAndDeleteBlockDiagonalMatrix) {
   }
 }
 
+#ifndef _WIN32
+TEST_F(BlockSparseMatrixTest, MemoryMappedStorage) {
+  std::string error;
+  std::unique_ptr<BlockSparseMatrix> m = BlockSparseMatrix::Create(
+      new CompressedRowBlockStructure(*A_->block_structure()),
+      testing::TempDir(),
+      &error);
+  ASSERT_TRUE(m != nullptr) << error;
+  ASSERT_EQ(m->num_nonzeros(), A_->num_nonzeros());
+  std::copy(A_->values(),
+            A_->values() + A_->num_nonzeros(),
+            m->mutable_values());
+
+  // Growing the matrix moves the values to a new memory mapped file.
+  ASSERT_TRUE(m->Reserve(2 * A_->num_nonzeros(), &error)) << error;
+  m->AppendRows(*A_);
+
+  Matrix expected;
+  A_->ToDenseMatrix(&expected);
+  Matrix actual;
+  m->ToDenseMatrix(&actual);
+  ASSERT_EQ(actual.rows(), 2 * expected.rows());
+  EXPECT_EQ(actual.topRows(expected.rows()), expected);
+  EXPECT_EQ(actual.bottomRows(expected.rows()), expected);
+}
+
+TEST_F(BlockSparseMatrixTest, MemoryMappedStorageInMissingDirectory) {
+  std::string error;
+  EXPECT_TRUE(BlockSparseMatrix::Create(
+                  new CompressedRowBlockStructure(*A_->block_structure()),
+                  testing::TempDir() + "/ceres_does_not_exist",
+                  &error) == nullptr);
+  EXPECT_FALSE(error.empty());
+}
+#endif  // _WIN32
+
 TEST(BlockSparseMatrix, CreateDiagonalMatrix) {
   std::vector<Block> column_blocks;
   column_blocks.push_back(Block(2, 0));
@@ -33,9 +33,11 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "ceres/graph.h"
 #include "ceres/map_util.h"
+#include "ceres/parallel_for.h"
 #include "glog/logging.h"
 
 namespace ceres {
@@ -107,18 +109,39 @@ void CanonicalViewsClustering::ComputeClustering(
 
   IntSet valid_views;
   FindValidViews(&valid_views);
+  vector<int> candidates;
+  vector<double> differences;
   while (valid_views.size() > 0) {
-    // Find the next best canonical view.
+    // Score all the candidate views. Scoring a view only reads the
+    // current state of the clustering, so the views can be scored
+    // independently of each other.
+    candidates.assign(valid_views.begin(), valid_views.end());
+    differences.resize(candidates.size());
+    auto score_view = [&](int i) {
+      differences[i] = ComputeClusteringQualityDifference(candidates[i],
+                                                          *centers);
+    };
+    if (options_.context == nullptr) {
+      for (int i = 0; i < candidates.size(); ++i) {
+        score_view(i);
+      }
+    } else {
+      ParallelFor(options_.context,
+                  0,
+                  candidates.size(),
+                  options_.num_threads,
+                  score_view);
+    }
+
+    // Find the next best canonical view. Ties are broken in favor of
+    // the view that comes first, which makes the result independent
+    // of the number of threads.
     double best_difference = -std::numeric_limits<double>::max();
     int best_view = 0;
-
-    // TODO(sameeragarwal): Make this loop multi-threaded.
-    for (const auto& view : valid_views) {
-      const double difference =
-          ComputeClusteringQualityDifference(view, *centers);
-      if (difference > best_difference) {
-        best_difference = difference;
-        best_view = view;
+    for (int i = 0; i < candidates.size(); ++i) {
+      if (differences[i] > best_difference) {
+        best_difference = differences[i];
+        best_view = candidates[i];
       }
     }
 
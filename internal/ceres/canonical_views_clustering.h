@@ -50,6 +50,7 @@
 namespace ceres {
 namespace internal {
 
+class ContextImpl;
 struct CanonicalViewsClusteringOptions;
 
 // Compute a partitioning of the vertices of the graph using the
@@ -117,6 +118,12 @@ struct CERES_EXPORT_INTERNAL CanonicalViewsClusteringOptions {
   // Weight for per-view scores.  Lower weight places less
   // confidence in the view scores.
   double view_score_weight = 0.0;
+
+  // The candidate views are scored in parallel using num_threads
+  // threads from context. If context is nullptr, the scoring is
+  // done on the calling thread.
+  ContextImpl* context = nullptr;
+  int num_threads = 1;
 };
 
 }  // namespace internal
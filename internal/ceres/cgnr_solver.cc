@@ -35,12 +35,56 @@
 #include "ceres/conjugate_gradients_solver.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/linear_solver.h"
+#include "ceres/matrix_free_jacobian.h"
 #include "ceres/subset_preconditioner.h"
+#include "ceres/trace.h"
 #include "ceres/wall_time.h"
 #include "glog/logging.h"
 
 namespace ceres {
 namespace internal {
+namespace {
+
+// (A^T A + D^T D)x for a MatrixFreeJacobian A. See CgnrLinearOperator.
+class MatrixFreeCgnrLinearOperator : public LinearOperator {
+ public:
+  MatrixFreeCgnrLinearOperator(const MatrixFreeJacobian& A, const double* D)
+      : A_(A), D_(D) {}
+
+  void RightMultiply(const double* x, double* y) const final {
+    A_.NormalEquationsRightMultiply(x, y);
+    if (D_ != NULL) {
+      int n = A_.num_cols();
+      VectorRef(y, n).array() +=
+          ConstVectorRef(D_, n).array().square() * ConstVectorRef(x, n).array();
+    }
+  }
+
+  void LeftMultiply(const double* x, double* y) const final {
+    RightMultiply(x, y);
+  }
+
+  int num_rows() const final { return A_.num_cols(); }
+  int num_cols() const final { return A_.num_cols(); }
+
+ private:
+  const MatrixFreeJacobian& A_;
+  const double* D_;
+};
+
+const char kEvaluationFailed[] =
+    "Residual block evaluation failed in a product with the matrix-free "
+    "Jacobian.";
+
+LinearSolver::Summary FailureSummary(const std::string& message) {
+  LinearSolver::Summary summary;
+  summary.num_iterations = 0;
+  summary.termination_type = LINEAR_SOLVER_FAILURE;
+  summary.message = message;
+  return summary;
+}
+
+}  // namespace
 
 CgnrSolver::CgnrSolver(const LinearSolver::Options& options)
     : options_(options) {
@@ -70,7 +114,11 @@ LinearSolver::Summary CgnrSolver::SolveImpl(
 
   if (!preconditioner_) {
     if (options_.preconditioner_type == JACOBI) {
-      preconditioner_.reset(new BlockJacobiPreconditioner(*A));
+      Preconditioner::Options preconditioner_options;
+      preconditioner_options.num_threads = options_.num_threads;
+      preconditioner_options.context = options_.context;
+      preconditioner_.reset(
+          new BlockJacobiPreconditioner(*A, preconditioner_options));
     } else if (options_.preconditioner_type == SUBSET) {
       Preconditioner::Options preconditioner_options;
       preconditioner_options.type = SUBSET;
@@ -87,7 +135,14 @@ LinearSolver::Summary CgnrSolver::SolveImpl(
   }
 
   if (preconditioner_) {
-    preconditioner_->Update(*A, per_solve_options.D);
+    ScopedTrace trace(options_.tracer, "Preconditioner::Update");
+    if (!preconditioner_->Update(*A, per_solve_options.D)) {
+      LinearSolver::Summary summary;
+      summary.num_iterations = 0;
+      summary.termination_type = LINEAR_SOLVER_FAILURE;
+      summary.message = "Preconditioner update failed.";
+      return summary;
+    }
   }
 
   LinearSolver::PerSolveOptions cg_per_solve_options = per_solve_options;
@@ -105,5 +160,69 @@ LinearSolver::Summary CgnrSolver::SolveImpl(
   return summary;
 }
 
+MatrixFreeCgnrSolver::MatrixFreeCgnrSolver(
+    const LinearSolver::Options& options)
+    : options_(options) {
+  if (options_.preconditioner_type != JACOBI &&
+      options_.preconditioner_type != IDENTITY) {
+    LOG(FATAL)
+        << "Preconditioner = "
+        << PreconditionerTypeToString(options_.preconditioner_type) << ". "
+        << "Congratulations, you found a bug in Ceres. Please report it.";
+  }
+}
+
+MatrixFreeCgnrSolver::~MatrixFreeCgnrSolver() {}
+
+LinearSolver::Summary MatrixFreeCgnrSolver::SolveImpl(
+    MatrixFreeJacobian* A,
+    const double* b,
+    const LinearSolver::PerSolveOptions& per_solve_options,
+    double* x) {
+  EventLogger event_logger("MatrixFreeCgnrSolver::Solve");
+
+  // Form z = Atb.
+  Vector z(A->num_cols());
+  z.setZero();
+  A->LeftMultiply(b, z.data());
+  if (A->evaluation_failed()) {
+    return FailureSummary(kEvaluationFailed);
+  }
+
+  if (!preconditioner_ && options_.preconditioner_type == JACOBI) {
+    Preconditioner::Options preconditioner_options;
+    preconditioner_options.num_threads = options_.num_threads;
+    preconditioner_options.context = options_.context;
+    preconditioner_.reset(
+        new MatrixFreeBlockJacobiPreconditioner(*A, preconditioner_options));
+  }
+
+  if (preconditioner_) {
+    ScopedTrace trace(options_.tracer, "Preconditioner::Update");
+    if (!preconditioner_->Update(*A, per_solve_options.D)) {
+      return FailureSummary("Preconditioner update failed.");
+    }
+  }
+
+  LinearSolver::PerSolveOptions cg_per_solve_options = per_solve_options;
+  cg_per_solve_options.preconditioner = preconditioner_.get();
+
+  // Solve (AtA + DtD)x = z (= Atb).
+  VectorRef(x, A->num_cols()).setZero();
+  MatrixFreeCgnrLinearOperator lhs(*A, per_solve_options.D);
+  event_logger.AddEvent("Setup");
+
+  ConjugateGradientsSolver conjugate_gradient_solver(options_);
+  LinearSolver::Summary summary =
+      conjugate_gradient_solver.Solve(&lhs, z.data(), cg_per_solve_options, x);
+  event_logger.AddEvent("Solve");
+  // The products of the conjugate gradients iterations are not valid
+  // if a residual block failed to evaluate in any of them.
+  if (A->evaluation_failed()) {
+    return FailureSummary(kEvaluationFailed);
+  }
+  return summary;
+}
+
 }  // namespace internal
 }  // namespace ceres
@@ -38,6 +38,7 @@
 namespace ceres {
 namespace internal {
 
+class MatrixFreeJacobian;
 class Preconditioner;
 
 class BlockJacobiPreconditioner;
@@ -66,6 +67,28 @@ class CgnrSolver : public BlockSparseMatrixSolver {
   std::unique_ptr<Preconditioner> preconditioner_;
 };
 
+// The same solver for a MatrixFreeJacobian. Each product with
+// A^TA evaluates the Jacobian of every residual block once. Only
+// JACOBI and IDENTITY preconditioning are supported. If a residual
+// block fails to evaluate during the solve, the solve returns
+// LINEAR_SOLVER_FAILURE.
+class MatrixFreeCgnrSolver : public TypedLinearSolver<MatrixFreeJacobian> {
+ public:
+  explicit MatrixFreeCgnrSolver(const LinearSolver::Options& options);
+  MatrixFreeCgnrSolver(const MatrixFreeCgnrSolver&) = delete;
+  void operator=(const MatrixFreeCgnrSolver&) = delete;
+  virtual ~MatrixFreeCgnrSolver();
+
+  Summary SolveImpl(MatrixFreeJacobian* A,
+                    const double* b,
+                    const LinearSolver::PerSolveOptions& per_solve_options,
+                    double* x) final;
+
+ private:
+  const LinearSolver::Options options_;
+  std::unique_ptr<Preconditioner> preconditioner_;
+};
+
 }  // namespace internal
 }  // namespace ceres
 
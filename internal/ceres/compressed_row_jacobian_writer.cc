@@ -84,7 +84,8 @@ void CompressedRowJacobianWriter::GetOrderedParameterBlocks(
   sort(evaluated_jacobian_blocks->begin(), evaluated_jacobian_blocks->end());
 }
 
-SparseMatrix* CompressedRowJacobianWriter::CreateJacobian() const {
+SparseMatrix* CompressedRowJacobianWriter::CreateJacobian(
+    std::string* /* error */) const {
   const vector<ResidualBlock*>& residual_blocks = program_->residual_blocks();
 
   int total_num_residuals = program_->NumResiduals();
@@ -33,6 +33,7 @@
 #ifndef CERES_INTERNAL_COMPRESSED_ROW_JACOBIAN_WRITER_H_
 #define CERES_INTERNAL_COMPRESSED_ROW_JACOBIAN_WRITER_H_
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -93,7 +94,7 @@ class CompressedRowJacobianWriter {
     return ScratchEvaluatePreparer::Create(*program_, num_threads);
   }
 
-  SparseMatrix* CreateJacobian() const;
+  SparseMatrix* CreateJacobian(std::string* error) const;
 
   void Write(int residual_id,
              int residual_offset,
@@ -39,12 +39,16 @@
 
 #include "ceres/conjugate_gradients_solver.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 
 #include "ceres/internal/eigen.h"
+#include "ceres/context_impl.h"
 #include "ceres/linear_operator.h"
+#include "ceres/parallel_for.h"
 #include "ceres/stringprintf.h"
+#include "ceres/trace.h"
 #include "ceres/types.h"
 #include "glog/logging.h"
 
@@ -54,12 +58,51 @@ namespace {
 
 bool IsZeroOrInfinity(double x) { return ((x == 0.0) || std::isinf(x)); }
 
+// The vector operations in Solve are done in chunks of this many
+// entries. Dot products are accumulated per chunk and the partial
+// sums are added up in chunk order, so the result does not depend on
+// the number of threads.
+const int kChunkSize = 4096;
+
+template <typename Function>
+void ForEachChunk(ContextImpl* context,
+                  int num_threads,
+                  int num_chunks,
+                  const Function& function) {
+  if (context == NULL || num_threads == 1 || num_chunks <= 1) {
+    for (int i = 0; i < num_chunks; ++i) {
+      function(i);
+    }
+  } else {
+    ParallelFor(
+        context, 0, num_chunks, std::min(num_threads, num_chunks), function);
+  }
+}
+
 }  // namespace
 
 ConjugateGradientsSolver::ConjugateGradientsSolver(
     const LinearSolver::Options& options)
     : options_(options) {}
 
+// This is the Chronopoulos & Gear variant of preconditioned conjugate
+// gradients. Instead of computing r'z and p'Ap in two separate
+// reductions separated by the update of p, it computes q = Az
+// instead of Ap, and uses the recurrences
+//
+//   p'Ap = z'Az - beta * rho / alpha_{n-1}
+//   Ap   = Az + beta * Ap_{n-1}
+//
+// As a result, every iteration consists of the preconditioner, the
+// matrix-vector product and two passes over the vectors: one that
+// computes r'z and z'Az together, and one that updates p, Ap, x and
+// r and at the same time computes the dot products needed by the
+// termination tests. Both passes are split into chunks that are
+// processed in parallel.
+//
+// Reference: A. T. Chronopoulos and C. W. Gear, s-step iterative
+// methods for symmetric linear systems, Journal of Computational and
+// Applied Mathematics 25(2) (1989) 153-168.
 LinearSolver::Summary ConjugateGradientsSolver::Solve(
     LinearOperator* A,
     const double* b,
@@ -88,15 +131,19 @@ LinearSolver::Summary ConjugateGradientsSolver::Solve(
   }
 
   Vector r(num_cols);
-  Vector p(num_cols);
   Vector z(num_cols);
-  Vector tmp(num_cols);
+  Vector q(num_cols);
+  // p and s are updated as p = z + beta * p and s = q + beta * s,
+  // with beta = 0 in the first iteration, so they must not contain
+  // NaNs or infinities to start with.
+  Vector p = Vector::Zero(num_cols);
+  Vector s = Vector::Zero(num_cols);
 
   const double tol_r = per_solve_options.r_tolerance * norm_b;
 
-  tmp.setZero();
-  A->RightMultiply(x, tmp.data());
-  r = bref - tmp;
+  q.setZero();
+  A->RightMultiply(x, q.data());
+  r = bref - q;
   double norm_r = r.norm();
   if (options_.min_num_iterations == 0 && norm_r <= tol_r) {
     summary.termination_type = LINEAR_SOLVER_SUCCESS;
@@ -105,32 +152,81 @@ LinearSolver::Summary ConjugateGradientsSolver::Solve(
     return summary;
   }
 
+  const int num_chunks = (num_cols + kChunkSize - 1) / kChunkSize;
+  // Per chunk partial sums of the dot products computed by the two
+  // passes over the vectors.
+  Matrix partial_sums(num_chunks, 2);
+
+  ContextImpl* context = options_.context;
+  const int num_threads = options_.num_threads;
+
+  // partial_sums(i, :) = [x'(b + r), r'r] for chunk i.
+  auto termination_dots = [&](int i) {
+    const int start = i * kChunkSize;
+    const int end = std::min(start + kChunkSize, num_cols);
+    double xbr = 0.0;
+    double rr = 0.0;
+    for (int j = start; j < end; ++j) {
+      xbr += x[j] * (b[j] + r[j]);
+      rr += r[j] * r[j];
+    }
+    partial_sums(i, 0) = xbr;
+    partial_sums(i, 1) = rr;
+  };
+
   double rho = 1.0;
+  double alpha = 1.0;
+  double beta = 0.0;
 
   // Initial value of the quadratic model Q = x'Ax - 2 * b'x.
   double Q0 = -1.0 * xref.dot(bref + r);
 
   for (summary.num_iterations = 1;; ++summary.num_iterations) {
+    ScopedTrace iteration_trace(options_.tracer,
+                                "ConjugateGradientsSolver::Iteration");
     // Apply preconditioner
     if (per_solve_options.preconditioner != NULL) {
+      ScopedTrace preconditioner_trace(options_.tracer,
+                                      "Preconditioner::RightMultiply");
       z.setZero();
       per_solve_options.preconditioner->RightMultiply(r.data(), z.data());
     } else {
       z = r;
     }
 
-    double last_rho = rho;
-    rho = r.dot(z);
+    q.setZero();
+    {
+      ScopedTrace trace(options_.tracer, "LinearOperator::RightMultiply");
+      A->RightMultiply(z.data(), q.data());
+    }
+
+    // rho = r'z, delta = z'q.
+    ForEachChunk(context, num_threads, num_chunks, [&](int i) {
+      const int start = i * kChunkSize;
+      const int end = std::min(start + kChunkSize, num_cols);
+      double rz = 0.0;
+      double zq = 0.0;
+      for (int j = start; j < end; ++j) {
+        rz += r[j] * z[j];
+        zq += z[j] * q[j];
+      }
+      partial_sums(i, 0) = rz;
+      partial_sums(i, 1) = zq;
+    });
+    const double last_rho = rho;
+    rho = partial_sums.col(0).sum();
+    const double delta = partial_sums.col(1).sum();
+
     if (IsZeroOrInfinity(rho)) {
       summary.termination_type = LINEAR_SOLVER_FAILURE;
       summary.message = StringPrintf("Numerical failure. rho = r'z = %e.", rho);
       break;
     }
 
-    if (summary.num_iterations == 1) {
-      p = z;
-    } else {
-      double beta = rho / last_rho;
+    // pq = p'Ap
+    double pq = delta;
+    if (summary.num_iterations > 1) {
+      beta = rho / last_rho;
       if (IsZeroOrInfinity(beta)) {
         summary.termination_type = LINEAR_SOLVER_FAILURE;
         summary.message = StringPrintf(
@@ -141,25 +237,20 @@ LinearSolver::Summary ConjugateGradientsSolver::Solve(
             last_rho);
         break;
       }
-      p = z + beta * p;
+      pq = delta - beta * rho / alpha;
     }
 
-    Vector& q = z;
-    q.setZero();
-    A->RightMultiply(p.data(), q.data());
-    const double pq = p.dot(q);
     if ((pq <= 0) || std::isinf(pq)) {
       summary.termination_type = LINEAR_SOLVER_NO_CONVERGENCE;
       summary.message = StringPrintf(
           "Matrix is indefinite, no more progress can be made. "
-          "p'q = %e. |p| = %e, |q| = %e",
+          "p'q = %e. z'Az = %e",
           pq,
-          p.norm(),
-          q.norm());
+          delta);
       break;
     }
 
-    const double alpha = rho / pq;
+    alpha = rho / pq;
     if (std::isinf(alpha)) {
       summary.termination_type = LINEAR_SOLVER_FAILURE;
       summary.message = StringPrintf(
@@ -170,7 +261,23 @@ LinearSolver::Summary ConjugateGradientsSolver::Solve(
       break;
     }
 
-    xref = xref + alpha * p;
+    // p = z + beta * p
+    // s = q + beta * s, i.e., s = Ap.
+    // x = x + alpha * p
+    // r = r - alpha * s
+    //
+    // and the dot products for the termination tests.
+    ForEachChunk(context, num_threads, num_chunks, [&](int i) {
+      const int start = i * kChunkSize;
+      const int end = std::min(start + kChunkSize, num_cols);
+      for (int j = start; j < end; ++j) {
+        p[j] = z[j] + beta * p[j];
+        s[j] = q[j] + beta * s[j];
+        x[j] += alpha * p[j];
+        r[j] -= alpha * s[j];
+      }
+      termination_dots(i);
+    });
 
     // Ideally we would just use the update r = r - alpha*q to keep
     // track of the residual vector. However this estimate tends to
@@ -180,16 +287,16 @@ LinearSolver::Summary ConjugateGradientsSolver::Solve(
     // requires an additional matrix vector multiply which would
     // double the complexity of the CG algorithm.
     if (summary.num_iterations % options_.residual_reset_period == 0) {
-      tmp.setZero();
-      A->RightMultiply(x, tmp.data());
-      r = bref - tmp;
-    } else {
-      r = r - alpha * q;
+      q.setZero();
+      A->RightMultiply(x, q.data());
+      r = bref - q;
+      ForEachChunk(context, num_threads, num_chunks, termination_dots);
     }
 
     // Quadratic model based termination.
     //   Q1 = x'Ax - 2 * b' x.
-    const double Q1 = -1.0 * xref.dot(bref + r);
+    const double Q1 = -1.0 * partial_sums.col(0).sum();
+    norm_r = std::sqrt(partial_sums.col(1).sum());
 
     // For PSD matrices A, let
     //
@@ -222,13 +329,12 @@ LinearSolver::Summary ConjugateGradientsSolver::Solve(
                        summary.num_iterations,
                        zeta,
                        per_solve_options.q_tolerance,
-                       r.norm());
+                       norm_r);
       break;
     }
     Q0 = Q1;
 
     // Residual based termination.
-    norm_r = r.norm();
     if (norm_r <= tol_r &&
         summary.num_iterations >= options_.min_num_iterations) {
       summary.termination_type = LINEAR_SOLVER_SUCCESS;
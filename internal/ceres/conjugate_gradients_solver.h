@@ -52,6 +52,11 @@ class LinearOperator;
 // needed for forcing early termination when used as part of an
 // inexact Newton solver.
 //
+// The iteration is organized as in Chronopoulos & Gear, so that all
+// the vector operations of an iteration are done in two passes over
+// the data, which are multithreaded using options.context and
+// options.num_threads.
+//
 // For more details see the documentation for
 // LinearSolver::PerSolveOptions::r_tolerance and
 // LinearSolver::PerSolveOptions::q_tolerance in linear_solver.h.
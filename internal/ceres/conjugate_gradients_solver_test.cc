@@ -33,8 +33,12 @@
 
 #include "ceres/conjugate_gradients_solver.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <vector>
 
+#include "ceres/context_impl.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/linear_solver.h"
 #include "ceres/triplet_sparse_matrix.h"
@@ -132,5 +136,98 @@ TEST(ConjuateGradientTest, Solves3x3SymmetricSystem) {
   ASSERT_DOUBLE_EQ(2, x(2));
 }
 
+TEST(ConjugateGradientTest, MultithreadedSolveMatchesSingleThreaded) {
+  // A tridiagonal diagonally dominant system, large enough for the
+  // vector operations to be split into several chunks.
+  const int kNumCols = 20000;
+  std::unique_ptr<TripletSparseMatrix> A(
+      new TripletSparseMatrix(kNumCols, kNumCols, 3 * kNumCols));
+  int num_nonzeros = 0;
+  for (int i = 0; i < kNumCols; ++i) {
+    for (int j = std::max(i - 1, 0); j <= std::min(i + 1, kNumCols - 1);
+         ++j) {
+      A->mutable_rows()[num_nonzeros] = i;
+      A->mutable_cols()[num_nonzeros] = j;
+      A->mutable_values()[num_nonzeros] = (i == j) ? 2.0 + i % 7 : -1.0;
+      ++num_nonzeros;
+    }
+  }
+  A->set_num_nonzeros(num_nonzeros);
+
+  const Vector b = Vector::Random(kNumCols);
+
+  LinearSolver::PerSolveOptions per_solve_options;
+  per_solve_options.r_tolerance = 1e-10;
+  per_solve_options.q_tolerance = 0.0;
+
+  Vector expected_x = Vector::Zero(kNumCols);
+  LinearSolver::Summary expected_summary;
+  {
+    LinearSolver::Options options;
+    options.max_num_iterations = 200;
+    ConjugateGradientsSolver solver(options);
+    expected_summary =
+        solver.Solve(A.get(), b.data(), per_solve_options, expected_x.data());
+    EXPECT_EQ(expected_summary.termination_type, LINEAR_SOLVER_SUCCESS)
+        << expected_summary.message;
+  }
+
+  Vector Ax = Vector::Zero(kNumCols);
+  A->RightMultiply(expected_x.data(), Ax.data());
+  EXPECT_LE((b - Ax).norm(), 1e-6 * b.norm());
+
+  for (int num_threads = 2; num_threads <= 4; ++num_threads) {
+    ContextImpl context;
+    context.EnsureMinimumThreads(num_threads);
+    LinearSolver::Options options;
+    options.max_num_iterations = 200;
+    options.num_threads = num_threads;
+    options.context = &context;
+    ConjugateGradientsSolver solver(options);
+    Vector x = Vector::Zero(kNumCols);
+    const LinearSolver::Summary summary =
+        solver.Solve(A.get(), b.data(), per_solve_options, x.data());
+    EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_SUCCESS)
+        << summary.message;
+    // The partial dot products are added up in a fixed order, so the
+    // result does not depend on the number of threads.
+    EXPECT_EQ(summary.num_iterations, expected_summary.num_iterations);
+    EXPECT_EQ((x - expected_x).lpNorm<Eigen::Infinity>(), 0.0);
+  }
+}
+
+TEST(ConjugateGradientTest, DoesNotReadUninitializedScratchVectors) {
+  const int kNumCols = 1000;
+  const Vector diagonal = Vector::Constant(kNumCols, 2.0);
+  std::unique_ptr<TripletSparseMatrix> A(
+      TripletSparseMatrix::CreateSparseDiagonalMatrix(diagonal.data(),
+                                                      kNumCols));
+  const Vector b = Vector::Ones(kNumCols);
+
+  // Free a few NaN filled vectors of the same size as the scratch
+  // vectors of the solver, so that the allocator is likely to hand
+  // their memory to the solver.
+  {
+    std::vector<Vector> nan_vectors;
+    for (int i = 0; i < 8; ++i) {
+      nan_vectors.push_back(
+          Vector::Constant(kNumCols, std::numeric_limits<double>::quiet_NaN()));
+    }
+  }
+
+  LinearSolver::Options options;
+  options.max_num_iterations = 10;
+  ConjugateGradientsSolver solver(options);
+  LinearSolver::PerSolveOptions per_solve_options;
+  per_solve_options.r_tolerance = 1e-9;
+  per_solve_options.q_tolerance = 0.0;
+  Vector x = Vector::Zero(kNumCols);
+  const LinearSolver::Summary summary =
+      solver.Solve(A.get(), b.data(), per_solve_options, x.data());
+  EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_SUCCESS)
+      << summary.message;
+  EXPECT_NEAR((x - Vector::Constant(kNumCols, 0.5)).norm(), 0.0, 1e-9);
+}
+
 }  // namespace internal
 }  // namespace ceres
@@ -31,11 +31,13 @@
 #include "ceres/coordinate_descent_minimizer.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <memory>
 #include <numeric>
 #include <vector>
 
+#include "Eigen/Dense"
 #include "ceres/evaluator.h"
 #include "ceres/linear_solver.h"
 #include "ceres/minimizer.h"
@@ -59,6 +61,34 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+
+// Parameters of the Levenberg-Marquardt loop used by the batched inner
+// iterations. These match the defaults of
+// Solver::Options::min_lm_diagonal, Solver::Options::max_lm_diagonal
+// and Solver::Options::initial_trust_region_radius.
+const double kMinDiagonal = 1e-6;
+const double kMaxDiagonal = 1e32;
+const double kInitialTrustRegionRadius = 1e4;
+
+}  // namespace
+
+// Per thread workspace used by SolveBlock and EvaluateBlock. The
+// buffers only ever grow, so after the first few parameter blocks no
+// further allocations are performed.
+struct CoordinateDescentMinimizer::BlockScratch {
+  Vector residuals;
+  Vector jacobian;
+  Vector evaluate_scratch;
+  vector<double*> jacobians;
+  Matrix jtj;
+  Matrix lhs;
+  Vector gradient;
+  Vector step;
+  Vector candidate;
+  Eigen::LDLT<Matrix> ldlt;
+};
+
 CoordinateDescentMinimizer::CoordinateDescentMinimizer(ContextImpl* context)
     : context_(context) {
   CHECK(context_ != nullptr);
@@ -135,6 +165,40 @@ void CoordinateDescentMinimizer::Minimize(const Minimizer::Options& options,
     parameter_block->SetConstant();
   }
 
+  if (options.use_batched_inner_iterations) {
+    // The per block problems are solved with the same tolerances and
+    // iteration limits that Solve uses for its inner
+    // TrustRegionMinimizer.
+    const Minimizer::Options inner_options;
+    vector<BlockScratch> scratch(options.num_threads);
+    for (int i = 0; i < independent_set_offsets_.size() - 1; ++i) {
+      const int num_problems =
+          independent_set_offsets_[i + 1] - independent_set_offsets_[i];
+      if (num_problems == 0) {
+        continue;
+      }
+
+      ParallelFor(context_,
+                  independent_set_offsets_[i],
+                  independent_set_offsets_[i + 1],
+                  min(options.num_threads, num_problems),
+                  [&](int thread_id, int j) {
+                    ParameterBlock* parameter_block = parameter_blocks_[j];
+                    parameter_block->SetVarying();
+                    SolveBlock(
+                        inner_options, j, parameters, &scratch[thread_id]);
+                    parameter_block->SetState(
+                        parameters + parameter_block->state_offset());
+                    parameter_block->SetConstant();
+                  });
+    }
+
+    for (int i = 0; i < parameter_blocks_.size(); ++i) {
+      parameter_blocks_[i]->SetVarying();
+    }
+    return;
+  }
+
   std::unique_ptr<LinearSolver*[]> linear_solvers(
       new LinearSolver*[options.num_threads]);
 
@@ -225,8 +289,8 @@ void CoordinateDescentMinimizer::Solve(Program* program,
       Evaluator::Create(evaluator_options_, program, &error));
   CHECK(minimizer_options.evaluator != nullptr);
   minimizer_options.jacobian.reset(
-      minimizer_options.evaluator->CreateJacobian());
-  CHECK(minimizer_options.jacobian != nullptr);
+      minimizer_options.evaluator->CreateJacobian(&error));
+  CHECK(minimizer_options.jacobian != nullptr) << error;
 
   TrustRegionStrategy::Options trs_options;
   trs_options.linear_solver = linear_solver;
@@ -239,6 +303,156 @@ void CoordinateDescentMinimizer::Solve(Program* program,
   minimizer.Minimize(minimizer_options, parameter, summary);
 }
 
+// Minimize the cost of the residual blocks depending on
+// parameter_blocks_[j], which must be varying, using
+// Levenberg-Marquardt. The normal equations
+// have only as many rows as the local size of the parameter block, so
+// they are formed explicitly and solved using a dense LDLT
+// factorization.
+void CoordinateDescentMinimizer::SolveBlock(const Minimizer::Options& options,
+                                            const int j,
+                                            double* parameters,
+                                            BlockScratch* scratch) {
+  ParameterBlock* parameter_block = parameter_blocks_[j];
+  const int size = parameter_block->Size();
+  const int local_size = parameter_block->LocalSize();
+  if (local_size == 0 || residual_blocks_[j].empty()) {
+    return;
+  }
+
+  double* x = parameters + parameter_block->state_offset();
+  scratch->candidate.resize(size);
+
+  // As in Solve, a failure here is not fatal. It just means that the
+  // parameter block is not updated.
+  double cost = 0.0;
+  if (!EvaluateBlock(j, true, scratch, &cost)) {
+    return;
+  }
+
+  // mu is the inverse of the trust region radius used by
+  // LevenbergMarquardtStrategy, and follows the same update rules.
+  double mu = 1.0 / kInitialTrustRegionRadius;
+  double decrease_factor = 2.0;
+  for (int iteration = 0; iteration < options.max_num_iterations;
+       ++iteration) {
+    if (scratch->gradient.lpNorm<Eigen::Infinity>() <=
+        options.gradient_tolerance) {
+      break;
+    }
+
+    scratch->lhs = scratch->jtj;
+    scratch->lhs.diagonal() +=
+        mu * scratch->jtj.diagonal().cwiseMax(kMinDiagonal).cwiseMin(
+                 kMaxDiagonal);
+    scratch->ldlt.compute(scratch->lhs);
+    if (scratch->ldlt.info() != Eigen::Success) {
+      mu *= decrease_factor;
+      decrease_factor *= 2.0;
+      continue;
+    }
+    scratch->step = scratch->ldlt.solve(scratch->gradient);
+
+    const double x_norm = ConstVectorRef(x, size).norm();
+    if (scratch->step.norm() <=
+        options.parameter_tolerance * (x_norm + options.parameter_tolerance)) {
+      break;
+    }
+
+    // Predicted decrease in the cost of the linearized model.
+    const double model_cost_change =
+        scratch->step.dot(scratch->gradient -
+                          0.5 * scratch->jtj * scratch->step);
+
+    double candidate_cost = 0.0;
+    const bool candidate_is_valid =
+        parameter_block->Plus(x, scratch->step.data(),
+                              scratch->candidate.data()) &&
+        parameter_block->SetState(scratch->candidate.data()) &&
+        EvaluateBlock(j, false, scratch, &candidate_cost);
+
+    const double cost_change = cost - candidate_cost;
+    const double relative_decrease = cost_change / model_cost_change;
+    if (!candidate_is_valid || model_cost_change <= 0.0 ||
+        relative_decrease <= options.min_relative_decrease) {
+      parameter_block->SetState(x);
+      mu *= decrease_factor;
+      decrease_factor *= 2.0;
+      continue;
+    }
+
+    std::copy_n(scratch->candidate.data(), size, x);
+    parameter_block->SetState(x);
+    if (!EvaluateBlock(j, true, scratch, &cost)) {
+      break;
+    }
+
+    if (cost_change <= options.function_tolerance * (cost + cost_change)) {
+      break;
+    }
+
+    mu *= max(1.0 / 3.0, 1.0 - std::pow(2.0 * relative_decrease - 1.0, 3));
+    decrease_factor = 2.0;
+  }
+}
+
+bool CoordinateDescentMinimizer::EvaluateBlock(const int j,
+                                               const bool compute_derivatives,
+                                               BlockScratch* scratch,
+                                               double* cost) {
+  ParameterBlock* parameter_block = parameter_blocks_[j];
+  const int local_size = parameter_block->LocalSize();
+  if (compute_derivatives) {
+    scratch->jtj.setZero(local_size, local_size);
+    scratch->gradient.setZero(local_size);
+  }
+
+  *cost = 0.0;
+  for (const ResidualBlock* residual_block : residual_blocks_[j]) {
+    const int num_residuals = residual_block->NumResiduals();
+    const int num_parameter_blocks = residual_block->NumParameterBlocks();
+    const int num_scratch = residual_block->NumScratchDoublesForEvaluate();
+    if (scratch->residuals.size() < num_residuals) {
+      scratch->residuals.resize(num_residuals);
+    }
+    if (scratch->jacobian.size() < num_residuals * local_size) {
+      scratch->jacobian.resize(num_residuals * local_size);
+    }
+    if (scratch->evaluate_scratch.size() < num_scratch) {
+      scratch->evaluate_scratch.resize(num_scratch);
+    }
+
+    // Only the jacobian with respect to parameter_block is needed.
+    scratch->jacobians.resize(num_parameter_blocks);
+    for (int k = 0; k < num_parameter_blocks; ++k) {
+      scratch->jacobians[k] =
+          (residual_block->parameter_blocks()[k] == parameter_block)
+              ? scratch->jacobian.data()
+              : nullptr;
+    }
+
+    double residual_block_cost = 0.0;
+    if (!residual_block->Evaluate(
+            true,
+            &residual_block_cost,
+            scratch->residuals.data(),
+            compute_derivatives ? scratch->jacobians.data() : nullptr,
+            scratch->evaluate_scratch.data())) {
+      return false;
+    }
+    *cost += residual_block_cost;
+
+    if (compute_derivatives) {
+      ConstMatrixRef jacobian(
+          scratch->jacobian.data(), num_residuals, local_size);
+      scratch->jtj.noalias() += jacobian.transpose() * jacobian;
+      scratch->gradient.noalias() -=
+          jacobian.transpose() * scratch->residuals.head(num_residuals);
+    }
+  }
+  return true;
+}
+
 bool CoordinateDescentMinimizer::IsOrderingValid(
     const Program& program,
     const ParameterBlockOrdering& ordering,
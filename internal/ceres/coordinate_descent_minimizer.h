@@ -56,6 +56,20 @@ class LinearSolver;
 //
 // The minimizer assumes that none of the parameter blocks in the
 // program are constant.
+//
+// If Minimizer::Options::use_batched_inner_iterations is true, each
+// parameter block is optimized directly by a small dense
+// Levenberg-Marquardt loop on its residual blocks, instead of by
+// constructing a Program, an Evaluator and a TrustRegionMinimizer for
+// it.
+//
+// The Jacobian of the outer minimizer is not reused, since it was
+// evaluated at x and the inner iterations start from x + delta. The
+// per block linear systems are factored one at a time with an LDLT.
+// InvertPSDMatricesBatched would need every block in a batch to be
+// the same size and to step in lockstep, while here each block runs
+// its own number of Levenberg-Marquardt iterations, and needs to detect
+// indefinite systems, which the batched kernel does not report.
 class CoordinateDescentMinimizer : public Minimizer {
  public:
   explicit CoordinateDescentMinimizer(ContextImpl* context);
@@ -84,11 +98,30 @@ class CoordinateDescentMinimizer : public Minimizer {
   static ParameterBlockOrdering* CreateOrdering(const Program& program);
 
  private:
+  struct BlockScratch;
+
   void Solve(Program* program,
              LinearSolver* linear_solver,
              double* parameters,
              Solver::Summary* summary);
 
+  // Optimize parameter_blocks_[j], whose state must point into
+  // parameters, holding every other parameter block fixed.
+  void SolveBlock(const Minimizer::Options& options,
+                  int j,
+                  double* parameters,
+                  BlockScratch* scratch);
+
+  // Evaluate the cost of residual_blocks_[j] at the current state of
+  // the parameter blocks. If compute_derivatives is true, also store
+  // the Gauss-Newton Hessian and the negative gradient with respect
+  // to (the local parameterization of) parameter_blocks_[j] in
+  // scratch.
+  bool EvaluateBlock(int j,
+                     bool compute_derivatives,
+                     BlockScratch* scratch,
+                     double* cost);
+
   std::vector<ParameterBlock*> parameter_blocks_;
   std::vector<std::vector<ResidualBlock*>> residual_blocks_;
   // The optimization is performed in rounds. In each round all the
@@ -0,0 +1,172 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Benchmarks for BiCubicInterpolator on large images stored in the
+// row major Grid2D and the tiled TiledGrid2D layouts.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "ceres/cubic_interpolation.h"
+
+namespace ceres {
+namespace internal {
+
+enum Layout { kRowMajor, kTiled };
+
+// An image with random intensities and the interpolator of it.
+template <Layout kLayout>
+struct Image;
+
+template <>
+struct Image<kRowMajor> {
+  typedef Grid2D<uint8_t, 1> GridType;
+
+  Image(const std::vector<uint8_t>& data, int num_rows, int num_cols)
+      : grid(data.data(), 0, num_rows, 0, num_cols), interpolator(grid) {}
+
+  GridType grid;
+  BiCubicInterpolator<GridType> interpolator;
+};
+
+template <>
+struct Image<kTiled> {
+  typedef TiledGrid2D<uint8_t, 1> GridType;
+
+  Image(const std::vector<uint8_t>& data, int num_rows, int num_cols)
+      : grid(Grid2D<uint8_t, 1>(data.data(), 0, num_rows, 0, num_cols),
+             0,
+             num_rows,
+             0,
+             num_cols),
+        interpolator(grid) {}
+
+  GridType grid;
+  BiCubicInterpolator<GridType> interpolator;
+};
+
+static std::vector<uint8_t> RandomImage(int num_rows, int num_cols) {
+  std::mt19937 prng;
+  std::uniform_int_distribution<int> uniform(0, 255);
+  std::vector<uint8_t> data(num_rows * num_cols);
+  for (uint8_t& value : data) {
+    value = uniform(prng);
+  }
+  return data;
+}
+
+// Interpolates the image at points uniformly distributed over it.
+//
+// Arguments: number of rows and number of columns of the image.
+template <Layout kLayout>
+static void BM_BiCubicRandomLookups(benchmark::State& state) {
+  const int num_rows = state.range(0);
+  const int num_cols = state.range(1);
+  const std::vector<uint8_t> data = RandomImage(num_rows, num_cols);
+  const Image<kLayout> image(data, num_rows, num_cols);
+
+  const int kNumPoints = 1 << 16;
+  std::mt19937 prng;
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<double> r(kNumPoints), c(kNumPoints);
+  for (int i = 0; i < kNumPoints; ++i) {
+    r[i] = uniform(prng) * num_rows;
+    c[i] = uniform(prng) * num_cols;
+  }
+
+  double f, dfdr, dfdc;
+  for (auto _ : state) {
+    for (int i = 0; i < kNumPoints; ++i) {
+      image.interpolator.Evaluate(r[i], c[i], &f, &dfdr, &dfdc);
+      benchmark::DoNotOptimize(f);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPoints);
+}
+
+// Interpolates the image at the pixels of 8 x 8 patches, rotated and
+// translated to random positions of the image, which is the access
+// pattern of a photometric error in a direct image alignment problem.
+//
+// Arguments: number of rows and number of columns of the image.
+template <Layout kLayout>
+static void BM_BiCubicPatchLookups(benchmark::State& state) {
+  const int num_rows = state.range(0);
+  const int num_cols = state.range(1);
+  const std::vector<uint8_t> data = RandomImage(num_rows, num_cols);
+  const Image<kLayout> image(data, num_rows, num_cols);
+
+  const int kNumPatches = 1 << 10;
+  const int kPatchSize = 8;
+  std::mt19937 prng;
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<double> r, c;
+  for (int i = 0; i < kNumPatches; ++i) {
+    const double center_r = uniform(prng) * num_rows;
+    const double center_c = uniform(prng) * num_cols;
+    const double angle = uniform(prng) * 2.0 * M_PI;
+    for (int j = 0; j < kPatchSize; ++j) {
+      for (int k = 0; k < kPatchSize; ++k) {
+        const double dr = j - kPatchSize / 2;
+        const double dc = k - kPatchSize / 2;
+        r.push_back(center_r + std::cos(angle) * dr - std::sin(angle) * dc);
+        c.push_back(center_c + std::sin(angle) * dr + std::cos(angle) * dc);
+      }
+    }
+  }
+
+  double f, dfdr, dfdc;
+  for (auto _ : state) {
+    for (int i = 0; i < r.size(); ++i) {
+      image.interpolator.Evaluate(r[i], c[i], &f, &dfdr, &dfdc);
+      benchmark::DoNotOptimize(f);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * r.size());
+}
+
+// VGA, 4K, 8K and 16K x 16K images.
+static void ImageSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({480, 640})->Args({2160, 3840})->Args({4320, 7680});
+  // Larger than the last level cache of most machines.
+  benchmark->Args({16384, 16384});
+}
+
+BENCHMARK_TEMPLATE(BM_BiCubicRandomLookups, kRowMajor)->Apply(ImageSizes);
+BENCHMARK_TEMPLATE(BM_BiCubicRandomLookups, kTiled)->Apply(ImageSizes);
+BENCHMARK_TEMPLATE(BM_BiCubicPatchLookups, kRowMajor)->Apply(ImageSizes);
+BENCHMARK_TEMPLATE(BM_BiCubicPatchLookups, kTiled)->Apply(ImageSizes);
+
+}  // namespace internal
+}  // namespace ceres
+
+BENCHMARK_MAIN();
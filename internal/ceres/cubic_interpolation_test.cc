@@ -31,6 +31,7 @@
 #include "ceres/cubic_interpolation.h"
 
 #include <memory>
+#include <random>
 
 #include "ceres/jet.h"
 #include "glog/logging.h"
@@ -327,6 +328,36 @@ TEST(CubicInterpolator, JetEvaluation) {
   EXPECT_NEAR((f_jets[1].v - dfdx[1] * x_jet.v).norm(), 0.0, kTolerance);
 }
 
+TEST(CubicInterpolator, BatchEvaluation) {
+  const double values[] = {1.0, 2.0, 2.0, 5.0, 3.0, 9.0, 2.0, 7.0};
+
+  Grid1D<double, 2, true> grid(values, 0, 4);
+  CubicInterpolator<Grid1D<double, 2, true>> interpolator(grid);
+
+  const double x[] = {-1.5, 0.0, 0.3, 1.5, 2.5, 3.0, 4.7};
+  const int num_points = sizeof(x) / sizeof(x[0]);
+  double f[2 * num_points], dfdx[2 * num_points];
+  interpolator.Evaluate(x, num_points, f, dfdx);
+
+  Jet<double, 1> x_jets[num_points];
+  for (int i = 0; i < num_points; ++i) {
+    x_jets[i] = Jet<double, 1>(x[i], 0);
+  }
+  Jet<double, 1> f_jets[2 * num_points];
+  interpolator.Evaluate(x_jets, num_points, f_jets);
+
+  for (int i = 0; i < num_points; ++i) {
+    double expected_f[2], expected_dfdx[2];
+    interpolator.Evaluate(x[i], expected_f, expected_dfdx);
+    for (int j = 0; j < 2; ++j) {
+      EXPECT_EQ(f[2 * i + j], expected_f[j]);
+      EXPECT_EQ(dfdx[2 * i + j], expected_dfdx[j]);
+      EXPECT_EQ(f_jets[2 * i + j].a, expected_f[j]);
+      EXPECT_EQ(f_jets[2 * i + j].v(0), expected_dfdx[j]);
+    }
+  }
+}
+
 class BiCubicInterpolatorTest : public ::testing::Test {
  public:
   // This class needs to have an Eigen aligned operator new as it contains
@@ -530,5 +561,256 @@ TEST(BiCubicInterpolator, JetEvaluation) {
               kTolerance);
 }
 
+TEST(BiCubicInterpolator, BatchEvaluation) {
+  // clang-format off
+  const double values[] = {1.0, 5.0, 2.0, 10.0, 2.0, 6.0, 3.0, 5.0,
+                           1.0, 2.0, 2.0,  2.0, 2.0, 2.0, 3.0, 1.0};
+  // clang-format on
+
+  Grid2D<double, 2> grid(values, 0, 2, 0, 4);
+  BiCubicInterpolator<Grid2D<double, 2>> interpolator(grid);
+
+  const double r[] = {-1.2, 0.0, 0.5, 0.5, 1.7, 3.0};
+  const double c[] = {0.3, -2.0, 2.5, 1.0, 3.9, 5.1};
+  const int num_points = sizeof(r) / sizeof(r[0]);
+  double f[2 * num_points], dfdr[2 * num_points], dfdc[2 * num_points];
+  interpolator.Evaluate(r, c, num_points, f, dfdr, dfdc);
+
+  Jet<double, 2> r_jets[num_points];
+  Jet<double, 2> c_jets[num_points];
+  for (int i = 0; i < num_points; ++i) {
+    r_jets[i] = Jet<double, 2>(r[i], 0);
+    c_jets[i] = Jet<double, 2>(c[i], 1);
+  }
+  Jet<double, 2> f_jets[2 * num_points];
+  interpolator.Evaluate(r_jets, c_jets, num_points, f_jets);
+
+  for (int i = 0; i < num_points; ++i) {
+    double expected_f[2], expected_dfdr[2], expected_dfdc[2];
+    interpolator.Evaluate(
+        r[i], c[i], expected_f, expected_dfdr, expected_dfdc);
+    for (int j = 0; j < 2; ++j) {
+      EXPECT_EQ(f[2 * i + j], expected_f[j]);
+      EXPECT_EQ(dfdr[2 * i + j], expected_dfdr[j]);
+      EXPECT_EQ(dfdc[2 * i + j], expected_dfdc[j]);
+      EXPECT_EQ(f_jets[2 * i + j].a, expected_f[j]);
+      EXPECT_EQ(f_jets[2 * i + j].v(0), expected_dfdr[j]);
+      EXPECT_EQ(f_jets[2 * i + j].v(1), expected_dfdc[j]);
+    }
+  }
+}
+
+TEST(CachedBiCubicInterpolator, MatchesBiCubicInterpolator) {
+  const int kNumRows = 5;
+  const int kNumCols = 7;
+  std::mt19937 prng;
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  double values[2 * kNumRows * kNumCols];
+  for (double& value : values) {
+    value = uniform(prng);
+  }
+
+  // A column major stacked grid, which does not start at the origin.
+  typedef Grid2D<double, 2, false, false> GridType;
+  GridType grid(values, 2, 2 + kNumRows, -1, -1 + kNumCols);
+  BiCubicInterpolator<GridType> interpolator(grid);
+  CachedBiCubicInterpolator<GridType> cached_interpolator(
+      grid, 2, 2 + kNumRows, -1, -1 + kNumCols);
+
+  // Sample points on a grid which extends two cells beyond the
+  // boundary of the grid in each direction, including the grid
+  // points themselves.
+  for (double r = -1.0; r <= 2 + kNumRows + 2; r += 0.25) {
+    for (double c = -4.0; c <= -1 + kNumCols + 2; c += 0.25) {
+      double f[2], dfdr[2], dfdc[2];
+      interpolator.Evaluate(r, c, f, dfdr, dfdc);
+      double cached_f[2], cached_dfdr[2], cached_dfdc[2];
+      cached_interpolator.Evaluate(r, c, cached_f, cached_dfdr, cached_dfdc);
+      for (int j = 0; j < 2; ++j) {
+        EXPECT_NEAR(f[j], cached_f[j], kTolerance) << r << " " << c;
+        EXPECT_NEAR(dfdr[j], cached_dfdr[j], kTolerance) << r << " " << c;
+        EXPECT_NEAR(dfdc[j], cached_dfdc[j], kTolerance) << r << " " << c;
+      }
+    }
+  }
+}
+
+TEST(CachedBiCubicInterpolator, JetAndBatchEvaluation) {
+  // clang-format off
+  const double values[] = {1.0, 5.0, 2.0, 10.0, 2.0, 6.0, 3.0, 5.0,
+                           1.0, 2.0, 2.0,  2.0, 2.0, 2.0, 3.0, 1.0};
+  // clang-format on
+
+  Grid2D<double, 2> grid(values, 0, 2, 0, 4);
+  CachedBiCubicInterpolator<Grid2D<double, 2>> interpolator(grid, 0, 2, 0, 4);
+
+  const double r[] = {-1.2, 0.0, 0.5, 1.7};
+  const double c[] = {0.3, -2.0, 2.5, 3.9};
+  const int num_points = sizeof(r) / sizeof(r[0]);
+  Jet<double, 2> r_jets[num_points];
+  Jet<double, 2> c_jets[num_points];
+  for (int i = 0; i < num_points; ++i) {
+    r_jets[i] = Jet<double, 2>(r[i], 0);
+    c_jets[i] = Jet<double, 2>(c[i], 1);
+  }
+  Jet<double, 2> f_jets[2 * num_points];
+  interpolator.Evaluate(r_jets, c_jets, num_points, f_jets);
+
+  for (int i = 0; i < num_points; ++i) {
+    double f[2], dfdr[2], dfdc[2];
+    interpolator.Evaluate(r[i], c[i], f, dfdr, dfdc);
+    for (int j = 0; j < 2; ++j) {
+      EXPECT_EQ(f_jets[2 * i + j].a, f[j]);
+      EXPECT_EQ(f_jets[2 * i + j].v(0), dfdr[j]);
+      EXPECT_EQ(f_jets[2 * i + j].v(1), dfdc[j]);
+    }
+  }
+}
+
+TEST(TiledGrid2D, MatchesGrid2D) {
+  const int kNumRows = 11;
+  const int kNumCols = 13;
+  int values[2 * kNumRows * kNumCols];
+  for (int i = 0; i < 2 * kNumRows * kNumCols; ++i) {
+    values[i] = i;
+  }
+
+  // Neither dimension is a multiple of the tile size.
+  typedef Grid2D<int, 2, false, false> GridType;
+  GridType grid(values, -3, -3 + kNumRows, 2, 2 + kNumCols);
+  TiledGrid2D<int, 2, 4> tiled_grid(grid, -3, -3 + kNumRows, 2, 2 + kNumCols);
+
+  for (int r = -6; r < kNumRows + 3; ++r) {
+    for (int c = -1; c < kNumCols + 5; ++c) {
+      double f[2], tiled_f[2];
+      grid.GetValue(r, c, f);
+      tiled_grid.GetValue(r, c, tiled_f);
+      EXPECT_EQ(f[0], tiled_f[0]) << r << " " << c;
+      EXPECT_EQ(f[1], tiled_f[1]) << r << " " << c;
+    }
+  }
+}
+
+TEST(TiledGrid2D, BiCubicInterpolation) {
+  const int kNumRows = 20;
+  const int kNumCols = 30;
+  std::mt19937 prng;
+  std::uniform_int_distribution<int> uniform(0, 255);
+  uint8_t values[kNumRows * kNumCols];
+  for (uint8_t& value : values) {
+    value = uniform(prng);
+  }
+
+  Grid2D<uint8_t, 1> grid(values, 0, kNumRows, 0, kNumCols);
+  TiledGrid2D<uint8_t, 1> tiled_grid(grid, 0, kNumRows, 0, kNumCols);
+  BiCubicInterpolator<Grid2D<uint8_t, 1>> interpolator(grid);
+  BiCubicInterpolator<TiledGrid2D<uint8_t, 1>> tiled_interpolator(tiled_grid);
+
+  for (double r = -1.0; r <= kNumRows + 1; r += 0.3) {
+    for (double c = -1.0; c <= kNumCols + 1; c += 0.3) {
+      double f, dfdr, dfdc;
+      interpolator.Evaluate(r, c, &f, &dfdr, &dfdc);
+      double tiled_f, tiled_dfdr, tiled_dfdc;
+      tiled_interpolator.Evaluate(r, c, &tiled_f, &tiled_dfdr, &tiled_dfdc);
+      EXPECT_EQ(f, tiled_f);
+      EXPECT_EQ(dfdr, tiled_dfdr);
+      EXPECT_EQ(dfdc, tiled_dfdc);
+    }
+  }
+}
+
+TEST(TiledGrid2DPyramid, Levels) {
+  // clang-format off
+  const double values[] = {1.0, 3.0,  5.0, 7.0, 9.0,
+                           3.0, 5.0,  7.0, 9.0, 1.0,
+                           2.0, 4.0,  6.0, 8.0, 0.0};
+  // clang-format on
+
+  Grid2D<double, 1> grid(values, 1, 4, 2, 7);
+  TiledGrid2DPyramid<double, 1, 2> pyramid(grid, 1, 4, 2, 7, 3);
+  ASSERT_EQ(pyramid.num_levels(), 3);
+
+  const TiledGrid2DPyramid<double, 1, 2>::Level& level0 = pyramid.level(0);
+  EXPECT_EQ(level0.row_begin(), 1);
+  EXPECT_EQ(level0.row_end(), 4);
+  EXPECT_EQ(level0.col_begin(), 2);
+  EXPECT_EQ(level0.col_end(), 7);
+  for (int r = 1; r < 4; ++r) {
+    for (int c = 2; c < 7; ++c) {
+      double f, level_f;
+      grid.GetValue(r, c, &f);
+      level0.GetValue(r, c, &level_f);
+      EXPECT_EQ(f, level_f);
+    }
+  }
+
+  // Level 1 is the 2 x 2 average of level 0, with the last row and
+  // column of level 0 replicated.
+  const TiledGrid2DPyramid<double, 1, 2>::Level& level1 = pyramid.level(1);
+  EXPECT_EQ(level1.row_begin(), 1);
+  EXPECT_EQ(level1.row_end(), 3);
+  EXPECT_EQ(level1.col_begin(), 2);
+  EXPECT_EQ(level1.col_end(), 5);
+  // clang-format off
+  const double expected_level1[] = {3.0, 7.0, 5.0,
+                                    3.0, 7.0, 0.0};
+  // clang-format on
+  for (int r = 1; r < 3; ++r) {
+    for (int c = 2; c < 5; ++c) {
+      double f;
+      level1.GetValue(r, c, &f);
+      EXPECT_EQ(f, expected_level1[3 * (r - 1) + c - 2]) << r << " " << c;
+    }
+  }
+
+  const TiledGrid2DPyramid<double, 1, 2>::Level& level2 = pyramid.level(2);
+  EXPECT_EQ(level2.row_end(), 2);
+  EXPECT_EQ(level2.col_end(), 4);
+  double f;
+  level2.GetValue(1, 2, &f);
+  EXPECT_EQ(f, 5.0);
+  level2.GetValue(1, 3, &f);
+  EXPECT_EQ(f, 2.5);
+}
+
+TEST(TiledGrid2DPyramid, IntegralValuesAreRounded) {
+  const uint8_t values[] = {1, 2, 2, 2};
+  Grid2D<uint8_t, 1> grid(values, 0, 2, 0, 2);
+  TiledGrid2DPyramid<uint8_t, 1> pyramid(grid, 0, 2, 0, 2, 2);
+  double f;
+  pyramid.level(1).GetValue(0, 0, &f);
+  EXPECT_EQ(f, 2.0);
+}
+
+TEST(TiledGrid2DPyramid, ToLevel) {
+  const double values[16] = {0.0};
+  Grid2D<double, 1> grid(values, 2, 6, -4, 0);
+  TiledGrid2DPyramid<double, 1> pyramid(grid, 2, 6, -4, 0, 3);
+
+  double r, c;
+  pyramid.ToLevel(0, 3.0, -1.0, &r, &c);
+  EXPECT_EQ(r, 3.0);
+  EXPECT_EQ(c, -1.0);
+
+  // The center of the 2 x 2 block (2, -4), .., (3, -3) of level 0 is
+  // the grid point (2, -4) of level 1.
+  pyramid.ToLevel(1, 2.5, -3.5, &r, &c);
+  EXPECT_EQ(r, 2.0);
+  EXPECT_EQ(c, -4.0);
+
+  pyramid.ToLevel(2, 3.5, -2.5, &r, &c);
+  EXPECT_EQ(r, 2.0);
+  EXPECT_EQ(c, -4.0);
+
+  Jet<double, 2> r_jet(3.5, 0);
+  Jet<double, 2> c_jet(-2.5, 1);
+  Jet<double, 2> level_r, level_c;
+  pyramid.ToLevel(2, r_jet, c_jet, &level_r, &level_c);
+  EXPECT_EQ(level_r.a, 2.0);
+  EXPECT_EQ(level_c.a, -4.0);
+  EXPECT_EQ(level_r.v(0), 0.25);
+  EXPECT_EQ(level_c.v(1), 0.25);
+}
+
 }  // namespace internal
 }  // namespace ceres
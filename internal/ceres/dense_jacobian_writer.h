@@ -33,6 +33,8 @@
 #ifndef CERES_INTERNAL_DENSE_JACOBIAN_WRITER_H_
 #define CERES_INTERNAL_DENSE_JACOBIAN_WRITER_H_
 
+#include <string>
+
 #include "ceres/casts.h"
 #include "ceres/dense_sparse_matrix.h"
 #include "ceres/internal/eigen.h"
@@ -58,7 +60,7 @@ class DenseJacobianWriter {
     return ScratchEvaluatePreparer::Create(*program_, num_threads);
   }
 
-  SparseMatrix* CreateJacobian() const {
+  SparseMatrix* CreateJacobian(std::string* /* error */) const {
     return new DenseSparseMatrix(
         program_->NumResiduals(), program_->NumEffectiveParameters(), true);
   }
@@ -33,7 +33,9 @@
 #include "ceres/casts.h"
 #include "ceres/context_impl.h"
 #include "ceres/linear_least_squares_problems.h"
+#include "ceres/dense_sparse_matrix.h"
 #include "ceres/linear_solver.h"
+#include "ceres/parallel_dense_ops.h"
 #include "ceres/triplet_sparse_matrix.h"
 #include "ceres/types.h"
 #include "glog/logging.h"
@@ -108,6 +110,49 @@ TEST_P(DenseLinearSolverTest, _) {
   EXPECT_NEAR(residual, 0.0, 10 * std::numeric_limits<double>::epsilon());
 }
 
+// With use_tiled_dense_factorization, more than one thread and large
+// enough matrices, the solvers switch to the tiled algorithms in
+// parallel_dense_ops.h.
+TEST(DenseLinearSolver, MultithreadedSolversMatchSingleThreaded) {
+  const int num_cols = 2 * kParallelDenseOpsTileSize + 5;
+  const int num_rows = num_cols + 40;
+  srand(5);
+  DenseSparseMatrix lhs(ColMajorMatrix::Random(num_rows, num_cols));
+  const Vector rhs = Vector::Random(num_rows);
+  Vector D = Vector::Constant(num_cols, 0.1);
+
+  ContextImpl context;
+  for (const LinearSolverType type : {DENSE_QR, DENSE_NORMAL_CHOLESKY}) {
+    for (const bool regularized : {true, false}) {
+      LinearSolver::PerSolveOptions per_solve_options;
+      if (regularized) {
+        per_solve_options.D = D.data();
+      }
+
+      Vector expected(num_cols);
+      Vector actual(num_cols);
+      for (const int num_threads : {1, 4}) {
+        LinearSolver::Options options;
+        options.type = type;
+        options.dense_linear_algebra_library_type = EIGEN;
+        options.use_tiled_dense_factorization = true;
+        options.num_threads = num_threads;
+        options.context = &context;
+        context.EnsureMinimumThreads(num_threads);
+        std::unique_ptr<LinearSolver> solver(LinearSolver::Create(options));
+        LinearSolver::Summary summary =
+            solver->Solve(&lhs,
+                          rhs.data(),
+                          per_solve_options,
+                          num_threads == 1 ? expected.data() : actual.data());
+        EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_SUCCESS);
+      }
+      EXPECT_NEAR((expected - actual).norm(), 0.0, 1e-8 * expected.norm())
+          << LinearSolverTypeToString(type) << " " << regularized;
+    }
+  }
+}
+
 namespace {
 
 // TODO(sameeragarwal): Should we move away from hard coded linear
@@ -38,6 +38,7 @@
 #include "ceres/internal/eigen.h"
 #include "ceres/lapack.h"
 #include "ceres/linear_solver.h"
+#include "ceres/parallel_dense_ops.h"
 #include "ceres/types.h"
 #include "ceres/wall_time.h"
 
@@ -54,6 +55,11 @@ LinearSolver::Summary DenseNormalCholeskySolver::SolveImpl(
     const LinearSolver::PerSolveOptions& per_solve_options,
     double* x) {
   if (options_.dense_linear_algebra_library_type == EIGEN) {
+    if (options_.use_tiled_dense_factorization &&
+        options_.num_threads > 1 &&
+        A->num_cols() > kParallelDenseOpsTileSize) {
+      return SolveUsingTiledCholesky(A, b, per_solve_options, x);
+    }
     return SolveUsingEigen(A, b, per_solve_options, x);
   } else {
     return SolveUsingLAPACK(A, b, per_solve_options, x);
@@ -111,6 +117,57 @@ LinearSolver::Summary DenseNormalCholeskySolver::SolveUsingEigen(
   return summary;
 }
 
+LinearSolver::Summary DenseNormalCholeskySolver::SolveUsingTiledCholesky(
+    DenseSparseMatrix* A,
+    const double* b,
+    const LinearSolver::PerSolveOptions& per_solve_options,
+    double* x) {
+  EventLogger event_logger("DenseNormalCholeskySolver::Solve");
+
+  const int num_rows = A->num_rows();
+  const int num_cols = A->num_cols();
+
+  ConstColMajorMatrixRef Aref = A->matrix();
+  ColMajorMatrix lhs(num_cols, num_cols);
+  lhs.setZero();
+
+  event_logger.AddEvent("Setup");
+
+  //   lhs += A'A
+  ParallelSymmetricRankUpdate(options_.context,
+                              options_.num_threads,
+                              num_rows,
+                              num_cols,
+                              Aref.data(),
+                              Aref.outerStride(),
+                              lhs.data());
+
+  //   rhs = A'b
+  Vector rhs = Aref.transpose() * ConstVectorRef(b, num_rows);
+
+  if (per_solve_options.D != NULL) {
+    ConstVectorRef D(per_solve_options.D, num_cols);
+    lhs.diagonal() += D.array().square().matrix();
+  }
+  event_logger.AddEvent("Product");
+
+  LinearSolver::Summary summary;
+  summary.num_iterations = 1;
+  if (!ParallelCholeskyFactorize(
+          options_.context, options_.num_threads, num_cols, lhs.data())) {
+    summary.termination_type = LINEAR_SOLVER_FAILURE;
+    summary.message = "Tiled Cholesky factorization failed.";
+    return summary;
+  }
+
+  CholeskySolveInPlace(num_cols, lhs.data(), rhs.data());
+  VectorRef(x, num_cols) = rhs;
+  summary.termination_type = LINEAR_SOLVER_SUCCESS;
+  summary.message = "Success.";
+  event_logger.AddEvent("Solve");
+  return summary;
+}
+
 LinearSolver::Summary DenseNormalCholeskySolver::SolveUsingLAPACK(
     DenseSparseMatrix* A,
     const double* b,
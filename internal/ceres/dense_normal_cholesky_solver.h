@@ -73,6 +73,10 @@ class DenseSparseMatrix;
 // library. This solver always returns a solution, it is the user's
 // responsibility to judge if the solution is good enough for their
 // purposes.
+//
+// If Eigen is used, use_tiled_dense_factorization is true and
+// num_threads > 1, A'A is formed and factorized using the tiled,
+// multithreaded routines in parallel_dense_ops.h.
 class DenseNormalCholeskySolver : public DenseSparseMatrixSolver {
  public:
   explicit DenseNormalCholeskySolver(const LinearSolver::Options& options);
@@ -96,6 +100,12 @@ class DenseNormalCholeskySolver : public DenseSparseMatrixSolver {
       const LinearSolver::PerSolveOptions& per_solve_options,
       double* x);
 
+  LinearSolver::Summary SolveUsingTiledCholesky(
+      DenseSparseMatrix* A,
+      const double* b,
+      const LinearSolver::PerSolveOptions& per_solve_options,
+      double* x);
+
   const LinearSolver::Options options_;
 };
 
@@ -37,6 +37,7 @@
 #include "ceres/internal/eigen.h"
 #include "ceres/lapack.h"
 #include "ceres/linear_solver.h"
+#include "ceres/parallel_dense_ops.h"
 #include "ceres/types.h"
 #include "ceres/wall_time.h"
 
@@ -54,6 +55,14 @@ LinearSolver::Summary DenseQRSolver::SolveImpl(
     const LinearSolver::PerSolveOptions& per_solve_options,
     double* x) {
   if (options_.dense_linear_algebra_library_type == EIGEN) {
+    // The blocked QR requires at least as many rows as columns, which
+    // is always the case when the system is regularized.
+    if (options_.use_tiled_dense_factorization &&
+        options_.num_threads > 1 &&
+        A->num_cols() > kParallelDenseOpsTileSize &&
+        (per_solve_options.D != NULL || A->num_rows() >= A->num_cols())) {
+      return SolveUsingTiledQR(A, b, per_solve_options, x);
+    }
     return SolveUsingEigen(A, b, per_solve_options, x);
   } else {
     return SolveUsingLAPACK(A, b, per_solve_options, x);
@@ -118,6 +127,55 @@ LinearSolver::Summary DenseQRSolver::SolveUsingLAPACK(
   return summary;
 }
 
+LinearSolver::Summary DenseQRSolver::SolveUsingTiledQR(
+    DenseSparseMatrix* A,
+    const double* b,
+    const LinearSolver::PerSolveOptions& per_solve_options,
+    double* x) {
+  EventLogger event_logger("DenseQRSolver::Solve");
+
+  const int num_rows = A->num_rows();
+
+  if (per_solve_options.D != NULL) {
+    // Temporarily append a diagonal block to the A matrix, but undo
+    // it before returning the matrix to the user.
+    A->AppendDiagonal(per_solve_options.D);
+  }
+
+  // The factorization is done in place, so A is copied.
+  lhs_ = A->matrix();
+
+  if (per_solve_options.D != NULL) {
+    // Undo the modifications to the matrix A.
+    A->RemoveDiagonal();
+  }
+
+  // rhs = [b;0] to account for the additional rows in the lhs.
+  if (rhs_.rows() != lhs_.rows()) {
+    rhs_.resize(lhs_.rows());
+  }
+  rhs_.setZero();
+  rhs_.head(num_rows) = ConstVectorRef(b, num_rows);
+  event_logger.AddEvent("Setup");
+
+  ParallelHouseholderQRSolve(options_.context,
+                             options_.num_threads,
+                             lhs_.rows(),
+                             lhs_.cols(),
+                             lhs_.data(),
+                             rhs_.data(),
+                             x);
+  event_logger.AddEvent("Solve");
+
+  // As with the Eigen and LAPACK paths, we always succeed and leave it
+  // to the caller to judge the solution.
+  LinearSolver::Summary summary;
+  summary.num_iterations = 1;
+  summary.termination_type = LINEAR_SOLVER_SUCCESS;
+  summary.message = "Success.";
+  return summary;
+}
+
 LinearSolver::Summary DenseQRSolver::SolveUsingEigen(
     DenseSparseMatrix* A,
     const double* b,
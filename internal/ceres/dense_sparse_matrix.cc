@@ -88,7 +88,7 @@ void DenseSparseMatrix::LeftMultiply(const double* x, double* y) const {
 }
 
 void DenseSparseMatrix::SquaredColumnNorm(double* x) const {
-  VectorRef(x, num_cols()) = m_.colwise().squaredNorm();
+  VectorRef(x, num_cols()) = matrix().colwise().squaredNorm();
 }
 
 void DenseSparseMatrix::ScaleColumns(const double* scale) {
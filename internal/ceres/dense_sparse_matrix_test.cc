@@ -146,6 +146,20 @@ TEST_F(DenseSparseMatrixTest, ColumnNorm) {
   EXPECT_EQ((b1 - b2).norm(), 0);
 }
 
+TEST_F(DenseSparseMatrixTest, ColumnNormIgnoresReservedDiagonal) {
+  Vector d = Vector::Ones(num_cols);
+  dsm->AppendDiagonal(d.data());
+  dsm->RemoveDiagonal();
+
+  Vector b1 = Vector::Zero(num_cols);
+  Vector b2 = Vector::Zero(num_cols);
+
+  tsm->SquaredColumnNorm(b1.data());
+  dsm->SquaredColumnNorm(b2.data());
+
+  EXPECT_EQ((b1 - b2).norm(), 0);
+}
+
 TEST_F(DenseSparseMatrixTest, Scale) {
   Vector scale(num_cols);
   for (int i = 0; i < num_cols; ++i) {
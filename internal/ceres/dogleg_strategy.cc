@@ -40,6 +40,7 @@
 #include "ceres/linear_solver.h"
 #include "ceres/polynomial.h"
 #include "ceres/sparse_matrix.h"
+#include "ceres/trace.h"
 #include "ceres/trust_region_strategy.h"
 #include "ceres/types.h"
 #include "glog/logging.h"
@@ -65,7 +66,9 @@ DoglegStrategy::DoglegStrategy(const TrustRegionStrategy::Options& options)
       decrease_threshold_(0.25),
       dogleg_step_norm_(0.0),
       reuse_(false),
-      dogleg_type_(options.dogleg_type) {
+      reuse_gradient_(false),
+      dogleg_type_(options.dogleg_type),
+      tracer_(options.tracer) {
   CHECK(linear_solver_ != nullptr);
   CHECK_GT(min_diagonal_, 0.0);
   CHECK_LE(min_diagonal_, max_diagonal_);
@@ -101,34 +104,37 @@ TrustRegionStrategy::Summary DoglegStrategy::ComputeStep(
     }
     TrustRegionStrategy::Summary summary;
     summary.num_iterations = 0;
+    summary.reused_linear_solve = true;
     summary.termination_type = LINEAR_SOLVER_SUCCESS;
     return summary;
   }
 
   reuse_ = true;
-  // Check that we have the storage needed to hold the various
-  // temporary vectors.
-  if (diagonal_.rows() != n) {
-    diagonal_.resize(n, 1);
-    gradient_.resize(n, 1);
-    gauss_newton_step_.resize(n, 1);
-  }
+  if (!reuse_gradient_ || diagonal_.rows() != n) {
+    // Check that we have the storage needed to hold the various
+    // temporary vectors.
+    if (diagonal_.rows() != n) {
+      diagonal_.resize(n, 1);
+      gradient_.resize(n, 1);
+      gauss_newton_step_.resize(n, 1);
+    }
 
-  // Vector used to form the diagonal matrix that is used to
-  // regularize the Gauss-Newton solve and that defines the
-  // elliptical trust region
-  //
-  //   || D * step || <= radius_ .
-  //
-  jacobian->SquaredColumnNorm(diagonal_.data());
-  for (int i = 0; i < n; ++i) {
-    diagonal_[i] =
-        std::min(std::max(diagonal_[i], min_diagonal_), max_diagonal_);
-  }
-  diagonal_ = diagonal_.array().sqrt();
+    // Vector used to form the diagonal matrix that is used to
+    // regularize the Gauss-Newton solve and that defines the
+    // elliptical trust region
+    //
+    //   || D * step || <= radius_ .
+    //
+    jacobian->SquaredColumnNorm(diagonal_.data());
+    for (int i = 0; i < n; ++i) {
+      diagonal_[i] =
+          std::min(std::max(diagonal_[i], min_diagonal_), max_diagonal_);
+    }
+    diagonal_ = diagonal_.array().sqrt();
 
-  ComputeGradient(jacobian, residuals);
-  ComputeCauchyPoint(jacobian);
+    ComputeGradient(jacobian, residuals);
+    ComputeCauchyPoint(jacobian);
+  }
 
   LinearSolver::Summary linear_solver_summary =
       ComputeGaussNewtonStep(per_solve_options, jacobian, residuals);
@@ -137,6 +143,7 @@ TrustRegionStrategy::Summary DoglegStrategy::ComputeStep(
   summary.residual_norm = linear_solver_summary.residual_norm;
   summary.num_iterations = linear_solver_summary.num_iterations;
   summary.termination_type = linear_solver_summary.termination_type;
+  summary.message = linear_solver_summary.message;
 
   if (linear_solver_summary.termination_type == LINEAR_SOLVER_FATAL_ERROR) {
     return summary;
@@ -563,8 +570,11 @@ LinearSolver::Summary DoglegStrategy::ComputeGaussNewtonStep(
     // of Jx = -r and later set x = -y to avoid having to modify
     // either jacobian or residuals.
     InvalidateArray(n, gauss_newton_step_.data());
-    linear_solver_summary = linear_solver_->Solve(
-        jacobian, residuals, solve_options, gauss_newton_step_.data());
+    {
+      ScopedTrace trace(tracer_, "LinearSolver::Solve");
+      linear_solver_summary = linear_solver_->Solve(
+          jacobian, residuals, solve_options, gauss_newton_step_.data());
+    }
 
     if (per_solve_options.dump_format_type == CONSOLE ||
         (per_solve_options.dump_format_type != CONSOLE &&
@@ -625,6 +635,7 @@ void DoglegStrategy::StepAccepted(double step_quality) {
   // to doing a pure Gauss-Newton solve.
   mu_ = std::max(min_mu_, 2.0 * mu_ / mu_increase_factor_);
   reuse_ = false;
+  reuse_gradient_ = false;
 }
 
 void DoglegStrategy::StepRejected(double step_quality) {
@@ -635,6 +646,7 @@ void DoglegStrategy::StepRejected(double step_quality) {
 void DoglegStrategy::StepIsInvalid() {
   mu_ *= mu_increase_factor_;
   reuse_ = false;
+  reuse_gradient_ = true;
 }
 
 double DoglegStrategy::Radius() const { return radius_; }
@@ -147,6 +147,13 @@ class CERES_EXPORT_INTERNAL DoglegStrategy : public TrustRegionStrategy {
   // called again, thus reuse is set to false.
   bool reuse_;
 
+  // If the user called StepIsInvalid, the Jacobian and the residuals
+  // have not changed, so the diagonal, the gradient and the Cauchy
+  // point are still valid and only the Gauss-Newton step has to be
+  // recomputed with the increased regularization. reuse_gradient_ is
+  // set to false by StepAccepted.
+  bool reuse_gradient_;
+
   // The dogleg type determines how the minimum of the local
   // quadratic model is found.
   DoglegType dogleg_type_;
@@ -157,6 +164,8 @@ class CERES_EXPORT_INTERNAL DoglegStrategy : public TrustRegionStrategy {
   Matrix subspace_basis_;
   Vector2d subspace_g_;
   Matrix2d subspace_B_;
+
+  Tracer* tracer_;
 };
 
 }  // namespace internal
@@ -191,6 +191,46 @@ TEST_F(DoglegStrategyFixtureEllipse, CorrectGaussNewtonStep) {
   EXPECT_NEAR(x_(5), 1.0, kToleranceLoose);
 }
 
+// After a rejected step, the Gauss-Newton step is reused and the
+// linear solver is not called again.
+TEST_F(DoglegStrategyFixtureEllipse, ReusesLinearSolveAfterRejectedStep) {
+  std::unique_ptr<LinearSolver> linear_solver(
+      new DenseQRSolver(LinearSolver::Options()));
+  options_.linear_solver = linear_solver.get();
+  options_.dogleg_type = SUBSPACE_DOGLEG;
+  options_.initial_radius = 2.0;
+  options_.max_radius = 2.0;
+
+  DoglegStrategy strategy(options_);
+  TrustRegionStrategy::PerSolveOptions pso;
+
+  TrustRegionStrategy::Summary summary =
+      strategy.ComputeStep(pso, jacobian_.get(), residual_.data(), x_.data());
+  EXPECT_NE(summary.termination_type, LINEAR_SOLVER_FAILURE);
+  EXPECT_FALSE(summary.reused_linear_solve);
+  const Vector gauss_newton_step = strategy.gauss_newton_step();
+  const Vector gradient = strategy.gradient();
+
+  strategy.StepRejected(0.0);
+  summary =
+      strategy.ComputeStep(pso, jacobian_.get(), residual_.data(), x_.data());
+  EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_SUCCESS);
+  EXPECT_TRUE(summary.reused_linear_solve);
+  EXPECT_EQ(summary.num_iterations, 0);
+  EXPECT_LE(x_.norm(), strategy.Radius() * (1.0 + 4.0 * kEpsilon));
+  EXPECT_EQ((strategy.gauss_newton_step() - gauss_newton_step).norm(), 0.0);
+
+  // An invalid step requires a new linear solve with a stronger
+  // regularization, but the gradient is unchanged.
+  strategy.StepIsInvalid();
+  summary =
+      strategy.ComputeStep(pso, jacobian_.get(), residual_.data(), x_.data());
+  EXPECT_NE(summary.termination_type, LINEAR_SOLVER_FAILURE);
+  EXPECT_FALSE(summary.reused_linear_solve);
+  EXPECT_EQ((strategy.gradient() - gradient).norm(), 0.0);
+  EXPECT_LE(x_.norm(), strategy.Radius() * (1.0 + 4.0 * kEpsilon));
+}
+
 // Test if the subspace basis is a valid orthonormal basis of the space spanned
 // by the gradient and the Gauss-Newton point.
 TEST_F(DoglegStrategyFixtureEllipse, ValidSubspaceBasis) {
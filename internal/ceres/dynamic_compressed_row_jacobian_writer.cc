@@ -48,7 +48,8 @@ DynamicCompressedRowJacobianWriter::CreateEvaluatePreparers(int num_threads) {
   return ScratchEvaluatePreparer::Create(*program_, num_threads);
 }
 
-SparseMatrix* DynamicCompressedRowJacobianWriter::CreateJacobian() const {
+SparseMatrix* DynamicCompressedRowJacobianWriter::CreateJacobian(
+    std::string* /* error */) const {
   DynamicCompressedRowSparseMatrix* jacobian =
       new DynamicCompressedRowSparseMatrix(program_->NumResiduals(),
                                            program_->NumEffectiveParameters(),
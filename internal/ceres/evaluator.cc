@@ -30,17 +30,26 @@
 
 #include "ceres/evaluator.h"
 
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
 #include <vector>
 
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif  // defined(__GNUG__)
+
 #include "ceres/block_evaluate_preparer.h"
 #include "ceres/block_jacobian_writer.h"
 #include "ceres/compressed_row_jacobian_writer.h"
 #include "ceres/compressed_row_sparse_matrix.h"
+#include "ceres/cost_function.h"
 #include "ceres/crs_matrix.h"
 #include "ceres/dense_jacobian_writer.h"
 #include "ceres/dynamic_compressed_row_finalizer.h"
 #include "ceres/dynamic_compressed_row_jacobian_writer.h"
 #include "ceres/internal/port.h"
+#include "ceres/matrix_free_jacobian_writer.h"
 #include "ceres/program_evaluator.h"
 #include "ceres/scratch_evaluate_preparer.h"
 #include "glog/logging.h"
@@ -48,6 +57,20 @@
 namespace ceres {
 namespace internal {
 
+std::string CostFunctionTypeName(const CostFunction& cost_function) {
+  const char* name = typeid(cost_function).name();
+#if defined(__GNUG__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled != nullptr) {
+    const std::string result(demangled);
+    free(demangled);
+    return result;
+  }
+#endif  // defined(__GNUG__)
+  return name;
+}
+
 Evaluator::~Evaluator() {}
 
 Evaluator* Evaluator::Create(const Evaluator::Options& options,
@@ -60,10 +83,18 @@ Evaluator* Evaluator::Create(const Evaluator::Options& options,
     case DENSE_NORMAL_CHOLESKY:
       return new ProgramEvaluator<ScratchEvaluatePreparer, DenseJacobianWriter>(
           options, program);
+    case CGNR:
+      if (options.use_matrix_free_jacobian) {
+        return new ProgramEvaluator<ScratchEvaluatePreparer,
+                                    MatrixFreeJacobianWriter,
+                                    MatrixFreeJacobianFinalizer>(options,
+                                                                 program);
+      }
+      return new ProgramEvaluator<BlockEvaluatePreparer, BlockJacobianWriter>(
+          options, program);
     case DENSE_SCHUR:
     case SPARSE_SCHUR:
     case ITERATIVE_SCHUR:
-    case CGNR:
       return new ProgramEvaluator<BlockEvaluatePreparer, BlockJacobianWriter>(
           options, program);
     case SPARSE_NORMAL_CHOLESKY:
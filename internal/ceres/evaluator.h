@@ -43,6 +43,7 @@
 
 namespace ceres {
 
+class CostFunction;
 struct CRSMatrix;
 class EvaluationCallback;
 
@@ -50,6 +51,22 @@ namespace internal {
 
 class Program;
 class SparseMatrix;
+class Tracer;
+
+// Evaluation statistics for all the residual blocks whose cost
+// functions have the same type.
+struct CostFunctionStatistics {
+  int num_residual_blocks = 0;
+  int num_residuals = 0;
+  int num_jacobian_entries = 0;
+  CallStatistics residual_evaluations;
+  CallStatistics jacobian_evaluations;
+};
+
+// The (demangled, if possible) name of the dynamic type of
+// cost_function.
+CERES_EXPORT_INTERNAL std::string CostFunctionTypeName(
+    const CostFunction& cost_function);
 
 // The Evaluator interface offers a way to interact with a least squares cost
 // function that is useful for an optimizer that wants to minimize the least
@@ -64,8 +81,14 @@ class CERES_EXPORT_INTERNAL Evaluator {
     int num_eliminate_blocks = -1;
     LinearSolverType linear_solver_type = DENSE_QR;
     bool dynamic_sparsity = false;
+    bool use_matrix_free_jacobian = false;
+    std::string memory_mapped_storage_directory;
     ContextImpl* context = nullptr;
+    // Records the evaluations if not nullptr.
+    Tracer* tracer = nullptr;
     EvaluationCallback* evaluation_callback = nullptr;
+    // If true, collect CostFunctionStatistics.
+    bool profile_cost_functions = false;
   };
 
   static Evaluator* Create(const Options& options,
@@ -88,7 +111,11 @@ class CERES_EXPORT_INTERNAL Evaluator {
   // the jacobian for use with CHOLMOD, where as BlockOptimizationProblem
   // creates a BlockSparseMatrix representation of the jacobian for use in the
   // Schur complement based methods.
-  virtual SparseMatrix* CreateJacobian() const = 0;
+  //
+  // Returns nullptr and sets error if the storage for the jacobian
+  // cannot be allocated. This only happens if
+  // Options::memory_mapped_storage_directory is set.
+  virtual SparseMatrix* CreateJacobian(std::string* error) const = 0;
 
   // Options struct to control Evaluator::Evaluate;
   struct EvaluateOptions {
@@ -160,6 +187,13 @@ class CERES_EXPORT_INTERNAL Evaluator {
   virtual std::map<std::string, CallStatistics> Statistics() const {
     return std::map<std::string, CallStatistics>();
   }
+
+  // If Options::profile_cost_functions is true, the evaluation
+  // statistics keyed by CostFunctionTypeName.
+  virtual std::map<std::string, CostFunctionStatistics>
+  PerCostFunctionStatistics() const {
+    return std::map<std::string, CostFunctionStatistics>();
+  }
 };
 
 }  // namespace internal
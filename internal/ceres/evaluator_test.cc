@@ -105,14 +105,17 @@ class ParameterIgnoringCostFunction
 struct EvaluatorTestOptions {
   EvaluatorTestOptions(LinearSolverType linear_solver_type,
                        int num_eliminate_blocks,
-                       bool dynamic_sparsity = false)
+                       bool dynamic_sparsity = false,
+                       bool use_matrix_free_jacobian = false)
       : linear_solver_type(linear_solver_type),
         num_eliminate_blocks(num_eliminate_blocks),
-        dynamic_sparsity(dynamic_sparsity) {}
+        dynamic_sparsity(dynamic_sparsity),
+        use_matrix_free_jacobian(use_matrix_free_jacobian) {}
 
   LinearSolverType linear_solver_type;
   int num_eliminate_blocks;
   bool dynamic_sparsity;
+  bool use_matrix_free_jacobian;
 };
 
 struct EvaluatorTest : public ::testing::TestWithParam<EvaluatorTestOptions> {
@@ -139,6 +142,7 @@ struct EvaluatorTest : public ::testing::TestWithParam<EvaluatorTestOptions> {
     options.linear_solver_type = GetParam().linear_solver_type;
     options.num_eliminate_blocks = GetParam().num_eliminate_blocks;
     options.dynamic_sparsity = GetParam().dynamic_sparsity;
+    options.use_matrix_free_jacobian = GetParam().use_matrix_free_jacobian;
     options.context = problem.context();
     string error;
     return Evaluator::Create(options, program, &error);
@@ -164,7 +168,9 @@ struct EvaluatorTest : public ::testing::TestWithParam<EvaluatorTestOptions> {
     Vector gradient(num_parameters);
     gradient.setConstant(-3000);
 
-    std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian());
+    string error;
+    std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian(&error));
+    ASSERT_TRUE(jacobian != nullptr) << error;
 
     ASSERT_EQ(expected_num_rows, evaluator->NumResiduals());
     ASSERT_EQ(expected_num_cols, evaluator->NumEffectiveParameters());
@@ -547,7 +553,8 @@ TEST_P(EvaluatorTest, EvaluatorAbortsForResidualsThatFailToEvaluate) {
 
   std::unique_ptr<Evaluator> evaluator(
       CreateEvaluator(problem.mutable_program()));
-  std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian());
+  string error;
+  std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian(&error));
   double cost;
   EXPECT_FALSE(evaluator->Evaluate(state, &cost, nullptr, nullptr, nullptr));
 }
@@ -578,7 +585,9 @@ INSTANTIATE_TEST_SUITE_P(
                       EvaluatorTestOptions(ITERATIVE_SCHUR, 3),
                       EvaluatorTestOptions(ITERATIVE_SCHUR, 4),
                       EvaluatorTestOptions(SPARSE_NORMAL_CHOLESKY, 0, false),
-                      EvaluatorTestOptions(SPARSE_NORMAL_CHOLESKY, 0, true)));
+                      EvaluatorTestOptions(SPARSE_NORMAL_CHOLESKY, 0, true),
+                      EvaluatorTestOptions(CGNR, 0, false, false),
+                      EvaluatorTestOptions(CGNR, 0, false, true)));
 
 // Simple cost function used to check if the evaluator is sensitive to
 // state changes.
@@ -623,7 +632,7 @@ TEST(Evaluator, EvaluatorRespectsParameterChanges) {
   string error;
   std::unique_ptr<Evaluator> evaluator(
       Evaluator::Create(options, program, &error));
-  std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian());
+  std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian(&error));
 
   ASSERT_EQ(2, jacobian->num_rows());
   ASSERT_EQ(2, jacobian->num_cols());
@@ -677,5 +686,63 @@ TEST(Evaluator, EvaluatorRespectsParameterChanges) {
   }
 }
 
+TEST(Evaluator, PerCostFunctionStatistics) {
+  ProblemImpl problem;
+
+  double x[2] = {1.0, 1.0};
+  double y[2] = {1.0, 1.0};
+  problem.AddResidualBlock(new ParameterSensitiveCostFunction(), nullptr, x);
+  problem.AddResidualBlock(new ParameterSensitiveCostFunction(), nullptr, y);
+  problem.AddResidualBlock(
+      new ParameterIgnoringCostFunction<1, 3, 2, 2>, nullptr, x, y);
+  Program* program = problem.mutable_program();
+  program->SetParameterOffsetsAndIndex();
+
+  Evaluator::Options options;
+  options.linear_solver_type = DENSE_QR;
+  options.num_eliminate_blocks = 0;
+  options.context = problem.context();
+  options.profile_cost_functions = true;
+  string error;
+  std::unique_ptr<Evaluator> evaluator(
+      Evaluator::Create(options, program, &error));
+  std::unique_ptr<SparseMatrix> jacobian(evaluator->CreateJacobian(&error));
+
+  double state[4] = {1.0, 2.0, 3.0, 4.0};
+  double cost;
+  ASSERT_TRUE(evaluator->Evaluate(state, &cost, nullptr, nullptr, nullptr));
+  ASSERT_TRUE(evaluator->Evaluate(state, &cost, nullptr, nullptr, nullptr));
+  ASSERT_TRUE(
+      evaluator->Evaluate(state, &cost, nullptr, nullptr, jacobian.get()));
+
+  const std::map<string, CostFunctionStatistics> statistics =
+      evaluator->PerCostFunctionStatistics();
+  ASSERT_EQ(statistics.size(), 2);
+
+  const string sensitive_name =
+      CostFunctionTypeName(ParameterSensitiveCostFunction());
+  const string ignoring_name =
+      CostFunctionTypeName(ParameterIgnoringCostFunction<1, 3, 2, 2>());
+  EXPECT_NE(sensitive_name.find("ParameterSensitiveCostFunction"),
+            string::npos);
+  ASSERT_EQ(statistics.count(sensitive_name), 1);
+  ASSERT_EQ(statistics.count(ignoring_name), 1);
+
+  const CostFunctionStatistics& sensitive = statistics.at(sensitive_name);
+  EXPECT_EQ(sensitive.num_residual_blocks, 2);
+  EXPECT_EQ(sensitive.num_residuals, 4);
+  EXPECT_EQ(sensitive.num_jacobian_entries, 8);
+  EXPECT_EQ(sensitive.residual_evaluations.calls, 4);
+  EXPECT_EQ(sensitive.jacobian_evaluations.calls, 2);
+  EXPECT_GE(sensitive.residual_evaluations.time, 0.0);
+
+  const CostFunctionStatistics& ignoring = statistics.at(ignoring_name);
+  EXPECT_EQ(ignoring.num_residual_blocks, 1);
+  EXPECT_EQ(ignoring.num_residuals, 3);
+  EXPECT_EQ(ignoring.num_jacobian_entries, 12);
+  EXPECT_EQ(ignoring.residual_evaluations.calls, 2);
+  EXPECT_EQ(ignoring.jacobian_evaluations.calls, 1);
+}
+
 }  // namespace internal
 }  // namespace ceres
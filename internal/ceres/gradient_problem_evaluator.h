@@ -31,24 +31,64 @@
 #ifndef CERES_INTERNAL_GRADIENT_PROBLEM_EVALUATOR_H_
 #define CERES_INTERNAL_GRADIENT_PROBLEM_EVALUATOR_H_
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "ceres/evaluator.h"
 #include "ceres/execution_summary.h"
+#include "ceres/first_order_function.h"
 #include "ceres/gradient_problem.h"
 #include "ceres/internal/port.h"
+#include "ceres/local_parameterization.h"
+#include "ceres/parallel_for.h"
 #include "ceres/wall_time.h"
+#include "glog/logging.h"
 
 namespace ceres {
 namespace internal {
 
 class GradientProblemEvaluator : public Evaluator {
  public:
-  explicit GradientProblemEvaluator(const GradientProblem& problem)
-      : problem_(problem) {}
+  // If the problem's function is a PartitionedFirstOrderFunction, its
+  // partitions are evaluated using num_threads threads from context.
+  // The partitions must cover the parameters as documented in
+  // first_order_function.h, since they write to the gradient
+  // concurrently. If they do not, the function is evaluated serially.
+  GradientProblemEvaluator(const GradientProblem& problem,
+                           ContextImpl* context,
+                           int num_threads)
+      : problem_(problem),
+        context_(context),
+        num_threads_(num_threads),
+        partitioned_function_(
+            dynamic_cast<const PartitionedFirstOrderFunction*>(
+                problem.function())) {
+    if (partitioned_function_ == nullptr) {
+      return;
+    }
+
+    const int num_partitions = partitioned_function_->NumPartitions();
+    partition_starts_.resize(num_partitions + 1);
+    for (int i = 0; i <= num_partitions; ++i) {
+      partition_starts_[i] = partitioned_function_->PartitionStart(i);
+    }
+    if (!ArePartitionStartsValid()) {
+      LOG(WARNING) << "The partitions of the PartitionedFirstOrderFunction "
+                   << "do not cover its " << problem_.NumParameters()
+                   << " parameters in order. Evaluating them serially.";
+      partitioned_function_ = nullptr;
+      partition_starts_.clear();
+      return;
+    }
+    partition_costs_.resize(num_partitions);
+    partition_is_valid_.resize(num_partitions);
+  }
   virtual ~GradientProblemEvaluator() {}
-  SparseMatrix* CreateJacobian() const final { return nullptr; }
+  SparseMatrix* CreateJacobian(std::string* /* error */) const final {
+    return nullptr;
+  }
   bool Evaluate(const EvaluateOptions& evaluate_options,
                 const double* state,
                 double* cost,
@@ -67,7 +107,11 @@ class GradientProblemEvaluator : public Evaluator {
     ScopedExecutionTimer call_type_timer(
         gradient == NULL ? "Evaluator::Residual" : "Evaluator::Jacobian",
         &execution_summary_);
-    return problem_.Evaluate(state, cost, gradient);
+    if (partitioned_function_ == nullptr || context_ == nullptr ||
+        num_threads_ == 1) {
+      return problem_.Evaluate(state, cost, gradient);
+    }
+    return EvaluatePartitions(state, cost, gradient);
   }
 
   bool Plus(const double* state,
@@ -89,7 +133,69 @@ class GradientProblemEvaluator : public Evaluator {
   }
 
  private:
+  bool ArePartitionStartsValid() const {
+    if (partition_starts_.size() < 2 || partition_starts_.front() != 0 ||
+        partition_starts_.back() != problem_.NumParameters()) {
+      return false;
+    }
+    return std::is_sorted(partition_starts_.begin(), partition_starts_.end());
+  }
+
+  // Evaluates the partitions of partitioned_function_ in parallel,
+  // and then applies the local parameterization to the gradient, like
+  // GradientProblem::Evaluate does. Each partition's range of the
+  // gradient is zeroed before the partition is evaluated, since the
+  // partition is not required to write all of it.
+  bool EvaluatePartitions(const double* state, double* cost, double* gradient) {
+    const int num_parameters = problem_.NumParameters();
+    double* ambient_gradient = nullptr;
+    if (gradient != nullptr) {
+      ambient_gradient_.resize(num_parameters);
+      ambient_gradient = ambient_gradient_.data();
+    }
+
+    ParallelFor(context_,
+                0,
+                partitioned_function_->NumPartitions(),
+                num_threads_,
+                [&](int i) {
+                  if (ambient_gradient != nullptr) {
+                    std::fill(ambient_gradient + partition_starts_[i],
+                              ambient_gradient + partition_starts_[i + 1],
+                              0.0);
+                  }
+                  partition_is_valid_[i] =
+                      partitioned_function_->EvaluatePartition(
+                          i, state, &partition_costs_[i], ambient_gradient);
+                });
+
+    // The costs are summed in a fixed order so that the result does
+    // not depend on the scheduling of the partitions.
+    *cost = 0.0;
+    for (int i = 0; i < partition_costs_.size(); ++i) {
+      if (!partition_is_valid_[i]) {
+        return false;
+      }
+      *cost += partition_costs_[i];
+    }
+
+    if (gradient == nullptr) {
+      return true;
+    }
+    return problem_.parameterization()->MultiplyByJacobian(
+        state, 1, ambient_gradient, gradient);
+  }
+
   const GradientProblem& problem_;
+  ContextImpl* context_;
+  const int num_threads_;
+  const PartitionedFirstOrderFunction* partitioned_function_;
+  std::vector<int> partition_starts_;
+  std::vector<double> partition_costs_;
+  // char instead of bool, so that the partitions can be written to
+  // concurrently.
+  std::vector<char> partition_is_valid_;
+  std::vector<double> ambient_gradient_;
   ::ceres::internal::ExecutionSummary execution_summary_;
 };
 
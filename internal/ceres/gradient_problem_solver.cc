@@ -33,12 +33,14 @@
 #include <memory>
 
 #include "ceres/callbacks.h"
+#include "ceres/context_impl.h"
 #include "ceres/gradient_problem.h"
 #include "ceres/gradient_problem_evaluator.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/internal/port.h"
 #include "ceres/map_util.h"
 #include "ceres/minimizer.h"
+#include "ceres/preprocessor.h"
 #include "ceres/solver.h"
 #include "ceres/solver_utils.h"
 #include "ceres/stringprintf.h"
@@ -63,6 +65,7 @@ Solver::Options GradientProblemSolverOptionsToSolverOptions(
   COPY_OPTION(nonlinear_conjugate_gradient_type);
   COPY_OPTION(max_lbfgs_rank);
   COPY_OPTION(use_approximate_eigenvalue_bfgs_scaling);
+  COPY_OPTION(use_compact_lbfgs_representation);
   COPY_OPTION(line_search_interpolation_type);
   COPY_OPTION(min_line_search_step_size);
   COPY_OPTION(line_search_sufficient_function_decrease);
@@ -75,6 +78,7 @@ Solver::Options GradientProblemSolverOptionsToSolverOptions(
   COPY_OPTION(max_num_iterations);
   COPY_OPTION(max_solver_time_in_seconds);
   COPY_OPTION(parameter_tolerance);
+  COPY_OPTION(num_threads);
   COPY_OPTION(function_tolerance);
   COPY_OPTION(gradient_tolerance);
   COPY_OPTION(logging_type);
@@ -99,6 +103,8 @@ void GradientProblemSolver::Solve(const GradientProblemSolver::Options& options,
                                   double* parameters_ptr,
                                   GradientProblemSolver::Summary* summary) {
   using internal::CallStatistics;
+  using internal::ChangeNumThreadsIfNeeded;
+  using internal::ContextImpl;
   using internal::GradientProblemEvaluator;
   using internal::GradientProblemSolverStateUpdatingCallback;
   using internal::LoggingCallback;
@@ -133,9 +139,17 @@ void GradientProblemSolver::Solve(const GradientProblemSolver::Options& options,
   // TODO(sameeragarwal): This is a bit convoluted, we should be able
   // to convert to minimizer options directly, but this will do for
   // now.
-  Minimizer::Options minimizer_options =
-      Minimizer::Options(GradientProblemSolverOptionsToSolverOptions(options));
-  minimizer_options.evaluator.reset(new GradientProblemEvaluator(problem));
+  Solver::Options solver_options =
+      GradientProblemSolverOptionsToSolverOptions(options);
+  ChangeNumThreadsIfNeeded(&solver_options);
+  Minimizer::Options minimizer_options = Minimizer::Options(solver_options);
+
+  // The main thread also does work so we only need to launch num_threads - 1.
+  ContextImpl context;
+  context.EnsureMinimumThreads(minimizer_options.num_threads - 1);
+  minimizer_options.context = &context;
+  minimizer_options.evaluator.reset(new GradientProblemEvaluator(
+      problem, &context, minimizer_options.num_threads));
 
   std::unique_ptr<IterationCallback> logging_callback;
   if (options.logging_type != SILENT) {
@@ -30,7 +30,12 @@
 
 #include "ceres/gradient_problem_solver.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "ceres/context_impl.h"
 #include "ceres/gradient_problem.h"
+#include "ceres/gradient_problem_evaluator.h"
 #include "gtest/gtest.h"
 
 namespace ceres {
@@ -72,6 +77,162 @@ TEST(GradientProblemSolver, SolvesRosenbrockWithDefaultOptions) {
   EXPECT_NEAR(1.0, parameters[1], expected_tolerance);
 }
 
+TEST(GradientProblemSolver, SolvesRosenbrockWithCompactLBFGSRepresentation) {
+  const double expected_tolerance = 1e-9;
+  double parameters[2] = {-1.2, 0.0};
+
+  ceres::GradientProblemSolver::Options options;
+  options.use_compact_lbfgs_representation = true;
+  ceres::GradientProblemSolver::Summary summary;
+  ceres::GradientProblem problem(new Rosenbrock());
+  ceres::Solve(options, problem, parameters, &summary);
+
+  EXPECT_EQ(CONVERGENCE, summary.termination_type);
+  EXPECT_NEAR(1.0, parameters[0], expected_tolerance);
+  EXPECT_NEAR(1.0, parameters[1], expected_tolerance);
+}
+
+// The extended Rosenbrock function, which is a sum of independent
+// Rosenbrock functions of the pairs (x_{2i}, x_{2i+1}), evaluated in
+// partitions of kPairsPerPartition pairs.
+class PartitionedRosenbrock : public ceres::PartitionedFirstOrderFunction {
+ public:
+  static constexpr int kNumPairs = 100;
+  static constexpr int kPairsPerPartition = 7;
+
+  int NumParameters() const final { return 2 * kNumPairs; }
+  int NumPartitions() const final {
+    return (kNumPairs + kPairsPerPartition - 1) / kPairsPerPartition;
+  }
+  int PartitionStart(int partition) const final {
+    return 2 * std::min(partition * kPairsPerPartition, int{kNumPairs});
+  }
+
+  bool EvaluatePartition(int partition,
+                         const double* parameters,
+                         double* cost,
+                         double* gradient) const final {
+    *cost = 0.0;
+    for (int i = PartitionStart(partition); i < PartitionStart(partition + 1);
+         i += 2) {
+      const double x = parameters[i];
+      const double y = parameters[i + 1];
+      *cost += (1.0 - x) * (1.0 - x) + 100.0 * (y - x * x) * (y - x * x);
+      if (gradient != NULL) {
+        gradient[i] = -2.0 * (1.0 - x) - 200.0 * (y - x * x) * 2.0 * x;
+        gradient[i + 1] = 200.0 * (y - x * x);
+      }
+    }
+    return true;
+  }
+};
+
+TEST(GradientProblemSolver, SolvesPartitionedRosenbrockWithMultipleThreads) {
+  const int num_parameters = 2 * PartitionedRosenbrock::kNumPairs;
+  std::vector<double> initial_parameters(num_parameters);
+  for (int i = 0; i < num_parameters; i += 2) {
+    initial_parameters[i] = -1.2;
+    initial_parameters[i + 1] = 0.01 * i;
+  }
+
+  ceres::GradientProblem problem(new PartitionedRosenbrock());
+  ceres::GradientProblemSolver::Options options;
+  options.function_tolerance = 1e-12;
+  options.gradient_tolerance = 1e-12;
+  options.max_num_iterations = 1000;
+
+  std::vector<double> serial_parameters = initial_parameters;
+  ceres::GradientProblemSolver::Summary serial_summary;
+  ceres::Solve(options, problem, serial_parameters.data(), &serial_summary);
+  EXPECT_EQ(CONVERGENCE, serial_summary.termination_type);
+  for (int i = 0; i < num_parameters; ++i) {
+    EXPECT_NEAR(1.0, serial_parameters[i], 1e-6);
+  }
+
+  // The partition costs are summed in the same order and the vectors
+  // are too short to be split, so the threaded solve follows exactly
+  // the same path.
+  options.num_threads = 4;
+  std::vector<double> parallel_parameters = initial_parameters;
+  ceres::GradientProblemSolver::Summary parallel_summary;
+  ceres::Solve(options, problem, parallel_parameters.data(), &parallel_summary);
+  EXPECT_EQ(CONVERGENCE, parallel_summary.termination_type);
+  EXPECT_EQ(serial_summary.iterations.size(),
+            parallel_summary.iterations.size());
+  EXPECT_EQ(serial_summary.final_cost, parallel_summary.final_cost);
+  EXPECT_EQ(serial_parameters, parallel_parameters);
+}
+
+// f(x) = sum_i (x_i - 1)^2, whose partitions only write the non-zero
+// entries of the gradient, and whose partition starts can be made
+// invalid.
+class SparseGradientQuadratic : public ceres::PartitionedFirstOrderFunction {
+ public:
+  static constexpr int kNumParameters = 10;
+
+  explicit SparseGradientQuadratic(int last_partition_start)
+      : last_partition_start_(last_partition_start) {}
+
+  int NumParameters() const final { return kNumParameters; }
+  int NumPartitions() const final { return 2; }
+  int PartitionStart(int partition) const final {
+    return partition == 2 ? last_partition_start_ : 5 * partition;
+  }
+
+  bool EvaluatePartition(int partition,
+                         const double* parameters,
+                         double* cost,
+                         double* gradient) const final {
+    *cost = 0.0;
+    for (int i = 5 * partition; i < 5 * (partition + 1); ++i) {
+      *cost += (parameters[i] - 1.0) * (parameters[i] - 1.0);
+      if (gradient != nullptr && parameters[i] != 1.0) {
+        gradient[i] = 2.0 * (parameters[i] - 1.0);
+      }
+    }
+    return true;
+  }
+
+ private:
+  const int last_partition_start_;
+};
+
+TEST(GradientProblemEvaluator, ZeroesTheGradientOfEachPartition) {
+  // The starts are invalid for the last function, which is then
+  // evaluated serially.
+  for (const int last_partition_start :
+       {SparseGradientQuadratic::kNumParameters,
+        SparseGradientQuadratic::kNumParameters - 1}) {
+    ceres::GradientProblem problem(
+        new SparseGradientQuadratic(last_partition_start));
+    ContextImpl context;
+    context.EnsureMinimumThreads(1);
+    GradientProblemEvaluator gradient_problem_evaluator(problem, &context, 2);
+    Evaluator& evaluator = gradient_problem_evaluator;
+
+    std::vector<double> parameters(SparseGradientQuadratic::kNumParameters,
+                                   0.0);
+    std::vector<double> gradient(SparseGradientQuadratic::kNumParameters);
+    double cost = 0.0;
+    ASSERT_TRUE(evaluator.Evaluate(
+        parameters.data(), &cost, nullptr, gradient.data(), nullptr));
+    EXPECT_EQ(cost, double{SparseGradientQuadratic::kNumParameters});
+    for (const double entry : gradient) {
+      EXPECT_EQ(entry, -2.0);
+    }
+
+    // The partitions do not write the gradient at the minimum, so the
+    // gradient of the previous evaluation must not leak through.
+    std::fill(parameters.begin(), parameters.end(), 1.0);
+    ASSERT_TRUE(evaluator.Evaluate(
+        parameters.data(), &cost, nullptr, gradient.data(), nullptr));
+    EXPECT_EQ(cost, 0.0);
+    for (const double entry : gradient) {
+      EXPECT_EQ(entry, 0.0);
+    }
+  }
+}
+
 class QuadraticFunction : public ceres::FirstOrderFunction {
   virtual ~QuadraticFunction() {}
   bool Evaluate(const double* parameters,
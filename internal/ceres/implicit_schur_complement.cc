@@ -34,6 +34,7 @@
 #include "ceres/block_sparse_matrix.h"
 #include "ceres/block_structure.h"
 #include "ceres/internal/eigen.h"
+#include "ceres/invert_psd_matrix.h"
 #include "ceres/linear_solver.h"
 #include "ceres/types.h"
 #include "glog/logging.h"
@@ -138,19 +139,39 @@ void ImplicitSchurComplement::AddDiagonalAndInvert(
     const double* D, BlockSparseMatrix* block_diagonal) {
   const CompressedRowBlockStructure* block_diagonal_structure =
       block_diagonal->block_structure();
-  for (int r = 0; r < block_diagonal_structure->rows.size(); ++r) {
+  const int num_row_blocks = block_diagonal_structure->rows.size();
+  bool uniform_block_size = true;
+  for (int r = 0; r < num_row_blocks; ++r) {
     const int row_block_pos = block_diagonal_structure->rows[r].block.position;
     const int row_block_size = block_diagonal_structure->rows[r].block.size;
-    const Cell& cell = block_diagonal_structure->rows[r].cells[0];
-    MatrixRef m(block_diagonal->mutable_values() + cell.position,
-                row_block_size,
-                row_block_size);
-
+    uniform_block_size =
+        uniform_block_size &&
+        row_block_size == block_diagonal_structure->rows[0].block.size;
     if (D != NULL) {
+      const Cell& cell = block_diagonal_structure->rows[r].cells[0];
+      MatrixRef m(block_diagonal->mutable_values() + cell.position,
+                  row_block_size,
+                  row_block_size);
       ConstVectorRef d(D + row_block_pos, row_block_size);
       m += d.array().square().matrix().asDiagonal();
     }
+  }
 
+  // The diagonal blocks are stored one after the other, so if they
+  // all have the same size, they can be inverted in one batch.
+  if (num_row_blocks > 0 && uniform_block_size &&
+      InvertPSDMatricesBatched(block_diagonal_structure->rows[0].block.size,
+                               num_row_blocks,
+                               block_diagonal->mutable_values())) {
+    return;
+  }
+
+  for (int r = 0; r < num_row_blocks; ++r) {
+    const int row_block_size = block_diagonal_structure->rows[r].block.size;
+    const Cell& cell = block_diagonal_structure->rows[r].cells[0];
+    MatrixRef m(block_diagonal->mutable_values() + cell.position,
+                row_block_size,
+                row_block_size);
     m = m.selfadjointView<Eigen::Upper>().llt().solve(
         Matrix::Identity(row_block_size, row_block_size));
   }
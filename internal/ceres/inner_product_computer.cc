@@ -32,7 +32,10 @@
 
 #include <algorithm>
 
+#include "ceres/context_impl.h"
+#include "ceres/parallel_for.h"
 #include "ceres/small_blas.h"
+#include "glog/logging.h"
 
 namespace ceres {
 namespace internal {
@@ -63,51 +66,66 @@ CompressedRowSparseMatrix* InnerProductComputer::CreateResultMatrix(
   return matrix;
 }
 
-// Given the set of product terms in the inner product, return the
-// total number of non-zeros in the result and for each row block of
-// the result matrix, compute the number of non-zeros in any one row
-// of the row block.
-int InnerProductComputer::ComputeNonzeros(
-    const std::vector<InnerProductComputer::ProductTerm>& product_terms,
-    std::vector<int>* row_nnz) {
-  const CompressedRowBlockStructure* bs = m_.block_structure();
-  const std::vector<Block>& blocks = bs->cols;
-
-  row_nnz->resize(blocks.size());
-  std::fill(row_nnz->begin(), row_nnz->end(), 0);
-
-  // First product term.
-  (*row_nnz)[product_terms[0].row] = blocks[product_terms[0].col].size;
-  int num_nonzeros =
-      blocks[product_terms[0].row].size * blocks[product_terms[0].col].size;
-
-  // Remaining product terms.
-  for (int i = 1; i < product_terms.size(); ++i) {
-    const ProductTerm& previous = product_terms[i - 1];
-    const ProductTerm& current = product_terms[i];
-
-    // Each (row, col) block counts only once.
-    // This check depends on product sorted on (row, col).
-    if (current.row != previous.row || current.col != previous.col) {
-      (*row_nnz)[current.row] += blocks[current.col].size;
-      num_nonzeros += blocks[current.row].size * blocks[current.col].size;
+void InnerProductComputer::ParallelForEach(
+    const int num_items, const std::function<void(int)>& function) const {
+  if (context_ == NULL || num_threads_ == 1 || num_items <= 1) {
+    for (int i = 0; i < num_items; ++i) {
+      function(i);
     }
+    return;
   }
 
-  return num_nonzeros;
+  ParallelFor(
+      context_, 0, num_items, std::min(num_threads_, num_items), function);
+}
+
+// Sort the terms of each row block of the result on the column block
+// and compute the number of non-zeros in any one row of the row
+// block.
+void InnerProductComputer::SortTermsAndComputeNonzeros(
+    std::vector<int>* row_block_nnz) {
+  const std::vector<Block>& blocks = m_.block_structure()->cols;
+  row_block_nnz->resize(blocks.size());
+
+  ParallelForEach(blocks.size(), [&](const int row_block) {
+    auto begin = product_terms_.begin() + term_offsets_[row_block];
+    auto end = product_terms_.begin() + term_offsets_[row_block + 1];
+    // The terms were added in the order of the row blocks of m, so a
+    // stable sort keeps the products that go into the same column
+    // block in that order.
+    std::stable_sort(
+        begin, end, [](const ProductTerm& left, const ProductTerm& right) {
+          return left.col < right.col;
+        });
+
+    int nnz = 0;
+    for (auto it = begin; it != end; ++it) {
+      // Each (row, col) block counts only once.
+      if (it == begin || it->col != (it - 1)->col) {
+        nnz += blocks[it->col].size;
+      }
+    }
+    (*row_block_nnz)[row_block] = nnz;
+  });
 }
 
 InnerProductComputer::InnerProductComputer(const BlockSparseMatrix& m,
                                            const int start_row_block,
-                                           const int end_row_block)
-    : m_(m), start_row_block_(start_row_block), end_row_block_(end_row_block) {}
+                                           const int end_row_block,
+                                           ContextImpl* context,
+                                           const int num_threads)
+    : m_(m),
+      start_row_block_(start_row_block),
+      end_row_block_(end_row_block),
+      context_(context),
+      num_threads_(num_threads) {}
 
 // Compute the sparsity structure of the product m.transpose() * m
 // and create a CompressedRowSparseMatrix corresponding to it.
 //
-// Also compute the "program" vector, which for every term in the
-// block outer product provides the information for the entry in the
-// values array of the result matrix where it should be accumulated.
+// Also compute the "program", which for every term in the block
+// outer product provides the information for the entry in the values
+// array of the result matrix where it should be accumulated.
 //
 // Since the entries of the program are the same for rows with the
 // same sparsity structure, the program only stores the result for one
@@ -128,60 +146,97 @@ InnerProductComputer* InnerProductComputer::Create(
     const int start_row_block,
     const int end_row_block,
     CompressedRowSparseMatrix::StorageType product_storage_type) {
+  return InnerProductComputer::Create(
+      m, start_row_block, end_row_block, product_storage_type, NULL, 1);
+}
+
+InnerProductComputer* InnerProductComputer::Create(
+    const BlockSparseMatrix& m,
+    const int start_row_block,
+    const int end_row_block,
+    CompressedRowSparseMatrix::StorageType product_storage_type,
+    ContextImpl* context,
+    const int num_threads) {
   CHECK(product_storage_type == CompressedRowSparseMatrix::LOWER_TRIANGULAR ||
         product_storage_type == CompressedRowSparseMatrix::UPPER_TRIANGULAR);
   CHECK_GT(m.num_nonzeros(), 0)
       << "Congratulations, you found a bug in Ceres. Please report it.";
-  InnerProductComputer* inner_product_computer =
-      new InnerProductComputer(m, start_row_block, end_row_block);
+  CHECK_GE(num_threads, 1);
+  InnerProductComputer* inner_product_computer = new InnerProductComputer(
+      m, start_row_block, end_row_block, context, num_threads);
   inner_product_computer->Init(product_storage_type);
   return inner_product_computer;
 }
 
 void InnerProductComputer::Init(
     const CompressedRowSparseMatrix::StorageType product_storage_type) {
-  std::vector<InnerProductComputer::ProductTerm> product_terms;
   const CompressedRowBlockStructure* bs = m_.block_structure();
 
   // Give input matrix m in Block Sparse format
   //     (row_block, col_block)
   // represent each block multiplication
   //     (row_block, col_block1)' X (row_block, col_block2)
-  // by its product term:
-  //     (col_block1, col_block2, index)
-  for (int row_block = start_row_block_; row_block < end_row_block_;
-       ++row_block) {
-    const CompressedRow& row = bs->rows[row_block];
-    for (int c1 = 0; c1 < row.cells.size(); ++c1) {
-      const Cell& cell1 = row.cells[c1];
-      int c2_begin, c2_end;
-      if (product_storage_type == CompressedRowSparseMatrix::LOWER_TRIANGULAR) {
-        c2_begin = 0;
-        c2_end = c1 + 1;
-      } else {
-        c2_begin = c1;
-        c2_end = row.cells.size();
-      }
-
-      for (int c2 = c2_begin; c2 < c2_end; ++c2) {
-        const Cell& cell2 = row.cells[c2];
-        product_terms.push_back(InnerProductComputer::ProductTerm(
-            cell1.block_id, cell2.block_id, product_terms.size()));
+  // by a product term in row block col_block1 of the result, which
+  // is stored in product_terms_ as
+  //     (col_block2, row_block, cell1, cell2)
+  //
+  // The terms are bucketed by the row block of the result using a
+  // counting sort. The first pass counts the terms of each row block
+  // and the second one places them.
+  auto for_each_term = [this, bs, product_storage_type](
+                           const std::function<void(int, int, int)>& f) {
+    for (int row_block = start_row_block_; row_block < end_row_block_;
+         ++row_block) {
+      const CompressedRow& row = bs->rows[row_block];
+      for (int c1 = 0; c1 < row.cells.size(); ++c1) {
+        int c2_begin, c2_end;
+        if (product_storage_type ==
+            CompressedRowSparseMatrix::LOWER_TRIANGULAR) {
+          c2_begin = 0;
+          c2_end = c1 + 1;
+        } else {
+          c2_begin = c1;
+          c2_end = row.cells.size();
+        }
+
+        for (int c2 = c2_begin; c2 < c2_end; ++c2) {
+          f(row_block, c1, c2);
+        }
       }
     }
+  };
+
+  term_offsets_.assign(bs->cols.size() + 1, 0);
+  for_each_term([this, bs](int row_block, int c1, int c2) {
+    ++term_offsets_[bs->rows[row_block].cells[c1].block_id + 1];
+  });
+  for (int i = 0; i < bs->cols.size(); ++i) {
+    term_offsets_[i + 1] += term_offsets_[i];
   }
 
-  std::sort(product_terms.begin(), product_terms.end());
-  ComputeOffsetsAndCreateResultMatrix(product_storage_type, product_terms);
+  std::vector<int> next_term(term_offsets_.begin(), term_offsets_.end() - 1);
+  product_terms_.clear();
+  product_terms_.resize(term_offsets_.back(), ProductTerm(0, 0, 0, 0));
+  for_each_term([this, bs, &next_term](int row_block, int c1, int c2) {
+    const CompressedRow& row = bs->rows[row_block];
+    product_terms_[next_term[row.cells[c1].block_id]++] =
+        ProductTerm(row.cells[c2].block_id, row_block, c1, c2);
+  });
+
+  ComputeOffsetsAndCreateResultMatrix(product_storage_type);
 }
 
 void InnerProductComputer::ComputeOffsetsAndCreateResultMatrix(
-    const CompressedRowSparseMatrix::StorageType product_storage_type,
-    const std::vector<InnerProductComputer::ProductTerm>& product_terms) {
+    const CompressedRowSparseMatrix::StorageType product_storage_type) {
   const std::vector<Block>& col_blocks = m_.block_structure()->cols;
 
   std::vector<int> row_block_nnz;
-  const int num_nonzeros = ComputeNonzeros(product_terms, &row_block_nnz);
+  SortTermsAndComputeNonzeros(&row_block_nnz);
+
+  int num_nonzeros = 0;
+  for (int i = 0; i < col_blocks.size(); ++i) {
+    num_nonzeros += row_block_nnz[i] * col_blocks[i].size;
+  }
 
   result_.reset(CreateResultMatrix(product_storage_type, num_nonzeros));
 
@@ -194,18 +249,10 @@ void InnerProductComputer::ComputeOffsetsAndCreateResultMatrix(
     }
   }
 
-  // The following macro FILL_CRSM_COL_BLOCK is key to understanding
-  // how this class works.
-  //
-  // It does two things.
-  //
-  // Sets the value for the current term in the result_offsets_ array
-  // and populates the cols array of the result matrix.
+  // For each row block of the result, set the offset of each term and
+  // populate the cols array of the result matrix.
   //
-  // row_block and col_block as the names imply, refer to the row and
-  // column blocks of the current term.
-  //
-  // row_nnz is the number of nonzeros in the result_matrix at the
+  // nnz is the number of nonzeros in the result matrix at the
   // beginning of the first row of row_block.
   //
   // col_nnz is the number of nonzeros in the first row of the row
@@ -226,106 +273,75 @@ void InnerProductComputer::ComputeOffsetsAndCreateResultMatrix(
   //
   // col_blocks[col_block].position + k, which is the column number of
   // the k^th column of the current column block.
-#define FILL_CRSM_COL_BLOCK                                \
-  const int row_block = current->row;                      \
-  const int col_block = current->col;                      \
-  const int nnz_in_row = row_block_nnz[row_block];         \
-  int* crsm_cols = result_->mutable_cols();                \
-  result_offsets_[current->index] = nnz + col_nnz;         \
-  for (int j = 0; j < col_blocks[row_block].size; ++j) {   \
-    for (int k = 0; k < col_blocks[col_block].size; ++k) { \
-      crsm_cols[nnz + j * nnz_in_row + col_nnz + k] =      \
-          col_blocks[col_block].position + k;              \
-    }                                                      \
-  }
-
-  result_offsets_.resize(product_terms.size());
-  int col_nnz = 0;
-  int nnz = 0;
-
-  // Process the first term.
-  const InnerProductComputer::ProductTerm* current = &product_terms[0];
-  FILL_CRSM_COL_BLOCK;
-
-  // Process the rest of the terms.
-  for (int i = 1; i < product_terms.size(); ++i) {
-    current = &product_terms[i];
-    const InnerProductComputer::ProductTerm* previous = &product_terms[i - 1];
-
-    // If the current term is the same as the previous term, then it
-    // stores its product at the same location as the previous term.
-    if (previous->row == current->row && previous->col == current->col) {
-      result_offsets_[current->index] = result_offsets_[previous->index];
-      continue;
-    }
+  const int* rows = result_->rows();
+  int* crsm_cols = result_->mutable_cols();
+  ParallelForEach(col_blocks.size(), [&](const int row_block) {
+    const int nnz = rows[col_blocks[row_block].position];
+    const int nnz_in_row = row_block_nnz[row_block];
+    int col_nnz = 0;
+    for (int i = term_offsets_[row_block]; i < term_offsets_[row_block + 1];
+         ++i) {
+      ProductTerm& current = product_terms_[i];
+      if (i > term_offsets_[row_block]) {
+        const ProductTerm& previous = product_terms_[i - 1];
+        // If the current term is in the same column block as the
+        // previous term, then it stores its product at the same
+        // location as the previous term.
+        if (previous.col == current.col) {
+          current.offset = previous.offset;
+          continue;
+        }
+        col_nnz += col_blocks[previous.col].size;
+      }
 
-    if (previous->row == current->row) {
-      // if the current and previous terms are in the same row block,
-      // then they differ in the column block, in which case advance
-      // col_nnz by the column size of the prevous term.
-      col_nnz += col_blocks[previous->col].size;
-    } else {
-      // If we have moved to a new row-block , then col_nnz is zero,
-      // and nnz is set to the beginning of the row block.
-      col_nnz = 0;
-      nnz += row_block_nnz[previous->row] * col_blocks[previous->row].size;
+      const int col_block = current.col;
+      current.offset = nnz + col_nnz;
+      for (int j = 0; j < col_blocks[row_block].size; ++j) {
+        for (int k = 0; k < col_blocks[col_block].size; ++k) {
+          crsm_cols[nnz + j * nnz_in_row + col_nnz + k] =
+              col_blocks[col_block].position + k;
+        }
+      }
     }
-
-    FILL_CRSM_COL_BLOCK;
-  }
+  });
 }
 
-// Use the results_offsets_ array to numerically compute the product
-// m' * m and store it in result_.
-//
-// TODO(sameeragarwal): Multithreading support.
+// Use the product_terms_ array to numerically compute the product
+// m' * m and store it in result_. Each row block of the result is
+// zeroed and then accumulated by a single thread.
 void InnerProductComputer::Compute() {
   const double* m_values = m_.values();
   const CompressedRowBlockStructure* bs = m_.block_structure();
 
-  const CompressedRowSparseMatrix::StorageType storage_type =
-      result_->storage_type();
-  result_->SetZero();
   double* values = result_->mutable_values();
   const int* rows = result_->rows();
-  int cursor = 0;
-
-  // Iterate row blocks.
-  for (int r = start_row_block_; r < end_row_block_; ++r) {
-    const CompressedRow& m_row = bs->rows[r];
-    for (int c1 = 0; c1 < m_row.cells.size(); ++c1) {
-      const Cell& cell1 = m_row.cells[c1];
-      const int c1_size = bs->cols[cell1.block_id].size;
-      const int row_nnz = rows[bs->cols[cell1.block_id].position + 1] -
-                          rows[bs->cols[cell1.block_id].position];
-
-      int c2_begin, c2_end;
-      if (storage_type == CompressedRowSparseMatrix::LOWER_TRIANGULAR) {
-        c2_begin = 0;
-        c2_end = c1 + 1;
-      } else {
-        c2_begin = c1;
-        c2_end = m_row.cells.size();
-      }
 
-      for (int c2 = c2_begin; c2 < c2_end; ++c2, ++cursor) {
-        const Cell& cell2 = m_row.cells[c2];
-        const int c2_size = bs->cols[cell2.block_id].size;
-        // clang-format off
-        MatrixTransposeMatrixMultiply<Eigen::Dynamic, Eigen::Dynamic,
-                                      Eigen::Dynamic, Eigen::Dynamic, 1>(
-                                          m_values + cell1.position,
-                                          m_row.block.size, c1_size,
-                                          m_values + cell2.position,
-                                          m_row.block.size, c2_size,
-                                          values + result_offsets_[cursor],
-                                          0, 0, c1_size, row_nnz);
-        // clang-format on
-      }
+  ParallelForEach(bs->cols.size(), [&](const int row_block) {
+    const Block& block = bs->cols[row_block];
+    const int row_nnz = rows[block.position + 1] - rows[block.position];
+    std::fill(values + rows[block.position],
+              values + rows[block.position + block.size],
+              0.0);
+
+    for (int i = term_offsets_[row_block]; i < term_offsets_[row_block + 1];
+         ++i) {
+      const ProductTerm& term = product_terms_[i];
+      const CompressedRow& m_row = bs->rows[term.row_block];
+      const Cell& cell1 = m_row.cells[term.cell1];
+      const Cell& cell2 = m_row.cells[term.cell2];
+      const int c2_size = bs->cols[cell2.block_id].size;
+      // clang-format off
+      MatrixTransposeMatrixMultiply<Eigen::Dynamic, Eigen::Dynamic,
+                                    Eigen::Dynamic, Eigen::Dynamic, 1>(
+                                        m_values + cell1.position,
+                                        m_row.block.size, block.size,
+                                        m_values + cell2.position,
+                                        m_row.block.size, c2_size,
+                                        values + term.offset,
+                                        0, 0, block.size, row_nnz);
+      // clang-format on
     }
-  }
-
-  CHECK_EQ(cursor, result_offsets_.size());
+  });
 }
 
 }  // namespace internal
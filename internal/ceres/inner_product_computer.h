@@ -31,6 +31,7 @@
 #ifndef CERES_INTERNAL_INNER_PRODUCT_COMPUTER_H_
 #define CERES_INTERNAL_INNER_PRODUCT_COMPUTER_H_
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -41,6 +42,8 @@
 namespace ceres {
 namespace internal {
 
+class ContextImpl;
+
 // This class is used to repeatedly compute the inner product
 //
 //   result = m' * m
@@ -61,6 +64,12 @@ namespace internal {
 // This is not a problem as sparse linear algebra libraries can ignore
 // these entries with ease and the space used is minimal/linear in the
 // size of the matrices.
+//
+// If created with a context and num_threads > 1, both the symbolic
+// analysis in Create and the numeric product in Compute are
+// multithreaded. Each row block of the result is computed by a single
+// thread, so there are no write conflicts, and the result is
+// identical to the single threaded one.
 class CERES_EXPORT_INTERNAL InnerProductComputer {
  public:
   // Factory
@@ -89,6 +98,17 @@ class CERES_EXPORT_INTERNAL InnerProductComputer {
       int end_row_block,
       CompressedRowSparseMatrix::StorageType storage_type);
 
+  // Same as above, but Create and Compute use up to num_threads
+  // threads from context. context may be NULL, in which case
+  // everything is done on the calling thread.
+  static InnerProductComputer* Create(
+      const BlockSparseMatrix& m,
+      int start_row_block,
+      int end_row_block,
+      CompressedRowSparseMatrix::StorageType storage_type,
+      ContextImpl* context,
+      int num_threads);
+
   // Update result_ to be numerically equal to m' * m.
   void Compute();
 
@@ -101,29 +121,32 @@ class CERES_EXPORT_INTERNAL InnerProductComputer {
 
  private:
   // A ProductTerm is a term in the block inner product of a matrix
-  // with itself.
+  // with itself, i.e., the product of the cells cell1 and cell2 of
+  // row block row_block of m. The row block of the result it
+  // contributes to is implied by the position of the term in
+  // product_terms_.
   struct ProductTerm {
-    ProductTerm(const int row, const int col, const int index)
-        : row(row), col(col), index(index) {}
-
-    bool operator<(const ProductTerm& right) const {
-      if (row == right.row) {
-        if (col == right.col) {
-          return index < right.index;
-        }
-        return col < right.col;
-      }
-      return row < right.row;
-    }
-
-    int row;
+    ProductTerm(const int col,
+                const int row_block,
+                const int cell1,
+                const int cell2)
+        : col(col), row_block(row_block), cell1(cell1), cell2(cell2) {}
+
+    // Column block of the result.
     int col;
-    int index;
+    int row_block;
+    int cell1;
+    int cell2;
+    // Location in the values array of result_ where the product is
+    // accumulated.
+    int offset = -1;
   };
 
   InnerProductComputer(const BlockSparseMatrix& m,
                        int start_row_block,
-                       int end_row_block);
+                       int end_row_block,
+                       ContextImpl* context,
+                       int num_threads);
 
   void Init(CompressedRowSparseMatrix::StorageType storage_type);
 
@@ -131,25 +154,35 @@ class CERES_EXPORT_INTERNAL InnerProductComputer {
       const CompressedRowSparseMatrix::StorageType storage_type,
       int num_nonzeros);
 
-  int ComputeNonzeros(const std::vector<ProductTerm>& product_terms,
-                      std::vector<int>* row_block_nnz);
+  // Sorts the terms of each row block of the result by column and
+  // computes the number of non-zeros in any one row of it.
+  void SortTermsAndComputeNonzeros(std::vector<int>* row_block_nnz);
 
   void ComputeOffsetsAndCreateResultMatrix(
-      const CompressedRowSparseMatrix::StorageType storage_type,
-      const std::vector<ProductTerm>& product_terms);
+      const CompressedRowSparseMatrix::StorageType storage_type);
+
+  // Calls function(i) for i in [0, num_items), using up to
+  // num_threads_ threads.
+  void ParallelForEach(int num_items,
+                       const std::function<void(int)>& function) const;
 
   const BlockSparseMatrix& m_;
   const int start_row_block_;
   const int end_row_block_;
+  ContextImpl* context_;
+  const int num_threads_;
   std::unique_ptr<CompressedRowSparseMatrix> result_;
 
-  // For each term in the inner product, result_offsets_ contains the
-  // location in the values array of the result_ matrix where it
-  // should be stored.
+  // The terms of the inner product, grouped by the row block of the
+  // result they contribute to. The terms of row block i of the result
+  // are product_terms_[term_offsets_[i] : term_offsets_[i + 1]],
+  // sorted by column block and within a column block in the order
+  // of the row blocks of m.
   //
   // This is the principal look up table that allows this class to
   // compute the inner product fast.
-  std::vector<int> result_offsets_;
+  std::vector<ProductTerm> product_terms_;
+  std::vector<int> term_offsets_;
 };
 
 }  // namespace internal
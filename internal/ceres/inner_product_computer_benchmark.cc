@@ -0,0 +1,139 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "ceres/block_sparse_matrix.h"
+#include "ceres/block_structure.h"
+#include "ceres/compressed_row_sparse_matrix.h"
+#include "ceres/context_impl.h"
+#include "ceres/inner_product_computer.h"
+#include "ceres/random.h"
+
+namespace ceres {
+namespace internal {
+
+constexpr int kRowBlockSize = 2;
+constexpr int kPointBlockSize = 3;
+constexpr int kCameraBlockSize = 9;
+constexpr int kNumCameras = 100;
+constexpr int kObservationsPerPoint = 8;
+
+// A Jacobian with the structure of a bundle adjustment problem, where
+// each point is observed by kObservationsPerPoint random cameras.
+std::unique_ptr<BlockSparseMatrix> CreateBundleAdjustmentJacobian(
+    const int num_points) {
+  CompressedRowBlockStructure* bs = new CompressedRowBlockStructure;
+  bs->cols.resize(num_points + kNumCameras);
+  int col_pos = 0;
+  for (int i = 0; i < bs->cols.size(); ++i) {
+    bs->cols[i].position = col_pos;
+    bs->cols[i].size = i < num_points ? kPointBlockSize : kCameraBlockSize;
+    col_pos += bs->cols[i].size;
+  }
+
+  SetRandomState(5);
+  bs->rows.resize(num_points * kObservationsPerPoint);
+  int row_pos = 0;
+  int cell_pos = 0;
+  for (int i = 0; i < bs->rows.size(); ++i) {
+    CompressedRow& row = bs->rows[i];
+    row.block.position = row_pos;
+    row.block.size = kRowBlockSize;
+    row_pos += kRowBlockSize;
+    row.cells.resize(2);
+    row.cells[0].block_id = i / kObservationsPerPoint;
+    row.cells[0].position = cell_pos;
+    cell_pos += kRowBlockSize * kPointBlockSize;
+    row.cells[1].block_id = num_points + Uniform(kNumCameras);
+    row.cells[1].position = cell_pos;
+    cell_pos += kRowBlockSize * kCameraBlockSize;
+  }
+
+  std::unique_ptr<BlockSparseMatrix> jacobian(new BlockSparseMatrix(bs));
+  double* values = jacobian->mutable_values();
+  for (int i = 0; i < jacobian->num_nonzeros(); ++i) {
+    values[i] = RandNormal();
+  }
+  return jacobian;
+}
+
+void BM_InnerProductComputerCreate(benchmark::State& state) {
+  const int num_points = state.range(0);
+  const int num_threads = state.range(1);
+  std::unique_ptr<BlockSparseMatrix> jacobian =
+      CreateBundleAdjustmentJacobian(num_points);
+  ContextImpl context;
+  context.EnsureMinimumThreads(num_threads);
+  for (auto _ : state) {
+    std::unique_ptr<InnerProductComputer> inner_product_computer(
+        InnerProductComputer::Create(
+            *jacobian,
+            0,
+            jacobian->block_structure()->rows.size(),
+            CompressedRowSparseMatrix::LOWER_TRIANGULAR,
+            &context,
+            num_threads));
+    benchmark::DoNotOptimize(inner_product_computer.get());
+  }
+}
+
+void BM_InnerProductComputerCompute(benchmark::State& state) {
+  const int num_points = state.range(0);
+  const int num_threads = state.range(1);
+  std::unique_ptr<BlockSparseMatrix> jacobian =
+      CreateBundleAdjustmentJacobian(num_points);
+  ContextImpl context;
+  context.EnsureMinimumThreads(num_threads);
+  std::unique_ptr<InnerProductComputer> inner_product_computer(
+      InnerProductComputer::Create(*jacobian,
+                                   0,
+                                   jacobian->block_structure()->rows.size(),
+                                   CompressedRowSparseMatrix::LOWER_TRIANGULAR,
+                                   &context,
+                                   num_threads));
+  for (auto _ : state) {
+    inner_product_computer->Compute();
+  }
+  state.counters["nnz"] = jacobian->num_nonzeros();
+}
+
+BENCHMARK(BM_InnerProductComputerCreate)
+    ->ArgsProduct({{1000, 10000, 100000}, {1, 2, 4, 8}})
+    ->UseRealTime();
+BENCHMARK(BM_InnerProductComputerCompute)
+    ->ArgsProduct({{1000, 10000, 100000}, {1, 2, 4, 8}})
+    ->UseRealTime();
+
+}  // namespace internal
+}  // namespace ceres
+
+BENCHMARK_MAIN();
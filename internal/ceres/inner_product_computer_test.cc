@@ -35,6 +35,7 @@
 
 #include "Eigen/SparseCore"
 #include "ceres/block_sparse_matrix.h"
+#include "ceres/context_impl.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/random.h"
 #include "ceres/triplet_sparse_matrix.h"
@@ -219,6 +220,57 @@ TEST(InnerProductComputer, SubMatrix) {
   }
 }
 
+TEST(InnerProductComputer, MultithreadedMatchesSingleThreaded) {
+  // "Randomly generated seed."
+  SetRandomState(29823);
+  BlockSparseMatrix::RandomMatrixOptions options;
+  options.num_row_blocks = 200;
+  options.num_col_blocks = 50;
+  options.min_row_block_size = 1;
+  options.max_row_block_size = 5;
+  options.min_col_block_size = 1;
+  options.max_col_block_size = 10;
+  options.block_density = 0.2;
+  std::unique_ptr<BlockSparseMatrix> random_matrix(
+      BlockSparseMatrix::CreateRandomMatrix(options));
+  const int num_row_blocks = random_matrix->block_structure()->rows.size();
+
+  const int kNumThreads = 4;
+  ContextImpl context;
+  context.EnsureMinimumThreads(kNumThreads);
+
+  for (const CompressedRowSparseMatrix::StorageType storage_type :
+       {CompressedRowSparseMatrix::LOWER_TRIANGULAR,
+        CompressedRowSparseMatrix::UPPER_TRIANGULAR}) {
+    std::unique_ptr<InnerProductComputer> expected(
+        InnerProductComputer::Create(*random_matrix, storage_type));
+    expected->Compute();
+    const CompressedRowSparseMatrix& e = expected->result();
+
+    std::unique_ptr<InnerProductComputer> actual(
+        InnerProductComputer::Create(*random_matrix,
+                                     0,
+                                     num_row_blocks,
+                                     storage_type,
+                                     &context,
+                                     kNumThreads));
+    // Compute twice, to check that the result is reset between calls.
+    actual->Compute();
+    actual->Compute();
+    const CompressedRowSparseMatrix& a = actual->result();
+
+    ASSERT_EQ(a.num_rows(), e.num_rows());
+    ASSERT_EQ(a.num_nonzeros(), e.num_nonzeros());
+    for (int i = 0; i <= e.num_rows(); ++i) {
+      EXPECT_EQ(a.rows()[i], e.rows()[i]);
+    }
+    for (int i = 0; i < e.num_nonzeros(); ++i) {
+      EXPECT_EQ(a.cols()[i], e.cols()[i]);
+      EXPECT_EQ(a.values()[i], e.values()[i]);
+    }
+  }
+}
+
 #undef COMPUTE_AND_COMPARE
 }  // namespace internal
 }  // namespace ceres
@@ -31,6 +31,9 @@
 #ifndef CERES_INTERNAL_INVERT_PSD_MATRIX_H_
 #define CERES_INTERNAL_INVERT_PSD_MATRIX_H_
 
+#include <algorithm>
+#include <cmath>
+
 #include "Eigen/Dense"
 #include "ceres/internal/eigen.h"
 #include "glog/logging.h"
@@ -73,6 +76,190 @@ typename EigenTypes<kSize, kSize>::Matrix InvertPSDMatrix(
   return svd.solve(MType::Identity(size, size));
 }
 
+// The number of matrices that InvertPSDMatricesBatched inverts
+// together. The entries of these matrices are interleaved, so that
+// every arithmetic operation in the factorization is applied to the
+// same entry of all of them at once, which the compiler maps to SIMD
+// instructions.
+static constexpr int kInvertPSDMatricesBatchSize = 8;
+
+// Invert num_matrices symmetric positive definite matrices of size
+// kSize x kSize in place. The matrices are stored one after the other
+// in values, each in row-major order, and must be stored in full. This
+// is the same computation as calling InvertPSDMatrix with
+// assume_full_rank = true on each of them.
+//
+// Like InvertPSDMatrix, matrices smaller than 5 x 5 are inverted one
+// at a time using Eigen's closed form inverse, which is faster than
+// any factorization. Larger matrices are inverted in batches via the
+// Cholesky factorization A = U'U as A^{-1} = U^{-1} U^{-T}, without
+// pivoting. If num_matrices is not a multiple of
+// kInvertPSDMatricesBatchSize, the last batch is padded with identity
+// matrices.
+template <int kSize>
+void InvertPSDMatricesBatched(const int num_matrices, double* values) {
+  static_assert(kSize > 0, "kSize must be a positive integer.");
+  constexpr int kNumLanes = kInvertPSDMatricesBatchSize;
+  constexpr int kMatrixSize = kSize * kSize;
+
+  if (kSize < 5) {
+    using MatrixType = typename EigenTypes<kSize, kSize>::Matrix;
+    for (int i = 0; i < num_matrices; ++i) {
+      Eigen::Map<MatrixType> m(values + i * kMatrixSize);
+      const MatrixType inverse = m.inverse();
+      m = inverse;
+    }
+    return;
+  }
+
+  // a[(i * kSize + j) * kNumLanes + lane] is the (i, j) entry of the
+  // lane^th matrix in the batch.
+  alignas(64) double a[kMatrixSize * kNumLanes];
+  alignas(64) double inverse_diagonal[kSize * kNumLanes];
+
+  for (int start = 0; start < num_matrices; start += kNumLanes) {
+    const int num_lanes = std::min(kNumLanes, num_matrices - start);
+    double* batch = values + start * kMatrixSize;
+
+    // Interleave the upper triangles of the matrices in this batch. If
+    // the batch is only partially filled, pad it with identity
+    // matrices.
+    if (num_lanes < kNumLanes) {
+      for (int i = 0; i < kSize; ++i) {
+        for (int j = i; j < kSize; ++j) {
+          for (int lane = num_lanes; lane < kNumLanes; ++lane) {
+            a[(i * kSize + j) * kNumLanes + lane] = (i == j) ? 1.0 : 0.0;
+          }
+        }
+      }
+    }
+    for (int lane = 0; lane < num_lanes; ++lane) {
+      const double* m = batch + lane * kMatrixSize;
+      for (int i = 0; i < kSize; ++i) {
+        for (int j = i; j < kSize; ++j) {
+          a[(i * kSize + j) * kNumLanes + lane] = m[i * kSize + j];
+        }
+      }
+    }
+
+    // Overwrite the upper triangle with U, where A = U'U, and record
+    // the inverse of its diagonal.
+    for (int k = 0; k < kSize; ++k) {
+      double* a_kk = a + (k * kSize + k) * kNumLanes;
+      double* d_k = inverse_diagonal + k * kNumLanes;
+      for (int p = 0; p < k; ++p) {
+        const double* u_pk = a + (p * kSize + k) * kNumLanes;
+        for (int lane = 0; lane < kNumLanes; ++lane) {
+          a_kk[lane] -= u_pk[lane] * u_pk[lane];
+        }
+      }
+      for (int lane = 0; lane < kNumLanes; ++lane) {
+        a_kk[lane] = std::sqrt(a_kk[lane]);
+        d_k[lane] = 1.0 / a_kk[lane];
+      }
+
+      for (int j = k + 1; j < kSize; ++j) {
+        double* a_kj = a + (k * kSize + j) * kNumLanes;
+        for (int p = 0; p < k; ++p) {
+          const double* u_pk = a + (p * kSize + k) * kNumLanes;
+          const double* u_pj = a + (p * kSize + j) * kNumLanes;
+          for (int lane = 0; lane < kNumLanes; ++lane) {
+            a_kj[lane] -= u_pk[lane] * u_pj[lane];
+          }
+        }
+        for (int lane = 0; lane < kNumLanes; ++lane) {
+          a_kj[lane] *= d_k[lane];
+        }
+      }
+    }
+
+    // Overwrite U with W = U^{-1}, one column at a time from the last
+    // column to the first, and within each column from the diagonal
+    // upwards. This order ensures that the entries of U needed for
+    // column j have not been overwritten yet.
+    for (int j = kSize - 1; j >= 0; --j) {
+      for (int lane = 0; lane < kNumLanes; ++lane) {
+        a[(j * kSize + j) * kNumLanes + lane] =
+            inverse_diagonal[j * kNumLanes + lane];
+      }
+      for (int i = j - 1; i >= 0; --i) {
+        double* w_ij = a + (i * kSize + j) * kNumLanes;
+        double sum[kNumLanes] = {0.0};
+        for (int p = i + 1; p <= j; ++p) {
+          const double* u_ip = a + (i * kSize + p) * kNumLanes;
+          const double* w_pj = a + (p * kSize + j) * kNumLanes;
+          for (int lane = 0; lane < kNumLanes; ++lane) {
+            sum[lane] += u_ip[lane] * w_pj[lane];
+          }
+        }
+        for (int lane = 0; lane < kNumLanes; ++lane) {
+          w_ij[lane] = -sum[lane] * inverse_diagonal[i * kNumLanes + lane];
+        }
+      }
+    }
+
+    // A^{-1} = W W'. Since W is upper triangular, the (i, j) entry for
+    // i <= j is the dot product of rows i and j of W starting at
+    // column j.
+    for (int i = 0; i < kSize; ++i) {
+      for (int j = i; j < kSize; ++j) {
+        double sum[kNumLanes] = {0.0};
+        for (int p = j; p < kSize; ++p) {
+          const double* w_ip = a + (i * kSize + p) * kNumLanes;
+          const double* w_jp = a + (j * kSize + p) * kNumLanes;
+          for (int lane = 0; lane < kNumLanes; ++lane) {
+            sum[lane] += w_ip[lane] * w_jp[lane];
+          }
+        }
+        for (int lane = 0; lane < num_lanes; ++lane) {
+          batch[lane * kMatrixSize + i * kSize + j] = sum[lane];
+          batch[lane * kMatrixSize + j * kSize + i] = sum[lane];
+        }
+      }
+    }
+  }
+}
+
+// Same as InvertPSDMatricesBatched<kSize>, with the matrix size
+// specified at runtime. Returns false, without modifying values, if
+// there is no batched kernel for matrices of this size, in which case
+// the caller should fall back to InvertPSDMatrix.
+inline bool InvertPSDMatricesBatched(const int size,
+                                     const int num_matrices,
+                                     double* values) {
+  switch (size) {
+    case 1:
+      InvertPSDMatricesBatched<1>(num_matrices, values);
+      return true;
+    case 2:
+      InvertPSDMatricesBatched<2>(num_matrices, values);
+      return true;
+    case 3:
+      InvertPSDMatricesBatched<3>(num_matrices, values);
+      return true;
+    case 4:
+      InvertPSDMatricesBatched<4>(num_matrices, values);
+      return true;
+    case 5:
+      InvertPSDMatricesBatched<5>(num_matrices, values);
+      return true;
+    case 6:
+      InvertPSDMatricesBatched<6>(num_matrices, values);
+      return true;
+    case 7:
+      InvertPSDMatricesBatched<7>(num_matrices, values);
+      return true;
+    case 8:
+      InvertPSDMatricesBatched<8>(num_matrices, values);
+      return true;
+    case 9:
+      InvertPSDMatricesBatched<9>(num_matrices, values);
+      return true;
+    default:
+      return false;
+  }
+}
+
 }  // namespace internal
 }  // namespace ceres
 
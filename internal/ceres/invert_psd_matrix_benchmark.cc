@@ -28,6 +28,8 @@
 //
 // Authors: sameeragarwal@google.com (Sameer Agarwal)
 
+#include <vector>
+
 #include "Eigen/Dense"
 #include "benchmark/benchmark.h"
 #include "ceres/invert_psd_matrix.h"
@@ -84,6 +86,62 @@ BENCHMARK(BenchmarkDynamicallyInvertPSDMatrix)
       }
     });
 
+// Fill values with num_matrices random symmetric positive definite
+// kSize x kSize matrices.
+template <int kSize>
+std::vector<double> RandomPSDMatrices(const int num_matrices) {
+  using MatrixType = typename EigenTypes<kSize, kSize>::Matrix;
+  std::vector<double> values(num_matrices * kSize * kSize);
+  for (int i = 0; i < num_matrices; ++i) {
+    MatrixType m = MatrixType::Random();
+    Eigen::Map<MatrixType>(values.data() + i * kSize * kSize) =
+        m * m.transpose() + MatrixType::Identity();
+  }
+  return values;
+}
+
+// Invert state.range(0) matrices one at a time. The matrices are
+// inverted in place, so each iteration alternates between the
+// matrices and their inverses.
+template <int kSize>
+void BenchmarkInvertPSDMatricesOneAtATime(benchmark::State& state) {
+  using MatrixType = typename EigenTypes<kSize, kSize>::Matrix;
+  const int num_matrices = state.range(0);
+  std::vector<double> values = RandomPSDMatrices<kSize>(num_matrices);
+  constexpr bool kAssumeFullRank = true;
+  for (auto _ : state) {
+    for (int i = 0; i < num_matrices; ++i) {
+      Eigen::Map<MatrixType> m(values.data() + i * kSize * kSize);
+      m = InvertPSDMatrix<kSize>(kAssumeFullRank, m);
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_matrices);
+}
+
+// Same as above, using InvertPSDMatricesBatched.
+template <int kSize>
+void BenchmarkInvertPSDMatricesBatched(benchmark::State& state) {
+  const int num_matrices = state.range(0);
+  std::vector<double> values = RandomPSDMatrices<kSize>(num_matrices);
+  for (auto _ : state) {
+    InvertPSDMatricesBatched<kSize>(num_matrices, values.data());
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_matrices);
+}
+
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesOneAtATime, 2)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesBatched, 2)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesOneAtATime, 3)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesBatched, 3)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesOneAtATime, 4)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesBatched, 4)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesOneAtATime, 6)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesBatched, 6)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesOneAtATime, 9)->Arg(4096);
+BENCHMARK_TEMPLATE(BenchmarkInvertPSDMatricesBatched, 9)->Arg(4096);
+
 }  // namespace internal
 }  // namespace ceres
 
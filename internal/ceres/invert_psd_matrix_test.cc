@@ -30,6 +30,9 @@
 
 #include "ceres/invert_psd_matrix.h"
 
+#include <limits>
+#include <vector>
+
 #include "ceres/internal/eigen.h"
 #include "gtest/gtest.h"
 
@@ -109,5 +112,61 @@ TEST(InvertPSDMatrix, DynamicRankDeficient5x5) {
               10 * std::numeric_limits<double>::epsilon());
 }
 
+// Invert num_matrices random well conditioned PSD matrices using
+// InvertPSDMatricesBatched and compare the result to InvertPSDMatrix.
+template <int kSize>
+void VerifyBatchedInversion(const int num_matrices) {
+  constexpr int kMatrixSize = kSize * kSize;
+  std::vector<double> values(num_matrices * kMatrixSize);
+  std::vector<Matrix> expected(num_matrices);
+  for (int i = 0; i < num_matrices; ++i) {
+    EigenTypes<Eigen::Dynamic>::Vector eigenvalues(kSize);
+    eigenvalues.setRandom();
+    eigenvalues = eigenvalues.array().abs().matrix();
+    eigenvalues.array() += 1.0;
+    const Matrix m =
+        RandomPSDMatrixWithEigenValues<Eigen::Dynamic>(eigenvalues);
+    expected[i] = InvertPSDMatrix<Eigen::Dynamic>(kFullRank, m);
+    MatrixRef(values.data() + i * kMatrixSize, kSize, kSize) = m;
+  }
+
+  InvertPSDMatricesBatched<kSize>(num_matrices, values.data());
+  for (int i = 0; i < num_matrices; ++i) {
+    ConstMatrixRef actual(values.data() + i * kMatrixSize, kSize, kSize);
+    EXPECT_NEAR((actual - expected[i]).norm() / expected[i].norm(),
+                0.0,
+                100 * std::numeric_limits<double>::epsilon())
+        << "Matrix: " << i;
+  }
+}
+
+TEST(InvertPSDMatricesBatched, MatchesInvertPSDMatrix) {
+  // 19 is not a multiple of kInvertPSDMatricesBatchSize, so the last
+  // batch is partially filled.
+  const int kNumMatrices = 19;
+  VerifyBatchedInversion<1>(kNumMatrices);
+  VerifyBatchedInversion<2>(kNumMatrices);
+  VerifyBatchedInversion<3>(kNumMatrices);
+  VerifyBatchedInversion<4>(kNumMatrices);
+  VerifyBatchedInversion<5>(kNumMatrices);
+  VerifyBatchedInversion<6>(kNumMatrices);
+  VerifyBatchedInversion<7>(kNumMatrices);
+  VerifyBatchedInversion<8>(kNumMatrices);
+  VerifyBatchedInversion<9>(kNumMatrices);
+}
+
+TEST(InvertPSDMatricesBatched, RuntimeSize) {
+  std::vector<double> values = {4.0, 2.0, 2.0, 3.0};
+  EXPECT_TRUE(InvertPSDMatricesBatched(2, 1, values.data()));
+  EXPECT_NEAR(values[0], 3.0 / 8.0, std::numeric_limits<double>::epsilon());
+  EXPECT_NEAR(values[1], -2.0 / 8.0, std::numeric_limits<double>::epsilon());
+  EXPECT_NEAR(values[2], -2.0 / 8.0, std::numeric_limits<double>::epsilon());
+  EXPECT_NEAR(values[3], 4.0 / 8.0, std::numeric_limits<double>::epsilon());
+
+  std::vector<double> large(100, 1.0);
+  EXPECT_FALSE(InvertPSDMatricesBatched(10, 1, large.data()));
+  EXPECT_EQ(large, std::vector<double>(100, 1.0));
+}
+
 }  // namespace internal
 }  // namespace ceres
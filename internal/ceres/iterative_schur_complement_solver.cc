@@ -44,6 +44,7 @@
 #include "ceres/linear_solver.h"
 #include "ceres/preconditioner.h"
 #include "ceres/schur_jacobi_preconditioner.h"
+#include "ceres/trace.h"
 #include "ceres/triplet_sparse_matrix.h"
 #include "ceres/types.h"
 #include "ceres/visibility_based_preconditioner.h"
@@ -97,6 +98,9 @@ LinearSolver::Summary IterativeSchurComplementSolver::SolveImpl(
   LinearSolver::Options cg_options;
   cg_options.min_num_iterations = options_.min_num_iterations;
   cg_options.max_num_iterations = options_.max_num_iterations;
+  cg_options.num_threads = options_.num_threads;
+  cg_options.context = options_.context;
+  cg_options.tracer = options_.tracer;
   ConjugateGradientsSolver cg_solver(cg_options);
 
   LinearSolver::PerSolveOptions cg_per_solve_options;
@@ -105,6 +109,7 @@ LinearSolver::Summary IterativeSchurComplementSolver::SolveImpl(
 
   CreatePreconditioner(A);
   if (preconditioner_.get() != NULL) {
+    ScopedTrace trace(options_.tracer, "Preconditioner::Update");
     if (!preconditioner_->Update(*A, per_solve_options.D)) {
       LinearSolver::Summary summary;
       summary.num_iterations = 0;
@@ -149,6 +154,8 @@ void IterativeSchurComplementSolver::CreatePreconditioner(
   preconditioner_options.e_block_size = options_.e_block_size;
   preconditioner_options.f_block_size = options_.f_block_size;
   preconditioner_options.elimination_groups = options_.elimination_groups;
+  preconditioner_options.visibility_clustering =
+      options_.visibility_clustering;
   CHECK(options_.context != NULL);
   preconditioner_options.context = options_.context;
 
@@ -34,11 +34,14 @@
 #include <cmath>
 
 #include "Eigen/Core"
+#include "Eigen/Eigenvalues"
 #include "ceres/array_utils.h"
+#include "ceres/dense_sparse_matrix.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/linear_least_squares_problems.h"
 #include "ceres/linear_solver.h"
 #include "ceres/sparse_matrix.h"
+#include "ceres/trace.h"
 #include "ceres/trust_region_strategy.h"
 #include "ceres/types.h"
 #include "glog/logging.h"
@@ -54,7 +57,10 @@ LevenbergMarquardtStrategy::LevenbergMarquardtStrategy(
       min_diagonal_(options.min_lm_diagonal),
       max_diagonal_(options.max_lm_diagonal),
       decrease_factor_(2.0),
-      reuse_diagonal_(false) {
+      reuse_diagonal_(false),
+      use_eigendecomposition_(options.use_lm_eigendecomposition),
+      eigendecomposition_is_valid_(false),
+      tracer_(options.tracer) {
   CHECK(linear_solver_ != nullptr);
   CHECK_GT(min_diagonal_, 0.0);
   CHECK_LE(min_diagonal_, max_diagonal_);
@@ -74,6 +80,7 @@ TrustRegionStrategy::Summary LevenbergMarquardtStrategy::ComputeStep(
 
   const int num_parameters = jacobian->num_cols();
   if (!reuse_diagonal_) {
+    eigendecomposition_is_valid_ = false;
     if (diagonal_.rows() != num_parameters) {
       diagonal_.resize(num_parameters, 1);
     }
@@ -105,8 +112,20 @@ TrustRegionStrategy::Summary LevenbergMarquardtStrategy::ComputeStep(
   // Instead of solving Jx = -r, solve Jy = r.
   // Then x can be found as x = -y, but the inputs jacobian and residuals
   // do not need to be modified.
-  LinearSolver::Summary linear_solver_summary =
-      linear_solver_->Solve(jacobian, residuals, solve_options, step);
+  DenseSparseMatrix* dense_jacobian =
+      use_eigendecomposition_ ? dynamic_cast<DenseSparseMatrix*>(jacobian)
+                              : nullptr;
+  const bool reused_linear_solve =
+      dense_jacobian != nullptr && eigendecomposition_is_valid_;
+  LinearSolver::Summary linear_solver_summary;
+  if (dense_jacobian != nullptr) {
+    linear_solver_summary =
+        SolveUsingEigendecomposition(*dense_jacobian, residuals, step);
+  } else {
+    ScopedTrace trace(tracer_, "LinearSolver::Solve");
+    linear_solver_summary =
+        linear_solver_->Solve(jacobian, residuals, solve_options, step);
+  }
 
   if (linear_solver_summary.termination_type == LINEAR_SOLVER_FATAL_ERROR) {
     LOG(WARNING) << "Linear solver fatal error: "
@@ -140,7 +159,60 @@ TrustRegionStrategy::Summary LevenbergMarquardtStrategy::ComputeStep(
   TrustRegionStrategy::Summary summary;
   summary.residual_norm = linear_solver_summary.residual_norm;
   summary.num_iterations = linear_solver_summary.num_iterations;
+  summary.reused_linear_solve = reused_linear_solve;
   summary.termination_type = linear_solver_summary.termination_type;
+  summary.message = linear_solver_summary.message;
+  return summary;
+}
+
+LinearSolver::Summary LevenbergMarquardtStrategy::SolveUsingEigendecomposition(
+    const DenseSparseMatrix& jacobian, const double* residuals, double* y) {
+  const int num_rows = jacobian.num_rows();
+  const int num_cols = jacobian.num_cols();
+
+  LinearSolver::Summary summary;
+  summary.num_iterations = 0;
+  if (!eigendecomposition_is_valid_) {
+    ScopedTrace trace(tracer_,
+                      "LevenbergMarquardtStrategy::Eigendecomposition");
+    ConstColMajorMatrixRef J = jacobian.matrix();
+    scale_ = diagonal_.array().sqrt().inverse();
+
+    //   lhs = S J'J S
+    Matrix lhs(num_cols, num_cols);
+    lhs.setZero();
+    lhs.selfadjointView<Eigen::Lower>().rankUpdate(J.transpose());
+    lhs.array() *= (scale_ * scale_.transpose()).array();
+
+    Eigen::SelfAdjointEigenSolver<Matrix> eigensolver(lhs);
+    if (eigensolver.info() != Eigen::Success) {
+      summary.termination_type = LINEAR_SOLVER_FAILURE;
+      summary.message = "Eigen SelfAdjointEigenSolver failed.";
+      return summary;
+    }
+
+    // J'J is positive semidefinite, any negative eigenvalues are
+    // round-off.
+    eigenvalues_ = eigensolver.eigenvalues().cwiseMax(0.0);
+    eigenvectors_ = eigensolver.eigenvectors();
+    projected_rhs_ =
+        eigenvectors_.transpose() *
+        (scale_.array() *
+         (J.transpose() * ConstVectorRef(residuals, num_rows)).array())
+            .matrix();
+    eigendecomposition_is_valid_ = true;
+    summary.num_iterations = 1;
+  }
+
+  // The scaled damping term diag(diagonal_) / radius_ becomes
+  // I / radius_, so the system is diagonal in the eigenbasis.
+  projected_step_ =
+      (projected_rhs_.array() / (eigenvalues_.array() + 1.0 / radius_))
+          .matrix();
+  VectorRef(y, num_cols) =
+      (scale_.array() * (eigenvectors_ * projected_step_).array()).matrix();
+  summary.termination_type = LINEAR_SOLVER_SUCCESS;
+  summary.message = "Success.";
   return summary;
 }
 
@@ -31,8 +31,10 @@
 #ifndef CERES_INTERNAL_LEVENBERG_MARQUARDT_STRATEGY_H_
 #define CERES_INTERNAL_LEVENBERG_MARQUARDT_STRATEGY_H_
 
+#include "ceres/dense_sparse_matrix.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/internal/port.h"
+#include "ceres/linear_solver.h"
 #include "ceres/trust_region_strategy.h"
 
 namespace ceres {
@@ -43,6 +45,20 @@ namespace internal {
 // K. Madsen, H.B. Nielsen and O. Tingleff. Available to download from
 //
 // http://www2.imm.dtu.dk/pubdb/views/edoc_download.php/3215/pdf/imm3215.pdf
+//
+// If Options::use_lm_eigendecomposition is true and the Jacobian is a
+// DenseSparseMatrix, the linear solver is bypassed. Instead the
+// scaled normal equations
+//
+//   S J'J S = V diag(lambda) V',   S = diag(diagonal_)^{-1/2}
+//
+// are eigendecomposed once per Jacobian, after which the step for any
+// radius is
+//
+//   step = -S V diag(1 / (lambda + 1 / radius)) V' S J'r,
+//
+// which costs O(n^2). Rejected steps, which only change the radius,
+// are thus much cheaper than a refactorization of J'J + D'D.
 class CERES_EXPORT_INTERNAL LevenbergMarquardtStrategy
     : public TrustRegionStrategy {
  public:
@@ -69,6 +85,11 @@ class CERES_EXPORT_INTERNAL LevenbergMarquardtStrategy
   double Radius() const final;
 
  private:
+  // Solves the LM system using (and if needed, first computing) the
+  // eigendecomposition of the scaled normal equations.
+  LinearSolver::Summary SolveUsingEigendecomposition(
+      const DenseSparseMatrix& jacobian, const double* residuals, double* y);
+
   LinearSolver* linear_solver_;
   double radius_;
   double max_radius_;
@@ -81,6 +102,17 @@ class CERES_EXPORT_INTERNAL LevenbergMarquardtStrategy
   // allocations in every iteration and reuse when a step fails and
   // ComputeStep is called again.
   Vector lm_diagonal_;  // lm_diagonal_ = sqrt(diagonal_ / radius_);
+
+  const bool use_eigendecomposition_;
+  // True if the following are valid for the current Jacobian.
+  bool eigendecomposition_is_valid_;
+  Vector scale_;         // scale_ = 1 / sqrt(diagonal_)
+  Vector eigenvalues_;   // Clamped to be non-negative.
+  Matrix eigenvectors_;
+  Vector projected_rhs_;  // projected_rhs_ = V' S J'r
+  Vector projected_step_;
+
+  Tracer* tracer_;
 };
 
 }  // namespace internal
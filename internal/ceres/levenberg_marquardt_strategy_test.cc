@@ -32,6 +32,7 @@
 
 #include <memory>
 
+#include "ceres/dense_qr_solver.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/linear_solver.h"
 #include "ceres/trust_region_strategy.h"
@@ -165,5 +166,55 @@ TEST(LevenbergMarquardtStrategy, CorrectDiagonalToLinearSolver) {
   }
 }
 
+TEST(LevenbergMarquardtStrategy, EigendecompositionMatchesLinearSolver) {
+  Matrix jacobian(4, 3);
+  // clang-format off
+  jacobian << 1.0, 2.0, 0.0,
+              0.0, 1.0, 3.0,
+              4.0, 0.0, 1.0,
+              1.0, 1.0, 1.0;
+  // clang-format on
+  DenseSparseMatrix dsm(jacobian);
+  const double residuals[] = {1.0, -2.0, 0.5, 3.0};
+
+  std::unique_ptr<LinearSolver> linear_solver(
+      new DenseQRSolver(LinearSolver::Options()));
+  TrustRegionStrategy::Options options;
+  options.initial_radius = 2.0;
+  options.linear_solver = linear_solver.get();
+  LevenbergMarquardtStrategy expected_lms(options);
+  options.use_lm_eigendecomposition = true;
+  LevenbergMarquardtStrategy actual_lms(options);
+
+  TrustRegionStrategy::PerSolveOptions pso;
+  Vector expected(3);
+  Vector actual(3);
+  for (int i = 0; i < 4; ++i) {
+    TrustRegionStrategy::Summary expected_summary =
+        expected_lms.ComputeStep(pso, &dsm, residuals, expected.data());
+    TrustRegionStrategy::Summary actual_summary =
+        actual_lms.ComputeStep(pso, &dsm, residuals, actual.data());
+    EXPECT_EQ(expected_summary.termination_type, LINEAR_SOLVER_SUCCESS);
+    EXPECT_EQ(actual_summary.termination_type, LINEAR_SOLVER_SUCCESS);
+    // Only the first solve needs an eigendecomposition, the
+    // subsequent ones only differ in the radius.
+    EXPECT_EQ(actual_summary.reused_linear_solve, i > 0);
+    EXPECT_FALSE(expected_summary.reused_linear_solve);
+    EXPECT_NEAR((expected - actual).norm(), 0.0, 1e-12 * expected.norm());
+
+    expected_lms.StepRejected(0.0);
+    actual_lms.StepRejected(0.0);
+  }
+
+  // Accepting a step invalidates the eigendecomposition.
+  expected_lms.StepAccepted(1.0);
+  actual_lms.StepAccepted(1.0);
+  expected_lms.ComputeStep(pso, &dsm, residuals, expected.data());
+  EXPECT_FALSE(
+      actual_lms.ComputeStep(pso, &dsm, residuals, actual.data())
+          .reused_linear_solve);
+  EXPECT_NEAR((expected - actual).norm(), 0.0, 1e-12 * expected.norm());
+}
+
 }  // namespace internal
 }  // namespace ceres
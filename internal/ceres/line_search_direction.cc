@@ -33,6 +33,7 @@
 #include "ceres/internal/eigen.h"
 #include "ceres/line_search_minimizer.h"
 #include "ceres/low_rank_inverse_hessian.h"
+#include "ceres/parallel_vector_ops.h"
 #include "glog/logging.h"
 
 namespace ceres {
@@ -99,10 +100,18 @@ class LBFGS : public LineSearchDirection {
  public:
   LBFGS(const int num_parameters,
         const int max_lbfgs_rank,
-        const bool use_approximate_eigenvalue_bfgs_scaling)
+        const bool use_approximate_eigenvalue_bfgs_scaling,
+        const bool use_compact_lbfgs_representation,
+        ContextImpl* context,
+        const int num_threads)
       : low_rank_inverse_hessian_(num_parameters,
                                   max_lbfgs_rank,
-                                  use_approximate_eigenvalue_bfgs_scaling),
+                                  use_approximate_eigenvalue_bfgs_scaling,
+                                  use_compact_lbfgs_representation,
+                                  context,
+                                  num_threads),
+        context_(context),
+        num_threads_(num_threads),
         is_positive_definite_(true) {}
 
   virtual ~LBFGS() {}
@@ -119,12 +128,20 @@ class LBFGS : public LineSearchDirection {
         previous.search_direction * previous.step_size,
         current.gradient - previous.gradient);
 
-    search_direction->setZero();
+    search_direction->resize(current.gradient.size());
     low_rank_inverse_hessian_.RightMultiply(current.gradient.data(),
                                             search_direction->data());
-    *search_direction *= -1.0;
-
-    if (search_direction->dot(current.gradient) >= 0.0) {
+    ParallelScale(context_,
+                  num_threads_,
+                  search_direction->size(),
+                  -1.0,
+                  search_direction->data());
+
+    if (ParallelDot(context_,
+                    num_threads_,
+                    search_direction->size(),
+                    search_direction->data(),
+                    current.gradient.data()) >= 0.0) {
       LOG(WARNING) << "Numerical failure in L-BFGS update: inverse Hessian "
                    << "approximation is not positive definite, and thus "
                    << "initial gradient for search direction is positive: "
@@ -138,6 +155,8 @@ class LBFGS : public LineSearchDirection {
 
  private:
   LowRankInverseHessian low_rank_inverse_hessian_;
+  ContextImpl* context_;
+  const int num_threads_;
   bool is_positive_definite_;
 };
 
@@ -353,7 +372,10 @@ LineSearchDirection* LineSearchDirection::Create(
     return new ceres::internal::LBFGS(
         options.num_parameters,
         options.max_lbfgs_rank,
-        options.use_approximate_eigenvalue_bfgs_scaling);
+        options.use_approximate_eigenvalue_bfgs_scaling,
+        options.use_compact_lbfgs_representation,
+        options.context,
+        options.num_threads);
   }
 
   if (options.type == ceres::BFGS) {
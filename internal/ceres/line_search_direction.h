@@ -38,6 +38,8 @@
 namespace ceres {
 namespace internal {
 
+class ContextImpl;
+
 class LineSearchDirection {
  public:
   struct Options {
@@ -47,7 +49,10 @@ class LineSearchDirection {
           nonlinear_conjugate_gradient_type(FLETCHER_REEVES),
           function_tolerance(1e-12),
           max_lbfgs_rank(20),
-          use_approximate_eigenvalue_bfgs_scaling(true) {}
+          use_approximate_eigenvalue_bfgs_scaling(true),
+          use_compact_lbfgs_representation(false),
+          context(nullptr),
+          num_threads(1) {}
 
     int num_parameters;
     LineSearchDirectionType type;
@@ -55,6 +60,12 @@ class LineSearchDirection {
     double function_tolerance;
     int max_lbfgs_rank;
     bool use_approximate_eigenvalue_bfgs_scaling;
+    bool use_compact_lbfgs_representation;
+
+    // Used by LBFGS to parallelize the vector operations in the
+    // computation of the search direction. context may be nullptr.
+    ContextImpl* context;
+    int num_threads;
   };
 
   static LineSearchDirection* Create(const Options& options);
@@ -55,6 +55,7 @@
 #include "ceres/line_search.h"
 #include "ceres/line_search_direction.h"
 #include "ceres/stringprintf.h"
+#include "ceres/trace.h"
 #include "ceres/types.h"
 #include "ceres/wall_time.h"
 #include "glog/logging.h"
@@ -171,6 +172,10 @@ void LineSearchMinimizer::Minimize(const Minimizer::Options& options,
   line_search_direction_options.max_lbfgs_rank = options.max_lbfgs_rank;
   line_search_direction_options.use_approximate_eigenvalue_bfgs_scaling =
       options.use_approximate_eigenvalue_bfgs_scaling;
+  line_search_direction_options.use_compact_lbfgs_representation =
+      options.use_compact_lbfgs_representation;
+  line_search_direction_options.context = options.context;
+  line_search_direction_options.num_threads = options.num_threads;
   std::unique_ptr<LineSearchDirection> line_search_direction(
       LineSearchDirection::Create(line_search_direction_options));
 
@@ -213,6 +218,7 @@ void LineSearchMinimizer::Minimize(const Minimizer::Options& options,
       break;
     }
 
+    ScopedTrace trace(options.tracer, "LineSearchMinimizer::Iteration");
     iteration_start_time = WallTimeInSeconds();
     if (iteration_summary.iteration >= options.max_num_iterations) {
       summary->message = "Maximum number of iterations reached.";
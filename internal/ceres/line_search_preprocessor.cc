@@ -60,7 +60,10 @@ bool SetupEvaluator(PreprocessedProblem* pp) {
   pp->evaluator_options.linear_solver_type = CGNR;
   pp->evaluator_options.num_eliminate_blocks = 0;
   pp->evaluator_options.num_threads = pp->options.num_threads;
+  pp->evaluator_options.profile_cost_functions =
+      pp->options.profile_cost_functions;
   pp->evaluator_options.context = pp->problem->context();
+  pp->evaluator_options.tracer = pp->tracer;
   pp->evaluator_options.evaluation_callback =
       pp->reduced_program->mutable_evaluation_callback();
   pp->evaluator.reset(Evaluator::Create(
@@ -74,6 +74,9 @@ LinearSolver* LinearSolver::Create(const LinearSolver::Options& options) {
 
   switch (options.type) {
     case CGNR:
+      if (options.use_matrix_free_jacobian) {
+        return new MatrixFreeCgnrSolver(options);
+      }
       return new CgnrSolver(options);
 
     case SPARSE_NORMAL_CHOLESKY:
@@ -53,6 +53,8 @@
 namespace ceres {
 namespace internal {
 
+struct CameraClustering;
+
 enum LinearSolverTerminationType {
   // Termination criterion was met.
   LINEAR_SOLVER_SUCCESS,
@@ -84,6 +86,7 @@ enum OrderingType {
 };
 
 class LinearOperator;
+class Tracer;
 
 // Abstract base class for objects that implement algorithms for
 // solving linear systems
@@ -115,6 +118,9 @@ class CERES_EXPORT_INTERNAL LinearSolver {
     bool use_postordering = false;
     bool dynamic_sparsity = false;
     bool use_explicit_schur_complement = false;
+    bool use_matrix_free_jacobian = false;
+    bool use_tiled_dense_factorization = false;
+    std::string memory_mapped_storage_directory;
 
     // Number of internal iterations that the solver uses. This
     // parameter only makes sense for iterative solvers like CG.
@@ -165,7 +171,12 @@ class CERES_EXPORT_INTERNAL LinearSolver {
     bool use_mixed_precision_solves = false;
     int max_num_refinement_iterations = 0;
     int subset_preconditioner_start_row_block = -1;
+
+    // See Preconditioner::Options::visibility_clustering.
+    CameraClustering* visibility_clustering = nullptr;
     ContextImpl* context = nullptr;
+    // Records the work done by the solver if not nullptr.
+    Tracer* tracer = nullptr;
   };
 
   // Options for the Solve method.
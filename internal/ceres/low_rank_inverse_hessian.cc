@@ -33,6 +33,7 @@
 #include <list>
 
 #include "ceres/internal/eigen.h"
+#include "ceres/parallel_vector_ops.h"
 #include "glog/logging.h"
 
 namespace ceres {
@@ -78,18 +79,34 @@ const double kLBFGSSecantConditionHessianUpdateTolerance = 1e-14;
 LowRankInverseHessian::LowRankInverseHessian(
     int num_parameters,
     int max_num_corrections,
-    bool use_approximate_eigenvalue_scaling)
+    bool use_approximate_eigenvalue_scaling,
+    bool use_compact_representation,
+    ContextImpl* context,
+    int num_threads)
     : num_parameters_(num_parameters),
       max_num_corrections_(max_num_corrections),
       use_approximate_eigenvalue_scaling_(use_approximate_eigenvalue_scaling),
+      use_compact_representation_(use_compact_representation),
+      context_(context),
+      num_threads_(num_threads),
       approximate_eigenvalue_scale_(1.0),
-      delta_x_history_(num_parameters, max_num_corrections),
-      delta_gradient_history_(num_parameters, max_num_corrections),
-      delta_x_dot_delta_gradient_(max_num_corrections) {}
+      history_(num_parameters, 2 * max_num_corrections),
+      delta_x_dot_delta_gradient_(max_num_corrections) {
+  if (use_compact_representation_) {
+    delta_x_dot_delta_gradient_matrix_.resize(max_num_corrections,
+                                              max_num_corrections);
+    delta_gradient_gram_matrix_.resize(max_num_corrections,
+                                       max_num_corrections);
+  }
+}
 
 bool LowRankInverseHessian::Update(const Vector& delta_x,
                                    const Vector& delta_gradient) {
-  const double delta_x_dot_delta_gradient = delta_x.dot(delta_gradient);
+  const double delta_x_dot_delta_gradient = ParallelDot(context_,
+                                                       num_threads_,
+                                                       num_parameters_,
+                                                       delta_x.data(),
+                                                       delta_gradient.data());
   if (delta_x_dot_delta_gradient <=
       kLBFGSSecantConditionHessianUpdateTolerance) {
     VLOG(2) << "Skipping L-BFGS Update, delta_x_dot_delta_gradient too "
@@ -109,20 +126,65 @@ bool LowRankInverseHessian::Update(const Vector& delta_x,
   }
 
   indices_.push_back(next);
-  delta_x_history_.col(next) = delta_x;
-  delta_gradient_history_.col(next) = delta_gradient;
+  ParallelAssign(context_,
+                 num_threads_,
+                 num_parameters_,
+                 delta_x.data(),
+                 history_.col(2 * next).data());
+  ParallelAssign(context_,
+                 num_threads_,
+                 num_parameters_,
+                 delta_gradient.data(),
+                 history_.col(2 * next + 1).data());
   delta_x_dot_delta_gradient_(next) = delta_x_dot_delta_gradient;
+
+  double delta_gradient_squared_norm;
+  if (use_compact_representation_) {
+    // Compute the inner products of the new delta_gradient with all
+    // the delta_x and delta_gradient vectors, including the new ones.
+    const int num_corrections = indices_.size();
+    Vector inner_products(2 * num_corrections);
+    ParallelTransposedMatrixVectorMultiply(context_,
+                                           num_threads_,
+                                           num_parameters_,
+                                           2 * num_corrections,
+                                           history_.data(),
+                                           delta_gradient.data(),
+                                           inner_products.data());
+    for (int i = 0; i < num_corrections; ++i) {
+      delta_x_dot_delta_gradient_matrix_(i, next) = inner_products(2 * i);
+      delta_gradient_gram_matrix_(i, next) = inner_products(2 * i + 1);
+      delta_gradient_gram_matrix_(next, i) = inner_products(2 * i + 1);
+    }
+    delta_gradient_squared_norm = inner_products(2 * next + 1);
+  } else {
+    delta_gradient_squared_norm = ParallelDot(context_,
+                                              num_threads_,
+                                              num_parameters_,
+                                              delta_gradient.data(),
+                                              delta_gradient.data());
+  }
+
   approximate_eigenvalue_scale_ =
-      delta_x_dot_delta_gradient / delta_gradient.squaredNorm();
+      delta_x_dot_delta_gradient / delta_gradient_squared_norm;
   return true;
 }
 
 void LowRankInverseHessian::RightMultiply(const double* x_ptr,
                                           double* y_ptr) const {
-  ConstVectorRef gradient(x_ptr, num_parameters_);
-  VectorRef search_direction(y_ptr, num_parameters_);
+  if (use_compact_representation_) {
+    CompactRightMultiply(x_ptr, y_ptr);
+  } else {
+    TwoLoopRightMultiply(x_ptr, y_ptr);
+  }
+}
 
-  search_direction = gradient;
+void LowRankInverseHessian::TwoLoopRightMultiply(const double* x_ptr,
+                                                 double* y_ptr) const {
+  // Each step of the two loop recursion below depends on the result
+  // of the previous one, so only the individual dot products and
+  // vector updates are parallelized.
+  ParallelAssign(context_, num_threads_, num_parameters_, x_ptr, y_ptr);
 
   const int num_corrections = indices_.size();
   Vector alpha(num_corrections);
@@ -130,9 +192,18 @@ void LowRankInverseHessian::RightMultiply(const double* x_ptr,
   for (list<int>::const_reverse_iterator it = indices_.rbegin();
        it != indices_.rend();
        ++it) {
-    const double alpha_i = delta_x_history_.col(*it).dot(search_direction) /
+    const double alpha_i = ParallelDot(context_,
+                                       num_threads_,
+                                       num_parameters_,
+                                       history_.col(2 * *it).data(),
+                                       y_ptr) /
                            delta_x_dot_delta_gradient_(*it);
-    search_direction -= alpha_i * delta_gradient_history_.col(*it);
+    ParallelAxpy(context_,
+                 num_threads_,
+                 num_parameters_,
+                 -alpha_i,
+                 history_.col(2 * *it + 1).data(),
+                 y_ptr);
     alpha(*it) = alpha_i;
   }
 
@@ -167,7 +238,11 @@ void LowRankInverseHessian::RightMultiply(const double* x_ptr,
     //     Implementation and experiments, Management Science,
     //     20(5), 863-874, 1974.
     // [2] Nocedal J., Wright S., Numerical Optimization, Springer, 1999.
-    search_direction *= approximate_eigenvalue_scale_;
+    ParallelScale(context_,
+                  num_threads_,
+                  num_parameters_,
+                  approximate_eigenvalue_scale_,
+                  y_ptr);
 
     VLOG(4) << "Applying approximate_eigenvalue_scale: "
             << approximate_eigenvalue_scale_ << " to initial inverse Hessian "
@@ -175,11 +250,89 @@ void LowRankInverseHessian::RightMultiply(const double* x_ptr,
   }
 
   for (const int i : indices_) {
-    const double beta = delta_gradient_history_.col(i).dot(search_direction) /
+    const double beta = ParallelDot(context_,
+                                    num_threads_,
+                                    num_parameters_,
+                                    history_.col(2 * i + 1).data(),
+                                    y_ptr) /
                         delta_x_dot_delta_gradient_(i);
-    search_direction += delta_x_history_.col(i) * (alpha(i) - beta);
+    ParallelAxpy(context_,
+                 num_threads_,
+                 num_parameters_,
+                 alpha(i) - beta,
+                 history_.col(2 * i).data(),
+                 y_ptr);
   }
 }
 
+void LowRankInverseHessian::CompactRightMultiply(const double* x_ptr,
+                                                 double* y_ptr) const {
+  // See the two loop recursion above for a discussion of this
+  // scaling.
+  const double gamma =
+      use_approximate_eigenvalue_scaling_ ? approximate_eigenvalue_scale_
+                                          : 1.0;
+  const int num_corrections = indices_.size();
+
+  // [a_i, b_i] = [delta_x_i, delta_gradient_i]^T * x.
+  Vector inner_products(2 * num_corrections);
+  ParallelTransposedMatrixVectorMultiply(context_,
+                                         num_threads_,
+                                         num_parameters_,
+                                         2 * num_corrections,
+                                         history_.data(),
+                                         x_ptr,
+                                         inner_products.data());
+
+  // Gather the small matrices and vectors of the compact
+  // representation, with the corrections ordered from the oldest to
+  // the newest. R is the upper triangular part of S^T * Y, and D its
+  // diagonal.
+  Matrix r(num_corrections, num_corrections);
+  Matrix d_plus_gamma_y_t_y(num_corrections, num_corrections);
+  Vector a(num_corrections);
+  Vector b(num_corrections);
+  int row = 0;
+  for (const int i : indices_) {
+    int col = 0;
+    for (const int j : indices_) {
+      r(row, col) = (row <= col) ? delta_x_dot_delta_gradient_matrix_(i, j)
+                                 : 0.0;
+      d_plus_gamma_y_t_y(row, col) = gamma * delta_gradient_gram_matrix_(i, j);
+      ++col;
+    }
+    d_plus_gamma_y_t_y(row, row) += delta_x_dot_delta_gradient_(i);
+    a(row) = inner_products(2 * i);
+    b(row) = inner_products(2 * i + 1);
+    ++row;
+  }
+
+  // With p = R^{-1} a, the product is
+  //
+  //   y = gamma * x + S * R^{-T} * ((D + gamma * Y^T Y) * p - gamma * b)
+  //       - gamma * Y * p.
+  const Vector p = r.triangularView<Eigen::Upper>().solve(a);
+  const Vector q = r.transpose().triangularView<Eigen::Lower>().solve(
+      d_plus_gamma_y_t_y * p - gamma * b);
+
+  Vector coefficients(2 * num_corrections);
+  row = 0;
+  for (const int i : indices_) {
+    coefficients(2 * i) = q(row);
+    coefficients(2 * i + 1) = -gamma * p(row);
+    ++row;
+  }
+
+  ParallelAssign(context_, num_threads_, num_parameters_, x_ptr, y_ptr);
+  ParallelMatrixVectorMultiply(context_,
+                               num_threads_,
+                               num_parameters_,
+                               2 * num_corrections,
+                               history_.data(),
+                               coefficients.data(),
+                               gamma,
+                               y_ptr);
+}
+
 }  // namespace internal
 }  // namespace ceres
@@ -42,6 +42,8 @@
 namespace ceres {
 namespace internal {
 
+class ContextImpl;
+
 // LowRankInverseHessian is a positive definite approximation to the
 // Hessian using the limited memory variant of the
 // Broyden-Fletcher-Goldfarb-Shanno (BFGS)secant formula for
@@ -59,6 +61,22 @@ namespace internal {
 // Byrd, R. H.; Nocedal, J.; Schnabel, R. B. (1994).
 // "Representations of Quasi-Newton Matrices and their use in
 // Limited Memory Methods". Mathematical Programming 63 (4):
+//
+// The product of the approximation with a vector can either be
+// computed using the two loop recursion of Nocedal, or using the
+// compact representation of Byrd, Nocedal and Schnabel
+//
+//   H = gamma * I + [S  gamma * Y] * M * [S  gamma * Y]^T
+//
+// where S and Y are the matrices whose columns are the delta_x and
+// delta_gradient vectors, and M is a small matrix which depends on
+// S^T * Y and Y^T * Y. The two loop recursion makes 4 *
+// max_num_corrections passes over vectors of size num_parameters,
+// whereas the compact representation computes the product using one
+// multiplication by [S Y]^T and one by [S Y], i.e., it reads the
+// history only twice. The inner products S^T * Y and Y^T * Y are
+// updated incrementally, at the cost of one more multiplication by
+// [S Y]^T in Update().
 class LowRankInverseHessian : public LinearOperator {
  public:
   // num_parameters is the row/column size of the Hessian.
@@ -67,12 +85,22 @@ class LowRankInverseHessian : public LinearOperator {
   // inverse Hessian used during Right/LeftMultiply() is scaled by
   // the approximate eigenvalue of the true inverse Hessian at the
   // current operating point.
+  // use_compact_representation selects between the compact
+  // representation and the two loop recursion.
   // The approximation uses:
   // 2 * max_num_corrections * num_parameters + max_num_corrections
-  // doubles.
+  // doubles, and 2 * max_num_corrections^2 more with the compact
+  // representation.
+  //
+  // The vector operations in Update() and RightMultiply() are done
+  // using num_threads threads from context. context may be NULL, in
+  // which case they are done on the calling thread.
   LowRankInverseHessian(int num_parameters,
                         int max_num_corrections,
-                        bool use_approximate_eigenvalue_scaling);
+                        bool use_approximate_eigenvalue_scaling,
+                        bool use_compact_representation,
+                        ContextImpl* context,
+                        int num_threads);
   virtual ~LowRankInverseHessian() {}
 
   // Update the low rank approximation. delta_x is the change in the
@@ -92,13 +120,34 @@ class LowRankInverseHessian : public LinearOperator {
   int num_cols() const final { return num_parameters_; }
 
  private:
+  void TwoLoopRightMultiply(const double* x, double* y) const;
+  void CompactRightMultiply(const double* x, double* y) const;
+
   const int num_parameters_;
   const int max_num_corrections_;
   const bool use_approximate_eigenvalue_scaling_;
+  const bool use_compact_representation_;
+  ContextImpl* context_;
+  const int num_threads_;
   double approximate_eigenvalue_scale_;
-  ColMajorMatrix delta_x_history_;
-  ColMajorMatrix delta_gradient_history_;
+
+  // The delta_x and delta_gradient vectors stored in slot i are
+  // columns 2 * i and 2 * i + 1 of history_. The slots are filled in
+  // order, so the slots in use are always the first indices_.size()
+  // ones, and their columns are contiguous.
+  ColMajorMatrix history_;
   Vector delta_x_dot_delta_gradient_;
+
+  // Only used with the compact representation.
+  //
+  // delta_x_dot_delta_gradient_matrix_(i, j) is the inner product of
+  // the delta_x in slot i with the delta_gradient in slot j. It is
+  // only valid if slot i is not newer than slot j.
+  Matrix delta_x_dot_delta_gradient_matrix_;
+  // Inner products of the delta_gradient vectors.
+  Matrix delta_gradient_gram_matrix_;
+
+  // The slots in use, from the oldest to the newest.
   std::list<int> indices_;
 };
 
@@ -0,0 +1,151 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Benchmarks for the two loop recursion and the compact
+// representation of the LBFGS inverse Hessian approximation. For
+// large problems both are limited by memory bandwidth, so the
+// benchmarks report the number of bytes of LBFGS history read per
+// second, which is an upper bound on the effective bandwidth of the
+// two loop recursion.
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "ceres/context_impl.h"
+#include "ceres/internal/eigen.h"
+#include "ceres/low_rank_inverse_hessian.h"
+
+namespace ceres {
+namespace internal {
+
+// Returns an approximation with a full history of corrections.
+std::unique_ptr<LowRankInverseHessian> CreateLowRankInverseHessian(
+    int num_parameters,
+    int max_num_corrections,
+    bool use_compact_representation,
+    ContextImpl* context,
+    int num_threads) {
+  std::unique_ptr<LowRankInverseHessian> inverse_hessian(
+      new LowRankInverseHessian(num_parameters,
+                                max_num_corrections,
+                                true,
+                                use_compact_representation,
+                                context,
+                                num_threads));
+  Vector delta_x(num_parameters);
+  Vector delta_gradient(num_parameters);
+  for (int i = 0; i < max_num_corrections; ++i) {
+    delta_x.setRandom();
+    delta_gradient = delta_x + 0.1 * Vector::Random(num_parameters);
+    CHECK(inverse_hessian->Update(delta_x, delta_gradient));
+  }
+  return inverse_hessian;
+}
+
+// Arguments: number of parameters, max number of corrections,
+// use_compact_representation and number of threads.
+static void BM_LBFGSRightMultiply(benchmark::State& state) {
+  const int num_parameters = state.range(0);
+  const int max_num_corrections = state.range(1);
+  const bool use_compact_representation = state.range(2) != 0;
+  const int num_threads = state.range(3);
+  ContextImpl context;
+  context.EnsureMinimumThreads(num_threads);
+  std::unique_ptr<LowRankInverseHessian> inverse_hessian =
+      CreateLowRankInverseHessian(num_parameters,
+                                  max_num_corrections,
+                                  use_compact_representation,
+                                  &context,
+                                  num_threads);
+
+  const Vector x = Vector::Random(num_parameters);
+  Vector y(num_parameters);
+  for (auto _ : state) {
+    inverse_hessian->RightMultiply(x.data(), y.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * max_num_corrections *
+                          num_parameters * sizeof(double));
+}
+
+// Adds a correction and computes the next search direction, like an
+// iteration of the line search minimizer does.
+static void BM_LBFGSUpdateAndRightMultiply(benchmark::State& state) {
+  const int num_parameters = state.range(0);
+  const int max_num_corrections = state.range(1);
+  const bool use_compact_representation = state.range(2) != 0;
+  const int num_threads = state.range(3);
+  ContextImpl context;
+  context.EnsureMinimumThreads(num_threads);
+  std::unique_ptr<LowRankInverseHessian> inverse_hessian =
+      CreateLowRankInverseHessian(num_parameters,
+                                  max_num_corrections,
+                                  use_compact_representation,
+                                  &context,
+                                  num_threads);
+
+  const Vector delta_x = Vector::Random(num_parameters);
+  const Vector delta_gradient =
+      delta_x + 0.1 * Vector::Random(num_parameters);
+  const Vector x = Vector::Random(num_parameters);
+  Vector y(num_parameters);
+  for (auto _ : state) {
+    inverse_hessian->Update(delta_x, delta_gradient);
+    inverse_hessian->RightMultiply(x.data(), y.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * max_num_corrections *
+                          num_parameters * sizeof(double));
+}
+
+static void LBFGSArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int num_parameters = 100000; num_parameters <= 10000000;
+       num_parameters *= 10) {
+    for (int use_compact_representation = 0; use_compact_representation < 2;
+         ++use_compact_representation) {
+      for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+        benchmark->Args(
+            {num_parameters, 20, use_compact_representation, num_threads});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_LBFGSRightMultiply)
+    ->Apply(LBFGSArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LBFGSUpdateAndRightMultiply)
+    ->Apply(LBFGSArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace internal
+}  // namespace ceres
+
+BENCHMARK_MAIN();
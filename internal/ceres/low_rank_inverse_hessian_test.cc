@@ -0,0 +1,125 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/low_rank_inverse_hessian.h"
+
+#include <memory>
+
+#include "ceres/internal/eigen.h"
+#include "gtest/gtest.h"
+
+namespace ceres {
+namespace internal {
+
+// The parameter is use_approximate_eigenvalue_scaling.
+class LowRankInverseHessianTest : public ::testing::TestWithParam<bool> {
+ protected:
+  static constexpr int kNumParameters = 100;
+  static constexpr int kMaxNumCorrections = 5;
+
+  void SetUp() final {
+    const bool use_approximate_eigenvalue_scaling = GetParam();
+    two_loop_.reset(new LowRankInverseHessian(kNumParameters,
+                                              kMaxNumCorrections,
+                                              use_approximate_eigenvalue_scaling,
+                                              false,
+                                              nullptr,
+                                              1));
+    compact_.reset(new LowRankInverseHessian(kNumParameters,
+                                             kMaxNumCorrections,
+                                             use_approximate_eigenvalue_scaling,
+                                             true,
+                                             nullptr,
+                                             1));
+    srand(5);
+    // delta_gradient = B * delta_x for a positive definite B
+    // guarantees that the secant condition holds.
+    const Matrix a = Matrix::Random(kNumParameters, kNumParameters);
+    hessian_ = a.transpose() * a + Matrix::Identity(kNumParameters,
+                                                    kNumParameters);
+  }
+
+  // Adds a random correction to both approximations.
+  void Update() {
+    const Vector delta_x = Vector::Random(kNumParameters);
+    const Vector delta_gradient = hessian_ * delta_x;
+    EXPECT_TRUE(two_loop_->Update(delta_x, delta_gradient));
+    EXPECT_TRUE(compact_->Update(delta_x, delta_gradient));
+  }
+
+  // Checks that both approximations compute the same product.
+  void ExpectSameProduct() {
+    const Vector x = Vector::Random(kNumParameters);
+    Vector expected(kNumParameters);
+    Vector actual(kNumParameters);
+    two_loop_->RightMultiply(x.data(), expected.data());
+    compact_->RightMultiply(x.data(), actual.data());
+    EXPECT_NEAR((expected - actual).norm(), 0.0, 1e-10 * expected.norm());
+  }
+
+  Matrix hessian_;
+  std::unique_ptr<LowRankInverseHessian> two_loop_;
+  std::unique_ptr<LowRankInverseHessian> compact_;
+};
+
+TEST_P(LowRankInverseHessianTest, CompactMatchesTwoLoopWithoutCorrections) {
+  ExpectSameProduct();
+}
+
+TEST_P(LowRankInverseHessianTest, CompactMatchesTwoLoop) {
+  // Add more corrections than the approximation can hold, so that the
+  // oldest ones get replaced.
+  for (int i = 0; i < 3 * kMaxNumCorrections; ++i) {
+    Update();
+    ExpectSameProduct();
+  }
+}
+
+TEST_P(LowRankInverseHessianTest, SatisfiesSecantEquationForNewestCorrection) {
+  for (int i = 0; i < 2 * kMaxNumCorrections; ++i) {
+    Update();
+  }
+  const Vector delta_x = Vector::Random(kNumParameters);
+  const Vector delta_gradient = hessian_ * delta_x;
+  ASSERT_TRUE(compact_->Update(delta_x, delta_gradient));
+
+  // H * delta_gradient = delta_x.
+  Vector h_delta_gradient(kNumParameters);
+  compact_->RightMultiply(delta_gradient.data(), h_delta_gradient.data());
+  EXPECT_NEAR(
+      (h_delta_gradient - delta_x).norm(), 0.0, 1e-8 * delta_x.norm());
+}
+
+INSTANTIATE_TEST_SUITE_P(ApproximateEigenvalueScaling,
+                         LowRankInverseHessianTest,
+                         ::testing::Bool());
+
+}  // namespace internal
+}  // namespace ceres
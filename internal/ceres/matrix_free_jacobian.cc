@@ -0,0 +1,423 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/matrix_free_jacobian.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "ceres/block_random_access_diagonal_matrix.h"
+#include "ceres/parallel_for.h"
+#include "ceres/parameter_block.h"
+#include "ceres/program.h"
+#include "ceres/residual_block.h"
+#include "ceres/scratch_evaluate_preparer.h"
+#include "ceres/small_blas.h"
+#include "glog/logging.h"
+
+namespace ceres {
+namespace internal {
+
+using Eigen::Dynamic;
+
+MatrixFreeJacobian::MatrixFreeJacobian(Program* program,
+                                       ContextImpl* context,
+                                       int num_threads)
+    : program_(program),
+      context_(context),
+      num_threads_(num_threads),
+      num_rows_(program->NumResiduals()),
+      num_cols_(program->NumEffectiveParameters()),
+      num_nonzeros_(0),
+      evaluation_failed_(false) {
+  CHECK(program_ != nullptr);
+  CHECK_GE(num_threads_, 1);
+
+  const std::vector<ResidualBlock*>& residual_blocks =
+      program_->residual_blocks();
+  row_positions_.resize(residual_blocks.size());
+  int row_position = 0;
+  for (int i = 0; i < residual_blocks.size(); ++i) {
+    const ResidualBlock* residual_block = residual_blocks[i];
+    const int num_residuals = residual_block->NumResiduals();
+    row_positions_[i] = row_position;
+    row_position += num_residuals;
+    for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+      const ParameterBlock* parameter_block =
+          residual_block->parameter_blocks()[j];
+      if (!parameter_block->IsConstant()) {
+        num_nonzeros_ += num_residuals * parameter_block->LocalSize();
+      }
+    }
+  }
+
+  const std::vector<ParameterBlock*>& parameter_blocks =
+      program_->parameter_blocks();
+  column_block_sizes_.resize(parameter_blocks.size());
+  diagonal_block_positions_.resize(parameter_blocks.size());
+  int diagonal_block_position = 0;
+  for (int i = 0; i < parameter_blocks.size(); ++i) {
+    const int size = parameter_blocks[i]->LocalSize();
+    column_block_sizes_[i] = size;
+    diagonal_block_positions_[i] = diagonal_block_position;
+    diagonal_block_position += size * size;
+  }
+
+  state_.resize(program_->NumParameters());
+  program_->ParameterBlocksToStateVector(state_.data());
+  column_scale_.setOnes(num_cols_);
+
+  evaluate_preparers_.reset(
+      ScratchEvaluatePreparer::Create(*program_, num_threads_));
+  const int max_scratch_doubles =
+      program_->MaxScratchDoublesNeededForEvaluate();
+  const int max_parameter_blocks = program_->MaxParametersPerResidualBlock();
+  const int max_residuals = program_->MaxResidualsPerResidualBlock();
+  for (int i = 0; i < num_threads_; ++i) {
+    evaluate_scratch_.emplace_back(new double[max_scratch_doubles]);
+    jacobian_block_ptrs_.emplace_back(new double*[max_parameter_blocks]);
+    residual_scratch_.emplace_back(max_residuals);
+  }
+  accumulators_.resize(num_threads_);
+}
+
+MatrixFreeJacobian::~MatrixFreeJacobian() {}
+
+void MatrixFreeJacobian::CaptureEvaluationPoint() {
+  program_->ParameterBlocksToStateVector(state_.data());
+  evaluation_failed_ = false;
+}
+
+void MatrixFreeJacobian::SetZero() { column_scale_.setOnes(); }
+
+void MatrixFreeJacobian::ScaleColumns(const double* scale) {
+  column_scale_.array() *= ConstVectorRef(scale, num_cols_).array();
+}
+
+bool MatrixFreeJacobian::ForEachResidualBlock(
+    int num_threads,
+    const std::function<void(int, int, int, double**)>& function) const {
+  const std::vector<ParameterBlock*>& parameter_blocks =
+      program_->parameter_blocks();
+  saved_states_.resize(parameter_blocks.size());
+  for (int i = 0; i < parameter_blocks.size(); ++i) {
+    saved_states_[i] = parameter_blocks[i]->state();
+  }
+
+  std::atomic<bool> failed(
+      !program_->StateVectorToParameterBlocks(state_.data()));
+  const std::vector<ResidualBlock*>& residual_blocks =
+      program_->residual_blocks();
+  ParallelFor(
+      context_,
+      0,
+      failed ? 0 : residual_blocks.size(),
+      num_threads,
+      [&](int thread_id, int i) {
+        if (failed) {
+          return;
+        }
+        const ResidualBlock* residual_block = residual_blocks[i];
+        double** jacobians = jacobian_block_ptrs_[thread_id].get();
+        evaluate_preparers_[thread_id].Prepare(
+            residual_block, i, nullptr, jacobians);
+        double cost;
+        if (!residual_block->Evaluate(true,
+                                      &cost,
+                                      nullptr,
+                                      jacobians,
+                                      evaluate_scratch_[thread_id].get())) {
+          failed = true;
+          return;
+        }
+
+        const int num_residuals = residual_block->NumResiduals();
+        for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          const int size = parameter_block->LocalSize();
+          MatrixRef(jacobians[j], num_residuals, size).array().rowwise() *=
+              column_scale_.segment(parameter_block->delta_offset(), size)
+                  .transpose()
+                  .array();
+        }
+
+        function(thread_id, i, row_positions_[i], jacobians);
+      });
+
+  for (int i = 0; i < parameter_blocks.size(); ++i) {
+    if (!parameter_blocks[i]->IsConstant() &&
+        parameter_blocks[i]->state() != saved_states_[i] &&
+        !parameter_blocks[i]->SetState(saved_states_[i])) {
+      failed = true;
+    }
+  }
+
+  if (failed) {
+    evaluation_failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+void MatrixFreeJacobian::ResetAccumulators(int size) const {
+  for (Vector& accumulator : accumulators_) {
+    accumulator.setZero(size);
+  }
+}
+
+void MatrixFreeJacobian::SumAccumulators(int size, double* y) const {
+  VectorRef yref(y, size);
+  for (const Vector& accumulator : accumulators_) {
+    yref += accumulator;
+  }
+}
+
+void MatrixFreeJacobian::RightMultiply(const double* x, double* y) const {
+  ForEachResidualBlock(
+      num_threads_, [&](int thread_id, int i, int row, double** jacobians) {
+        const ResidualBlock* residual_block = program_->residual_blocks()[i];
+        const int num_residuals = residual_block->NumResiduals();
+        for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          MatrixVectorMultiply<Dynamic, Dynamic, 1>(
+              jacobians[j],
+              num_residuals,
+              parameter_block->LocalSize(),
+              x + parameter_block->delta_offset(),
+              y + row);
+        }
+      });
+}
+
+void MatrixFreeJacobian::LeftMultiply(const double* x, double* y) const {
+  ResetAccumulators(num_cols_);
+  ForEachResidualBlock(
+      num_threads_, [&](int thread_id, int i, int row, double** jacobians) {
+        const ResidualBlock* residual_block = program_->residual_blocks()[i];
+        const int num_residuals = residual_block->NumResiduals();
+        double* accumulator = accumulators_[thread_id].data();
+        for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          MatrixTransposeVectorMultiply<Dynamic, Dynamic, 1>(
+              jacobians[j],
+              num_residuals,
+              parameter_block->LocalSize(),
+              x + row,
+              accumulator + parameter_block->delta_offset());
+        }
+      });
+  SumAccumulators(num_cols_, y);
+}
+
+void MatrixFreeJacobian::NormalEquationsRightMultiply(const double* x,
+                                                      double* y) const {
+  ResetAccumulators(num_cols_);
+  ForEachResidualBlock(
+      num_threads_, [&](int thread_id, int i, int row, double** jacobians) {
+        const ResidualBlock* residual_block = program_->residual_blocks()[i];
+        const int num_residuals = residual_block->NumResiduals();
+        const int num_parameter_blocks = residual_block->NumParameterBlocks();
+        double* z = residual_scratch_[thread_id].data();
+        double* accumulator = accumulators_[thread_id].data();
+
+        // z = J_i x
+        std::fill(z, z + num_residuals, 0.0);
+        for (int j = 0; j < num_parameter_blocks; ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          MatrixVectorMultiply<Dynamic, Dynamic, 1>(
+              jacobians[j],
+              num_residuals,
+              parameter_block->LocalSize(),
+              x + parameter_block->delta_offset(),
+              z);
+        }
+
+        // y += J_i' z
+        for (int j = 0; j < num_parameter_blocks; ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          MatrixTransposeVectorMultiply<Dynamic, Dynamic, 1>(
+              jacobians[j],
+              num_residuals,
+              parameter_block->LocalSize(),
+              z,
+              accumulator + parameter_block->delta_offset());
+        }
+      });
+  SumAccumulators(num_cols_, y);
+}
+
+void MatrixFreeJacobian::SquaredColumnNorm(double* x) const {
+  ResetAccumulators(num_cols_);
+  ForEachResidualBlock(
+      num_threads_, [&](int thread_id, int i, int row, double** jacobians) {
+        const ResidualBlock* residual_block = program_->residual_blocks()[i];
+        const int num_residuals = residual_block->NumResiduals();
+        for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          const int size = parameter_block->LocalSize();
+          accumulators_[thread_id].segment(parameter_block->delta_offset(),
+                                           size) +=
+              ConstMatrixRef(jacobians[j], num_residuals, size)
+                  .colwise()
+                  .squaredNorm()
+                  .transpose();
+        }
+      });
+  VectorRef(x, num_cols_).setZero();
+  SumAccumulators(num_cols_, x);
+}
+
+bool MatrixFreeJacobian::BlockDiagonalJtJ(
+    BlockRandomAccessDiagonalMatrix* block_diagonal) const {
+  CHECK(block_diagonal != nullptr);
+  CHECK_EQ(block_diagonal->num_rows(), num_cols_);
+  const int num_column_blocks = column_block_sizes_.size();
+  const int num_values =
+      num_column_blocks == 0
+          ? 0
+          : diagonal_block_positions_.back() +
+                column_block_sizes_.back() * column_block_sizes_.back();
+
+  ResetAccumulators(num_values);
+  const bool status = ForEachResidualBlock(
+      num_threads_, [&](int thread_id, int i, int row, double** jacobians) {
+        const ResidualBlock* residual_block = program_->residual_blocks()[i];
+        const int num_residuals = residual_block->NumResiduals();
+        double* accumulator = accumulators_[thread_id].data();
+        for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          const int size = parameter_block->LocalSize();
+          MatrixTransposeMatrixMultiply<Dynamic, Dynamic, Dynamic, Dynamic, 1>(
+              jacobians[j],
+              num_residuals,
+              size,
+              jacobians[j],
+              num_residuals,
+              size,
+              accumulator + diagonal_block_positions_[parameter_block->index()],
+              0,
+              0,
+              size,
+              size);
+        }
+      });
+
+  Vector values = Vector::Zero(num_values);
+  SumAccumulators(num_values, values.data());
+  for (int i = 0; i < num_column_blocks; ++i) {
+    int r, c, row_stride, col_stride;
+    CellInfo* cell_info =
+        block_diagonal->GetCell(i, i, &r, &c, &row_stride, &col_stride);
+    const int size = column_block_sizes_[i];
+    MatrixRef(cell_info->values, row_stride, col_stride).block(r, c, size, size) =
+        ConstMatrixRef(values.data() + diagonal_block_positions_[i], size, size);
+  }
+  return status;
+}
+
+void MatrixFreeJacobian::ToDenseMatrix(Matrix* dense_matrix) const {
+  CHECK(dense_matrix != nullptr);
+  dense_matrix->setZero(num_rows_, num_cols_);
+  ForEachResidualBlock(
+      num_threads_, [&](int thread_id, int i, int row, double** jacobians) {
+        const ResidualBlock* residual_block = program_->residual_blocks()[i];
+        const int num_residuals = residual_block->NumResiduals();
+        for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+          if (jacobians[j] == nullptr) {
+            continue;
+          }
+          const ParameterBlock* parameter_block =
+              residual_block->parameter_blocks()[j];
+          const int size = parameter_block->LocalSize();
+          dense_matrix->block(
+              row, parameter_block->delta_offset(), num_residuals, size) =
+              ConstMatrixRef(jacobians[j], num_residuals, size);
+        }
+      });
+}
+
+void MatrixFreeJacobian::ToTextFile(FILE* file) const {
+  CHECK(file != nullptr);
+  // The triplets are written in order, so use a single thread.
+  ForEachResidualBlock(1, [&](int thread_id, int i, int row, double** jacobians) {
+    const ResidualBlock* residual_block = program_->residual_blocks()[i];
+    const int num_residuals = residual_block->NumResiduals();
+    for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+      if (jacobians[j] == nullptr) {
+        continue;
+      }
+      const ParameterBlock* parameter_block =
+          residual_block->parameter_blocks()[j];
+      const int size = parameter_block->LocalSize();
+      const double* values = jacobians[j];
+      for (int r = 0; r < num_residuals; ++r) {
+        for (int c = 0; c < size; ++c) {
+          fprintf(file,
+                  "% 10d % 10d %17f\n",
+                  row + r,
+                  parameter_block->delta_offset() + c,
+                  *values++);
+        }
+      }
+    }
+  });
+}
+
+}  // namespace internal
+}  // namespace ceres
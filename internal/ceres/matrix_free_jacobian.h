@@ -0,0 +1,175 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// A Jacobian that is never stored. Products with it re-evaluate the
+// Jacobians of the residual blocks of a Program, one residual block
+// at a time.
+
+#ifndef CERES_INTERNAL_MATRIX_FREE_JACOBIAN_H_
+#define CERES_INTERNAL_MATRIX_FREE_JACOBIAN_H_
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ceres/internal/eigen.h"
+#include "ceres/internal/port.h"
+#include "ceres/sparse_matrix.h"
+
+namespace ceres {
+namespace internal {
+
+class BlockRandomAccessDiagonalMatrix;
+class ContextImpl;
+class Program;
+class ScratchEvaluatePreparer;
+
+// The Jacobian of a Program at the point where CaptureEvaluationPoint
+// was last called, with the loss functions applied and the columns
+// scaled by ScaleColumns.
+//
+// The memory used is proportional to the number of residual blocks
+// and parameters, and not to the number of non-zeros in the Jacobian.
+// The price is that every product evaluates all the residual blocks
+// of the Program with Jacobians. Residual blocks are evaluated in
+// parallel using up to num_threads threads from context.
+//
+// Products evaluate the residual blocks at the captured state and
+// then point the parameter blocks of the Program back at the state
+// they had before the product.
+//
+// The SparseMatrix interface has no way to report errors, so if a
+// residual block fails to evaluate during a product, the result of
+// the product is invalid and evaluation_failed() returns true until
+// the next call to CaptureEvaluationPoint.
+class CERES_EXPORT_INTERNAL MatrixFreeJacobian : public SparseMatrix {
+ public:
+  // program must outlive the Jacobian.
+  MatrixFreeJacobian(Program* program, ContextImpl* context, int num_threads);
+  MatrixFreeJacobian(const MatrixFreeJacobian&) = delete;
+  void operator=(const MatrixFreeJacobian&) = delete;
+  virtual ~MatrixFreeJacobian();
+
+  // Use the current state of the parameter blocks of the program as
+  // the point at which the Jacobian is evaluated.
+  void CaptureEvaluationPoint();
+
+  // True if a residual block failed to evaluate in a product since
+  // the last call to CaptureEvaluationPoint.
+  bool evaluation_failed() const { return evaluation_failed_; }
+
+  // SparseMatrix interface.
+  //
+  // Since there are no values to zero, SetZero resets the column
+  // scaling instead. It is called by the Evaluator before every
+  // evaluation of the Jacobian.
+  void SetZero() final;
+  void RightMultiply(const double* x, double* y) const final;
+  void LeftMultiply(const double* x, double* y) const final;
+  void SquaredColumnNorm(double* x) const final;
+  void ScaleColumns(const double* scale) final;
+  void ToDenseMatrix(Matrix* dense_matrix) const final;
+  void ToTextFile(FILE* file) const final;
+  double* mutable_values() final { return nullptr; }
+  const double* values() const final { return nullptr; }
+  int num_rows() const final { return num_rows_; }
+  int num_cols() const final { return num_cols_; }
+  // The number of structurally non-zero entries of the Jacobian.
+  int num_nonzeros() const final { return num_nonzeros_; }
+
+  // y += J'J x. Cheaper than a RightMultiply followed by a
+  // LeftMultiply, since the Jacobian of every residual block is only
+  // evaluated once.
+  void NormalEquationsRightMultiply(const double* x, double* y) const;
+
+  // The sizes of the column blocks of the Jacobian, i.e., the local
+  // sizes of the parameter blocks of the program.
+  const std::vector<int>& column_block_sizes() const {
+    return column_block_sizes_;
+  }
+
+  // Set the diagonal blocks of block_diagonal to the diagonal blocks
+  // of J'J. block_diagonal must have been created with
+  // column_block_sizes(). Returns false if a residual block failed to
+  // evaluate.
+  bool BlockDiagonalJtJ(BlockRandomAccessDiagonalMatrix* block_diagonal) const;
+
+ private:
+  // Call function(thread_id, residual_block_id, row, jacobians) for
+  // every residual block of the program, where jacobians contains
+  // the scaled Jacobians of the residual block with respect to its
+  // parameter blocks, or nullptr for the constant ones. Returns false,
+  // and sets evaluation_failed_, if a residual block failed to
+  // evaluate, in which case function may not have been called for
+  // all the residual blocks.
+  bool ForEachResidualBlock(
+      int num_threads,
+      const std::function<void(int, int, int, double**)>& function) const;
+
+  // Resize the per thread accumulators to size and zero them.
+  void ResetAccumulators(int size) const;
+
+  // y += the sum of the per thread accumulators, which have size
+  // entries.
+  void SumAccumulators(int size, double* y) const;
+
+  Program* program_;
+  ContextImpl* context_;
+  int num_threads_;
+
+  int num_rows_;
+  int num_cols_;
+  int num_nonzeros_;
+  // The position of the first row of each residual block.
+  std::vector<int> row_positions_;
+  std::vector<int> column_block_sizes_;
+  // The position of the diagonal block of each column block in
+  // the per thread accumulators used by BlockDiagonalJtJ.
+  std::vector<int> diagonal_block_positions_;
+
+  Vector state_;
+  Vector column_scale_;
+  mutable bool evaluation_failed_;
+  // The states of the parameter blocks before a product.
+  mutable std::vector<const double*> saved_states_;
+
+  // Per thread scratch space.
+  std::unique_ptr<ScratchEvaluatePreparer[]> evaluate_preparers_;
+  std::vector<std::unique_ptr<double[]>> evaluate_scratch_;
+  std::vector<std::unique_ptr<double*[]>> jacobian_block_ptrs_;
+  mutable std::vector<Vector> residual_scratch_;
+  mutable std::vector<Vector> accumulators_;
+};
+
+}  // namespace internal
+}  // namespace ceres
+
+#endif  // CERES_INTERNAL_MATRIX_FREE_JACOBIAN_H_
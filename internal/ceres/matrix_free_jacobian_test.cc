@@ -0,0 +1,312 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/matrix_free_jacobian.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ceres/autodiff_cost_function.h"
+#include "ceres/casts.h"
+#include "ceres/block_random_access_diagonal_matrix.h"
+#include "ceres/context_impl.h"
+#include "ceres/evaluator.h"
+#include "ceres/internal/eigen.h"
+#include "ceres/linear_solver.h"
+#include "ceres/local_parameterization.h"
+#include "ceres/loss_function.h"
+#include "ceres/parameter_block.h"
+#include "ceres/problem_impl.h"
+#include "ceres/program.h"
+#include "ceres/sized_cost_function.h"
+#include "ceres/sparse_matrix.h"
+#include "gtest/gtest.h"
+
+namespace ceres {
+namespace internal {
+
+namespace {
+
+// A nonlinear function of two parameter blocks.
+template <int kSize1, int kSize2>
+struct NonlinearFunctor {
+  template <typename T>
+  bool operator()(const T* x, const T* y, T* residuals) const {
+    using std::exp;
+    using std::sin;
+    residuals[0] = x[0] * y[0] - 1.0;
+    residuals[1] = sin(x[kSize1 - 1]) + y[kSize2 - 1] * y[0];
+    residuals[2] = x[0] * x[kSize1 - 1] + exp(0.1 * y[1 % kSize2]);
+    return true;
+  }
+};
+
+template <int kSize1, int kSize2>
+CostFunction* CreateCostFunction() {
+  return new AutoDiffCostFunction<NonlinearFunctor<kSize1, kSize2>,
+                                  3,
+                                  kSize1,
+                                  kSize2>(
+      new NonlinearFunctor<kSize1, kSize2>);
+}
+
+}  // namespace
+
+class MatrixFreeJacobianTest : public ::testing::Test {
+ protected:
+  void SetUp() final {
+    for (double* values : {x_, y_, z_, w_}) {
+      VectorRef(values, 3) = Vector::Random(3);
+    }
+
+    problem_.AddResidualBlock(CreateCostFunction<2, 3>(), nullptr, x_, y_);
+    problem_.AddResidualBlock(
+        CreateCostFunction<3, 3>(), new CauchyLoss(0.5), y_, z_);
+    problem_.AddResidualBlock(CreateCostFunction<3, 2>(), nullptr, z_, w_);
+    problem_.AddResidualBlock(
+        CreateCostFunction<2, 2>(), new HuberLoss(0.1), x_, w_);
+    problem_.AddResidualBlock(CreateCostFunction<2, 3>(), nullptr, x_, z_);
+    problem_.SetParameterization(z_,
+                                 new SubsetParameterization(3, {1}));
+
+    program_ = problem_.mutable_program();
+    program_->SetParameterOffsetsAndIndex();
+    problem_.context()->EnsureMinimumThreads(kNumThreads);
+
+    Evaluator::Options options;
+    options.linear_solver_type = CGNR;
+    options.num_eliminate_blocks = 0;
+    options.num_threads = kNumThreads;
+    options.context = problem_.context();
+    std::string error;
+    block_evaluator_.reset(Evaluator::Create(options, program_, &error));
+    options.use_matrix_free_jacobian = true;
+    matrix_free_evaluator_.reset(
+        Evaluator::Create(options, program_, &error));
+    ASSERT_TRUE(block_evaluator_ != nullptr);
+    ASSERT_TRUE(matrix_free_evaluator_ != nullptr);
+
+    block_jacobian_.reset(block_evaluator_->CreateJacobian(&error));
+    jacobian_.reset(down_cast<MatrixFreeJacobian*>(
+        matrix_free_evaluator_->CreateJacobian(&error)));
+    state_.resize(program_->NumParameters());
+    program_->ParameterBlocksToStateVector(state_.data());
+
+    double cost;
+    ASSERT_TRUE(block_evaluator_->Evaluate(
+        state_.data(), &cost, nullptr, nullptr, block_jacobian_.get()));
+    ASSERT_TRUE(matrix_free_evaluator_->Evaluate(
+        state_.data(), &cost, nullptr, nullptr, jacobian_.get()));
+
+    // Move the parameter blocks away from the evaluation point, which
+    // the products must not be affected by.
+    other_state_ = state_ + Vector::Ones(state_.size());
+    ASSERT_TRUE(matrix_free_evaluator_->Evaluate(
+        other_state_.data(), &cost, nullptr, nullptr, nullptr));
+  }
+
+  void ExpectProductsMatch() {
+    const double kTolerance = 1e-14;
+    const int num_rows = block_jacobian_->num_rows();
+    const int num_cols = block_jacobian_->num_cols();
+    ASSERT_EQ(jacobian_->num_rows(), num_rows);
+    ASSERT_EQ(jacobian_->num_cols(), num_cols);
+
+    Matrix expected_dense;
+    Matrix actual_dense;
+    block_jacobian_->ToDenseMatrix(&expected_dense);
+    jacobian_->ToDenseMatrix(&actual_dense);
+    EXPECT_NEAR((expected_dense - actual_dense).norm(), 0.0, kTolerance);
+
+    const Vector x = Vector::Random(num_cols);
+    Vector expected_y = Vector::Random(num_rows);
+    Vector actual_y = expected_y;
+    block_jacobian_->RightMultiply(x.data(), expected_y.data());
+    jacobian_->RightMultiply(x.data(), actual_y.data());
+    EXPECT_NEAR((expected_y - actual_y).norm(), 0.0, kTolerance);
+
+    const Vector y = Vector::Random(num_rows);
+    Vector expected_x = Vector::Random(num_cols);
+    Vector actual_x = expected_x;
+    block_jacobian_->LeftMultiply(y.data(), expected_x.data());
+    jacobian_->LeftMultiply(y.data(), actual_x.data());
+    EXPECT_NEAR((expected_x - actual_x).norm(), 0.0, kTolerance);
+
+    expected_x = Vector::Random(num_cols);
+    actual_x = expected_x;
+    expected_x += expected_dense.transpose() * (expected_dense * x);
+    jacobian_->NormalEquationsRightMultiply(x.data(), actual_x.data());
+    EXPECT_NEAR((expected_x - actual_x).norm(), 0.0, kTolerance);
+
+    Vector expected_norms(num_cols);
+    Vector actual_norms(num_cols);
+    block_jacobian_->SquaredColumnNorm(expected_norms.data());
+    jacobian_->SquaredColumnNorm(actual_norms.data());
+    EXPECT_NEAR((expected_norms - actual_norms).norm(), 0.0, kTolerance);
+
+    const Matrix jtj = expected_dense.transpose() * expected_dense;
+    BlockRandomAccessDiagonalMatrix block_diagonal(
+        jacobian_->column_block_sizes());
+    jacobian_->BlockDiagonalJtJ(&block_diagonal);
+    Matrix actual_block_diagonal;
+    block_diagonal.matrix()->ToDenseMatrix(&actual_block_diagonal);
+    int position = 0;
+    for (int size : jacobian_->column_block_sizes()) {
+      EXPECT_NEAR((jtj.block(position, position, size, size) -
+                   actual_block_diagonal.block(position, position, size, size))
+                      .norm(),
+                  0.0,
+                  kTolerance);
+      position += size;
+    }
+  }
+
+  static const int kNumThreads = 2;
+
+  double x_[3];
+  double y_[3];
+  double z_[3];
+  double w_[3];
+  ProblemImpl problem_;
+  Program* program_;
+  std::unique_ptr<Evaluator> block_evaluator_;
+  std::unique_ptr<Evaluator> matrix_free_evaluator_;
+  std::unique_ptr<SparseMatrix> block_jacobian_;
+  std::unique_ptr<MatrixFreeJacobian> jacobian_;
+  Vector state_;
+  Vector other_state_;
+};
+
+TEST_F(MatrixFreeJacobianTest, MatchesBlockSparseJacobian) {
+  ExpectProductsMatch();
+}
+
+TEST_F(MatrixFreeJacobianTest, ScaleColumns) {
+  const Vector scale = Vector::Random(jacobian_->num_cols());
+  block_jacobian_->ScaleColumns(scale.data());
+  jacobian_->ScaleColumns(scale.data());
+  ExpectProductsMatch();
+
+  // SetZero undoes the scaling, since the evaluator calls it before
+  // every evaluation.
+  jacobian_->SetZero();
+  double cost;
+  ASSERT_TRUE(block_evaluator_->Evaluate(
+      state_.data(), &cost, nullptr, nullptr, block_jacobian_.get()));
+  ExpectProductsMatch();
+}
+
+TEST_F(MatrixFreeJacobianTest, ProductsDoNotMoveTheParameterBlocks) {
+  std::vector<const double*> states;
+  for (const ParameterBlock* parameter_block : program_->parameter_blocks()) {
+    states.push_back(parameter_block->state());
+  }
+  ExpectProductsMatch();
+  for (int i = 0; i < states.size(); ++i) {
+    EXPECT_EQ(program_->parameter_blocks()[i]->state(), states[i]);
+  }
+}
+
+// Fails to evaluate once *fail is true.
+class FailingCostFunction : public SizedCostFunction<1, 1> {
+ public:
+  explicit FailingCostFunction(const bool* fail) : fail_(fail) {}
+
+  bool Evaluate(double const* const* parameters,
+                double* residuals,
+                double** jacobians) const final {
+    if (*fail_) {
+      return false;
+    }
+    residuals[0] = parameters[0][0] * parameters[0][0] - 1.0;
+    if (jacobians != nullptr && jacobians[0] != nullptr) {
+      jacobians[0][0] = 2.0 * parameters[0][0];
+    }
+    return true;
+  }
+
+ private:
+  const bool* fail_;
+};
+
+TEST(MatrixFreeJacobian, FailedEvaluationIsReportedByTheSolver) {
+  bool fail = false;
+  double x = 2.0;
+  ProblemImpl problem;
+  problem.AddResidualBlock(new FailingCostFunction(&fail), nullptr, &x);
+  Program* program = problem.mutable_program();
+  program->SetParameterOffsetsAndIndex();
+
+  Evaluator::Options evaluator_options;
+  evaluator_options.linear_solver_type = CGNR;
+  evaluator_options.num_eliminate_blocks = 0;
+  evaluator_options.use_matrix_free_jacobian = true;
+  evaluator_options.context = problem.context();
+  std::string error;
+  std::unique_ptr<Evaluator> evaluator(
+      Evaluator::Create(evaluator_options, program, &error));
+  ASSERT_TRUE(evaluator != nullptr) << error;
+  std::unique_ptr<MatrixFreeJacobian> jacobian(
+      down_cast<MatrixFreeJacobian*>(evaluator->CreateJacobian(&error)));
+  double cost;
+  double residual;
+  ASSERT_TRUE(
+      evaluator->Evaluate(&x, &cost, &residual, nullptr, jacobian.get()));
+  EXPECT_FALSE(jacobian->evaluation_failed());
+
+  LinearSolver::Options linear_solver_options;
+  linear_solver_options.type = CGNR;
+  linear_solver_options.preconditioner_type = JACOBI;
+  linear_solver_options.use_matrix_free_jacobian = true;
+  linear_solver_options.context = problem.context();
+  std::unique_ptr<LinearSolver> solver(
+      LinearSolver::Create(linear_solver_options));
+  double step;
+  LinearSolver::Summary summary = solver->Solve(
+      jacobian.get(), &residual, LinearSolver::PerSolveOptions(), &step);
+  EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_SUCCESS);
+
+  fail = true;
+  summary = solver->Solve(
+      jacobian.get(), &residual, LinearSolver::PerSolveOptions(), &step);
+  EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_FAILURE);
+  EXPECT_TRUE(jacobian->evaluation_failed());
+
+  // The failure is forgotten when the Jacobian is evaluated again.
+  fail = false;
+  ASSERT_TRUE(
+      evaluator->Evaluate(&x, &cost, &residual, nullptr, jacobian.get()));
+  EXPECT_FALSE(jacobian->evaluation_failed());
+}
+
+}  // namespace internal
+}  // namespace ceres
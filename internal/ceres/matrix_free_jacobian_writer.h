@@ -0,0 +1,88 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// A jacobian writer for MatrixFreeJacobian. Nothing is written; the
+// evaluation point is recorded when the evaluation is finalized.
+
+#ifndef CERES_INTERNAL_MATRIX_FREE_JACOBIAN_WRITER_H_
+#define CERES_INTERNAL_MATRIX_FREE_JACOBIAN_WRITER_H_
+
+#include <string>
+
+#include "ceres/casts.h"
+#include "ceres/evaluator.h"
+#include "ceres/matrix_free_jacobian.h"
+#include "ceres/program.h"
+#include "ceres/scratch_evaluate_preparer.h"
+
+namespace ceres {
+namespace internal {
+
+class MatrixFreeJacobianWriter {
+ public:
+  MatrixFreeJacobianWriter(Evaluator::Options options, Program* program)
+      : options_(options), program_(program) {}
+
+  // JacobianWriter interface.
+
+  // The jacobians are still needed to compute the gradient, so they
+  // are evaluated into scratch space.
+  ScratchEvaluatePreparer* CreateEvaluatePreparers(int num_threads) {
+    return ScratchEvaluatePreparer::Create(*program_, num_threads);
+  }
+
+  SparseMatrix* CreateJacobian(std::string* /* error */) const {
+    return new MatrixFreeJacobian(
+        program_, options_.context, options_.num_threads);
+  }
+
+  void Write(int /* residual_id */,
+             int /* residual_offset */,
+             double** /* jacobians */,
+             SparseMatrix* /* jacobian */) {}
+
+ private:
+  const Evaluator::Options options_;
+  Program* program_;
+};
+
+// The program evaluator sets the parameter blocks to the evaluation
+// point, so after a successful evaluation they hold the point at
+// which the Jacobian was evaluated.
+struct MatrixFreeJacobianFinalizer {
+  void operator()(SparseMatrix* jacobian, int /* num_parameters */) {
+    down_cast<MatrixFreeJacobian*>(jacobian)->CaptureEvaluationPoint();
+  }
+};
+
+}  // namespace internal
+}  // namespace ceres
+
+#endif  // CERES_INTERNAL_MATRIX_FREE_JACOBIAN_WRITER_H_
@@ -0,0 +1,158 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/memory_mapped_buffer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "ceres/file.h"
+#include "ceres/stringprintf.h"
+#include "glog/logging.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace ceres {
+namespace internal {
+
+using std::string;
+
+namespace {
+
+// mmap does not accept empty mappings.
+size_t MappedSize(size_t num_bytes) { return std::max<size_t>(num_bytes, 1); }
+
+}  // namespace
+
+MemoryMappedBuffer::MemoryMappedBuffer(void* data, size_t num_bytes)
+    : data_(data), num_bytes_(num_bytes) {}
+
+#ifdef _WIN32
+
+std::unique_ptr<MemoryMappedBuffer> MemoryMappedBuffer::Create(
+    const string& directory, size_t num_bytes, string* error) {
+  *error = "Memory mapped storage is not supported on this platform.";
+  return nullptr;
+}
+
+MemoryMappedBuffer::~MemoryMappedBuffer() {}
+void MemoryMappedBuffer::AdviseSequentialAccess() {}
+void MemoryMappedBuffer::AdviseRandomAccess() {}
+
+#else  // _WIN32
+
+std::unique_ptr<MemoryMappedBuffer> MemoryMappedBuffer::Create(
+    const string& directory, size_t num_bytes, string* error) {
+  string path = JoinPath(directory, "ceres-XXXXXX");
+  const int fd = mkstemp(&path[0]);
+  if (fd < 0) {
+    *error = StringPrintf("Unable to create a file in %s: %s",
+                          directory.c_str(),
+                          strerror(errno));
+    return nullptr;
+  }
+  // The mapping keeps the file alive.
+  unlink(path.c_str());
+
+  const size_t mapped_size = MappedSize(num_bytes);
+#if defined(__linux__)
+  const int status = posix_fallocate(fd, 0, mapped_size);
+#else
+  const int status = ftruncate(fd, mapped_size) == 0 ? 0 : errno;
+#endif  // defined(__linux__)
+  if (status != 0) {
+    *error = StringPrintf("Unable to reserve %zu bytes in %s: %s",
+                          mapped_size,
+                          directory.c_str(),
+                          strerror(status));
+    close(fd);
+    return nullptr;
+  }
+
+  void* data =
+      mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    *error = StringPrintf("Unable to map %zu bytes from %s: %s",
+                          mapped_size,
+                          directory.c_str(),
+                          strerror(errno));
+    return nullptr;
+  }
+
+  VLOG(2) << "Mapped " << mapped_size << " bytes from " << directory;
+  return std::unique_ptr<MemoryMappedBuffer>(
+      new MemoryMappedBuffer(data, num_bytes));
+}
+
+MemoryMappedBuffer::~MemoryMappedBuffer() {
+  munmap(data_, MappedSize(num_bytes_));
+}
+
+void MemoryMappedBuffer::AdviseSequentialAccess() {
+  madvise(data_, MappedSize(num_bytes_), MADV_SEQUENTIAL);
+}
+
+void MemoryMappedBuffer::AdviseRandomAccess() {
+  madvise(data_, MappedSize(num_bytes_), MADV_RANDOM);
+}
+
+#endif  // _WIN32
+
+double* AllocateValues(const string& directory,
+                       int num_values,
+                       std::unique_ptr<double[]>* heap_values,
+                       std::unique_ptr<MemoryMappedBuffer>* mapped_buffer,
+                       string* error) {
+  CHECK_GE(num_values, 0);
+  if (directory.empty()) {
+    heap_values->reset(new double[num_values]);
+    mapped_buffer->reset();
+    return heap_values->get();
+  }
+
+  std::unique_ptr<MemoryMappedBuffer> buffer =
+      MemoryMappedBuffer::Create(directory, num_values * sizeof(double), error);
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  *mapped_buffer = std::move(buffer);
+  heap_values->reset();
+  return static_cast<double*>((*mapped_buffer)->data());
+}
+
+}  // namespace internal
+}  // namespace ceres
@@ -0,0 +1,103 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Memory backed by a temporary file, for arrays that are too large
+// to fit in RAM.
+
+#ifndef CERES_INTERNAL_MEMORY_MAPPED_BUFFER_H_
+#define CERES_INTERNAL_MEMORY_MAPPED_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "ceres/internal/port.h"
+
+namespace ceres {
+namespace internal {
+
+// A block of memory that is mapped from a file created in a user
+// specified directory. The file is unlinked as soon as it is mapped,
+// so it disappears when the buffer is destroyed or the process
+// exits.
+//
+// Since the mapping is shared, the operating system writes pages
+// that do not fit in RAM back to the file instead of to swap, and
+// reads them again on demand. Disk space for the whole buffer is
+// reserved when it is created, so running out of space is reported
+// by Create instead of as a fault on first access.
+//
+// Only supported on POSIX systems.
+class CERES_EXPORT_INTERNAL MemoryMappedBuffer {
+ public:
+  // Returns nullptr and sets error if the buffer cannot be created.
+  // The contents of the buffer are zero.
+  static std::unique_ptr<MemoryMappedBuffer> Create(
+      const std::string& directory, size_t num_bytes, std::string* error);
+
+  MemoryMappedBuffer(const MemoryMappedBuffer&) = delete;
+  void operator=(const MemoryMappedBuffer&) = delete;
+  ~MemoryMappedBuffer();
+
+  void* data() const { return data_; }
+  size_t num_bytes() const { return num_bytes_; }
+
+  // Hint to the operating system that the buffer will be accessed
+  // sequentially, so that it reads ahead aggressively and evicts the
+  // pages behind the access early.
+  void AdviseSequentialAccess();
+
+  // Hint to the operating system that the buffer will be accessed in
+  // no particular order, so that it does not read ahead.
+  void AdviseRandomAccess();
+
+ private:
+  MemoryMappedBuffer(void* data, size_t num_bytes);
+
+  void* data_;
+  size_t num_bytes_;
+};
+
+// Allocate an array of num_values doubles, either on the heap if
+// directory is empty, or in a MemoryMappedBuffer in directory. In the
+// latter case, the buffer is returned in mapped_buffer, which owns
+// the array. Otherwise, the array is returned in heap_values. Returns
+// nullptr and sets error if the buffer cannot be created, in which
+// case heap_values and mapped_buffer are unchanged.
+double* AllocateValues(const std::string& directory,
+                       int num_values,
+                       std::unique_ptr<double[]>* heap_values,
+                       std::unique_ptr<MemoryMappedBuffer>* mapped_buffer,
+                       std::string* error);
+
+}  // namespace internal
+}  // namespace ceres
+
+#endif  // CERES_INTERNAL_MEMORY_MAPPED_BUFFER_H_
@@ -0,0 +1,119 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/memory_mapped_buffer.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace ceres {
+namespace internal {
+
+#ifndef _WIN32
+
+TEST(MemoryMappedBuffer, IsZeroInitializedAndWritable) {
+  const int kNumValues = 1 << 20;
+  std::string error;
+  std::unique_ptr<MemoryMappedBuffer> buffer = MemoryMappedBuffer::Create(
+      testing::TempDir(), kNumValues * sizeof(double), &error);
+  ASSERT_TRUE(buffer != nullptr) << error;
+  EXPECT_EQ(buffer->num_bytes(), kNumValues * sizeof(double));
+
+  buffer->AdviseSequentialAccess();
+  double* values = static_cast<double*>(buffer->data());
+  for (int i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(values[i], 0.0);
+    values[i] = i;
+  }
+  for (int i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(MemoryMappedBuffer, EmptyBuffer) {
+  std::string error;
+  std::unique_ptr<MemoryMappedBuffer> buffer =
+      MemoryMappedBuffer::Create(testing::TempDir(), 0, &error);
+  ASSERT_TRUE(buffer != nullptr) << error;
+  EXPECT_EQ(buffer->num_bytes(), 0u);
+  EXPECT_TRUE(buffer->data() != nullptr);
+}
+
+TEST(MemoryMappedBuffer, MissingDirectory) {
+  std::string error;
+  EXPECT_TRUE(MemoryMappedBuffer::Create(
+                  testing::TempDir() + "/ceres_does_not_exist", 8, &error) ==
+              nullptr);
+  EXPECT_FALSE(error.empty());
+}
+
+TEST(AllocateValues, MemoryMapped) {
+  std::unique_ptr<double[]> heap_values;
+  std::unique_ptr<MemoryMappedBuffer> mapped_buffer;
+  std::string error;
+  double* values = AllocateValues(
+      testing::TempDir(), 10, &heap_values, &mapped_buffer, &error);
+  EXPECT_TRUE(heap_values == nullptr);
+  ASSERT_TRUE(mapped_buffer != nullptr);
+  EXPECT_EQ(values, mapped_buffer->data());
+  EXPECT_EQ(mapped_buffer->num_bytes(), 10 * sizeof(double));
+}
+
+TEST(AllocateValues, MissingDirectoryIsAnError) {
+  std::unique_ptr<double[]> heap_values(new double[1]);
+  double* old_values = heap_values.get();
+  std::unique_ptr<MemoryMappedBuffer> mapped_buffer;
+  std::string error;
+  EXPECT_TRUE(AllocateValues(testing::TempDir() + "/ceres_does_not_exist",
+                             10,
+                             &heap_values,
+                             &mapped_buffer,
+                             &error) == nullptr);
+  EXPECT_FALSE(error.empty());
+  EXPECT_EQ(heap_values.get(), old_values);
+  EXPECT_TRUE(mapped_buffer == nullptr);
+}
+
+#endif  // _WIN32
+
+TEST(AllocateValues, Heap) {
+  std::unique_ptr<double[]> heap_values;
+  std::unique_ptr<MemoryMappedBuffer> mapped_buffer;
+  std::string error;
+  double* values =
+      AllocateValues("", 10, &heap_values, &mapped_buffer, &error);
+  EXPECT_TRUE(mapped_buffer == nullptr);
+  EXPECT_EQ(values, heap_values.get());
+}
+
+}  // namespace internal
+}  // namespace ceres
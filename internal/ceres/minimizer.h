@@ -45,8 +45,10 @@ namespace internal {
 class Evaluator;
 class SparseMatrix;
 class TrustRegionStrategy;
+class ContextImpl;
 class CoordinateDescentMinimizer;
 class LinearSolver;
+class Tracer;
 
 // Interface for non-linear least squares solvers.
 class CERES_EXPORT_INTERNAL Minimizer {
@@ -61,6 +63,8 @@ class CERES_EXPORT_INTERNAL Minimizer {
 
     void Init(const Solver::Options& options) {
       num_threads = options.num_threads;
+      context = nullptr;
+      tracer = nullptr;
       max_num_iterations = options.max_num_iterations;
       max_solver_time_in_seconds = options.max_solver_time_in_seconds;
       max_step_solver_retries = 5;
@@ -89,6 +93,8 @@ class CERES_EXPORT_INTERNAL Minimizer {
       max_lbfgs_rank = options.max_lbfgs_rank;
       use_approximate_eigenvalue_bfgs_scaling =
           options.use_approximate_eigenvalue_bfgs_scaling;
+      use_compact_lbfgs_representation =
+          options.use_compact_lbfgs_representation;
       line_search_interpolation_type = options.line_search_interpolation_type;
       min_line_search_step_size = options.min_line_search_step_size;
       line_search_sufficient_function_decrease =
@@ -105,6 +111,7 @@ class CERES_EXPORT_INTERNAL Minimizer {
           options.line_search_sufficient_curvature_decrease;
       max_line_search_step_expansion = options.max_line_search_step_expansion;
       inner_iteration_tolerance = options.inner_iteration_tolerance;
+      use_batched_inner_iterations = options.use_batched_inner_iterations;
       is_silent = (options.logging_type == SILENT);
       is_constrained = false;
       callbacks = options.callbacks;
@@ -114,6 +121,14 @@ class CERES_EXPORT_INTERNAL Minimizer {
     double max_solver_time_in_seconds;
     int num_threads;
 
+    // Context used to parallelize the minimizer's own vector
+    // operations. May be nullptr, in which case they are done on the
+    // calling thread.
+    ContextImpl* context;
+
+    // Records the iterations of the minimizer if not nullptr.
+    Tracer* tracer;
+
     // Number of times the linear solver should be retried in case of
     // numerical failure. The retries are done by exponentially scaling up
     // mu at each retry. This leads to stronger and stronger
@@ -138,6 +153,7 @@ class CERES_EXPORT_INTERNAL Minimizer {
     NonlinearConjugateGradientType nonlinear_conjugate_gradient_type;
     int max_lbfgs_rank;
     bool use_approximate_eigenvalue_bfgs_scaling;
+    bool use_compact_lbfgs_representation;
     LineSearchInterpolationType line_search_interpolation_type;
     double min_line_search_step_size;
     double line_search_sufficient_function_decrease;
@@ -148,6 +164,7 @@ class CERES_EXPORT_INTERNAL Minimizer {
     double line_search_sufficient_curvature_decrease;
     double max_line_search_step_expansion;
     double inner_iteration_tolerance;
+    bool use_batched_inner_iterations;
 
     // If true, then all logging is disabled.
     bool is_silent;
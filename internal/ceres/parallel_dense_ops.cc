@@ -0,0 +1,248 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/parallel_dense_ops.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "Eigen/Dense"
+#include "ceres/context_impl.h"
+#include "ceres/internal/eigen.h"
+#include "ceres/parallel_for.h"
+#include "ceres/parallel_utils.h"
+#include "glog/logging.h"
+
+namespace ceres {
+namespace internal {
+
+namespace {
+
+int NumTiles(int n) {
+  return (n + kParallelDenseOpsTileSize - 1) / kParallelDenseOpsTileSize;
+}
+
+int TileSize(int n, int tile) {
+  return std::min(kParallelDenseOpsTileSize,
+                  n - tile * kParallelDenseOpsTileSize);
+}
+
+ColMajorMatrixRef MakeRef(double* A, int num_rows, int num_cols, int lda) {
+  return ColMajorMatrixRef(
+      A, num_rows, num_cols, Eigen::Stride<Eigen::Dynamic, 1>(lda, 1));
+}
+
+ConstColMajorMatrixRef MakeRef(const double* A,
+                               int num_rows,
+                               int num_cols,
+                               int lda) {
+  return ConstColMajorMatrixRef(
+      A, num_rows, num_cols, Eigen::Stride<Eigen::Dynamic, 1>(lda, 1));
+}
+
+void ForEach(ContextImpl* context,
+             int num_threads,
+             int num_items,
+             const std::function<void(int)>& function) {
+  if (context == NULL || num_threads == 1 || num_items <= 1) {
+    for (int i = 0; i < num_items; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  ParallelFor(
+      context, 0, num_items, std::min(num_threads, num_items), function);
+}
+
+// Calls function(i, j) for all tiles 0 <= i <= j < num_tiles.
+void ForEachTilePair(ContextImpl* context,
+                     int num_threads,
+                     int num_tiles,
+                     const std::function<void(int, int)>& function) {
+  ForEach(context,
+          num_threads,
+          num_tiles * (num_tiles + 1) / 2,
+          [num_tiles, &function](int k) {
+            int i, j;
+            LinearIndexToUpperTriangularIndex(k, num_tiles, &i, &j);
+            function(i, j);
+          });
+}
+
+}  // namespace
+
+void ParallelSymmetricRankUpdate(ContextImpl* context,
+                                 int num_threads,
+                                 int num_rows,
+                                 int num_cols,
+                                 const double* A,
+                                 int lda,
+                                 double* C) {
+  const ConstColMajorMatrixRef a = MakeRef(A, num_rows, num_cols, lda);
+  ColMajorMatrixRef c = MakeRef(C, num_cols, num_cols, num_cols);
+  const int num_tiles = NumTiles(num_cols);
+
+  //   C(j, i) += A(:, j)^T A(:, i) for j >= i.
+  ForEachTilePair(context, num_threads, num_tiles, [&](int i, int j) {
+    const int row = j * kParallelDenseOpsTileSize;
+    const int col = i * kParallelDenseOpsTileSize;
+    const int num_block_rows = TileSize(num_cols, j);
+    const int num_block_cols = TileSize(num_cols, i);
+    if (i == j) {
+      c.block(row, col, num_block_rows, num_block_cols)
+          .selfadjointView<Eigen::Lower>()
+          .rankUpdate(a.middleCols(col, num_block_cols).transpose());
+    } else {
+      c.block(row, col, num_block_rows, num_block_cols).noalias() +=
+          a.middleCols(row, num_block_rows).transpose() *
+          a.middleCols(col, num_block_cols);
+    }
+  });
+}
+
+bool ParallelCholeskyFactorize(ContextImpl* context,
+                               int num_threads,
+                               int n,
+                               double* A) {
+  ColMajorMatrixRef a = MakeRef(A, n, n, n);
+  const int num_tiles = NumTiles(n);
+
+  // Right looking tiled factorization. For each column of tiles k,
+  // factorize the diagonal tile, solve for the tiles below it and
+  // then update the trailing lower triangle.
+  for (int k = 0; k < num_tiles; ++k) {
+    const int start = k * kParallelDenseOpsTileSize;
+    const int size = TileSize(n, k);
+    ColMajorMatrix diagonal_tile = a.block(start, start, size, size);
+    Eigen::LLT<Eigen::Ref<ColMajorMatrix>, Eigen::Lower> llt(diagonal_tile);
+    if (llt.info() != Eigen::Success) {
+      return false;
+    }
+    a.block(start, start, size, size).triangularView<Eigen::Lower>() =
+        diagonal_tile.triangularView<Eigen::Lower>();
+
+    const int num_trailing_tiles = num_tiles - k - 1;
+    if (num_trailing_tiles == 0) {
+      break;
+    }
+
+    const int trailing_start = start + size;
+    const int trailing_size = n - trailing_start;
+    const ColMajorMatrix& l_kk = diagonal_tile;
+
+    //   L(i, k) = A(i, k) L(k, k)^{-T}
+    ForEach(context, num_threads, num_trailing_tiles, [&](int t) {
+      const int row = trailing_start + t * kParallelDenseOpsTileSize;
+      const int num_block_rows = std::min(kParallelDenseOpsTileSize, n - row);
+      auto block = a.block(row, start, num_block_rows, size);
+      l_kk.transpose().triangularView<Eigen::Upper>().solveInPlace<
+          Eigen::OnTheRight>(block);
+    });
+
+    //   A(j, i) -= L(j, k) L(i, k)^T for j >= i > k.
+    const auto panel = a.block(trailing_start, start, trailing_size, size);
+    ForEachTilePair(
+        context, num_threads, num_trailing_tiles, [&](int i, int j) {
+          const int row = j * kParallelDenseOpsTileSize;
+          const int col = i * kParallelDenseOpsTileSize;
+          const int num_block_rows =
+              std::min(kParallelDenseOpsTileSize, trailing_size - row);
+          const int num_block_cols =
+              std::min(kParallelDenseOpsTileSize, trailing_size - col);
+          auto block = a.block(trailing_start + row,
+                               trailing_start + col,
+                               num_block_rows,
+                               num_block_cols);
+          if (i == j) {
+            block.selfadjointView<Eigen::Lower>().rankUpdate(
+                panel.middleRows(row, num_block_rows), -1.0);
+          } else {
+            block.noalias() -= panel.middleRows(row, num_block_rows) *
+                               panel.middleRows(col, num_block_cols).transpose();
+          }
+        });
+  }
+  return true;
+}
+
+void CholeskySolveInPlace(int n, const double* L, double* b) {
+  const ConstColMajorMatrixRef l = MakeRef(L, n, n, n);
+  VectorRef x(b, n);
+  l.triangularView<Eigen::Lower>().solveInPlace(x);
+  l.transpose().triangularView<Eigen::Upper>().solveInPlace(x);
+}
+
+void ParallelHouseholderQRSolve(ContextImpl* context,
+                                int num_threads,
+                                int num_rows,
+                                int num_cols,
+                                double* A,
+                                double* b,
+                                double* x) {
+  CHECK_GE(num_rows, num_cols);
+  ColMajorMatrixRef a = MakeRef(A, num_rows, num_cols, num_rows);
+  VectorRef rhs(b, num_rows);
+  const int num_tiles = NumTiles(num_cols);
+
+  // Blocked Householder QR. For each column of tiles, the panel is
+  // factorized on the calling thread and its reflectors are then
+  // applied to the trailing column tiles and to b in parallel.
+  for (int k = 0; k < num_tiles; ++k) {
+    const int start = k * kParallelDenseOpsTileSize;
+    const int size = TileSize(num_cols, k);
+    const int num_panel_rows = num_rows - start;
+    Eigen::HouseholderQR<ColMajorMatrix> qr(
+        a.block(start, start, num_panel_rows, size));
+    a.block(start, start, num_panel_rows, size) = qr.matrixQR();
+    const auto q_transpose = qr.householderQ().transpose();
+
+    // The last work item applies the reflectors to b.
+    const int num_trailing_tiles = num_tiles - k - 1;
+    ForEach(context, num_threads, num_trailing_tiles + 1, [&](int t) {
+      if (t == num_trailing_tiles) {
+        rhs.tail(num_panel_rows).applyOnTheLeft(q_transpose);
+        return;
+      }
+      const int col = start + size + t * kParallelDenseOpsTileSize;
+      const int num_block_cols =
+          std::min(kParallelDenseOpsTileSize, num_cols - col);
+      a.block(start, col, num_panel_rows, num_block_cols)
+          .applyOnTheLeft(q_transpose);
+    });
+  }
+
+  VectorRef(x, num_cols) = a.topLeftCorner(num_cols, num_cols)
+                               .triangularView<Eigen::Upper>()
+                               .solve(rhs.head(num_cols));
+}
+
+}  // namespace internal
+}  // namespace ceres
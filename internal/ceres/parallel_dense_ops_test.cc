@@ -0,0 +1,155 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/parallel_dense_ops.h"
+
+#include "Eigen/Dense"
+#include "ceres/context_impl.h"
+#include "ceres/internal/eigen.h"
+#include "gtest/gtest.h"
+
+namespace ceres {
+namespace internal {
+
+// The sizes are chosen so that there are several tiles, the last of
+// which is only partially filled.
+class ParallelDenseOpsTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() final {
+    n_ = GetParam();
+    srand(5);
+    context_.EnsureMinimumThreads(kNumThreads);
+  }
+
+  static constexpr int kNumThreads = 4;
+  int n_;
+  ContextImpl context_;
+};
+
+TEST_P(ParallelDenseOpsTest, SymmetricRankUpdate) {
+  const int num_rows = n_ + 7;
+  // Use a leading dimension larger than the number of rows.
+  const int lda = num_rows + 3;
+  ColMajorMatrix storage = ColMajorMatrix::Random(lda, n_);
+  const ColMajorMatrix A = storage.topRows(num_rows);
+  const ColMajorMatrix C0 = ColMajorMatrix::Random(n_, n_);
+  const ColMajorMatrix expected = C0 + A.transpose() * A;
+
+  ColMajorMatrix reference;
+  for (int num_threads = 1; num_threads <= kNumThreads; ++num_threads) {
+    ColMajorMatrix C = C0;
+    ParallelSymmetricRankUpdate(
+        &context_, num_threads, num_rows, n_, storage.data(), lda, C.data());
+    EXPECT_NEAR((C.triangularView<Eigen::Lower>().toDenseMatrix() -
+                 expected.triangularView<Eigen::Lower>().toDenseMatrix())
+                    .norm(),
+                0.0,
+                1e-12 * expected.norm());
+    // The upper triangle is not touched.
+    EXPECT_EQ(C.triangularView<Eigen::StrictlyUpper>().toDenseMatrix(),
+              C0.triangularView<Eigen::StrictlyUpper>().toDenseMatrix());
+    if (num_threads == 1) {
+      reference = C;
+    } else {
+      EXPECT_EQ(C, reference);
+    }
+  }
+}
+
+TEST_P(ParallelDenseOpsTest, CholeskyFactorizeAndSolve) {
+  const ColMajorMatrix M = ColMajorMatrix::Random(n_ + 5, n_);
+  ColMajorMatrix A = M.transpose() * M;
+  A.diagonal().array() += 1.0;
+  const Vector b = Vector::Random(n_);
+  const Vector expected = A.llt().solve(b);
+
+  Vector reference;
+  for (int num_threads = 1; num_threads <= kNumThreads; ++num_threads) {
+    ColMajorMatrix L = A;
+    ASSERT_TRUE(
+        ParallelCholeskyFactorize(&context_, num_threads, n_, L.data()));
+    Vector x = b;
+    CholeskySolveInPlace(n_, L.data(), x.data());
+    EXPECT_NEAR((x - expected).norm(), 0.0, 1e-10 * expected.norm());
+    if (num_threads == 1) {
+      reference = x;
+    } else {
+      EXPECT_EQ(x, reference);
+    }
+  }
+
+  ColMajorMatrix L = A;
+  EXPECT_TRUE(ParallelCholeskyFactorize(nullptr, 1, n_, L.data()));
+}
+
+TEST_P(ParallelDenseOpsTest, CholeskyFactorizeFailsForIndefiniteMatrix) {
+  ColMajorMatrix A = ColMajorMatrix::Identity(n_, n_);
+  A(n_ - 1, n_ - 1) = -1.0;
+  EXPECT_FALSE(
+      ParallelCholeskyFactorize(&context_, kNumThreads, n_, A.data()));
+}
+
+TEST_P(ParallelDenseOpsTest, HouseholderQRSolve) {
+  const int num_rows = 2 * n_ + 3;
+  const ColMajorMatrix A = ColMajorMatrix::Random(num_rows, n_);
+  const Vector b = Vector::Random(num_rows);
+  const Vector expected = A.householderQr().solve(b);
+
+  Vector reference;
+  for (int num_threads = 1; num_threads <= kNumThreads; ++num_threads) {
+    ColMajorMatrix lhs = A;
+    Vector rhs = b;
+    Vector x(n_);
+    ParallelHouseholderQRSolve(&context_,
+                               num_threads,
+                               num_rows,
+                               n_,
+                               lhs.data(),
+                               rhs.data(),
+                               x.data());
+    EXPECT_NEAR((x - expected).norm(), 0.0, 1e-10 * expected.norm());
+    if (num_threads == 1) {
+      reference = x;
+    } else {
+      EXPECT_EQ(x, reference);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Sizes,
+    ParallelDenseOpsTest,
+    ::testing::Values(1,
+                      kParallelDenseOpsTileSize,
+                      2 * kParallelDenseOpsTileSize + 17,
+                      3 * kParallelDenseOpsTileSize + 1));
+
+}  // namespace internal
+}  // namespace ceres
@@ -0,0 +1,178 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/parallel_vector_ops.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "ceres/context_impl.h"
+#include "ceres/internal/eigen.h"
+#include "ceres/parallel_for.h"
+
+namespace ceres {
+namespace internal {
+
+namespace {
+
+int NumChunks(int n) {
+  return (n + kParallelVectorOpsChunkSize - 1) / kParallelVectorOpsChunkSize;
+}
+
+// Calls function(start, size) for each chunk of an n-vector.
+void ForEachChunk(ContextImpl* context,
+                  int num_threads,
+                  int n,
+                  const std::function<void(int, int, int)>& function) {
+  const int num_chunks = NumChunks(n);
+  auto chunk_function = [n, &function](int chunk) {
+    const int start = chunk * kParallelVectorOpsChunkSize;
+    const int size = std::min(kParallelVectorOpsChunkSize, n - start);
+    function(chunk, start, size);
+  };
+
+  if (context == NULL || num_threads == 1 || num_chunks <= 1) {
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+      chunk_function(chunk);
+    }
+    return;
+  }
+
+  ParallelFor(context,
+              0,
+              num_chunks,
+              std::min(num_threads, num_chunks),
+              chunk_function);
+}
+
+}  // namespace
+
+double ParallelDot(ContextImpl* context,
+                   int num_threads,
+                   int n,
+                   const double* x,
+                   const double* y) {
+  if (n <= kParallelVectorOpsChunkSize) {
+    return ConstVectorRef(x, n).dot(ConstVectorRef(y, n));
+  }
+
+  std::vector<double> partial_sums(NumChunks(n));
+  ForEachChunk(
+      context, num_threads, n, [&](int chunk, int start, int size) {
+        partial_sums[chunk] =
+            ConstVectorRef(x + start, size).dot(ConstVectorRef(y + start, size));
+      });
+
+  double sum = 0.0;
+  for (const double partial_sum : partial_sums) {
+    sum += partial_sum;
+  }
+  return sum;
+}
+
+void ParallelAssign(
+    ContextImpl* context, int num_threads, int n, const double* x, double* y) {
+  ForEachChunk(context, num_threads, n, [&](int chunk, int start, int size) {
+    VectorRef(y + start, size) = ConstVectorRef(x + start, size);
+  });
+}
+
+void ParallelScale(
+    ContextImpl* context, int num_threads, int n, double a, double* y) {
+  ForEachChunk(context, num_threads, n, [&](int chunk, int start, int size) {
+    VectorRef(y + start, size) *= a;
+  });
+}
+
+void ParallelAxpy(ContextImpl* context,
+                  int num_threads,
+                  int n,
+                  double a,
+                  const double* x,
+                  double* y) {
+  ForEachChunk(context, num_threads, n, [&](int chunk, int start, int size) {
+    VectorRef(y + start, size) += a * ConstVectorRef(x + start, size);
+  });
+}
+
+void ParallelTransposedMatrixVectorMultiply(ContextImpl* context,
+                                            int num_threads,
+                                            int n,
+                                            int k,
+                                            const double* A,
+                                            const double* x,
+                                            double* z) {
+  VectorRef result(z, k);
+  if (n <= kParallelVectorOpsChunkSize) {
+    result.noalias() = ConstColMajorMatrixRef(
+                           A, n, k, Eigen::Stride<Eigen::Dynamic, 1>(n, 1))
+                           .transpose() *
+                       ConstVectorRef(x, n);
+    return;
+  }
+
+  // Column i of partial_products is the contribution of chunk i.
+  ColMajorMatrix partial_products(k, NumChunks(n));
+  ForEachChunk(
+      context, num_threads, n, [&](int chunk, int start, int size) {
+        partial_products.col(chunk).noalias() =
+            ConstColMajorMatrixRef(
+                A + start, size, k, Eigen::Stride<Eigen::Dynamic, 1>(n, 1))
+                .transpose() *
+            ConstVectorRef(x + start, size);
+      });
+
+  result.setZero();
+  for (int i = 0; i < partial_products.cols(); ++i) {
+    result += partial_products.col(i);
+  }
+}
+
+void ParallelMatrixVectorMultiply(ContextImpl* context,
+                                  int num_threads,
+                                  int n,
+                                  int k,
+                                  const double* A,
+                                  const double* x,
+                                  double beta,
+                                  double* y) {
+  ForEachChunk(context, num_threads, n, [&](int chunk, int start, int size) {
+    VectorRef y_chunk(y + start, size);
+    y_chunk *= beta;
+    y_chunk.noalias() +=
+        ConstColMajorMatrixRef(
+            A + start, size, k, Eigen::Stride<Eigen::Dynamic, 1>(n, 1)) *
+        ConstVectorRef(x, k);
+  });
+}
+
+}  // namespace internal
+}  // namespace ceres
@@ -0,0 +1,107 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Multithreaded versions of the BLAS level 1 and 2 operations used by
+// the line search minimizer. They are meant for vectors with millions of
+// entries, where a single thread cannot saturate the memory
+// bandwidth.
+
+#ifndef CERES_INTERNAL_PARALLEL_VECTOR_OPS_H_
+#define CERES_INTERNAL_PARALLEL_VECTOR_OPS_H_
+
+#include "ceres/internal/port.h"
+
+namespace ceres {
+namespace internal {
+
+class ContextImpl;
+
+// The vectors are split into chunks of this size, and each chunk is
+// processed by a single thread. Vectors shorter than this are
+// processed serially.
+constexpr int kParallelVectorOpsChunkSize = 1 << 16;
+
+// Returns the dot product of the n-vectors x and y. The partial sums
+// of the chunks are accumulated in a fixed order, so the result does
+// not depend on num_threads.
+//
+// For all the functions in this file, context may be NULL, in which
+// case the computation is done on the calling thread.
+CERES_EXPORT_INTERNAL double ParallelDot(ContextImpl* context,
+                                         int num_threads,
+                                         int n,
+                                         const double* x,
+                                         const double* y);
+
+// y = x.
+CERES_EXPORT_INTERNAL void ParallelAssign(
+    ContextImpl* context, int num_threads, int n, const double* x, double* y);
+
+// y = a * y.
+CERES_EXPORT_INTERNAL void ParallelScale(
+    ContextImpl* context, int num_threads, int n, double a, double* y);
+
+// y += a * x.
+CERES_EXPORT_INTERNAL void ParallelAxpy(ContextImpl* context,
+                                        int num_threads,
+                                        int n,
+                                        double a,
+                                        const double* x,
+                                        double* y);
+
+// In the following, A is an n x k column major matrix with leading
+// dimension n, i.e., column j of A starts at A + j * n. These are
+// meant for tall and skinny matrices, i.e., k << n.
+
+// z = A^T * x, where z is a k-vector. As with ParallelDot, the result
+// does not depend on num_threads.
+CERES_EXPORT_INTERNAL void ParallelTransposedMatrixVectorMultiply(
+    ContextImpl* context,
+    int num_threads,
+    int n,
+    int k,
+    const double* A,
+    const double* x,
+    double* z);
+
+// y = beta * y + A * x, where x is a k-vector.
+CERES_EXPORT_INTERNAL void ParallelMatrixVectorMultiply(ContextImpl* context,
+                                                        int num_threads,
+                                                        int n,
+                                                        int k,
+                                                        const double* A,
+                                                        const double* x,
+                                                        double beta,
+                                                        double* y);
+
+}  // namespace internal
+}  // namespace ceres
+
+#endif  // CERES_INTERNAL_PARALLEL_VECTOR_OPS_H_
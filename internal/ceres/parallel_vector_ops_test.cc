@@ -0,0 +1,125 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/parallel_vector_ops.h"
+
+#include <algorithm>
+
+#include "ceres/context_impl.h"
+#include "ceres/internal/eigen.h"
+#include "gtest/gtest.h"
+
+namespace ceres {
+namespace internal {
+
+class ParallelVectorOpsTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() final {
+    n_ = GetParam();
+    srand(5);
+    x_ = Vector::Random(n_);
+    y_ = Vector::Random(n_);
+    context_.EnsureMinimumThreads(kNumThreads);
+  }
+
+  static constexpr int kNumThreads = 4;
+  int n_;
+  Vector x_;
+  Vector y_;
+  ContextImpl context_;
+};
+
+TEST_P(ParallelVectorOpsTest, Dot) {
+  const double expected = x_.dot(y_);
+  const double tolerance = 1e-12 * n_;
+  for (int num_threads = 1; num_threads <= kNumThreads; ++num_threads) {
+    EXPECT_NEAR(
+        ParallelDot(&context_, num_threads, n_, x_.data(), y_.data()),
+        expected,
+        tolerance);
+  }
+  EXPECT_NEAR(
+      ParallelDot(nullptr, 1, n_, x_.data(), y_.data()), expected, tolerance);
+}
+
+TEST_P(ParallelVectorOpsTest, DotIsIndependentOfNumThreads) {
+  const double expected = ParallelDot(&context_, 1, n_, x_.data(), y_.data());
+  for (int num_threads = 2; num_threads <= kNumThreads; ++num_threads) {
+    EXPECT_EQ(ParallelDot(&context_, num_threads, n_, x_.data(), y_.data()),
+              expected);
+  }
+}
+
+TEST_P(ParallelVectorOpsTest, AssignScaleAndAxpy) {
+  Vector z(n_);
+  ParallelAssign(&context_, kNumThreads, n_, x_.data(), z.data());
+  EXPECT_EQ((z - x_).norm(), 0.0);
+
+  ParallelScale(&context_, kNumThreads, n_, -2.0, z.data());
+  EXPECT_EQ((z + 2.0 * x_).norm(), 0.0);
+
+  ParallelAxpy(&context_, kNumThreads, n_, 3.0, y_.data(), z.data());
+  EXPECT_NEAR((z - (3.0 * y_ - 2.0 * x_)).norm(), 0.0, 1e-12 * n_);
+}
+
+TEST_P(ParallelVectorOpsTest, MatrixVectorMultiply) {
+  const int k = 5;
+  const ColMajorMatrix a = ColMajorMatrix::Random(n_, k);
+  const Vector v = Vector::Random(k);
+  const double tolerance = 1e-12 * std::max(n_, 1);
+
+  Vector z(k);
+  ParallelTransposedMatrixVectorMultiply(
+      &context_, kNumThreads, n_, k, a.data(), x_.data(), z.data());
+  EXPECT_NEAR((z - a.transpose() * x_).norm(), 0.0, tolerance);
+
+  Vector z_serial(k);
+  ParallelTransposedMatrixVectorMultiply(
+      &context_, 1, n_, k, a.data(), x_.data(), z_serial.data());
+  EXPECT_EQ(z, z_serial);
+
+  Vector w = y_;
+  ParallelMatrixVectorMultiply(
+      &context_, kNumThreads, n_, k, a.data(), v.data(), 2.0, w.data());
+  EXPECT_NEAR((w - (2.0 * y_ + a * v)).norm(), 0.0, tolerance);
+}
+
+// The last size is not a multiple of the chunk size, so that the last
+// chunk is partial.
+INSTANTIATE_TEST_SUITE_P(
+    Sizes,
+    ParallelVectorOpsTest,
+    ::testing::Values(0,
+                      1,
+                      kParallelVectorOpsChunkSize,
+                      5 * kParallelVectorOpsChunkSize + 123));
+
+}  // namespace internal
+}  // namespace ceres
@@ -31,6 +31,7 @@
 #ifndef CERES_INTERNAL_PRECONDITIONER_H_
 #define CERES_INTERNAL_PRECONDITIONER_H_
 
+#include <utility>
 #include <vector>
 
 #include "ceres/casts.h"
@@ -47,6 +48,31 @@ namespace internal {
 class BlockSparseMatrix;
 class SparseMatrix;
 
+// The camera clustering used by a VisibilityBasedPreconditioner. It
+// only depends on the block structure of the linear system, so it
+// can be saved from one instance of the preconditioner and used to
+// initialize another one for a problem with the same or a similar
+// set of f_blocks. See Options::visibility_clustering below.
+struct CameraClustering {
+  // The preconditioner type the clustering was computed for.
+  PreconditionerType type = CLUSTER_JACOBI;
+  int num_clusters = 0;
+
+  // Mapping from cameras/f_blocks to clusters. Cameras which are not
+  // clustered yet are mapped to -1, as are the cameras beyond the end
+  // of the vector.
+  std::vector<int> cluster_membership;
+
+  // Cluster pairs (i, j) with i <= j, including the self pairs
+  // (i, i), whose camera pairs are present in the preconditioner.
+  std::vector<std::pair<int, int>> cluster_pairs;
+
+  // Camera pairs (i, j) with i <= j, whose cells are present in the
+  // preconditioner. Only written by the preconditioner, since it
+  // also depends on the e_blocks of the linear system.
+  std::vector<std::pair<int, int>> block_pairs;
+};
+
 class CERES_EXPORT_INTERNAL Preconditioner : public LinearOperator {
  public:
   struct Options {
@@ -104,6 +130,12 @@ class CERES_EXPORT_INTERNAL Preconditioner : public LinearOperator {
     int e_block_size = Eigen::Dynamic;
     int f_block_size = Eigen::Dynamic;
 
+    // If not NULL, CLUSTER_JACOBI and CLUSTER_TRIDIAGONAL reuse the
+    // camera clustering stored in it instead of computing it from
+    // scratch, and store the clustering they use in it. See
+    // visibility_based_preconditioner.h for details.
+    CameraClustering* visibility_clustering = nullptr;
+
     ContextImpl* context = nullptr;
   };
 
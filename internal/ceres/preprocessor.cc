@@ -83,6 +83,8 @@ void SetupCommonMinimizerOptions(PreprocessedProblem* pp) {
   Minimizer::Options& minimizer_options = pp->minimizer_options;
   minimizer_options = Minimizer::Options(options);
   minimizer_options.evaluator = pp->evaluator;
+  minimizer_options.context = pp->problem->context();
+  minimizer_options.tracer = pp->tracer;
 
   if (options.logging_type != SILENT) {
     pp->logging_callback.reset(new LoggingCallback(
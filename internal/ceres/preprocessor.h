@@ -42,6 +42,7 @@
 #include "ceres/iteration_callback.h"
 #include "ceres/linear_solver.h"
 #include "ceres/minimizer.h"
+#include "ceres/preconditioner.h"
 #include "ceres/problem_impl.h"
 #include "ceres/program.h"
 #include "ceres/solver.h"
@@ -82,12 +83,22 @@ class CERES_EXPORT_INTERNAL Preprocessor {
 struct PreprocessedProblem {
   PreprocessedProblem() : fixed_cost(0.0) {}
 
+  // Set by the caller of Preprocessor::Preprocess to record the
+  // evaluations, linear solves and minimizer iterations of the
+  // solve. May be nullptr.
+  Tracer* tracer = nullptr;
+
   std::string error;
   Solver::Options options;
   LinearSolver::Options linear_solver_options;
   Evaluator::Options evaluator_options;
   Minimizer::Options minimizer_options;
 
+  // Camera clustering shared with the linear solver via
+  // linear_solver_options.visibility_clustering, if
+  // options.visibility_clustering is used.
+  CameraClustering camera_clustering;
+
   ProblemImpl* problem;
   std::unique_ptr<ProblemImpl> gradient_checking_problem;
   std::unique_ptr<Program> reduced_program;
@@ -66,6 +66,18 @@ ResidualBlockId Problem::AddResidualBlock(CostFunction* cost_function,
       cost_function, loss_function, parameter_blocks, num_parameter_blocks);
 }
 
+void Problem::AddResidualBlocks(const vector<CostFunction*>& cost_functions,
+                                const vector<LossFunction*>& loss_functions,
+                                const vector<double*>& parameter_blocks,
+                                int num_threads,
+                                vector<ResidualBlockId>* residual_blocks) {
+  impl_->AddResidualBlocks(cost_functions,
+                           loss_functions,
+                           parameter_blocks,
+                           num_threads,
+                           residual_blocks);
+}
+
 void Problem::AddParameterBlock(double* values, int size) {
   impl_->AddParameterBlock(values, size);
 }
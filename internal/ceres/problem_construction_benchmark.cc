@@ -0,0 +1,256 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materils provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Benchmarks for the construction and modification of a Problem with a
+// bundle adjustment like structure. Each residual block depends on one
+// camera and one point, there are 10 residual blocks per point and
+// 1000 per camera.
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "ceres/problem.h"
+#include "ceres/sized_cost_function.h"
+
+namespace ceres {
+namespace internal {
+
+constexpr int kCameraSize = 9;
+constexpr int kPointSize = 3;
+constexpr int kResidualsPerPoint = 10;
+constexpr int kResidualsPerCamera = 1000;
+
+class ReprojectionError : public SizedCostFunction<2, kCameraSize, kPointSize> {
+ public:
+  bool Evaluate(double const* const* parameters,
+                double* residuals,
+                double** jacobians) const final {
+    return true;
+  }
+};
+
+class BenchmarkData {
+ public:
+  explicit BenchmarkData(const int num_residual_blocks)
+      : num_residual_blocks_(num_residual_blocks),
+        num_cameras_((num_residual_blocks + kResidualsPerCamera - 1) /
+                     kResidualsPerCamera),
+        num_points_((num_residual_blocks + kResidualsPerPoint - 1) /
+                    kResidualsPerPoint),
+        cameras_(num_cameras_ * kCameraSize, 0.0),
+        points_(num_points_ * kPointSize, 0.0) {}
+
+  // Adds the residual blocks to the problem and returns their ids.
+  void AddResidualBlocks(Problem* problem,
+                         std::vector<ResidualBlockId>* residual_block_ids) {
+    residual_block_ids->resize(num_residual_blocks_);
+    for (int i = 0; i < num_residual_blocks_; ++i) {
+      // Spread the observations of each point over distinct cameras.
+      double* camera = &cameras_[(i % num_cameras_) * kCameraSize];
+      double* point = &points_[(i / kResidualsPerPoint) * kPointSize];
+      (*residual_block_ids)[i] =
+          problem->AddResidualBlock(&cost_function_, nullptr, camera, point);
+    }
+  }
+
+  // Adds the residual blocks to the problem using a single call to
+  // Problem::AddResidualBlocks.
+  void AddResidualBlocksInBulk(Problem* problem,
+                               int num_threads,
+                               std::vector<ResidualBlockId>* residual_block_ids) {
+    std::vector<CostFunction*> cost_functions(num_residual_blocks_,
+                                              &cost_function_);
+    std::vector<double*> parameter_blocks(2 * num_residual_blocks_);
+    for (int i = 0; i < num_residual_blocks_; ++i) {
+      parameter_blocks[2 * i] = &cameras_[(i % num_cameras_) * kCameraSize];
+      parameter_blocks[2 * i + 1] =
+          &points_[(i / kResidualsPerPoint) * kPointSize];
+    }
+    residual_block_ids->clear();
+    problem->AddResidualBlocks(
+        cost_functions, {}, parameter_blocks, num_threads, residual_block_ids);
+  }
+
+  double* camera(int i) { return &cameras_[i * kCameraSize]; }
+  int num_cameras() const { return num_cameras_; }
+
+ private:
+  const int num_residual_blocks_;
+  const int num_cameras_;
+  const int num_points_;
+  std::vector<double> cameras_;
+  std::vector<double> points_;
+  ReprojectionError cost_function_;
+};
+
+Problem::Options ProblemOptions(const bool enable_fast_removal,
+                                const bool disable_all_safety_checks) {
+  Problem::Options options;
+  options.cost_function_ownership = DO_NOT_TAKE_OWNERSHIP;
+  options.enable_fast_removal = enable_fast_removal;
+  options.disable_all_safety_checks = disable_all_safety_checks;
+  return options;
+}
+
+// Arguments: number of residual blocks, enable_fast_removal and
+// disable_all_safety_checks.
+static void BM_AddResidualBlocks(benchmark::State& state) {
+  const int num_residual_blocks = state.range(0);
+  const Problem::Options options =
+      ProblemOptions(state.range(1) != 0, state.range(2) != 0);
+  BenchmarkData data(num_residual_blocks);
+  std::vector<ResidualBlockId> residual_block_ids;
+  for (auto _ : state) {
+    std::unique_ptr<Problem> problem(new Problem(options));
+    data.AddResidualBlocks(problem.get(), &residual_block_ids);
+    state.PauseTiming();
+    problem.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_residual_blocks);
+}
+
+// Arguments: number of residual blocks, enable_fast_removal and
+// number of threads.
+static void BM_AddResidualBlocksInBulk(benchmark::State& state) {
+  const int num_residual_blocks = state.range(0);
+  const Problem::Options options = ProblemOptions(state.range(1) != 0, false);
+  const int num_threads = state.range(2);
+  BenchmarkData data(num_residual_blocks);
+  std::vector<ResidualBlockId> residual_block_ids;
+  for (auto _ : state) {
+    std::unique_ptr<Problem> problem(new Problem(options));
+    data.AddResidualBlocksInBulk(
+        problem.get(), num_threads, &residual_block_ids);
+    state.PauseTiming();
+    problem.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_residual_blocks);
+}
+
+// Remove every other residual block. Arguments: number of residual
+// blocks and enable_fast_removal.
+static void BM_RemoveResidualBlocks(benchmark::State& state) {
+  const int num_residual_blocks = state.range(0);
+  const Problem::Options options = ProblemOptions(state.range(1) != 0, false);
+  BenchmarkData data(num_residual_blocks);
+  std::vector<ResidualBlockId> residual_block_ids;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<Problem> problem(new Problem(options));
+    data.AddResidualBlocks(problem.get(), &residual_block_ids);
+    state.ResumeTiming();
+    for (int i = 0; i < num_residual_blocks; i += 2) {
+      problem->RemoveResidualBlock(residual_block_ids[i]);
+    }
+    state.PauseTiming();
+    problem.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * (num_residual_blocks / 2));
+}
+
+// Remove all the cameras, and with them all the residual blocks.
+// Arguments: number of residual blocks.
+static void BM_RemoveParameterBlocks(benchmark::State& state) {
+  const int num_residual_blocks = state.range(0);
+  const Problem::Options options = ProblemOptions(true, false);
+  BenchmarkData data(num_residual_blocks);
+  std::vector<ResidualBlockId> residual_block_ids;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<Problem> problem(new Problem(options));
+    data.AddResidualBlocks(problem.get(), &residual_block_ids);
+    state.ResumeTiming();
+    for (int i = 0; i < data.num_cameras(); ++i) {
+      problem->RemoveParameterBlock(data.camera(i));
+    }
+    state.PauseTiming();
+    problem.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_residual_blocks);
+}
+
+BENCHMARK(BM_AddResidualBlocks)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      for (int num_residual_blocks = 100000; num_residual_blocks <= 10000000;
+           num_residual_blocks *= 10) {
+        for (int enable_fast_removal = 0; enable_fast_removal < 2;
+             ++enable_fast_removal) {
+          for (int disable_all_safety_checks = 0;
+               disable_all_safety_checks < 2;
+               ++disable_all_safety_checks) {
+            benchmark->Args({num_residual_blocks,
+                             enable_fast_removal,
+                             disable_all_safety_checks});
+          }
+        }
+      }
+    })
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_AddResidualBlocksInBulk)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      for (int num_residual_blocks = 100000; num_residual_blocks <= 10000000;
+           num_residual_blocks *= 10) {
+        for (int enable_fast_removal = 0; enable_fast_removal < 2;
+             ++enable_fast_removal) {
+          for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+            benchmark->Args(
+                {num_residual_blocks, enable_fast_removal, num_threads});
+          }
+        }
+      }
+    })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Without fast removal, every removal scans all the residual blocks,
+// so only small problems are benchmarked.
+BENCHMARK(BM_RemoveResidualBlocks)
+    ->Args({10000, 0})
+    ->Args({100000, 1})
+    ->Args({1000000, 1})
+    ->Args({10000000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_RemoveParameterBlocks)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace internal
+}  // namespace ceres
+
+BENCHMARK_MAIN();
@@ -38,6 +38,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -53,6 +54,7 @@
 #include "ceres/internal/port.h"
 #include "ceres/loss_function.h"
 #include "ceres/map_util.h"
+#include "ceres/parallel_for.h"
 #include "ceres/parameter_block.h"
 #include "ceres/program.h"
 #include "ceres/program_evaluator.h"
@@ -65,11 +67,16 @@
 namespace ceres {
 namespace internal {
 
-using std::map;
 using std::string;
 using std::vector;
 
 namespace {
+
+// Parameter blocks up to this size are found by probing
+// parameter_block_map_ when checking new parameter blocks for
+// aliasing. See ProblemImpl::CheckForNoAliasingWithExistingBlocks.
+constexpr int kMaxProbedParameterBlockSize = 32;
+
 // Returns true if two regions of memory, a and b, with sizes size_a and size_b
 // respectively, overlap.
 bool RegionsAlias(const double* a, int size_a, const double* b, int size_b) {
@@ -89,9 +96,45 @@ void CheckForNoAliasing(double* existing_block,
       << "size " << new_block_size << ".";
 }
 
+// Dies if any of the parameter_blocks occurs more than once.
+void CheckForNoDuplicates(double* const* const parameter_blocks,
+                          int num_parameter_blocks) {
+  vector<double*> sorted_parameter_blocks(
+      parameter_blocks, parameter_blocks + num_parameter_blocks);
+  sort(sorted_parameter_blocks.begin(), sorted_parameter_blocks.end());
+  const bool has_duplicate_items =
+      (std::adjacent_find(sorted_parameter_blocks.begin(),
+                          sorted_parameter_blocks.end()) !=
+       sorted_parameter_blocks.end());
+  if (has_duplicate_items) {
+    string blocks;
+    for (int i = 0; i < num_parameter_blocks; ++i) {
+      blocks += StringPrintf(" %p ", parameter_blocks[i]);
+    }
+
+    LOG(FATAL) << "Duplicate parameter blocks in a residual parameter "
+               << "are not allowed. Parameter block pointers: [" << blocks
+               << "]";
+  }
+}
+
+// Dies if the sizes of the parameter blocks do not match the block
+// sizes expected by the cost_function.
+void CheckParameterBlockSizes(const CostFunction& cost_function,
+                              ParameterBlock* const* parameter_blocks) {
+  const vector<int32_t>& parameter_block_sizes =
+      cost_function.parameter_block_sizes();
+  for (int i = 0; i < parameter_block_sizes.size(); ++i) {
+    CHECK_EQ(parameter_block_sizes[i], parameter_blocks[i]->Size())
+        << "The cost function expects parameter block " << i << " of size "
+        << parameter_block_sizes[i] << " but was given a block of size "
+        << parameter_blocks[i]->Size();
+  }
+}
+
 template <typename KeyType>
 void DecrementValueOrDeleteKey(const KeyType key,
-                               std::map<KeyType, int>* container) {
+                               std::unordered_map<KeyType, int>* container) {
   auto it = container->find(key);
   if (it->second == 1) {
     delete key;
@@ -124,6 +167,37 @@ void InitializeContext(Context* context,
 
 }  // namespace
 
+// parameter_block_map_ is a hash map, so it cannot be used to find
+// the neighbours in memory of a new parameter block. Instead, the
+// addresses at which a parameter block overlapping the new one could
+// start are looked up in it. These are the addresses of the new block
+// itself, and the max_probed_parameter_block_size_ - 1 addresses
+// before it. This costs O(size + max_probed_parameter_block_size_)
+// lookups. Parameter blocks larger than kMaxProbedParameterBlockSize
+// would make this expensive, so they are checked against directly
+// instead. There are rarely more than a few of them.
+void ProblemImpl::CheckForNoAliasingWithExistingBlocks(double* values,
+                                                      int size) {
+  // Do not probe below address 0.
+  const int num_addresses_before = static_cast<int>(
+      std::min<uintptr_t>(max_probed_parameter_block_size_ - 1,
+                          reinterpret_cast<uintptr_t>(values) / sizeof(double)));
+  for (double* start = values - num_addresses_before; start < values + size;
+       ++start) {
+    const auto it = parameter_block_map_.find(start);
+    if (it != parameter_block_map_.end()) {
+      CheckForNoAliasing(start, it->second->Size(), values, size);
+    }
+  }
+
+  for (ParameterBlock* large_parameter_block : large_parameter_blocks_) {
+    CheckForNoAliasing(large_parameter_block->mutable_user_state(),
+                       large_parameter_block->Size(),
+                       values,
+                       size);
+  }
+}
+
 ParameterBlock* ProblemImpl::InternalAddParameterBlock(double* values,
                                                        int size) {
   CHECK(values != nullptr) << "Null pointer passed to AddParameterBlock "
@@ -145,22 +219,7 @@ ParameterBlock* ProblemImpl::InternalAddParameterBlock(double* values,
   if (!options_.disable_all_safety_checks) {
     // Before adding the parameter block, also check that it doesn't alias any
     // other parameter blocks.
-    if (!parameter_block_map_.empty()) {
-      ParameterMap::iterator lb = parameter_block_map_.lower_bound(values);
-
-      // If lb is not the first block, check the previous block for aliasing.
-      if (lb != parameter_block_map_.begin()) {
-        ParameterMap::iterator previous = lb;
-        --previous;
-        CheckForNoAliasing(
-            previous->first, previous->second->Size(), values, size);
-      }
-
-      // If lb is not off the end, check lb for aliasing.
-      if (lb != parameter_block_map_.end()) {
-        CheckForNoAliasing(lb->first, lb->second->Size(), values, size);
-      }
-    }
+    CheckForNoAliasingWithExistingBlocks(values, size);
   }
 
   // Pass the index of the new parameter block as well to keep the index in
@@ -175,6 +234,14 @@ ParameterBlock* ProblemImpl::InternalAddParameterBlock(double* values,
   }
   parameter_block_map_[values] = new_parameter_block;
   program_->parameter_blocks_.push_back(new_parameter_block);
+  if (!options_.disable_all_safety_checks) {
+    if (size > kMaxProbedParameterBlockSize) {
+      large_parameter_blocks_.push_back(new_parameter_block);
+    } else {
+      max_probed_parameter_block_size_ =
+          std::max(max_probed_parameter_block_size_, size);
+    }
+  }
   return new_parameter_block;
 }
 
@@ -235,6 +302,13 @@ void ProblemImpl::DeleteBlock(ParameterBlock* parameter_block) {
         parameter_block->mutable_local_parameterization());
   }
   parameter_block_map_.erase(parameter_block->mutable_user_state());
+  if (!options_.disable_all_safety_checks &&
+      parameter_block->Size() > kMaxProbedParameterBlockSize) {
+    large_parameter_blocks_.erase(
+        std::find(large_parameter_blocks_.begin(),
+                  large_parameter_blocks_.end(),
+                  parameter_block));
+  }
   delete parameter_block;
 }
 
@@ -293,25 +367,7 @@ ResidualBlockId ProblemImpl::AddResidualBlock(
     CHECK_EQ(parameter_block_sizes.size(), num_parameter_blocks)
         << "Number of blocks input is different than the number of blocks "
         << "that the cost function expects.";
-
-    // Check for duplicate parameter blocks.
-    vector<double*> sorted_parameter_blocks(
-        parameter_blocks, parameter_blocks + num_parameter_blocks);
-    sort(sorted_parameter_blocks.begin(), sorted_parameter_blocks.end());
-    const bool has_duplicate_items =
-        (std::adjacent_find(sorted_parameter_blocks.begin(),
-                            sorted_parameter_blocks.end()) !=
-         sorted_parameter_blocks.end());
-    if (has_duplicate_items) {
-      string blocks;
-      for (int i = 0; i < num_parameter_blocks; ++i) {
-        blocks += StringPrintf(" %p ", parameter_blocks[i]);
-      }
-
-      LOG(FATAL) << "Duplicate parameter blocks in a residual parameter "
-                 << "are not allowed. Parameter block pointers: [" << blocks
-                 << "]";
-    }
+    CheckForNoDuplicates(parameter_blocks, num_parameter_blocks);
   }
 
   // Add parameter blocks and convert the double*'s to parameter blocks.
@@ -324,14 +380,7 @@ ResidualBlockId ProblemImpl::AddResidualBlock(
   if (!options_.disable_all_safety_checks) {
     // Check that the block sizes match the block sizes expected by the
     // cost_function.
-    for (int i = 0; i < parameter_block_ptrs.size(); ++i) {
-      CHECK_EQ(cost_function->parameter_block_sizes()[i],
-               parameter_block_ptrs[i]->Size())
-          << "The cost function expects parameter block " << i << " of size "
-          << cost_function->parameter_block_sizes()[i]
-          << " but was given a block of size "
-          << parameter_block_ptrs[i]->Size();
-    }
+    CheckParameterBlockSizes(*cost_function, parameter_block_ptrs.data());
   }
 
   ResidualBlock* new_residual_block =
@@ -368,6 +417,118 @@ ResidualBlockId ProblemImpl::AddResidualBlock(
   return new_residual_block;
 }
 
+void ProblemImpl::AddResidualBlocks(
+    const vector<CostFunction*>& cost_functions,
+    const vector<LossFunction*>& loss_functions,
+    const vector<double*>& parameter_blocks,
+    int num_threads,
+    vector<ResidualBlockId>* residual_blocks) {
+  const int num_residual_blocks = cost_functions.size();
+  CHECK(loss_functions.empty() ||
+        loss_functions.size() == num_residual_blocks)
+      << "loss_functions must be empty or have the same size as "
+      << "cost_functions.";
+
+  // offsets[i] is the position in parameter_blocks of the first
+  // parameter block of the i^th residual block.
+  vector<int> offsets(num_residual_blocks + 1);
+  offsets[0] = 0;
+  for (int i = 0; i < num_residual_blocks; ++i) {
+    CHECK(cost_functions[i] != nullptr);
+    offsets[i + 1] =
+        offsets[i] + cost_functions[i]->parameter_block_sizes().size();
+  }
+  CHECK_EQ(offsets.back(), parameter_blocks.size())
+      << "Number of parameter blocks input is different than the number "
+      << "of parameter blocks that the cost functions expect.";
+
+#ifdef CERES_NO_THREADS
+  if (num_threads > 1) {
+    LOG(WARNING) << "No threading support is compiled into this binary; "
+                 << "only num_threads = 1 is supported. Switching to "
+                 << "single threaded mode.";
+  }
+  num_threads = 1;
+#endif  // CERES_NO_THREADS
+  num_threads = std::max(num_threads, 1);
+
+  // The main thread also does work so we only need to launch num_threads - 1.
+  context_impl_->EnsureMinimumThreads(num_threads - 1);
+
+  if (!options_.disable_all_safety_checks) {
+    ParallelFor(
+        context_impl_, 0, num_residual_blocks, num_threads, [&](int i) {
+          CheckForNoDuplicates(parameter_blocks.data() + offsets[i],
+                               offsets[i + 1] - offsets[i]);
+        });
+  }
+
+  // Adding the parameter blocks modifies the parameter block map and
+  // the program, so it is done serially.
+  vector<ParameterBlock*> parameter_block_ptrs(parameter_blocks.size());
+  for (int i = 0; i < num_residual_blocks; ++i) {
+    const vector<int32_t>& parameter_block_sizes =
+        cost_functions[i]->parameter_block_sizes();
+    for (int j = offsets[i]; j < offsets[i + 1]; ++j) {
+      parameter_block_ptrs[j] = InternalAddParameterBlock(
+          parameter_blocks[j], parameter_block_sizes[j - offsets[i]]);
+    }
+  }
+
+  const int first_index = program_->residual_blocks_.size();
+  program_->residual_blocks_.resize(first_index + num_residual_blocks);
+  ResidualBlock** new_residual_blocks =
+      program_->residual_blocks_.data() + first_index;
+  ParallelFor(
+      context_impl_, 0, num_residual_blocks, num_threads, [&](int i) {
+        ParameterBlock** residual_parameter_blocks =
+            parameter_block_ptrs.data() + offsets[i];
+        if (!options_.disable_all_safety_checks) {
+          CheckParameterBlockSizes(*cost_functions[i],
+                                   residual_parameter_blocks);
+        }
+        new_residual_blocks[i] = new ResidualBlock(
+            cost_functions[i],
+            loss_functions.empty() ? nullptr : loss_functions[i],
+            vector<ParameterBlock*>(residual_parameter_blocks,
+                                    parameter_block_ptrs.data() +
+                                        offsets[i + 1]),
+            first_index + i);
+      });
+
+  if (options_.enable_fast_removal) {
+    residual_block_set_.reserve(residual_block_set_.size() +
+                                num_residual_blocks);
+    for (int i = 0; i < num_residual_blocks; ++i) {
+      ResidualBlock* residual_block = new_residual_blocks[i];
+      residual_block_set_.insert(residual_block);
+      for (int j = offsets[i]; j < offsets[i + 1]; ++j) {
+        parameter_block_ptrs[j]->AddResidualBlock(residual_block);
+      }
+    }
+  }
+
+  if (options_.cost_function_ownership == TAKE_OWNERSHIP) {
+    for (CostFunction* cost_function : cost_functions) {
+      ++cost_function_ref_count_[cost_function];
+    }
+  }
+
+  if (options_.loss_function_ownership == TAKE_OWNERSHIP) {
+    for (LossFunction* loss_function : loss_functions) {
+      if (loss_function != nullptr) {
+        ++loss_function_ref_count_[loss_function];
+      }
+    }
+  }
+
+  if (residual_blocks != nullptr) {
+    residual_blocks->insert(residual_blocks->end(),
+                            new_residual_blocks,
+                            new_residual_blocks + num_residual_blocks);
+  }
+}
+
 void ProblemImpl::AddParameterBlock(double* values, int size) {
   InternalAddParameterBlock(values, size);
 }
@@ -716,8 +877,10 @@ bool ProblemImpl::Evaluate(const Problem::EvaluateOptions& evaluate_options,
 
   std::unique_ptr<CompressedRowSparseMatrix> tmp_jacobian;
   if (jacobian != nullptr) {
-    tmp_jacobian.reset(
-        down_cast<CompressedRowSparseMatrix*>(evaluator->CreateJacobian()));
+    std::string error;
+    tmp_jacobian.reset(down_cast<CompressedRowSparseMatrix*>(
+        evaluator->CreateJacobian(&error)));
+    CHECK(tmp_jacobian != nullptr) << error;
   }
 
   // Point the state pointers to the user state pointers. This is
@@ -849,10 +1012,14 @@ bool ProblemImpl::HasParameterBlock(const double* parameter_block) const {
 void ProblemImpl::GetParameterBlocks(vector<double*>* parameter_blocks) const {
   CHECK(parameter_blocks != nullptr);
   parameter_blocks->resize(0);
-  parameter_blocks->reserve(parameter_block_map_.size());
-  for (const auto& entry : parameter_block_map_) {
-    parameter_blocks->push_back(entry.first);
+  parameter_blocks->reserve(program_->parameter_blocks_.size());
+  for (const ParameterBlock* parameter_block : program_->parameter_blocks_) {
+    parameter_blocks->push_back(
+        const_cast<double*>(parameter_block->user_state()));
   }
+  // parameter_block_map_ is not ordered, but the parameter blocks have
+  // always been returned in increasing order of their addresses.
+  std::sort(parameter_blocks->begin(), parameter_blocks->end());
 }
 
 void ProblemImpl::GetResidualBlocks(
@@ -40,8 +40,8 @@
 #define CERES_PUBLIC_PROBLEM_IMPL_H_
 
 #include <array>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -65,10 +65,10 @@ class ResidualBlock;
 
 class CERES_EXPORT_INTERNAL ProblemImpl {
  public:
-  typedef std::map<double*, ParameterBlock*> ParameterMap;
+  typedef std::unordered_map<double*, ParameterBlock*> ParameterMap;
   typedef std::unordered_set<ResidualBlock*> ResidualBlockSet;
-  typedef std::map<CostFunction*, int> CostFunctionRefCount;
-  typedef std::map<LossFunction*, int> LossFunctionRefCount;
+  typedef std::unordered_map<CostFunction*, int> CostFunctionRefCount;
+  typedef std::unordered_map<LossFunction*, int> LossFunctionRefCount;
 
   ProblemImpl();
   explicit ProblemImpl(const Problem::Options& options);
@@ -95,6 +95,12 @@ class CERES_EXPORT_INTERNAL ProblemImpl {
                             static_cast<int>(parameter_blocks.size()));
   }
 
+  void AddResidualBlocks(const std::vector<CostFunction*>& cost_functions,
+                         const std::vector<LossFunction*>& loss_functions,
+                         const std::vector<double*>& parameter_blocks,
+                         int num_threads,
+                         std::vector<ResidualBlockId>* residual_blocks);
+
   void AddParameterBlock(double* values, int size);
   void AddParameterBlock(double* values,
                          int size,
@@ -169,6 +175,7 @@ class CERES_EXPORT_INTERNAL ProblemImpl {
 
  private:
   ParameterBlock* InternalAddParameterBlock(double* values, int size);
+  void CheckForNoAliasingWithExistingBlocks(double* values, int size);
   void InternalRemoveResidualBlock(ResidualBlock* residual_block);
 
   // Delete the arguments in question. These differ from the Remove* functions
@@ -188,6 +195,14 @@ class CERES_EXPORT_INTERNAL ProblemImpl {
   // The mapping from user pointers to parameter blocks.
   ParameterMap parameter_block_map_;
 
+  // Iff safety checks are enabled, the largest size of the parameter
+  // blocks that are not larger than kMaxProbedParameterBlockSize, and
+  // the parameter blocks that are. See
+  // CheckForNoAliasingWithExistingBlocks. The size is not decreased
+  // when parameter blocks are removed.
+  int max_probed_parameter_block_size_ = 1;
+  std::vector<ParameterBlock*> large_parameter_blocks_;
+
   // Iff enable_fast_removal is enabled, contains the current residual blocks.
   ResidualBlockSet residual_block_set_;
 
@@ -45,6 +45,7 @@
 #include "ceres/parameter_block.h"
 #include "ceres/problem_impl.h"
 #include "ceres/program.h"
+#include "ceres/residual_block.h"
 #include "ceres/sized_cost_function.h"
 #include "ceres/sparse_matrix.h"
 #include "ceres/types.h"
@@ -269,6 +270,35 @@ TEST(Problem, AddParameterWithAliasedParametersDies) {
   ASSERT_EQ(5, problem.NumParameterBlocks());
 }
 
+TEST(Problem, AddParameterWithAliasedLargeParametersDies) {
+  // x covers 5, ..., 44 and y covers 48, ..., 97.
+  //
+  // x and y are larger than the blocks ProblemImpl finds by probing
+  // its hash map of parameter blocks.
+
+  Problem problem;
+  problem.AddParameterBlock(IntToPtr(5), 40);   // x
+  problem.AddParameterBlock(IntToPtr(48), 50);  // y
+
+  EXPECT_DEATH_IF_SUPPORTED(problem.AddParameterBlock(IntToPtr(44), 5),
+                            "Aliasing detected");
+  EXPECT_DEATH_IF_SUPPORTED(problem.AddParameterBlock(IntToPtr(30), 2),
+                            "Aliasing detected");
+  EXPECT_DEATH_IF_SUPPORTED(problem.AddParameterBlock(IntToPtr(47), 2),
+                            "Aliasing detected");
+  EXPECT_DEATH_IF_SUPPORTED(problem.AddParameterBlock(IntToPtr(1), 100),
+                            "Aliasing detected");
+
+  // This one should work.
+  problem.AddParameterBlock(IntToPtr(45), 2);
+
+  // Removing a large parameter block frees its memory for new ones.
+  problem.RemoveParameterBlock(IntToPtr(48));
+  problem.AddParameterBlock(IntToPtr(60), 3);
+
+  ASSERT_EQ(3, problem.NumParameterBlocks());
+}
+
 TEST(Problem, AddParameterIgnoresDuplicateCalls) {
   double x[3], y[4];
 
@@ -328,6 +358,98 @@ TEST(Problem, AddingParametersAndResidualsResultsInExpectedProblem) {
   EXPECT_EQ(problem.NumResiduals(), total_residuals);
 }
 
+TEST(Problem, AddResidualBlocksResultsInExpectedProblem) {
+  double x[3], y[4], z[5];
+
+  Problem problem;
+  // clang-format off
+  const vector<CostFunction*> cost_functions = {
+    new UnaryCostFunction  (2, 3),
+    new BinaryCostFunction (6, 5, 4),
+    new BinaryCostFunction (3, 3, 5),
+    new TernaryCostFunction(1, 5, 3, 4),
+  };
+  const vector<double*> parameter_blocks = {
+    x,
+    z, y,
+    x, z,
+    z, x, y,
+  };
+  // clang-format on
+  LossFunction* loss_function = new TrivialLoss;
+  const vector<LossFunction*> loss_functions = {
+      nullptr, loss_function, nullptr, nullptr};
+
+  vector<ResidualBlockId> residual_blocks;
+  problem.AddResidualBlocks(
+      cost_functions, loss_functions, parameter_blocks, 4, &residual_blocks);
+
+  EXPECT_EQ(problem.NumParameterBlocks(), 3);
+  EXPECT_EQ(problem.NumParameters(), 12);
+  EXPECT_EQ(problem.NumResidualBlocks(), 4);
+  EXPECT_EQ(problem.NumResiduals(), 2 + 6 + 3 + 1);
+
+  vector<ResidualBlockId> problem_residual_blocks;
+  problem.GetResidualBlocks(&problem_residual_blocks);
+  EXPECT_EQ(residual_blocks, problem_residual_blocks);
+
+  for (int i = 0; i < residual_blocks.size(); ++i) {
+    EXPECT_EQ(problem.GetCostFunctionForResidualBlock(residual_blocks[i]),
+              cost_functions[i]);
+    EXPECT_EQ(problem.GetLossFunctionForResidualBlock(residual_blocks[i]),
+              loss_functions[i]);
+  }
+
+  vector<double*> residual_parameter_blocks;
+  problem.GetParameterBlocksForResidualBlock(residual_blocks[3],
+                                             &residual_parameter_blocks);
+  EXPECT_EQ(residual_parameter_blocks, (vector<double*>{z, x, y}));
+}
+
+TEST(Problem, AddResidualBlocksWithIncorrectNumberOfParameterBlocksDies) {
+  double x[3], y[4];
+
+  Problem problem;
+  EXPECT_DEATH_IF_SUPPORTED(
+      problem.AddResidualBlocks({new UnaryCostFunction(2, 3)},
+                                {},
+                                {x, y},
+                                1,
+                                nullptr),
+      "Number of parameter blocks");
+}
+
+TEST(Problem, AddResidualBlocksWithDuplicateParametersDies) {
+  double x[3], y[4];
+
+  Problem problem;
+  EXPECT_DEATH_IF_SUPPORTED(
+      problem.AddResidualBlocks(
+          {new UnaryCostFunction(2, 4), new BinaryCostFunction(2, 3, 3)},
+          {},
+          {y, x, x},
+          2,
+          nullptr),
+      "Duplicate parameter blocks");
+}
+
+TEST(Problem, AddResidualBlocksWithIncorrectSizesOfParameterBlockDies) {
+  double x[3], z[5];
+
+  Problem problem;
+  problem.AddParameterBlock(z, 5);
+
+  // The cost function expects the size of z to be 4 instead of 5.
+  EXPECT_DEATH_IF_SUPPORTED(
+      problem.AddResidualBlocks(
+          {new UnaryCostFunction(2, 3), new BinaryCostFunction(2, 3, 4)},
+          {},
+          {x, x, z},
+          2,
+          nullptr),
+      "different block sizes");
+}
+
 class DestructorCountingCostFunction : public SizedCostFunction<3, 4, 5> {
  public:
   explicit DestructorCountingCostFunction(int* num_destructions)
@@ -642,6 +764,20 @@ TEST(Problem, ParameterBlockQueryTest) {
   EXPECT_TRUE(parameter_blocks[0] == y);
 }
 
+TEST(Problem, GetParameterBlocksReturnsTheBlocksInAddressOrder) {
+  double x[10];
+  Problem problem;
+  problem.AddParameterBlock(x + 6, 2);
+  problem.AddParameterBlock(x, 3);
+  problem.AddParameterBlock(x + 8, 2);
+  problem.AddParameterBlock(x + 3, 3);
+  problem.RemoveParameterBlock(x + 6);
+
+  vector<double*> parameter_blocks;
+  problem.GetParameterBlocks(&parameter_blocks);
+  EXPECT_EQ(parameter_blocks, (vector<double*>{x, x + 3, x + 8}));
+}
+
 TEST_P(DynamicProblem, RemoveParameterBlockWithNoResiduals) {
   problem->AddParameterBlock(y, 4);
   problem->AddParameterBlock(z, 5);
@@ -890,6 +1026,47 @@ TEST_P(DynamicProblem, RemoveResidualBlock) {
   // clang-format on
 }
 
+TEST_P(DynamicProblem, AddResidualBlocksThenRemove) {
+  // clang-format off
+  CostFunction* cost_yzw = new TernaryCostFunction(1, 4, 5, 3);
+  CostFunction* cost_yz  = new BinaryCostFunction (1, 4, 5);
+  CostFunction* cost_w   = new UnaryCostFunction  (1, 3);
+  // clang-format on
+
+  vector<ResidualBlockId> residual_blocks;
+  problem->AddResidualBlocks({cost_yzw, cost_yz, cost_w},
+                             {},
+                             {y, z, w, y, z, w},
+                             2,
+                             &residual_blocks);
+  ASSERT_EQ(3, residual_blocks.size());
+  ResidualBlock* r_yzw = residual_blocks[0];
+  ResidualBlock* r_yz = residual_blocks[1];
+  ResidualBlock* r_w = residual_blocks[2];
+
+  ASSERT_EQ(3, problem->NumParameterBlocks());
+  ASSERT_EQ(3, NumResidualBlocks());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(GetResidualBlock(i), residual_blocks[i]);
+    EXPECT_EQ(GetResidualBlock(i)->index(), i);
+  }
+  if (GetParam()) {
+    ExpectParameterBlockContains(y, r_yzw, r_yz);
+    ExpectParameterBlockContains(z, r_yzw, r_yz);
+    ExpectParameterBlockContains(w, r_yzw, r_w);
+  }
+
+  problem->RemoveResidualBlock(r_yz);
+  ASSERT_EQ(2, NumResidualBlocks());
+  EXPECT_TRUE(HasResidualBlock(r_yzw));
+  EXPECT_FALSE(HasResidualBlock(r_yz));
+  EXPECT_TRUE(HasResidualBlock(r_w));
+
+  problem->RemoveParameterBlock(w);
+  ASSERT_EQ(2, problem->NumParameterBlocks());
+  ASSERT_EQ(0, NumResidualBlocks());
+}
+
 TEST_P(DynamicProblem, RemoveInvalidResidualBlockDies) {
   problem->AddParameterBlock(y, 4);
   problem->AddParameterBlock(z, 5);
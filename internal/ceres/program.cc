@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "ceres/array_utils.h"
@@ -459,7 +460,8 @@ Program::CreateJacobianBlockSparsityTranspose(int start_residual_block) const {
       // Re-size the matrix if needed.
       if (num_nonzeros >= tsm->max_num_nonzeros()) {
         tsm->set_num_nonzeros(num_nonzeros);
-        tsm->Reserve(2 * num_nonzeros);
+        std::string error;
+        CHECK(tsm->Reserve(2 * num_nonzeros, &error)) << error;
         rows = tsm->mutable_rows();
         cols = tsm->mutable_cols();
         values = tsm->mutable_values();
@@ -59,7 +59,7 @@
 //   class JacobianWriter {
 //     // Create a jacobian that this writer can write. Same as
 //     // Evaluator::CreateJacobian.
-//     SparseMatrix* CreateJacobian() const;
+//     SparseMatrix* CreateJacobian(std::string* error) const;
 //
 //     // Create num_threads evaluate preparers. Caller owns result which must
 //     // be freed with delete[]. Resulting preparers are valid while *this is.
@@ -85,6 +85,7 @@
 // clang-format on
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -98,6 +99,7 @@
 #include "ceres/program.h"
 #include "ceres/residual_block.h"
 #include "ceres/small_blas.h"
+#include "ceres/trace.h"
 
 namespace ceres {
 namespace internal {
@@ -129,11 +131,14 @@ class ProgramEvaluator : public Evaluator {
     BuildResidualLayout(*program, &residual_layout_);
     evaluate_scratch_.reset(
         CreateEvaluatorScratch(*program, options.num_threads));
+    if (options_.profile_cost_functions) {
+      BuildCostFunctionTypes();
+    }
   }
 
   // Implementation of Evaluator interface.
-  SparseMatrix* CreateJacobian() const final {
-    return jacobian_writer_.CreateJacobian();
+  SparseMatrix* CreateJacobian(std::string* error) const final {
+    return jacobian_writer_.CreateJacobian(error);
   }
 
   bool Evaluate(const Evaluator::EvaluateOptions& evaluate_options,
@@ -147,6 +152,10 @@ class ProgramEvaluator : public Evaluator {
         gradient == nullptr && jacobian == nullptr ? "Evaluator::Residual"
                                                    : "Evaluator::Jacobian",
         &execution_summary_);
+    ScopedTrace trace(options_.tracer,
+                      gradient == nullptr && jacobian == nullptr
+                          ? "Evaluator::Residual"
+                          : "Evaluator::Jacobian");
 
     // The parameters are stateful, so set the state before evaluating.
     if (!program_->StateVectorToParameterBlocks(state)) {
@@ -166,6 +175,7 @@ class ProgramEvaluator : public Evaluator {
     }
 
     if (jacobian != nullptr) {
+      ScopedTrace set_zero_trace(options_.tracer, "SparseMatrix::SetZero");
       jacobian->SetZero();
     }
 
@@ -217,6 +227,10 @@ class ProgramEvaluator : public Evaluator {
           }
 
           // Evaluate the cost, residuals, and jacobians.
+          std::chrono::steady_clock::time_point block_start_time;
+          if (options_.profile_cost_functions) {
+            block_start_time = std::chrono::steady_clock::now();
+          }
           double block_cost;
           if (!residual_block->Evaluate(
                   evaluate_options.apply_loss_function,
@@ -227,6 +241,17 @@ class ProgramEvaluator : public Evaluator {
             abort = true;
             return;
           }
+          if (options_.profile_cost_functions) {
+            const std::chrono::duration<double> block_time =
+                std::chrono::steady_clock::now() - block_start_time;
+            CostFunctionStatistics& statistics =
+                scratch->cost_function_statistics[cost_function_type_[i]];
+            CallStatistics& call_stats =
+                block_jacobians == nullptr ? statistics.residual_evaluations
+                                           : statistics.jacobian_evaluations;
+            call_stats.time += block_time.count();
+            ++call_stats.calls;
+          }
 
           scratch->cost += block_cost;
 
@@ -258,6 +283,7 @@ class ProgramEvaluator : public Evaluator {
         });
 
     if (!abort) {
+      ScopedTrace finalize_trace(options_.tracer, "Evaluator::Finalize");
       const int num_parameters = program_->NumEffectiveParameters();
 
       // Sum the cost and gradient (if requested) from each thread.
@@ -302,6 +328,35 @@ class ProgramEvaluator : public Evaluator {
     return execution_summary_.statistics();
   }
 
+  // The per thread statistics are summed here rather than after each
+  // evaluation, since this is called rarely.
+  std::map<std::string, CostFunctionStatistics> PerCostFunctionStatistics()
+      const final {
+    std::map<std::string, CostFunctionStatistics> statistics;
+    if (!options_.profile_cost_functions) {
+      return statistics;
+    }
+
+    for (int i = 0; i < cost_function_type_names_.size(); ++i) {
+      CostFunctionStatistics& type_statistics =
+          statistics[cost_function_type_names_[i]];
+      type_statistics = cost_function_statistics_[i];
+      for (int j = 0; j < options_.num_threads; ++j) {
+        const CostFunctionStatistics& thread_statistics =
+            evaluate_scratch_[j].cost_function_statistics[i];
+        type_statistics.residual_evaluations.time +=
+            thread_statistics.residual_evaluations.time;
+        type_statistics.residual_evaluations.calls +=
+            thread_statistics.residual_evaluations.calls;
+        type_statistics.jacobian_evaluations.time +=
+            thread_statistics.jacobian_evaluations.time;
+        type_statistics.jacobian_evaluations.calls +=
+            thread_statistics.jacobian_evaluations.calls;
+      }
+    }
+    return statistics;
+  }
+
  private:
   // Per-thread scratch space needed to evaluate and store each residual block.
   struct EvaluateScratch {
@@ -325,8 +380,52 @@ class ProgramEvaluator : public Evaluator {
     // Enough space to store the residual for the largest residual block.
     std::unique_ptr<double[]> residual_block_residuals;
     std::unique_ptr<double*[]> jacobian_block_ptrs;
+    // Only the call statistics are used, indexed by cost function
+    // type. Empty unless Options::profile_cost_functions is true.
+    std::vector<CostFunctionStatistics> cost_function_statistics;
   };
 
+  // Assign each residual block the index of the type of its cost
+  // function, and collect the sizes of the residual blocks of each
+  // type.
+  void BuildCostFunctionTypes() {
+    const std::vector<ResidualBlock*>& residual_blocks =
+        program_->residual_blocks();
+    std::map<std::string, int> type_index;
+    cost_function_type_.resize(residual_blocks.size());
+    for (int i = 0; i < residual_blocks.size(); ++i) {
+      const ResidualBlock* residual_block = residual_blocks[i];
+      const std::string name =
+          CostFunctionTypeName(*residual_block->cost_function());
+      auto it = type_index.find(name);
+      if (it == type_index.end()) {
+        it = type_index.emplace(name, cost_function_type_names_.size()).first;
+        cost_function_type_names_.push_back(name);
+        cost_function_statistics_.emplace_back();
+      }
+      cost_function_type_[i] = it->second;
+
+      CostFunctionStatistics& statistics =
+          cost_function_statistics_[it->second];
+      const int num_residuals = residual_block->NumResiduals();
+      ++statistics.num_residual_blocks;
+      statistics.num_residuals += num_residuals;
+      for (int j = 0; j < residual_block->NumParameterBlocks(); ++j) {
+        const ParameterBlock* parameter_block =
+            residual_block->parameter_blocks()[j];
+        if (!parameter_block->IsConstant()) {
+          statistics.num_jacobian_entries +=
+              num_residuals * parameter_block->LocalSize();
+        }
+      }
+    }
+
+    for (int i = 0; i < options_.num_threads; ++i) {
+      evaluate_scratch_[i].cost_function_statistics.resize(
+          cost_function_type_names_.size());
+    }
+  }
+
   static void BuildResidualLayout(const Program& program,
                                   std::vector<int>* residual_layout) {
     const std::vector<ResidualBlock*>& residual_blocks =
@@ -367,6 +466,12 @@ class ProgramEvaluator : public Evaluator {
   std::unique_ptr<EvaluatePreparer[]> evaluate_preparers_;
   std::unique_ptr<EvaluateScratch[]> evaluate_scratch_;
   std::vector<int> residual_layout_;
+  // The index of the type of the cost function of each residual
+  // block, the names of these types and the sizes of their residual
+  // blocks. Only used if Options::profile_cost_functions is true.
+  std::vector<int> cost_function_type_;
+  std::vector<std::string> cost_function_type_names_;
+  std::vector<CostFunctionStatistics> cost_function_statistics_;
   ::ceres::internal::ExecutionSummary execution_summary_;
 };
 
@@ -34,6 +34,7 @@
 #include <ctime>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "Eigen/Dense"
@@ -48,7 +49,9 @@
 #include "ceres/internal/eigen.h"
 #include "ceres/lapack.h"
 #include "ceres/linear_solver.h"
+#include "ceres/parallel_dense_ops.h"
 #include "ceres/sparse_cholesky.h"
+#include "ceres/trace.h"
 #include "ceres/triplet_sparse_matrix.h"
 #include "ceres/types.h"
 #include "ceres/wall_time.h"
@@ -127,7 +130,11 @@ LinearSolver::Summary SchurComplementSolver::SolveImpl(
     const int num_eliminate_blocks = options_.elimination_groups[0];
     const int num_f_blocks = bs->cols.size() - num_eliminate_blocks;
 
-    InitStorage(bs);
+    LinearSolver::Summary summary;
+    if (!InitStorage(bs, &summary.message)) {
+      summary.termination_type = LINEAR_SOLVER_FATAL_ERROR;
+      return summary;
+    }
     DetectStructure(*bs,
                     num_eliminate_blocks,
                     &options_.row_block_size,
@@ -154,19 +161,27 @@ LinearSolver::Summary SchurComplementSolver::SolveImpl(
   std::fill(x, x + A->num_cols(), 0.0);
   event_logger.AddEvent("Setup");
 
-  eliminator_->Eliminate(BlockSparseMatrixData(*A),
-                         b,
-                         per_solve_options.D,
-                         lhs_.get(),
-                         rhs_.get());
+  {
+    ScopedTrace trace(options_.tracer, "SchurEliminator::Eliminate");
+    eliminator_->Eliminate(BlockSparseMatrixData(*A),
+                           b,
+                           per_solve_options.D,
+                           lhs_.get(),
+                           rhs_.get());
+  }
   event_logger.AddEvent("Eliminate");
 
   double* reduced_solution = x + A->num_cols() - lhs_->num_cols();
-  const LinearSolver::Summary summary =
-      SolveReducedLinearSystem(per_solve_options, reduced_solution);
+  LinearSolver::Summary summary;
+  {
+    ScopedTrace trace(options_.tracer,
+                      "SchurComplementSolver::SolveReducedLinearSystem");
+    summary = SolveReducedLinearSystem(per_solve_options, reduced_solution);
+  }
   event_logger.AddEvent("ReducedSolve");
 
   if (summary.termination_type == LINEAR_SOLVER_SUCCESS) {
+    ScopedTrace trace(options_.tracer, "SchurEliminator::BackSubstitute");
     eliminator_->BackSubstitute(
         BlockSparseMatrixData(*A), b, per_solve_options.D, reduced_solution, x);
     event_logger.AddEvent("BackSubstitute");
@@ -177,8 +192,8 @@ LinearSolver::Summary SchurComplementSolver::SolveImpl(
 
 // Initialize a BlockRandomAccessDenseMatrix to store the Schur
 // complement.
-void DenseSchurComplementSolver::InitStorage(
-    const CompressedRowBlockStructure* bs) {
+bool DenseSchurComplementSolver::InitStorage(
+    const CompressedRowBlockStructure* bs, std::string* /* error */) {
   const int num_eliminate_blocks = options().elimination_groups[0];
   const int num_col_blocks = bs->cols.size();
 
@@ -189,11 +204,13 @@ void DenseSchurComplementSolver::InitStorage(
 
   set_lhs(new BlockRandomAccessDenseMatrix(blocks));
   set_rhs(new double[lhs()->num_rows()]);
+  return true;
 }
 
 // Solve the system Sx = r, assuming that the matrix S is stored in a
 // BlockRandomAccessDenseMatrix. The linear system is solved using
-// Eigen's Cholesky factorization.
+// Eigen's Cholesky factorization, or if num_threads > 1, using the
+// tiled multithreaded Cholesky factorization.
 LinearSolver::Summary DenseSchurComplementSolver::SolveReducedLinearSystem(
     const LinearSolver::PerSolveOptions& per_solve_options, double* solution) {
   LinearSolver::Summary summary;
@@ -213,7 +230,24 @@ LinearSolver::Summary DenseSchurComplementSolver::SolveReducedLinearSystem(
 
   summary.num_iterations = 1;
 
-  if (options().dense_linear_algebra_library_type == EIGEN) {
+  if (options().dense_linear_algebra_library_type == EIGEN &&
+      options().use_tiled_dense_factorization &&
+      options().num_threads > 1 && num_rows > kParallelDenseOpsTileSize) {
+    // S is stored as the upper triangle of a row major matrix, which
+    // is the lower triangle of the same matrix in column major order.
+    double* values =
+        down_cast<BlockRandomAccessDenseMatrix*>(mutable_lhs())
+            ->mutable_values();
+    if (!ParallelCholeskyFactorize(
+            options().context, options().num_threads, num_rows, values)) {
+      summary.termination_type = LINEAR_SOLVER_FAILURE;
+      summary.message =
+          "Unable to perform tiled dense Cholesky factorization.";
+      return summary;
+    }
+    VectorRef(solution, num_rows) = ConstVectorRef(rhs(), num_rows);
+    CholeskySolveInPlace(num_rows, values, solution);
+  } else if (options().dense_linear_algebra_library_type == EIGEN) {
     Eigen::LLT<Matrix, Eigen::Upper> llt =
         ConstMatrixRef(m->values(), num_rows, num_rows)
             .selfadjointView<Eigen::Upper>()
@@ -247,8 +281,8 @@ SparseSchurComplementSolver::~SparseSchurComplementSolver() {}
 
 // Determine the non-zero blocks in the Schur Complement matrix, and
 // initialize a BlockRandomAccessSparseMatrix object.
-void SparseSchurComplementSolver::InitStorage(
-    const CompressedRowBlockStructure* bs) {
+bool SparseSchurComplementSolver::InitStorage(
+    const CompressedRowBlockStructure* bs, std::string* error) {
   const int num_eliminate_blocks = options().elimination_groups[0];
   const int num_col_blocks = bs->cols.size();
   const int num_row_blocks = bs->rows.size();
@@ -312,8 +346,19 @@ void SparseSchurComplementSolver::InitStorage(
     }
   }
 
-  set_lhs(new BlockRandomAccessSparseMatrix(blocks_, block_pairs));
+  std::unique_ptr<BlockRandomAccessSparseMatrix> matrix =
+      BlockRandomAccessSparseMatrix::Create(
+          blocks_,
+          block_pairs,
+          options().memory_mapped_storage_directory,
+          error);
+  if (matrix == nullptr) {
+    *error = "Unable to allocate the Schur complement. " + *error;
+    return false;
+  }
+  set_lhs(matrix.release());
   set_rhs(new double[lhs()->num_rows()]);
+  return true;
 }
 
 LinearSolver::Summary SparseSchurComplementSolver::SolveReducedLinearSystem(
@@ -400,7 +445,7 @@ SparseSchurComplementSolver::SolveReducedLinearSystemUsingConjugateGradients(
     pre_m.block(pre_r, pre_c, block_size, block_size) =
         sc_m.block(sc_r, sc_c, block_size, block_size);
   }
-  preconditioner_->Invert();
+  preconditioner_->Invert(options().context, options().num_threads);
 
   VectorRef(solution, num_rows).setZero();
 
@@ -412,6 +457,7 @@ SparseSchurComplementSolver::SolveReducedLinearSystemUsingConjugateGradients(
   LinearSolver::Options cg_options;
   cg_options.min_num_iterations = options().min_num_iterations;
   cg_options.max_num_iterations = options().max_num_iterations;
+  cg_options.tracer = options().tracer;
   ConjugateGradientsSolver cg_solver(cg_options);
 
   LinearSolver::PerSolveOptions cg_per_solve_options;
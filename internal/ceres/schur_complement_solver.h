@@ -33,6 +33,7 @@
 
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -131,12 +132,16 @@ class CERES_EXPORT_INTERNAL SchurComplementSolver
   const LinearSolver::Options& options() const { return options_; }
 
   const BlockRandomAccessMatrix* lhs() const { return lhs_.get(); }
+  BlockRandomAccessMatrix* mutable_lhs() { return lhs_.get(); }
   void set_lhs(BlockRandomAccessMatrix* lhs) { lhs_.reset(lhs); }
   const double* rhs() const { return rhs_.get(); }
   void set_rhs(double* rhs) { rhs_.reset(rhs); }
 
  private:
-  virtual void InitStorage(const CompressedRowBlockStructure* bs) = 0;
+  // Returns false and sets error if the storage for the Schur
+  // complement cannot be allocated.
+  virtual bool InitStorage(const CompressedRowBlockStructure* bs,
+                           std::string* error) = 0;
   virtual LinearSolver::Summary SolveReducedLinearSystem(
       const LinearSolver::PerSolveOptions& per_solve_options,
       double* solution) = 0;
@@ -159,7 +164,8 @@ class DenseSchurComplementSolver : public SchurComplementSolver {
   virtual ~DenseSchurComplementSolver() {}
 
  private:
-  void InitStorage(const CompressedRowBlockStructure* bs) final;
+  bool InitStorage(const CompressedRowBlockStructure* bs,
+                   std::string* error) final;
   LinearSolver::Summary SolveReducedLinearSystem(
       const LinearSolver::PerSolveOptions& per_solve_options,
       double* solution) final;
@@ -175,7 +181,8 @@ class SparseSchurComplementSolver : public SchurComplementSolver {
   virtual ~SparseSchurComplementSolver();
 
  private:
-  void InitStorage(const CompressedRowBlockStructure* bs) final;
+  bool InitStorage(const CompressedRowBlockStructure* bs,
+                   std::string* error) final;
   LinearSolver::Summary SolveReducedLinearSystem(
       const LinearSolver::PerSolveOptions& per_solve_options,
       double* solution) final;
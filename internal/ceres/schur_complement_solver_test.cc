@@ -32,6 +32,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
 
 #include "ceres/block_sparse_matrix.h"
 #include "ceres/block_structure.h"
@@ -176,6 +177,30 @@ TEST_F(SchurComplementSolverTest, DenseSchurWithLAPACKLargeProblem) {
 }
 #endif
 
+#if defined(CERES_USE_EIGEN_SPARSE) && !defined(_WIN32)
+TEST_F(SchurComplementSolverTest,
+       SparseSchurReportsFailureToAllocateSchurComplement) {
+  SetUpFromProblemId(2);
+  LinearSolver::Options options;
+  options.elimination_groups.push_back(num_eliminate_blocks);
+  options.elimination_groups.push_back(A->block_structure()->cols.size() -
+                                       num_eliminate_blocks);
+  options.type = SPARSE_SCHUR;
+  options.sparse_linear_algebra_library_type = EIGEN_SPARSE;
+  options.memory_mapped_storage_directory =
+      testing::TempDir() + "/ceres_does_not_exist";
+  ContextImpl context;
+  options.context = &context;
+  std::unique_ptr<LinearSolver> solver(LinearSolver::Create(options));
+
+  const LinearSolver::Summary summary = solver->Solve(
+      A.get(), b.get(), LinearSolver::PerSolveOptions(), x.data());
+  EXPECT_EQ(summary.termination_type, LINEAR_SOLVER_FATAL_ERROR);
+  EXPECT_NE(summary.message.find("Schur complement"), std::string::npos)
+      << summary.message;
+}
+#endif  // defined(CERES_USE_EIGEN_SPARSE) && !defined(_WIN32)
+
 #ifndef CERES_NO_SUITESPARSE
 TEST_F(SchurComplementSolverTest,
        SparseSchurWithSuiteSparseSmallProblemNoPostOrdering) {
@@ -225,7 +225,9 @@ template <int kRowBlockSize = Eigen::Dynamic,
 class SchurEliminator : public SchurEliminatorBase {
  public:
   explicit SchurEliminator(const LinearSolver::Options& options)
-      : num_threads_(options.num_threads), context_(options.context) {
+      : num_threads_(options.num_threads),
+        context_(options.context),
+        stream_chunks_(!options.memory_mapped_storage_directory.empty()) {
     CHECK(context_ != nullptr);
   }
 
@@ -316,8 +318,20 @@ class SchurEliminator : public SchurEliminatorBase {
                                int row_block_index,
                                BlockRandomAccessMatrix* lhs);
 
+  // Calls function for each chunk using ParallelFor. ParallelFor
+  // hands the chunks to the threads out of order, so if
+  // stream_chunks_ is true, the chunks are split into consecutive
+  // windows of kNumStreamedChunksPerThread chunks per thread, which
+  // are processed one after the other. The rows of a memory mapped
+  // Jacobian are then read in order, a window at a time.
+  template <typename Function>
+  void ParallelForEachChunk(const Function& function);
+
+  static constexpr int kNumStreamedChunksPerThread = 64;
+
   int num_threads_;
   ContextImpl* context_;
+  bool stream_chunks_;
   int num_eliminate_blocks_;
   bool assume_full_rank_ete_;
 
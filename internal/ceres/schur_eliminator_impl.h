@@ -173,6 +173,24 @@ void SchurEliminator<kRowBlockSize, kEBlockSize, kFBlockSize>::Init(
   }
 }
 
+template <int kRowBlockSize, int kEBlockSize, int kFBlockSize>
+template <typename Function>
+void SchurEliminator<kRowBlockSize, kEBlockSize, kFBlockSize>::
+    ParallelForEachChunk(const Function& function) {
+  const int num_chunks = chunks_.size();
+  const int window_size =
+      stream_chunks_
+          ? std::max(kNumStreamedChunksPerThread * num_threads_, 1)
+          : std::max(num_chunks, 1);
+  for (int start = 0; start < num_chunks; start += window_size) {
+    ParallelFor(context_,
+                start,
+                std::min(start + window_size, num_chunks),
+                num_threads_,
+                function);
+  }
+}
+
 template <int kRowBlockSize, int kEBlockSize, int kFBlockSize>
 void SchurEliminator<kRowBlockSize, kEBlockSize, kFBlockSize>::Eliminate(
     const BlockSparseMatrixData& A,
@@ -227,11 +245,7 @@ void SchurEliminator<kRowBlockSize, kEBlockSize, kFBlockSize>::Eliminate(
   // z blocks that share a row block/residual term with the y
   // block. EliminateRowOuterProduct does the corresponding operation
   // for the lhs of the reduced linear system.
-  ParallelFor(
-      context_,
-      0,
-      int(chunks_.size()),
-      num_threads_,
+  ParallelForEachChunk(
       [&](int thread_id, int i) {
         double* buffer = buffer_.get() + thread_id * buffer_size_;
         const Chunk& chunk = chunks_[i];
@@ -315,7 +329,7 @@ void SchurEliminator<kRowBlockSize, kEBlockSize, kFBlockSize>::BackSubstitute(
   const CompressedRowBlockStructure* bs = A.block_structure();
   const double* values = A.values();
 
-  ParallelFor(context_, 0, int(chunks_.size()), num_threads_, [&](int i) {
+  ParallelForEachChunk([&](int i) {
     const Chunk& chunk = chunks_[i];
     const int e_block_id = bs->rows[chunk.start].cells.front().block_id;
     const int e_block_size = bs->cols[e_block_id].size;
@@ -31,6 +31,8 @@
 #include "ceres/schur_eliminator.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "Eigen/Dense"
 #include "ceres/block_random_access_dense_matrix.h"
@@ -369,5 +371,112 @@ TEST(SchurEliminatorForOneFBlock, MatchesSchurEliminator) {
       << actual_e_sol;
 }
 
+// With memory mapped storage, the chunks are eliminated in windows,
+// one window after the other. The windows must cover all the chunks,
+// and with a single thread, the chunks are processed in the same
+// order as without windows.
+TEST(SchurEliminator, StreamedChunksMatchUnstreamedChunks) {
+  constexpr int kRowBlockSize = 2;
+  constexpr int kEBlockSize = 3;
+  constexpr int kFBlockSize = 6;
+  constexpr int kNumEBlocks = 300;
+  constexpr int kNumFBlocks = 3;
+
+  // Each e_block is seen by two consecutive f_blocks, in a row each.
+  CompressedRowBlockStructure* bs = new CompressedRowBlockStructure;
+  bs->cols.resize(kNumEBlocks + kNumFBlocks);
+  int col_pos = 0;
+  for (int i = 0; i < bs->cols.size(); ++i) {
+    bs->cols[i].position = col_pos;
+    bs->cols[i].size = (i < kNumEBlocks) ? kEBlockSize : kFBlockSize;
+    col_pos += bs->cols[i].size;
+  }
+
+  int row_pos = 0;
+  int cell_pos = 0;
+  for (int i = 0; i < kNumEBlocks; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      bs->rows.emplace_back();
+      CompressedRow& row = bs->rows.back();
+      row.block.position = row_pos;
+      row.block.size = kRowBlockSize;
+      row_pos += kRowBlockSize;
+      row.cells.resize(2);
+      row.cells[0].block_id = i;
+      row.cells[0].position = cell_pos;
+      cell_pos += kRowBlockSize * kEBlockSize;
+      row.cells[1].block_id = kNumEBlocks + (i + j) % kNumFBlocks;
+      row.cells[1].position = cell_pos;
+      cell_pos += kRowBlockSize * kFBlockSize;
+    }
+  }
+
+  BlockSparseMatrix matrix(bs);
+  double* values = matrix.mutable_values();
+  for (int i = 0; i < matrix.num_nonzeros(); ++i) {
+    values[i] = RandNormal();
+  }
+  Vector b(matrix.num_rows());
+  b.setRandom();
+  Vector diagonal(matrix.num_cols());
+  diagonal.setOnes();
+  Vector f_sol(kNumFBlocks * kFBlockSize);
+  f_sol.setRandom();
+
+  const std::vector<int> blocks(kNumFBlocks, kFBlockSize);
+  const int schur_size = kNumFBlocks * kFBlockSize;
+  ContextImpl context;
+  context.EnsureMinimumThreads(4);
+  auto eliminate = [&](const std::string& storage_directory,
+                       const int num_threads,
+                       Matrix* lhs,
+                       Vector* rhs,
+                       Vector* e_sol) {
+    LinearSolver::Options options;
+    options.elimination_groups.push_back(kNumEBlocks);
+    options.memory_mapped_storage_directory = storage_directory;
+    options.num_threads = num_threads;
+    options.context = &context;
+    std::unique_ptr<SchurEliminatorBase> eliminator(
+        SchurEliminatorBase::Create(options));
+    eliminator->Init(kNumEBlocks, true, matrix.block_structure());
+
+    BlockRandomAccessDenseMatrix lhs_matrix(blocks);
+    rhs->resize(schur_size);
+    eliminator->Eliminate(BlockSparseMatrixData(matrix),
+                          b.data(),
+                          diagonal.data(),
+                          &lhs_matrix,
+                          rhs->data());
+    *lhs = ConstMatrixRef(lhs_matrix.values(), schur_size, schur_size);
+
+    e_sol->resize(kNumEBlocks * kEBlockSize);
+    e_sol->setZero();
+    eliminator->BackSubstitute(BlockSparseMatrixData(matrix),
+                               b.data(),
+                               diagonal.data(),
+                               f_sol.data(),
+                               e_sol->data());
+  };
+
+  Matrix expected_lhs;
+  Vector expected_rhs;
+  Vector expected_e_sol;
+  eliminate("", 1, &expected_lhs, &expected_rhs, &expected_e_sol);
+
+  Matrix lhs;
+  Vector rhs;
+  Vector e_sol;
+  eliminate(testing::TempDir(), 1, &lhs, &rhs, &e_sol);
+  EXPECT_EQ(lhs, expected_lhs);
+  EXPECT_EQ(rhs, expected_rhs);
+  EXPECT_EQ(e_sol, expected_e_sol);
+
+  eliminate(testing::TempDir(), 4, &lhs, &rhs, &e_sol);
+  EXPECT_NEAR((lhs - expected_lhs).norm() / expected_lhs.norm(), 0.0, 1e-12);
+  EXPECT_NEAR((rhs - expected_rhs).norm() / expected_rhs.norm(), 0.0, 1e-12);
+  EXPECT_EQ(e_sol, expected_e_sol);
+}
+
 }  // namespace internal
 }  // namespace ceres
@@ -89,7 +89,7 @@ bool SchurJacobiPreconditioner::UpdateImpl(const BlockSparseMatrix& A,
   // Compute a subset of the entries of the Schur complement.
   eliminator_->Eliminate(
       BlockSparseMatrixData(A), nullptr, D, m_.get(), nullptr);
-  m_->Invert();
+  m_->Invert(options_.context, options_.num_threads);
   return true;
 }
 
@@ -42,6 +42,7 @@
 #include "ceres/detect_structure.h"
 #include "ceres/gradient_checking_cost_function.h"
 #include "ceres/internal/port.h"
+#include "ceres/parameter_block.h"
 #include "ceres/parameter_block_ordering.h"
 #include "ceres/preprocessor.h"
 #include "ceres/problem.h"
@@ -50,6 +51,7 @@
 #include "ceres/schur_templates.h"
 #include "ceres/solver_utils.h"
 #include "ceres/stringprintf.h"
+#include "ceres/trace.h"
 #include "ceres/types.h"
 #include "ceres/wall_time.h"
 
@@ -202,6 +204,17 @@ bool TrustRegionOptionsAreValid(const Solver::Options& options, string* error) {
     }
   }
 
+  if (options.use_lm_eigendecomposition) {
+    if (options.trust_region_strategy_type != LEVENBERG_MARQUARDT ||
+        (options.linear_solver_type != DENSE_QR &&
+         options.linear_solver_type != DENSE_NORMAL_CHOLESKY)) {
+      *error =
+          "Solver::Options::use_lm_eigendecomposition requires "
+          "LEVENBERG_MARQUARDT with DENSE_QR or DENSE_NORMAL_CHOLESKY.";
+      return false;
+    }
+  }
+
   if (!options.trust_region_minimizer_iterations_to_dump.empty() &&
       options.trust_region_problem_dump_format_type != CONSOLE &&
       options.trust_region_problem_dump_directory.empty()) {
@@ -222,6 +235,17 @@ bool TrustRegionOptionsAreValid(const Solver::Options& options, string* error) {
     }
   }
 
+  if (options.use_matrix_free_jacobian) {
+    if (options.linear_solver_type != CGNR ||
+        (options.preconditioner_type != JACOBI &&
+         options.preconditioner_type != IDENTITY)) {
+      *error =
+          "Solver::Options::use_matrix_free_jacobian requires CGNR with the "
+          "JACOBI or IDENTITY preconditioner.";
+      return false;
+    }
+  }
+
   if (options.linear_solver_type == CGNR &&
       options.preconditioner_type == SUBSET &&
       options.residual_blocks_for_subset_preconditioner.empty()) {
@@ -402,6 +426,37 @@ void PostSolveSummarize(const internal::PreprocessedProblem& pp,
       summary->jacobian_evaluation_time_in_seconds = call_stats.time;
       summary->num_jacobian_evaluations = call_stats.calls;
     }
+
+    for (const auto& type_and_statistics :
+         pp.evaluator->PerCostFunctionStatistics()) {
+      const internal::CostFunctionStatistics& statistics =
+          type_and_statistics.second;
+      Solver::Summary::CostFunctionStatistics cost_function_statistics;
+      cost_function_statistics.cost_function_type = type_and_statistics.first;
+      cost_function_statistics.num_residual_blocks =
+          statistics.num_residual_blocks;
+      cost_function_statistics.num_residuals = statistics.num_residuals;
+      cost_function_statistics.num_jacobian_entries =
+          statistics.num_jacobian_entries;
+      cost_function_statistics.num_residual_evaluations =
+          statistics.residual_evaluations.calls;
+      cost_function_statistics.residual_evaluation_time_in_seconds =
+          statistics.residual_evaluations.time;
+      cost_function_statistics.num_jacobian_evaluations =
+          statistics.jacobian_evaluations.calls;
+      cost_function_statistics.jacobian_evaluation_time_in_seconds =
+          statistics.jacobian_evaluations.time;
+      summary->cost_function_statistics.push_back(cost_function_statistics);
+    }
+    std::stable_sort(summary->cost_function_statistics.begin(),
+                     summary->cost_function_statistics.end(),
+                     [](const Solver::Summary::CostFunctionStatistics& a,
+                        const Solver::Summary::CostFunctionStatistics& b) {
+                       return a.residual_evaluation_time_in_seconds +
+                                  a.jacobian_evaluation_time_in_seconds >
+                              b.residual_evaluation_time_in_seconds +
+                                  b.jacobian_evaluation_time_in_seconds;
+                     });
   }
 
   // Again, like the evaluator, there may or may not be a linear
@@ -417,6 +472,24 @@ void PostSolveSummarize(const internal::PreprocessedProblem& pp,
   }
 }
 
+// Tags the events recorded by the tracer with the minimizer iteration
+// they belong to. The callbacks for an iteration are run once it is
+// complete, so everything recorded after them belongs to the next
+// iteration.
+class TraceIterationCallback : public IterationCallback {
+ public:
+  explicit TraceIterationCallback(internal::Tracer* tracer)
+      : tracer_(tracer) {}
+
+  CallbackReturnType operator()(const IterationSummary& summary) final {
+    tracer_->SetIteration(summary.iteration + 1);
+    return SOLVER_CONTINUE;
+  }
+
+ private:
+  internal::Tracer* tracer_;
+};
+
 void Minimize(internal::PreprocessedProblem* pp, Solver::Summary* summary) {
   using internal::Minimizer;
   using internal::Program;
@@ -447,6 +520,45 @@ void Minimize(internal::PreprocessedProblem* pp, Solver::Summary* summary) {
   program->CopyParameterBlockStateToUserState();
 }
 
+// Copy the camera clustering used by the linear solver, which is
+// keyed by the index of the f_blocks in the reduced program, to
+// options.visibility_clustering, keyed by the user's parameter
+// blocks.
+void SaveVisibilityClustering(const internal::PreprocessedProblem& pp) {
+  const internal::CameraClustering& camera_clustering = pp.camera_clustering;
+  VisibilityClustering* visibility_clustering =
+      pp.options.visibility_clustering;
+  if (visibility_clustering == nullptr ||
+      pp.linear_solver_options.visibility_clustering == nullptr ||
+      camera_clustering.cluster_membership.empty()) {
+    return;
+  }
+
+  const std::vector<internal::ParameterBlock*>& parameter_blocks =
+      pp.reduced_program->parameter_blocks();
+  const int num_eliminate_blocks =
+      pp.linear_solver_options.elimination_groups[0];
+  std::vector<const double*> cameras;
+  for (int i = num_eliminate_blocks; i < parameter_blocks.size(); ++i) {
+    cameras.push_back(parameter_blocks[i]->user_state());
+  }
+  CHECK_EQ(cameras.size(), camera_clustering.cluster_membership.size());
+
+  visibility_clustering->preconditioner_type = camera_clustering.type;
+  visibility_clustering->num_clusters = camera_clustering.num_clusters;
+  visibility_clustering->cluster_membership.clear();
+  for (int i = 0; i < cameras.size(); ++i) {
+    visibility_clustering->cluster_membership[cameras[i]] =
+        camera_clustering.cluster_membership[i];
+  }
+  visibility_clustering->cluster_pairs = camera_clustering.cluster_pairs;
+  visibility_clustering->block_pairs.clear();
+  for (const auto& block_pair : camera_clustering.block_pairs) {
+    visibility_clustering->block_pairs.emplace_back(
+        cameras[block_pair.first], cameras[block_pair.second]);
+  }
+}
+
 std::string SchurStructureToString(const int row_block_size,
                                    const int e_block_size,
                                    const int f_block_size) {
@@ -527,6 +639,14 @@ void Solver::Solve(const Solver::Options& options,
     program = problem_impl->mutable_program();
   }
 
+  std::unique_ptr<internal::Tracer> tracer;
+  std::unique_ptr<TraceIterationCallback> trace_iteration_callback;
+  if (options.enable_tracing) {
+    tracer.reset(new internal::Tracer(options.trace_hardware_counters));
+    trace_iteration_callback.reset(new TraceIterationCallback(tracer.get()));
+    modified_options.callbacks.push_back(trace_iteration_callback.get());
+  }
+
   // Make sure that all the parameter blocks states are set to the
   // values provided by the user.
   program->SetParameterBlockStatePtrsToUserStatePtrs();
@@ -537,9 +657,13 @@ void Solver::Solve(const Solver::Options& options,
   std::unique_ptr<Preprocessor> preprocessor(
       Preprocessor::Create(modified_options.minimizer_type));
   PreprocessedProblem pp;
+  pp.tracer = tracer.get();
 
-  const bool status =
-      preprocessor->Preprocess(modified_options, problem_impl, &pp);
+  bool status;
+  {
+    internal::ScopedTrace trace(tracer.get(), "Preprocessor::Preprocess");
+    status = preprocessor->Preprocess(modified_options, problem_impl, &pp);
+  }
 
   // We check the linear_solver_options.type rather than
   // modified_options.linear_solver_type because, depending on the
@@ -573,6 +697,7 @@ void Solver::Solve(const Solver::Options& options,
   if (status) {
     const double minimizer_start_time = WallTimeInSeconds();
     Minimize(&pp, summary);
+    SaveVisibilityClustering(pp);
     summary->minimizer_time_in_seconds =
         WallTimeInSeconds() - minimizer_start_time;
   } else {
@@ -598,6 +723,13 @@ void Solver::Solve(const Solver::Options& options,
     summary->message = gradient_checking_callback.error_log();
   }
 
+  if (tracer != nullptr) {
+    if (!options.trace_filename.empty()) {
+      tracer->WriteChromeTrace(options.trace_filename);
+    }
+    summary->trace_report = tracer->IterationTable();
+  }
+
   summary->total_time_in_seconds = WallTimeInSeconds() - start_time;
 }
 
@@ -803,6 +935,12 @@ string Solver::Summary::FullReport() const {
     StringAppendF(&report,
                   "Unsuccessful steps             % 14d\n",
                   num_unsuccessful_steps);
+    if (trust_region_strategy_type == DOGLEG ||
+        num_reused_linear_solves > 0) {
+      StringAppendF(&report,
+                    "Reused linear solves           % 14d\n",
+                    num_reused_linear_solves);
+    }
   }
   if (inner_iterations_used) {
     StringAppendF(&report,
@@ -871,6 +1009,32 @@ string Solver::Summary::FullReport() const {
   StringAppendF(
       &report, "Total               %25.6f\n\n", total_time_in_seconds);
 
+  if (!cost_function_statistics.empty()) {
+    StringAppendF(&report, "Cost function evaluation (in seconds):\n");
+    for (const CostFunctionStatistics& statistics : cost_function_statistics) {
+      StringAppendF(
+          &report, "\n  %s\n", statistics.cost_function_type.c_str());
+      StringAppendF(&report,
+                    "    Residual blocks     %21d\n",
+                    statistics.num_residual_blocks);
+      StringAppendF(&report,
+                    "    Residuals           %21d\n",
+                    statistics.num_residuals);
+      StringAppendF(&report,
+                    "    Jacobian entries    %21d\n",
+                    statistics.num_jacobian_entries);
+      StringAppendF(&report,
+                    "    Residual only evaluation %16.6f (%d)\n",
+                    statistics.residual_evaluation_time_in_seconds,
+                    statistics.num_residual_evaluations);
+      StringAppendF(&report,
+                    "    Jacobian & residual evaluation %10.6f (%d)\n",
+                    statistics.jacobian_evaluation_time_in_seconds,
+                    statistics.num_jacobian_evaluations);
+    }
+    StringAppendF(&report, "\n");
+  }
+
   StringAppendF(&report,
                 "Termination:        %25s (%s)\n",
                 TerminationTypeToString(termination_type),
@@ -0,0 +1,533 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// End-to-end benchmarks of Solve on bundle adjustment and pose graph
+// problems, for the linear solvers and preconditioners suited to each
+// type of problem and for a range of thread counts.
+//
+// A synthetic bundle adjustment problem and a synthetic 2D pose graph
+// are always benchmarked. Problems in the BAL format, e.g.,
+// data/problem-16-22106-pre.txt, and pose graphs in the g2o format,
+// as used by examples/slam, can be added on the command line:
+//
+//   solver_benchmarks --bal=<file> --g2o_2d=<file> --g2o_3d=<file>
+//
+// Each flag can be repeated. The standard Google Benchmark flags are
+// also supported, so
+//
+//   solver_benchmarks --benchmark_out=results.json
+//
+// writes the results in the same JSON format as the files in
+// internal/ceres/benchmarks, which can be compared using
+// compare.py from the Google Benchmark repository.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Eigen/Cholesky"
+#include "bal_problem.h"
+#include "benchmark/benchmark.h"
+#include "ceres/ceres.h"
+#include "ceres/random.h"
+#include "ceres/stringprintf.h"
+#include "slam/common/read_g2o.h"
+#include "slam/pose_graph_2d/angle_local_parameterization.h"
+#include "slam/pose_graph_2d/pose_graph_2d_error_term.h"
+#include "slam/pose_graph_2d/types.h"
+#include "slam/pose_graph_3d/pose_graph_3d_error_term.h"
+#include "slam/pose_graph_3d/types.h"
+#include "snavely_reprojection_error.h"
+
+namespace ceres {
+namespace internal {
+namespace {
+
+using examples::AngleLocalParameterization;
+using examples::BALProblem;
+using examples::PoseGraph2dErrorTerm;
+using examples::PoseGraph3dErrorTerm;
+using examples::SnavelyReprojectionError;
+using std::string;
+using std::vector;
+
+// The number of iterations is capped, so that every configuration
+// does a comparable amount of work.
+constexpr int kMaxNumIterations = 10;
+
+// A Problem together with the initial values of its parameters, so
+// that every Solve starts from the same point.
+class BenchmarkProblem {
+ public:
+  BenchmarkProblem(const string& name, bool is_bundle_adjustment)
+      : name_(name), is_bundle_adjustment_(is_bundle_adjustment) {}
+
+  const string& name() const { return name_; }
+  bool is_bundle_adjustment() const { return is_bundle_adjustment_; }
+  Problem* mutable_problem() { return &problem_; }
+
+  // All the parameter blocks of the problem must point into
+  // parameters, which must outlive this object.
+  void SetParameters(double* parameters, int num_parameters) {
+    parameters_ = parameters;
+    initial_parameters_.assign(parameters, parameters + num_parameters);
+  }
+
+  void ResetParameters() {
+    std::copy(
+        initial_parameters_.begin(), initial_parameters_.end(), parameters_);
+  }
+
+  // Storage for the parameters of problems that are not loaded using
+  // BALProblem.
+  vector<double>* mutable_storage() { return &storage_; }
+
+  void set_bal_problem(BALProblem* bal_problem) {
+    bal_problem_.reset(bal_problem);
+  }
+
+ private:
+  const string name_;
+  const bool is_bundle_adjustment_;
+  Problem problem_;
+  double* parameters_ = nullptr;
+  vector<double> initial_parameters_;
+  vector<double> storage_;
+  std::unique_ptr<BALProblem> bal_problem_;
+};
+
+string Basename(const string& filename) {
+  const size_t pos = filename.find_last_of("/\\");
+  return pos == string::npos ? filename : filename.substr(pos + 1);
+}
+
+BenchmarkProblem* CreateBALProblem(const string& filename) {
+  BenchmarkProblem* benchmark_problem =
+      new BenchmarkProblem("BAL/" + Basename(filename), true);
+  BALProblem* bal_problem = new BALProblem(filename, false);
+  benchmark_problem->set_bal_problem(bal_problem);
+
+  Problem* problem = benchmark_problem->mutable_problem();
+  const double* observations = bal_problem->observations();
+  for (int i = 0; i < bal_problem->num_observations(); ++i) {
+    double* camera = bal_problem->mutable_cameras() +
+                     bal_problem->camera_block_size() *
+                         bal_problem->camera_index()[i];
+    double* point = bal_problem->mutable_points() +
+                    bal_problem->point_block_size() *
+                        bal_problem->point_index()[i];
+    problem->AddResidualBlock(
+        SnavelyReprojectionError::Create(observations[2 * i],
+                                         observations[2 * i + 1]),
+        new HuberLoss(1.0),
+        camera,
+        point);
+  }
+  benchmark_problem->SetParameters(bal_problem->mutable_cameras(),
+                                   bal_problem->num_parameters());
+  return benchmark_problem;
+}
+
+// Cameras looking down the negative z axis at points in the unit
+// cube around the origin. Each point is observed by
+// observations_per_point randomly chosen cameras, with pixel noise,
+// and the cameras and points are perturbed from their true values.
+BenchmarkProblem* CreateSyntheticBundleAdjustmentProblem(
+    const int num_cameras,
+    const int num_points,
+    const int observations_per_point) {
+  BenchmarkProblem* benchmark_problem = new BenchmarkProblem(
+      StringPrintf("Synthetic/BA-%d-%d", num_cameras, num_points), true);
+  SetRandomState(5);
+
+  const int kCameraSize = 9;
+  const int kPointSize = 3;
+  vector<double>* parameters = benchmark_problem->mutable_storage();
+  parameters->resize(kCameraSize * num_cameras + kPointSize * num_points);
+  double* cameras = parameters->data();
+  double* points = cameras + kCameraSize * num_cameras;
+
+  for (int i = 0; i < num_cameras; ++i) {
+    double* camera = cameras + kCameraSize * i;
+    // Angle-axis rotation, translation, focal length and radial
+    // distortion.
+    for (int j = 0; j < 3; ++j) {
+      camera[j] = 0.1 * RandNormal();
+    }
+    camera[3] = RandNormal();
+    camera[4] = RandNormal();
+    camera[5] = -10.0 + RandNormal();
+    camera[6] = 500.0;
+    camera[7] = 0.0;
+    camera[8] = 0.0;
+  }
+  for (int i = 0; i < kPointSize * num_points; ++i) {
+    points[i] = 2.0 * RandDouble() - 1.0;
+  }
+
+  Problem* problem = benchmark_problem->mutable_problem();
+  for (int i = 0; i < num_points; ++i) {
+    double* point = points + kPointSize * i;
+    for (int j = 0; j < observations_per_point; ++j) {
+      double* camera = cameras + kCameraSize * Uniform(num_cameras);
+      // With a zero observation, the residual is the projection.
+      double projection[2];
+      SnavelyReprojectionError(0.0, 0.0)(camera, point, projection);
+      problem->AddResidualBlock(
+          SnavelyReprojectionError::Create(projection[0] + RandNormal(),
+                                           projection[1] + RandNormal()),
+          nullptr,
+          camera,
+          point);
+    }
+  }
+
+  for (int i = 0; i < num_cameras; ++i) {
+    double* camera = cameras + kCameraSize * i;
+    for (int j = 0; j < 3; ++j) {
+      camera[j] += 0.01 * RandNormal();
+      camera[3 + j] += 0.1 * RandNormal();
+    }
+  }
+  for (int i = 0; i < kPointSize * num_points; ++i) {
+    points[i] += 0.1 * RandNormal();
+  }
+
+  benchmark_problem->SetParameters(parameters->data(), parameters->size());
+  return benchmark_problem;
+}
+
+// Adds the pose graph to benchmark_problem. The x, y and yaw of each
+// pose are separate parameter blocks, as in examples/slam/pose_graph_2d.
+void BuildPoseGraph2dProblem(const std::map<int, examples::Pose2d>& poses,
+                             const vector<examples::Constraint2d>& constraints,
+                             BenchmarkProblem* benchmark_problem) {
+  vector<double>* parameters = benchmark_problem->mutable_storage();
+  parameters->resize(3 * poses.size());
+  std::map<int, double*> pose_parameters;
+  int offset = 0;
+  for (const auto& id_and_pose : poses) {
+    double* pose = parameters->data() + offset;
+    pose[0] = id_and_pose.second.x;
+    pose[1] = id_and_pose.second.y;
+    pose[2] = id_and_pose.second.yaw_radians;
+    pose_parameters[id_and_pose.first] = pose;
+    offset += 3;
+  }
+
+  Problem* problem = benchmark_problem->mutable_problem();
+  LocalParameterization* angle_local_parameterization =
+      AngleLocalParameterization::Create();
+  for (const examples::Constraint2d& constraint : constraints) {
+    double* pose_begin = pose_parameters.at(constraint.id_begin);
+    double* pose_end = pose_parameters.at(constraint.id_end);
+    const Eigen::Matrix3d sqrt_information =
+        constraint.information.llt().matrixL();
+    problem->AddResidualBlock(
+        PoseGraph2dErrorTerm::Create(constraint.x,
+                                     constraint.y,
+                                     constraint.yaw_radians,
+                                     sqrt_information),
+        nullptr,
+        pose_begin,
+        pose_begin + 1,
+        pose_begin + 2,
+        pose_end,
+        pose_end + 1,
+        pose_end + 2);
+  }
+  for (const auto& id_and_pose : pose_parameters) {
+    double* yaw = id_and_pose.second + 2;
+    if (problem->HasParameterBlock(yaw)) {
+      problem->SetParameterization(yaw, angle_local_parameterization);
+    }
+  }
+
+  // The gauge freedom is removed by holding the first pose constant.
+  double* first_pose = parameters->data();
+  for (int i = 0; i < 3; ++i) {
+    problem->SetParameterBlockConstant(first_pose + i);
+  }
+  benchmark_problem->SetParameters(parameters->data(), parameters->size());
+}
+
+BenchmarkProblem* CreatePoseGraph2dProblem(const string& filename) {
+  std::map<int, examples::Pose2d> poses;
+  vector<examples::Constraint2d> constraints;
+  CHECK(examples::ReadG2oFile(filename, &poses, &constraints))
+      << "Unable to read " << filename;
+  BenchmarkProblem* benchmark_problem =
+      new BenchmarkProblem("G2O-2D/" + Basename(filename), false);
+  BuildPoseGraph2dProblem(poses, constraints, benchmark_problem);
+  return benchmark_problem;
+}
+
+// A robot driving num_laps times around a circle with num_poses
+// poses per lap. Consecutive poses are connected by odometry
+// constraints, and each pose is connected to the same pose on the
+// previous lap by a loop closure.
+BenchmarkProblem* CreateSyntheticPoseGraph2dProblem(const int num_poses,
+                                                    const int num_laps) {
+  SetRandomState(5);
+  const double kRadius = 10.0;
+  const int num_total_poses = num_poses * num_laps;
+  std::map<int, examples::Pose2d> ground_truth;
+  for (int i = 0; i < num_total_poses; ++i) {
+    const double angle = 2.0 * M_PI * i / num_poses;
+    examples::Pose2d& pose = ground_truth[i];
+    pose.x = kRadius * std::cos(angle);
+    pose.y = kRadius * std::sin(angle);
+    pose.yaw_radians = examples::NormalizeAngle(angle + M_PI / 2.0);
+  }
+
+  auto add_constraint = [&ground_truth](int id_begin,
+                                        int id_end,
+                                        vector<examples::Constraint2d>* out) {
+    const examples::Pose2d& a = ground_truth[id_begin];
+    const examples::Pose2d& b = ground_truth[id_end];
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    examples::Constraint2d constraint;
+    constraint.id_begin = id_begin;
+    constraint.id_end = id_end;
+    constraint.x =
+        std::cos(a.yaw_radians) * dx + std::sin(a.yaw_radians) * dy +
+        0.01 * RandNormal();
+    constraint.y =
+        -std::sin(a.yaw_radians) * dx + std::cos(a.yaw_radians) * dy +
+        0.01 * RandNormal();
+    constraint.yaw_radians = examples::NormalizeAngle(
+        b.yaw_radians - a.yaw_radians + 0.001 * RandNormal());
+    constraint.information = Eigen::Matrix3d::Identity();
+    out->push_back(constraint);
+  };
+
+  vector<examples::Constraint2d> constraints;
+  for (int i = 1; i < num_total_poses; ++i) {
+    add_constraint(i - 1, i, &constraints);
+    if (i >= num_poses) {
+      add_constraint(i - num_poses, i, &constraints);
+    }
+  }
+
+  std::map<int, examples::Pose2d> poses = ground_truth;
+  for (auto& id_and_pose : poses) {
+    id_and_pose.second.x += 0.5 * RandNormal();
+    id_and_pose.second.y += 0.5 * RandNormal();
+    id_and_pose.second.yaw_radians = examples::NormalizeAngle(
+        id_and_pose.second.yaw_radians + 0.1 * RandNormal());
+  }
+
+  BenchmarkProblem* benchmark_problem = new BenchmarkProblem(
+      StringPrintf("Synthetic/PoseGraph2d-%d-%d", num_poses, num_laps), false);
+  BuildPoseGraph2dProblem(poses, constraints, benchmark_problem);
+  return benchmark_problem;
+}
+
+// The position and the orientation of each pose are separate
+// parameter blocks, as in examples/slam/pose_graph_3d.
+BenchmarkProblem* CreatePoseGraph3dProblem(const string& filename) {
+  examples::MapOfPoses poses;
+  examples::VectorOfConstraints constraints;
+  CHECK(examples::ReadG2oFile(filename, &poses, &constraints))
+      << "Unable to read " << filename;
+  BenchmarkProblem* benchmark_problem =
+      new BenchmarkProblem("G2O-3D/" + Basename(filename), false);
+
+  vector<double>* parameters = benchmark_problem->mutable_storage();
+  parameters->resize(7 * poses.size());
+  std::map<int, double*> pose_parameters;
+  int offset = 0;
+  for (const auto& id_and_pose : poses) {
+    double* pose = parameters->data() + offset;
+    Eigen::Map<Eigen::Vector3d> p(pose);
+    Eigen::Map<Eigen::Vector4d> q(pose + 3);
+    p = id_and_pose.second.p;
+    q = id_and_pose.second.q.coeffs();
+    pose_parameters[id_and_pose.first] = pose;
+    offset += 7;
+  }
+
+  Problem* problem = benchmark_problem->mutable_problem();
+  LocalParameterization* quaternion_local_parameterization =
+      new EigenQuaternionParameterization;
+  for (const examples::Constraint3d& constraint : constraints) {
+    double* pose_begin = pose_parameters.at(constraint.id_begin);
+    double* pose_end = pose_parameters.at(constraint.id_end);
+    const Eigen::Matrix<double, 6, 6> sqrt_information =
+        constraint.information.llt().matrixL();
+    problem->AddResidualBlock(
+        PoseGraph3dErrorTerm::Create(constraint.t_be, sqrt_information),
+        nullptr,
+        pose_begin,
+        pose_begin + 3,
+        pose_end,
+        pose_end + 3);
+  }
+  for (const auto& id_and_pose : pose_parameters) {
+    double* q = id_and_pose.second + 3;
+    if (problem->HasParameterBlock(q)) {
+      problem->SetParameterization(q, quaternion_local_parameterization);
+    }
+  }
+
+  problem->SetParameterBlockConstant(parameters->data());
+  problem->SetParameterBlockConstant(parameters->data() + 3);
+  benchmark_problem->SetParameters(parameters->data(), parameters->size());
+  return benchmark_problem;
+}
+
+struct SolverConfiguration {
+  LinearSolverType linear_solver_type;
+  PreconditionerType preconditioner_type;
+};
+
+vector<SolverConfiguration> SolverConfigurations(bool is_bundle_adjustment) {
+  if (is_bundle_adjustment) {
+    return {{DENSE_SCHUR, IDENTITY},
+            {SPARSE_SCHUR, IDENTITY},
+            {ITERATIVE_SCHUR, JACOBI},
+            {ITERATIVE_SCHUR, SCHUR_JACOBI},
+            {ITERATIVE_SCHUR, CLUSTER_JACOBI},
+            {ITERATIVE_SCHUR, CLUSTER_TRIDIAGONAL}};
+  }
+  return {{SPARSE_NORMAL_CHOLESKY, IDENTITY}, {CGNR, JACOBI}};
+}
+
+Solver::Options SolverOptions(const SolverConfiguration& configuration,
+                              const int num_threads) {
+  Solver::Options options;
+  options.linear_solver_type = configuration.linear_solver_type;
+  options.preconditioner_type = configuration.preconditioner_type;
+  options.num_threads = num_threads;
+  options.max_num_iterations = kMaxNumIterations;
+  options.logging_type = SILENT;
+  return options;
+}
+
+void BM_Solve(benchmark::State& state,
+              BenchmarkProblem* benchmark_problem,
+              const Solver::Options& options) {
+  Solver::Summary summary;
+  for (auto _ : state) {
+    state.PauseTiming();
+    benchmark_problem->ResetParameters();
+    state.ResumeTiming();
+    Solve(options, benchmark_problem->mutable_problem(), &summary);
+  }
+  state.counters["solver_iterations"] = summary.iterations.size() - 1;
+  state.counters["initial_cost"] = summary.initial_cost;
+  state.counters["final_cost"] = summary.final_cost;
+  state.counters["linear_solver_time"] = summary.linear_solver_time_in_seconds;
+  state.counters["jacobian_evaluation_time"] =
+      summary.jacobian_evaluation_time_in_seconds;
+  if (!summary.IsSolutionUsable()) {
+    state.SkipWithError(summary.message.c_str());
+  }
+}
+
+void RegisterBenchmarks(BenchmarkProblem* benchmark_problem) {
+  for (const SolverConfiguration& configuration :
+       SolverConfigurations(benchmark_problem->is_bundle_adjustment())) {
+    for (int num_threads : {1, 2, 4, 8}) {
+      const Solver::Options options = SolverOptions(configuration, num_threads);
+      // Skip the linear solvers that are not compiled in.
+      string error;
+      if (!options.IsValid(&error)) {
+        continue;
+      }
+      const string name = StringPrintf(
+          "BM_Solve/%s/%s/%s/threads:%d",
+          benchmark_problem->name().c_str(),
+          LinearSolverTypeToString(configuration.linear_solver_type),
+          PreconditionerTypeToString(configuration.preconditioner_type),
+          num_threads);
+      auto benchmark_function = [benchmark_problem,
+                                 options](benchmark::State& state) {
+        BM_Solve(state, benchmark_problem, options);
+      };
+      benchmark::RegisterBenchmark(name.c_str(), benchmark_function)
+          ->Unit(benchmark::kMillisecond)
+          ->UseRealTime();
+    }
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace ceres
+
+int main(int argc, char** argv) {
+  using ceres::internal::BenchmarkProblem;
+
+  // Google Benchmark removes the flags it knows from argv, the rest
+  // are ours.
+  benchmark::Initialize(&argc, argv);
+
+  std::vector<std::unique_ptr<BenchmarkProblem>> problems;
+  problems.emplace_back(
+      ceres::internal::CreateSyntheticBundleAdjustmentProblem(50, 5000, 8));
+  problems.emplace_back(
+      ceres::internal::CreateSyntheticPoseGraph2dProblem(500, 4));
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    const size_t equals = arg.find('=');
+    const std::string flag = arg.substr(0, equals);
+    const std::string value =
+        equals == std::string::npos ? "" : arg.substr(equals + 1);
+    if (flag == "--bal" && !value.empty()) {
+      problems.emplace_back(ceres::internal::CreateBALProblem(value));
+    } else if (flag == "--g2o_2d" && !value.empty()) {
+      problems.emplace_back(ceres::internal::CreatePoseGraph2dProblem(value));
+    } else if (flag == "--g2o_3d" && !value.empty()) {
+      problems.emplace_back(ceres::internal::CreatePoseGraph3dProblem(value));
+    } else {
+      fprintf(stderr,
+              "Unknown argument: %s\n"
+              "Usage: %s [--bal=<file>] [--g2o_2d=<file>] [--g2o_3d=<file>] "
+              "[benchmark flags]\n",
+              argv[i],
+              argv[0]);
+      return 1;
+    }
+  }
+
+  for (const auto& problem : problems) {
+    ceres::internal::RegisterBenchmarks(problem.get());
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
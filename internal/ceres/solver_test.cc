@@ -30,14 +30,18 @@
 
 #include "ceres/solver.h"
 
+#include <atomic>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "ceres/autodiff_cost_function.h"
 #include "ceres/evaluation_callback.h"
 #include "ceres/local_parameterization.h"
+#include "ceres/loss_function.h"
 #include "ceres/problem.h"
 #include "ceres/problem_impl.h"
 #include "ceres/sized_cost_function.h"
@@ -201,6 +205,88 @@ TEST(Solver, CantMixEvaluationCallbackWithInnerIterations) {
   EXPECT_EQ(summary.termination_type, CONVERGENCE);
 }
 
+// A bundle adjustment like residual, where a "camera" (log scale,
+// translation) maps a two dimensional point to an observation.
+struct ScaledTranslationCostFunctor {
+  ScaledTranslationCostFunctor(double u, double v) : u(u), v(v) {}
+
+  template <typename T>
+  bool operator()(const T* const camera,
+                  const T* const point,
+                  T* residual) const {
+    const T scale = exp(camera[0]);
+    residual[0] = scale * point[0] + camera[1] - u;
+    residual[1] = scale * point[1] + camera[2] - v;
+    return true;
+  }
+
+  static CostFunction* Create(double u, double v) {
+    return new AutoDiffCostFunction<ScaledTranslationCostFunctor, 2, 3, 2>(
+        new ScaledTranslationCostFunctor(u, v));
+  }
+
+  double u;
+  double v;
+};
+
+static double SolveScaledTranslationProblem(bool use_batched_inner_iterations,
+                                            double* initial_cost) {
+  const int kNumCameras = 4;
+  const int kNumPoints = 50;
+  std::vector<double> cameras(3 * kNumCameras);
+  std::vector<double> points(2 * kNumPoints);
+
+  Problem problem;
+  for (int i = 0; i < kNumCameras; ++i) {
+    const double camera[3] = {0.1 * i, 1.0 - i, 0.5 * i};
+    for (int j = 0; j < kNumPoints; ++j) {
+      const double point[2] = {std::sin(j), std::cos(2.0 * j)};
+      // Perturb the observations, so that the problem has a non-zero
+      // residual at the optimum.
+      const double noise = 0.01 * std::sin(7.0 * (i * kNumPoints + j));
+      const double scale = std::exp(camera[0]);
+      problem.AddResidualBlock(
+          ScaledTranslationCostFunctor::Create(
+              scale * point[0] + camera[1] + noise,
+              scale * point[1] + camera[2] - noise),
+          i == 1 ? new HuberLoss(0.1) : nullptr,
+          cameras.data() + 3 * i,
+          points.data() + 2 * j);
+    }
+    cameras[3 * i] = camera[0] + 0.2;
+    cameras[3 * i + 1] = camera[1] - 0.3;
+    cameras[3 * i + 2] = camera[2] + 0.1;
+  }
+  for (int j = 0; j < kNumPoints; ++j) {
+    points[2 * j] = 0.0;
+    points[2 * j + 1] = 0.0;
+  }
+  problem.SetParameterBlockConstant(cameras.data());
+
+  Solver::Options options;
+  options.linear_solver_type = DENSE_SCHUR;
+  options.use_inner_iterations = true;
+  options.use_batched_inner_iterations = use_batched_inner_iterations;
+  Solver::Summary summary;
+  Solve(options, &problem, &summary);
+  EXPECT_EQ(summary.termination_type, CONVERGENCE);
+  EXPECT_TRUE(summary.inner_iterations_used);
+  EXPECT_GT(summary.num_inner_iteration_steps, 0);
+  *initial_cost = summary.initial_cost;
+  return summary.final_cost;
+}
+
+TEST(Solver, BatchedInnerIterationsMatchInnerIterations) {
+  double initial_cost = 0.0;
+  const double final_cost = SolveScaledTranslationProblem(false, &initial_cost);
+  double batched_initial_cost = 0.0;
+  const double batched_final_cost =
+      SolveScaledTranslationProblem(true, &batched_initial_cost);
+  EXPECT_EQ(initial_cost, batched_initial_cost);
+  EXPECT_LT(final_cost, 1e-3 * initial_cost);
+  EXPECT_NEAR(batched_final_cost, final_cost, 1e-6 * final_cost);
+}
+
 // The parameters must be in separate blocks so that they can be individually
 // set constant or not.
 struct Quadratic4DCostFunction {
@@ -444,6 +530,285 @@ TEST(Solver, IterativeLinearSolverForDogleg) {
   EXPECT_FALSE(options.IsValid(&message));
 }
 
+TEST(Solver, LevenbergMarquardtEigendecompositionRequiresDenseSolver) {
+  Solver::Options options;
+  options.use_lm_eigendecomposition = true;
+  string message;
+  options.linear_solver_type = DENSE_QR;
+  EXPECT_TRUE(options.IsValid(&message));
+
+  options.linear_solver_type = DENSE_NORMAL_CHOLESKY;
+  EXPECT_TRUE(options.IsValid(&message));
+
+  options.linear_solver_type = DENSE_SCHUR;
+  EXPECT_FALSE(options.IsValid(&message));
+
+  options.linear_solver_type = DENSE_QR;
+  options.trust_region_strategy_type = DOGLEG;
+  EXPECT_FALSE(options.IsValid(&message));
+}
+
+TEST(Solver, MatrixFreeJacobianRequiresCgnr) {
+  Solver::Options options;
+  options.use_matrix_free_jacobian = true;
+  string message;
+  options.linear_solver_type = CGNR;
+  options.preconditioner_type = JACOBI;
+  EXPECT_TRUE(options.IsValid(&message));
+
+  options.preconditioner_type = IDENTITY;
+  EXPECT_TRUE(options.IsValid(&message));
+
+  options.preconditioner_type = SUBSET;
+  EXPECT_FALSE(options.IsValid(&message));
+
+  options.preconditioner_type = JACOBI;
+  options.linear_solver_type = ITERATIVE_SCHUR;
+  EXPECT_FALSE(options.IsValid(&message));
+}
+
+TEST(Solver, CantMixEvaluationCallbackWithMatrixFreeJacobian) {
+  double x = 50.0;
+  double y = 60.0;
+
+  Problem::Options problem_options;
+  NoOpEvaluationCallback evaluation_callback;
+  problem_options.evaluation_callback = &evaluation_callback;
+
+  Problem problem(problem_options);
+  problem.AddResidualBlock(QuadraticCostFunctor::Create(), nullptr, &x);
+  problem.AddResidualBlock(QuadraticCostFunctor::Create(), nullptr, &y);
+
+  Solver::Options options;
+  options.linear_solver_type = CGNR;
+  options.preconditioner_type = JACOBI;
+  options.use_matrix_free_jacobian = true;
+  Solver::Summary summary;
+  Solve(options, &problem, &summary);
+  EXPECT_EQ(summary.termination_type, FAILURE);
+
+  options.use_matrix_free_jacobian = false;
+  Solve(options, &problem, &summary);
+  EXPECT_EQ(summary.termination_type, CONVERGENCE);
+}
+
+// Couples consecutive points of a chain.
+struct ChainCostFunctor {
+  template <typename T>
+  bool operator()(const T* const x, const T* const y, T* residuals) const {
+    using std::sin;
+    residuals[0] = x[0] * y[1] - 1.0;
+    residuals[1] = x[1] + sin(y[0]) - 0.5;
+    return true;
+  }
+};
+
+// Solve a chain problem and return the final cost and the solution.
+double SolveChainProblem(const Solver::Options& options,
+                         std::vector<double>* solution,
+                         Solver::Summary* summary) {
+  const int kNumPoints = 20;
+  solution->resize(2 * kNumPoints);
+  for (int i = 0; i < 2 * kNumPoints; ++i) {
+    (*solution)[i] = 1.0 + 0.1 * (i % 7);
+  }
+
+  Problem problem;
+  for (int i = 0; i + 1 < kNumPoints; ++i) {
+    problem.AddResidualBlock(
+        new AutoDiffCostFunction<ChainCostFunctor, 2, 2, 2>(
+            new ChainCostFunctor),
+        new SoftLOneLoss(1.0),
+        solution->data() + 2 * i,
+        solution->data() + 2 * (i + 1));
+  }
+
+  Solve(options, &problem, summary);
+  EXPECT_TRUE(summary->IsSolutionUsable()) << summary->message;
+  return summary->final_cost;
+}
+
+double SolveChainProblem(const Solver::Options& options,
+                         std::vector<double>* solution) {
+  Solver::Summary summary;
+  return SolveChainProblem(options, solution, &summary);
+}
+
+TEST(Solver, MatrixFreeJacobianMatchesStoredJacobian) {
+  for (PreconditionerType preconditioner_type : {JACOBI, IDENTITY}) {
+    Solver::Options options;
+    options.linear_solver_type = CGNR;
+    options.preconditioner_type = preconditioner_type;
+    options.num_threads = 2;
+    options.max_linear_solver_iterations = 100;
+    std::vector<double> expected_solution;
+    const double expected_cost = SolveChainProblem(options, &expected_solution);
+
+    options.use_matrix_free_jacobian = true;
+    std::vector<double> solution;
+    const double cost = SolveChainProblem(options, &solution);
+    EXPECT_NEAR(cost, expected_cost, 1e-10 * (1.0 + expected_cost));
+    for (int i = 0; i < solution.size(); ++i) {
+      EXPECT_NEAR(solution[i], expected_solution[i], 1e-6);
+    }
+  }
+}
+
+TEST(Solver, ConcurrentSolvesAreTracedSeparately) {
+  // Keep solving an untraced line search problem on another thread
+  // while the traced trust region solves run.
+  std::atomic<bool> traced_solves_done(false);
+  std::thread untraced_thread([&traced_solves_done]() {
+    Solver::Options options;
+    options.minimizer_type = LINE_SEARCH;
+    do {
+      std::vector<double> solution;
+      Solver::Summary summary;
+      SolveChainProblem(options, &solution, &summary);
+      EXPECT_TRUE(summary.trace_report.empty());
+    } while (!traced_solves_done);
+  });
+
+  Solver::Options options;
+  options.linear_solver_type = DENSE_QR;
+  options.enable_tracing = true;
+  for (int i = 0; i < 10; ++i) {
+    std::vector<double> solution;
+    Solver::Summary summary;
+    SolveChainProblem(options, &solution, &summary);
+    EXPECT_NE(summary.trace_report.find("TrustRegionMinimizer::Iteration"),
+              std::string::npos);
+    EXPECT_EQ(summary.trace_report.find("LineSearchMinimizer"),
+              std::string::npos);
+  }
+  traced_solves_done = true;
+  untraced_thread.join();
+}
+
+#ifndef _WIN32
+TEST(Solver, MemoryMappedStorageMatchesHeapStorage) {
+  Solver::Options options;
+  options.linear_solver_type = ITERATIVE_SCHUR;
+  options.preconditioner_type = SCHUR_JACOBI;
+  options.use_explicit_schur_complement = true;
+  options.num_threads = 2;
+  std::vector<double> expected_solution;
+  const double expected_cost = SolveChainProblem(options, &expected_solution);
+
+  // Storage only changes where the values live, not the arithmetic.
+  options.memory_mapped_storage_directory = testing::TempDir();
+  std::vector<double> solution;
+  const double cost = SolveChainProblem(options, &solution);
+  EXPECT_EQ(cost, expected_cost);
+  EXPECT_EQ(solution, expected_solution);
+}
+#endif  // _WIN32
+
+TEST(Solver, MemoryMappedStorageRequiresUsableDirectory) {
+  double x = 50.0;
+  Problem problem;
+  problem.AddResidualBlock(QuadraticCostFunctor::Create(), nullptr, &x);
+
+  Solver::Options options;
+  options.linear_solver_type = CGNR;
+  options.memory_mapped_storage_directory =
+      testing::TempDir() + "/ceres_does_not_exist";
+  Solver::Summary summary;
+  Solve(options, &problem, &summary);
+  EXPECT_EQ(summary.termination_type, FAILURE);
+  EXPECT_NE(summary.message.find("Unable to create the Jacobian"),
+            std::string::npos)
+      << summary.message;
+}
+
+#if !defined(CERES_NO_SUITESPARSE) || defined(CERES_USE_EIGEN_SPARSE)
+// Add a camera which sees the points first_point, ..., first_point +
+// 4 (mod the number of points) to a bundle adjustment like problem.
+void AddCamera(double* camera,
+               std::vector<double>* points,
+               const int first_point,
+               Problem* problem,
+               ParameterBlockOrdering* ordering) {
+  const int num_points = points->size() / 2;
+  for (int i = 0; i < 5; ++i) {
+    double* point = points->data() + 2 * ((first_point + i) % num_points);
+    problem->AddResidualBlock(
+        new AutoDiffCostFunction<ChainCostFunctor, 2, 2, 2>(
+            new ChainCostFunctor),
+        nullptr,
+        camera,
+        point);
+    ordering->AddElementToGroup(point, 0);
+  }
+  ordering->AddElementToGroup(camera, 1);
+}
+
+TEST(Solver, ReusesVisibilityClustering) {
+  const int kNumPoints = 12;
+  const int kNumCameras = 7;
+  std::vector<double> points(2 * kNumPoints);
+  std::vector<double> cameras(2 * kNumCameras);
+  for (int i = 0; i < points.size(); ++i) {
+    points[i] = 1.0 + 0.1 * (i % 7);
+  }
+  for (int i = 0; i < cameras.size(); ++i) {
+    cameras[i] = 1.0 + 0.1 * (i % 5);
+  }
+
+  Problem problem;
+  std::shared_ptr<ParameterBlockOrdering> ordering(
+      new ParameterBlockOrdering);
+  for (int i = 0; i + 1 < kNumCameras; ++i) {
+    AddCamera(cameras.data() + 2 * i, &points, 2 * i, &problem, ordering.get());
+  }
+
+  VisibilityClustering clustering;
+  Solver::Options options;
+  options.linear_solver_type = ITERATIVE_SCHUR;
+  options.preconditioner_type = CLUSTER_JACOBI;
+#ifdef CERES_USE_EIGEN_SPARSE
+  options.sparse_linear_algebra_library_type = EIGEN_SPARSE;
+#endif
+  options.linear_solver_ordering = ordering;
+  options.visibility_clustering = &clustering;
+  options.max_num_iterations = 2;
+  Solver::Summary summary;
+  Solve(options, &problem, &summary);
+  EXPECT_TRUE(summary.IsSolutionUsable()) << summary.message;
+
+  EXPECT_EQ(clustering.preconditioner_type, CLUSTER_JACOBI);
+  ASSERT_EQ(clustering.cluster_membership.size(), kNumCameras - 1);
+  for (int i = 0; i + 1 < kNumCameras; ++i) {
+    const double* camera = cameras.data() + 2 * i;
+    ASSERT_EQ(clustering.cluster_membership.count(camera), 1);
+    EXPECT_GE(clustering.cluster_membership[camera], 0);
+    EXPECT_LT(clustering.cluster_membership[camera], clustering.num_clusters);
+  }
+  EXPECT_GE(clustering.block_pairs.size(), kNumCameras - 1);
+  for (const auto& block_pair : clustering.block_pairs) {
+    EXPECT_EQ(clustering.cluster_membership.count(block_pair.first), 1);
+    EXPECT_EQ(clustering.cluster_membership.count(block_pair.second), 1);
+  }
+
+  // The cameras keep their clusters when a camera is added.
+  const VisibilityClustering previous_clustering = clustering;
+  double* new_camera = cameras.data() + 2 * (kNumCameras - 1);
+  AddCamera(new_camera, &points, 1, &problem, ordering.get());
+  options.linear_solver_ordering = ordering;
+  Solve(options, &problem, &summary);
+  EXPECT_TRUE(summary.IsSolutionUsable()) << summary.message;
+
+  ASSERT_EQ(clustering.cluster_membership.size(), kNumCameras);
+  for (const auto& camera_cluster : previous_clustering.cluster_membership) {
+    EXPECT_EQ(clustering.cluster_membership[camera_cluster.first],
+              camera_cluster.second);
+  }
+  ASSERT_EQ(clustering.cluster_membership.count(new_camera), 1);
+  EXPECT_LT(clustering.cluster_membership[new_camera],
+            previous_clustering.num_clusters);
+}
+#endif  // !defined(CERES_NO_SUITESPARSE) || defined(CERES_USE_EIGEN_SPARSE)
+
 TEST(Solver, LinearSolverTypeNormalOperation) {
   Solver::Options options;
   options.linear_solver_type = DENSE_QR;
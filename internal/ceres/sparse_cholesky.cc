@@ -37,6 +37,7 @@
 #include "ceres/float_suitesparse.h"
 #include "ceres/iterative_refiner.h"
 #include "ceres/suitesparse.h"
+#include "ceres/trace.h"
 
 namespace ceres {
 namespace internal {
@@ -110,6 +111,7 @@ std::unique_ptr<SparseCholesky> SparseCholesky::Create(
     sparse_cholesky = std::unique_ptr<SparseCholesky>(new RefinedSparseCholesky(
         std::move(sparse_cholesky), std::move(refiner)));
   }
+  sparse_cholesky->tracer_ = options.tracer;
   return sparse_cholesky;
 }
 
@@ -120,8 +122,13 @@ LinearSolverTerminationType SparseCholesky::FactorAndSolve(
     const double* rhs,
     double* solution,
     std::string* message) {
-  LinearSolverTerminationType termination_type = Factorize(lhs, message);
+  LinearSolverTerminationType termination_type;
+  {
+    ScopedTrace trace(tracer_, "SparseCholesky::Factorize");
+    termination_type = Factorize(lhs, message);
+  }
   if (termination_type == LINEAR_SOLVER_SUCCESS) {
+    ScopedTrace trace(tracer_, "SparseCholesky::Solve");
     termination_type = Solve(rhs, solution, message);
   }
   return termination_type;
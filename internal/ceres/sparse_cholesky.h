@@ -109,6 +109,11 @@ class CERES_EXPORT_INTERNAL SparseCholesky {
       const double* rhs,
       double* solution,
       std::string* message);
+
+ private:
+  // Records the calls to FactorAndSolve if not nullptr. Set by Create
+  // from LinearSolver::Options::tracer.
+  Tracer* tracer_ = nullptr;
 };
 
 class IterativeRefiner;
@@ -82,6 +82,13 @@ LinearSolver::Summary SparseNormalCholeskySolver::SolveImpl(
     regularizer.reset(BlockSparseMatrix::CreateDiagonalMatrix(
         per_solve_options.D, A->block_structure()->cols));
     event_logger.AddEvent("Diagonal");
+    // Growing A fails if it is memory mapped and a larger file cannot
+    // be created.
+    if (!A->Reserve(A->num_nonzeros() + regularizer->num_nonzeros(),
+                    &summary.message)) {
+      summary.termination_type = LINEAR_SOLVER_FATAL_ERROR;
+      return summary;
+    }
     A->AppendRows(*regularizer);
     event_logger.AddEvent("Append");
   }
@@ -89,7 +96,12 @@ LinearSolver::Summary SparseNormalCholeskySolver::SolveImpl(
 
   if (inner_product_computer_.get() == NULL) {
     inner_product_computer_.reset(
-        InnerProductComputer::Create(*A, sparse_cholesky_->StorageType()));
+        InnerProductComputer::Create(*A,
+                                     0,
+                                     A->block_structure()->rows.size(),
+                                     sparse_cholesky_->StorageType(),
+                                     options_.context,
+                                     options_.num_threads));
 
     event_logger.AddEvent("InnerProductComputer::Create");
   }
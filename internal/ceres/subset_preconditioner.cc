@@ -79,6 +79,12 @@ bool SubsetPreconditioner::UpdateImpl(const BlockSparseMatrix& A,
     //     [D]
     std::unique_ptr<BlockSparseMatrix> regularizer(
         BlockSparseMatrix::CreateDiagonalMatrix(D, bs->cols));
+    std::string message;
+    if (!m->Reserve(m->num_nonzeros() + regularizer->num_nonzeros(),
+                    &message)) {
+      LOG(ERROR) << "Unable to append the regularizer: " << message;
+      return false;
+    }
     m->AppendRows(*regularizer);
   }
 
@@ -87,7 +93,9 @@ bool SubsetPreconditioner::UpdateImpl(const BlockSparseMatrix& A,
         *m,
         options_.subset_preconditioner_start_row_block,
         bs->rows.size(),
-        sparse_cholesky_->StorageType()));
+        sparse_cholesky_->StorageType(),
+        options_.context,
+        options_.num_threads));
   }
 
   // Compute inner_product = [Q'*Q + D'*D]
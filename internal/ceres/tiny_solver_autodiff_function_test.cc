@@ -144,4 +144,28 @@ TEST(TinySolverAutoDiffFunction, ResidualsDynamicAutoDiff) {
   EXPECT_NEAR(0.0, solver.summary.final_cost, 1e-10);
 }
 
+// A test case for when the number of residuals is dynamically sized
+// with an upper bound and we use autodiff.
+TEST(TinySolverAutoDiffFunction, BoundedResidualsDynamicAutoDiff) {
+  Eigen::Vector3d x0(0.76026643, -30.01799744, 0.55192142);
+
+  DynamicResidualsFunctor f;
+  using AutoDiffCostFunctor = ceres::TinySolverAutoDiffFunction<
+      DynamicResidualsFunctor,
+      Eigen::Dynamic,
+      3,
+      double,
+      /* kMaxNumResiduals = */ 4>;
+  static_assert(AutoDiffCostFunctor::MAX_NUM_RESIDUALS == 4, "");
+  AutoDiffCostFunctor f_autodiff(f);
+
+  Eigen::Vector2d residuals;
+  f_autodiff(x0.data(), residuals.data(), nullptr);
+  EXPECT_GT(residuals.squaredNorm() / 2.0, 1e-10);
+
+  TinySolver<AutoDiffCostFunctor> solver;
+  solver.Solve(f_autodiff, &x0);
+  EXPECT_NEAR(0.0, solver.summary.final_cost, 1e-10);
+}
+
 }  // namespace ceres
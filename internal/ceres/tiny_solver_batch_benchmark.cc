@@ -0,0 +1,109 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Throughput of TinySolverBatch on a batch of triangulation problems.
+
+#include <random>
+#include <vector>
+
+#include "Eigen/Core"
+#include "benchmark/benchmark.h"
+#include "ceres/tiny_solver_autodiff_function.h"
+#include "ceres/tiny_solver_batch.h"
+
+namespace ceres {
+
+static constexpr int kNumCameras = 4;
+
+// The reprojection errors of a point observed by kNumCameras
+// cameras with identity rotations and unit focal lengths.
+struct Triangulation {
+  template <typename T>
+  bool operator()(const T* point, T* residuals) const {
+    for (int i = 0; i < kNumCameras; ++i) {
+      const T x = point[0] - camera_centers[3 * i];
+      const T y = point[1] - camera_centers[3 * i + 1];
+      const T z = point[2] - camera_centers[3 * i + 2];
+      residuals[2 * i] = x / z - observations[2 * i];
+      residuals[2 * i + 1] = y / z - observations[2 * i + 1];
+    }
+    return true;
+  }
+
+  double camera_centers[3 * kNumCameras];
+  double observations[2 * kNumCameras];
+};
+
+// Arguments: number of problems and number of threads.
+static void BM_TinySolverBatch(benchmark::State& state) {
+  typedef TinySolverAutoDiffFunction<Triangulation, 2 * kNumCameras, 3>
+      Function;
+  const int num_problems = state.range(0);
+  const int num_threads = state.range(1);
+
+  std::mt19937 prng;
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::normal_distribution<double> noise(0.0, 1e-3);
+  std::vector<Triangulation> problems(num_problems);
+  std::vector<Eigen::Vector3d> initial_points(num_problems);
+  for (int i = 0; i < num_problems; ++i) {
+    const Eigen::Vector3d point(uniform(prng), uniform(prng), 5.0);
+    Triangulation& problem = problems[i];
+    for (int j = 0; j < kNumCameras; ++j) {
+      const Eigen::Vector3d center(uniform(prng), uniform(prng), 0.0);
+      Eigen::Map<Eigen::Vector3d>(problem.camera_centers + 3 * j) = center;
+      const Eigen::Vector3d ray = point - center;
+      problem.observations[2 * j] = ray.x() / ray.z() + noise(prng);
+      problem.observations[2 * j + 1] = ray.y() / ray.z() + noise(prng);
+    }
+    initial_points[i] = point + Eigen::Vector3d(0.1, -0.1, 0.5);
+  }
+  std::vector<Function> functions(problems.begin(), problems.end());
+
+  TinySolverBatch<Function> solver(num_threads);
+  std::vector<Eigen::Vector3d> points;
+  for (auto _ : state) {
+    points = initial_points;
+    solver.Solve(functions.data(), num_problems, points.data(), NULL);
+  }
+  state.SetItemsProcessed(state.iterations() * num_problems);
+}
+
+BENCHMARK(BM_TinySolverBatch)
+    ->Args({100000, 1})
+    ->Args({100000, 2})
+    ->Args({100000, 4})
+    ->Args({100000, 8})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace ceres
+
+BENCHMARK_MAIN();
@@ -0,0 +1,263 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+// Count failed Eigen assertions instead of relying on assert(), which is
+// compiled out in release builds. Together with EIGEN_RUNTIME_NO_MALLOC this
+// lets the tests below check that TinySolverBatch::Solve does not allocate.
+// The problems are solved on several threads, so the count is atomic.
+#include <atomic>
+namespace {
+std::atomic<int> num_eigen_assertion_failures(0);
+}  // namespace
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) ((x) ? (void)0 : (void)++num_eigen_assertion_failures)
+
+#include "ceres/tiny_solver_batch.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ceres/sized_cost_function.h"
+#include "ceres/tiny_solver.h"
+#include "ceres/tiny_solver_autodiff_function.h"
+#include "ceres/tiny_solver_cost_function_adapter.h"
+#include "gtest/gtest.h"
+
+namespace ceres {
+
+// The residuals of locating a point in the plane from its distances
+// to three anchors.
+struct Trilateration {
+  template <typename T>
+  bool operator()(const T* point, T* residuals) const {
+    for (int i = 0; i < 3; ++i) {
+      const T dx = point[0] - anchors[2 * i];
+      const T dy = point[1] - anchors[2 * i + 1];
+      residuals[i] = sqrt(dx * dx + dy * dy) - distances[i];
+    }
+    return true;
+  }
+
+  double anchors[6] = {0.0, 0.0, 10.0, 0.0, 0.0, 10.0};
+  double distances[3];
+};
+
+class TrilaterationCostFunction : public SizedCostFunction<3, 2> {
+ public:
+  explicit TrilaterationCostFunction(const Trilateration& trilateration)
+      : trilateration_(trilateration) {}
+
+  bool Evaluate(double const* const* parameters,
+                double* residuals,
+                double** jacobians) const final {
+    const double* point = parameters[0];
+    trilateration_(point, residuals);
+    if (jacobians != NULL && jacobians[0] != NULL) {
+      for (int i = 0; i < 3; ++i) {
+        const double distance = residuals[i] + trilateration_.distances[i];
+        jacobians[0][2 * i] =
+            (point[0] - trilateration_.anchors[2 * i]) / distance;
+        jacobians[0][2 * i + 1] =
+            (point[1] - trilateration_.anchors[2 * i + 1]) / distance;
+      }
+    }
+    return true;
+  }
+
+ private:
+  const Trilateration& trilateration_;
+};
+
+// Random problems with their exact solutions and initial guesses.
+static void CreateProblems(int num_problems,
+                           std::vector<Trilateration>* problems,
+                           std::vector<Eigen::Vector2d>* solutions,
+                           std::vector<Eigen::Vector2d>* initial_guesses) {
+  std::mt19937 prng;
+  std::uniform_real_distribution<double> uniform(1.0, 9.0);
+  std::normal_distribution<double> normal(0.0, 0.5);
+  for (int i = 0; i < num_problems; ++i) {
+    const Eigen::Vector2d solution(uniform(prng), uniform(prng));
+    Trilateration problem;
+    for (int j = 0; j < 3; ++j) {
+      problem.distances[j] =
+          (solution - Eigen::Vector2d(problem.anchors[2 * j],
+                                      problem.anchors[2 * j + 1]))
+              .norm();
+    }
+    problems->push_back(problem);
+    solutions->push_back(solution);
+    initial_guesses->push_back(solution +
+                               Eigen::Vector2d(normal(prng), normal(prng)));
+  }
+}
+
+TEST(TinySolverBatch, MatchesTinySolverWithAutoDiffFunction) {
+  typedef TinySolverAutoDiffFunction<Trilateration, 3, 2> Function;
+  const int kNumProblems = 1000;
+  std::vector<Trilateration> problems;
+  std::vector<Eigen::Vector2d> solutions;
+  std::vector<Eigen::Vector2d> initial_guesses;
+  CreateProblems(kNumProblems, &problems, &solutions, &initial_guesses);
+
+  std::vector<Function> functions(problems.begin(), problems.end());
+
+  std::vector<Eigen::Vector2d> expected = initial_guesses;
+  std::vector<TinySolver<Function>::Summary> expected_summaries;
+  TinySolver<Function> solver;
+  for (int i = 0; i < kNumProblems; ++i) {
+    expected_summaries.push_back(solver.Solve(functions[i], &expected[i]));
+  }
+
+  for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+    std::vector<Eigen::Vector2d> x = initial_guesses;
+    std::vector<TinySolverBatch<Function>::Summary> summaries(kNumProblems);
+    TinySolverBatch<Function> batch_solver(num_threads);
+    batch_solver.Solve(
+        functions.data(), kNumProblems, x.data(), summaries.data());
+
+    for (int i = 0; i < kNumProblems; ++i) {
+      EXPECT_EQ(x[i], expected[i]);
+      EXPECT_NEAR((x[i] - solutions[i]).norm(), 0.0, 1e-6);
+      EXPECT_EQ(summaries[i].status, expected_summaries[i].status);
+      EXPECT_EQ(summaries[i].iterations, expected_summaries[i].iterations);
+      EXPECT_EQ(summaries[i].final_cost, expected_summaries[i].final_cost);
+    }
+  }
+}
+
+TEST(TinySolverBatch, CostFunctionAdapterWithSharedContext) {
+  typedef TinySolverCostFunctionAdapter<Eigen::Dynamic, Eigen::Dynamic>
+      Function;
+  const int kNumProblems = 100;
+  std::vector<Trilateration> problems;
+  std::vector<Eigen::Vector2d> solutions;
+  std::vector<Eigen::Vector2d> initial_guesses;
+  CreateProblems(kNumProblems, &problems, &solutions, &initial_guesses);
+
+  std::vector<std::unique_ptr<CostFunction>> cost_functions;
+  std::vector<Function> functions;
+  std::vector<Eigen::VectorXd> x;
+  for (int i = 0; i < kNumProblems; ++i) {
+    cost_functions.emplace_back(new TrilaterationCostFunction(problems[i]));
+    functions.emplace_back(*cost_functions.back());
+    x.push_back(initial_guesses[i]);
+  }
+
+  std::unique_ptr<Context> context(Context::Create());
+  TinySolverBatch<Function> batch_solver(2, context.get());
+  batch_solver.Solve(functions.data(), kNumProblems, x.data(), NULL);
+  for (int i = 0; i < kNumProblems; ++i) {
+    EXPECT_NEAR((x[i] - solutions[i]).norm(), 0.0, 1e-6);
+  }
+
+  // Solving an empty batch is a no-op.
+  batch_solver.Solve(functions.data(), 0, x.data(), NULL);
+}
+
+// Fits a line y = a * x + b to num_points points on the line
+// y = 2 x + 1. The sizes are dynamic, and bounded unless the maximum
+// sizes are Eigen::Dynamic.
+template <int kMaxNumResiduals, int kMaxNumParameters>
+class LineFit {
+ public:
+  typedef double Scalar;
+  enum {
+    NUM_RESIDUALS = Eigen::Dynamic,
+    NUM_PARAMETERS = Eigen::Dynamic,
+    MAX_NUM_RESIDUALS = kMaxNumResiduals,
+    MAX_NUM_PARAMETERS = kMaxNumParameters,
+  };
+
+  explicit LineFit(int num_points) : num_points_(num_points) {}
+
+  int NumResiduals() const { return num_points_; }
+
+  int NumParameters() const { return 2; }
+
+  bool operator()(const double* parameters,
+                  double* residuals,
+                  double* jacobian) const {
+    for (int i = 0; i < num_points_; ++i) {
+      const double x = i;
+      residuals[i] = parameters[0] * x + parameters[1] - (2.0 * x + 1.0);
+      if (jacobian) {
+        jacobian[i] = x;
+        jacobian[num_points_ + i] = 1.0;
+      }
+    }
+    return true;
+  }
+
+ private:
+  int num_points_;
+};
+
+// Solve line fits of varying sizes and return the number of heap
+// allocations made by Eigen during the solve.
+template <typename Function>
+int NumAllocationsInSolve() {
+  std::vector<Function> functions;
+  std::vector<typename TinySolverBatch<Function>::Parameters> x;
+  for (int num_points = 3; num_points <= 10; ++num_points) {
+    functions.emplace_back(num_points);
+    x.emplace_back(2);
+    x.back() << 0.0, 0.0;
+  }
+
+  TinySolverBatch<Function> batch_solver(2);
+  std::vector<typename TinySolverBatch<Function>::Summary> summaries(
+      functions.size());
+  num_eigen_assertion_failures = 0;
+  Eigen::internal::set_is_malloc_allowed(false);
+  batch_solver.Solve(
+      functions.data(), functions.size(), x.data(), summaries.data());
+  Eigen::internal::set_is_malloc_allowed(true);
+
+  for (int i = 0; i < functions.size(); ++i) {
+    EXPECT_NEAR(summaries[i].final_cost, 0.0, 1e-10);
+  }
+  return num_eigen_assertion_failures;
+}
+
+TEST(TinySolverBatch, DynamicWithMaxSizesDoesNotAllocate) {
+  typedef LineFit<10, 2> Function;
+  EXPECT_EQ(NumAllocationsInSolve<Function>(), 0);
+}
+
+// This checks that the allocation check above is not vacuous.
+TEST(TinySolverBatch, DynamicWithoutMaxSizesAllocates) {
+  typedef LineFit<Eigen::Dynamic, Eigen::Dynamic> Function;
+  EXPECT_GT(NumAllocationsInSolve<Function>(), 0);
+}
+
+}  // namespace ceres
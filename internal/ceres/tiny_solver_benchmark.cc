@@ -0,0 +1,127 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// Benchmarks of TinySolver with statically sized, dynamically sized
+// and dynamically sized but bounded problems.
+
+#include "Eigen/Core"
+#include "benchmark/benchmark.h"
+#include "ceres/tiny_solver.h"
+#include "ceres/tiny_solver_autodiff_function.h"
+
+namespace ceres {
+
+static constexpr int kNumCameras = 4;
+
+// The reprojection errors of a point observed by num_cameras <=
+// kNumCameras cameras with identity rotations and unit focal lengths.
+struct Triangulation {
+  Triangulation() {
+    const Eigen::Vector3d point(0.3, -0.2, 5.0);
+    for (int i = 0; i < kNumCameras; ++i) {
+      const Eigen::Vector3d center(0.5 * i, 0.2 * i * i, 0.0);
+      Eigen::Map<Eigen::Vector3d>(camera_centers + 3 * i) = center;
+      const Eigen::Vector3d ray = point - center;
+      observations[2 * i] = ray.x() / ray.z() + 1e-3 * (i % 2);
+      observations[2 * i + 1] = ray.y() / ray.z() - 1e-3 * (i % 3);
+    }
+  }
+
+  int NumResiduals() const { return 2 * num_cameras; }
+
+  template <typename T>
+  bool operator()(const T* point, T* residuals) const {
+    for (int i = 0; i < num_cameras; ++i) {
+      const T x = point[0] - camera_centers[3 * i];
+      const T y = point[1] - camera_centers[3 * i + 1];
+      const T z = point[2] - camera_centers[3 * i + 2];
+      residuals[2 * i] = x / z - observations[2 * i];
+      residuals[2 * i + 1] = y / z - observations[2 * i + 1];
+    }
+    return true;
+  }
+
+  int num_cameras = kNumCameras;
+  double camera_centers[3 * kNumCameras];
+  double observations[2 * kNumCameras];
+};
+
+template <typename Function>
+static void BM_TinySolver(benchmark::State& state) {
+  Triangulation triangulation;
+  Function function(triangulation);
+  TinySolver<Function> solver;
+  const Eigen::Vector3d initial_point(0.5, 0.0, 6.0);
+  typename TinySolver<Function>::Parameters point(3);
+  for (auto _ : state) {
+    point = initial_point;
+    solver.Solve(function, &point);
+  }
+}
+
+// Alternately solves problems with kNumCameras - 1 and kNumCameras
+// cameras, e.g., tracks with different numbers of observations.
+template <typename Function>
+static void BM_TinySolverVaryingSize(benchmark::State& state) {
+  Triangulation triangulations[2];
+  triangulations[0].num_cameras = kNumCameras - 1;
+  Function functions[2] = {Function(triangulations[0]),
+                           Function(triangulations[1])};
+  TinySolver<Function> solver;
+  const Eigen::Vector3d initial_point(0.5, 0.0, 6.0);
+  typename TinySolver<Function>::Parameters point(3);
+  int i = 0;
+  for (auto _ : state) {
+    point = initial_point;
+    solver.Solve(functions[i], &point);
+    i = 1 - i;
+  }
+}
+
+typedef TinySolverAutoDiffFunction<Triangulation, 2 * kNumCameras, 3>
+    StaticFunction;
+typedef TinySolverAutoDiffFunction<Triangulation, Eigen::Dynamic, 3>
+    DynamicFunction;
+typedef TinySolverAutoDiffFunction<Triangulation,
+                                   Eigen::Dynamic,
+                                   3,
+                                   double,
+                                   2 * kNumCameras>
+    BoundedDynamicFunction;
+
+BENCHMARK_TEMPLATE(BM_TinySolver, StaticFunction);
+BENCHMARK_TEMPLATE(BM_TinySolver, DynamicFunction);
+BENCHMARK_TEMPLATE(BM_TinySolver, BoundedDynamicFunction);
+BENCHMARK_TEMPLATE(BM_TinySolverVaryingSize, DynamicFunction);
+BENCHMARK_TEMPLATE(BM_TinySolverVaryingSize, BoundedDynamicFunction);
+
+}  // namespace ceres
+
+BENCHMARK_MAIN();
@@ -65,10 +65,16 @@ class CostFunction2x3 : public SizedCostFunction<2, 3> {
   }
 };
 
-template <int kNumResiduals, int kNumParameters>
+template <int kNumResiduals,
+          int kNumParameters,
+          int kMaxNumResiduals = kNumResiduals,
+          int kMaxNumParameters = kNumParameters>
 void TestHelper() {
   std::unique_ptr<CostFunction> cost_function(new CostFunction2x3);
-  typedef TinySolverCostFunctionAdapter<kNumResiduals, kNumParameters>
+  typedef TinySolverCostFunctionAdapter<kNumResiduals,
+                                        kNumParameters,
+                                        kMaxNumResiduals,
+                                        kMaxNumParameters>
       CostFunctionAdapter;
   CostFunctionAdapter cfa(*cost_function);
   EXPECT_EQ(CostFunctionAdapter::NUM_RESIDUALS, kNumResiduals);
@@ -130,4 +136,9 @@ TEST(TinySolverCostFunctionAdapter, DynamicResidualsDynamicParameterBlock) {
   TestHelper<Eigen::Dynamic, Eigen::Dynamic>();
 }
 
+TEST(TinySolverCostFunctionAdapter,
+     BoundedDynamicResidualsBoundedDynamicParameterBlock) {
+  TestHelper<Eigen::Dynamic, Eigen::Dynamic, 4, 3>();
+}
+
 }  // namespace ceres
@@ -29,6 +29,15 @@
 //
 // Author: mierle@gmail.com (Keir Mierle)
 
+// Count failed Eigen assertions instead of relying on assert(), which is
+// compiled out in release builds. Together with EIGEN_RUNTIME_NO_MALLOC this
+// lets the tests below check that TinySolver::Solve does not allocate.
+namespace {
+int num_eigen_assertion_failures = 0;
+}  // namespace
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) ((x) ? (void)0 : (void)++num_eigen_assertion_failures)
+
 #include "ceres/tiny_solver.h"
 
 #include <algorithm>
@@ -111,6 +120,41 @@ class ExampleAllDynamic {
   }
 };
 
+// Fits a line y = a * x + b to num_points points on the line y = 2 x + 1.
+class LineFitWithMaxSizes {
+ public:
+  typedef double Scalar;
+  enum {
+    NUM_RESIDUALS = Eigen::Dynamic,
+    NUM_PARAMETERS = Eigen::Dynamic,
+    MAX_NUM_RESIDUALS = 10,
+    MAX_NUM_PARAMETERS = 2,
+  };
+
+  explicit LineFitWithMaxSizes(int num_points) : num_points_(num_points) {}
+
+  int NumResiduals() const { return num_points_; }
+
+  int NumParameters() const { return 2; }
+
+  bool operator()(const double* parameters,
+                  double* residuals,
+                  double* jacobian) const {
+    for (int i = 0; i < num_points_; ++i) {
+      const double x = i;
+      residuals[i] = parameters[0] * x + parameters[1] - (2.0 * x + 1.0);
+      if (jacobian) {
+        jacobian[i] = x;
+        jacobian[num_points_ + i] = 1.0;
+      }
+    }
+    return true;
+  }
+
+ private:
+  int num_points_;
+};
+
 template <typename Function, typename Vector>
 void TestHelper(const Function& f, const Vector& x0) {
   Vector x = x0;
@@ -161,4 +205,62 @@ TEST(TinySolver, ParametersAndResidualsDynamic) {
   TestHelper(f, x0);
 }
 
+// A test case for when the number of parameters and residuals is
+// dynamically sized but bounded, and changes between solves.
+TEST(TinySolver, ParametersAndResidualsDynamicWithMaxSizes) {
+  typedef TinySolver<LineFitWithMaxSizes> Solver;
+  static_assert(Solver::MAX_NUM_RESIDUALS == 10, "");
+  static_assert(Solver::MAX_NUM_PARAMETERS == 2, "");
+  static_assert(Solver::Parameters::MaxRowsAtCompileTime == 2, "");
+
+  Solver solver;
+  for (int num_points = 3; num_points <= 10; ++num_points) {
+    LineFitWithMaxSizes f(num_points);
+    Solver::Parameters x(2);
+    x << 0.0, 0.0;
+    solver.Solve(f, &x);
+    EXPECT_NEAR(0.0, solver.summary.final_cost, 1e-10);
+    EXPECT_NEAR(2.0, x[0], 1e-6);
+    EXPECT_NEAR(1.0, x[1], 1e-6);
+  }
+}
+
+// Solves a problem with Eigen's heap allocation check enabled and returns
+// the number of allocations it caught.
+template <typename Solver, typename Function>
+int NumAllocationsInSolve(Solver* solver,
+                          const Function& f,
+                          typename Solver::Parameters* x) {
+  num_eigen_assertion_failures = 0;
+  Eigen::internal::set_is_malloc_allowed(false);
+  solver->Solve(f, x);
+  Eigen::internal::set_is_malloc_allowed(true);
+  return num_eigen_assertion_failures;
+}
+
+// Bounded dynamic sizes keep all of the solver's storage inline, so solving
+// problems of varying size does not allocate.
+TEST(TinySolver, DynamicWithMaxSizesDoesNotAllocate) {
+  typedef TinySolver<LineFitWithMaxSizes> Solver;
+  Solver solver;
+  for (int num_points = 3; num_points <= 10; ++num_points) {
+    LineFitWithMaxSizes f(num_points);
+    Solver::Parameters x(2);
+    x << 0.0, 0.0;
+    EXPECT_EQ(0, NumAllocationsInSolve(&solver, f, &x));
+    EXPECT_NEAR(0.0, solver.summary.final_cost, 1e-10);
+  }
+}
+
+// Unbounded dynamic sizes allocate on the first solve. This checks that the
+// allocation check above is not vacuous.
+TEST(TinySolver, DynamicWithoutMaxSizesAllocates) {
+  typedef TinySolver<ExampleAllDynamic> Solver;
+  Solver solver;
+  ExampleAllDynamic f;
+  Solver::Parameters x(3);
+  x << 0.76026643, -30.01799744, 0.55192142;
+  EXPECT_GT(NumAllocationsInSolve(&solver, f, &x), 0);
+}
+
 }  // namespace ceres
@@ -0,0 +1,437 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "ceres/stringprintf.h"
+#include "glog/logging.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+namespace ceres {
+namespace internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+int64_t NowInNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::atomic<uint64_t> next_tracer_id(1);
+
+// The buffer last used by the thread and the id of its tracer.
+struct CachedThreadBuffer {
+  uint64_t tracer_id = 0;
+  void* buffer = nullptr;
+};
+
+thread_local CachedThreadBuffer cached_thread_buffer;
+
+// A group of hardware performance counters measuring the thread that
+// opened them.
+class PerfCounterGroup {
+ public:
+  PerfCounterGroup() { std::fill(fds_, fds_ + kNumHardwareCounters, -1); }
+  PerfCounterGroup(const PerfCounterGroup&) = delete;
+  void operator=(const PerfCounterGroup&) = delete;
+  ~PerfCounterGroup() { Close(); }
+
+  // Open the counters for the calling thread. Returns false if the
+  // counters are not available, in which case Read must not be
+  // called.
+  bool Open() {
+#if defined(__linux__)
+    const uint64_t configs[kNumHardwareCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < kNumHardwareCounters; ++i) {
+      struct perf_event_attr attr;
+      std::fill(reinterpret_cast<char*>(&attr),
+                reinterpret_cast<char*>(&attr) + sizeof(attr),
+                0);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.disabled = (i == 0) ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = static_cast<int>(syscall(__NR_perf_event_open,
+                                         &attr,
+                                         0,
+                                         -1,
+                                         (i == 0) ? -1 : fds_[0],
+                                         0));
+      if (fds_[i] < 0) {
+        VLOG(2) << "perf_event_open failed. Hardware counters are not "
+                << "available.";
+        Close();
+        return false;
+      }
+    }
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif  // defined(__linux__)
+  }
+
+  void Read(int64_t* values) const {
+#if defined(__linux__)
+    uint64_t data[kNumHardwareCounters + 1];
+    if (read(fds_[0], data, sizeof(data)) != sizeof(data)) {
+      std::fill(values, values + kNumHardwareCounters, 0);
+      return;
+    }
+    for (int i = 0; i < kNumHardwareCounters; ++i) {
+      values[i] = static_cast<int64_t>(data[i + 1]);
+    }
+#endif  // defined(__linux__)
+  }
+
+ private:
+  void Close() {
+#if defined(__linux__)
+    for (int i = kNumHardwareCounters - 1; i >= 0; --i) {
+      if (fds_[i] >= 0) {
+        close(fds_[i]);
+        fds_[i] = -1;
+      }
+    }
+#endif  // defined(__linux__)
+  }
+
+  int fds_[kNumHardwareCounters];
+};
+
+// Aggregate statistics for all events with the same name and the
+// same ancestors in an iteration.
+struct TableNode {
+  explicit TableNode(const char* name) : name(name) {
+    std::fill(counters, counters + kNumHardwareCounters, 0);
+  }
+
+  const char* name;
+  int depth = -1;
+  int calls = 0;
+  int64_t time_ns = 0;
+  int64_t counters[kNumHardwareCounters];
+  vector<int> children;
+  std::map<string, int> child_index;
+};
+
+int AddChild(int parent, const char* name, vector<TableNode>* nodes) {
+  auto it = (*nodes)[parent].child_index.find(name);
+  if (it != (*nodes)[parent].child_index.end()) {
+    return it->second;
+  }
+  const int child = nodes->size();
+  nodes->emplace_back(name);
+  (*nodes)[child].depth = (*nodes)[parent].depth + 1;
+  (*nodes)[parent].child_index[name] = child;
+  (*nodes)[parent].children.push_back(child);
+  return child;
+}
+
+void AppendTableRows(const vector<TableNode>& nodes,
+                     const int node,
+                     const int name_width,
+                     const bool with_counters,
+                     string* output) {
+  for (int child : nodes[node].children) {
+    const TableNode& row = nodes[child];
+    const string name = string(2 * row.depth, ' ') + row.name;
+    StringAppendF(output,
+                  "  %-*s %8d %12.6f",
+                  name_width,
+                  name.c_str(),
+                  row.calls,
+                  row.time_ns * 1e-9);
+    if (with_counters) {
+      for (int i = 0; i < kNumHardwareCounters; ++i) {
+        StringAppendF(output, " %14lld", static_cast<long long>(row.counters[i]));
+      }
+    }
+    output->append("\n");
+    AppendTableRows(nodes, child, name_width, with_counters, output);
+  }
+}
+
+}  // namespace
+
+const char* HardwareCounterToString(HardwareCounter counter) {
+  switch (counter) {
+    case kCycles:
+      return "cycles";
+    case kInstructions:
+      return "instructions";
+    case kCacheMisses:
+      return "cache_misses";
+    case kBranchMisses:
+      return "branch_misses";
+    default:
+      return "unknown";
+  }
+}
+
+struct Tracer::ThreadBuffer {
+  int thread_id = 0;
+  int depth = 0;
+  bool sample_counters = false;
+  PerfCounterGroup counters;
+  vector<TraceEvent> events;
+};
+
+Tracer::Tracer(bool collect_hardware_counters)
+    : collect_hardware_counters_(collect_hardware_counters),
+      id_(next_tracer_id.fetch_add(1)),
+      start_ns_(NowInNanoseconds()),
+      iteration_(0) {}
+
+Tracer::~Tracer() {}
+
+void Tracer::SetIteration(int iteration) {
+  iteration_.store(iteration, std::memory_order_relaxed);
+}
+
+Tracer::ThreadBuffer* Tracer::GetThreadBuffer() {
+  if (cached_thread_buffer.tracer_id == id_) {
+    return static_cast<ThreadBuffer*>(cached_thread_buffer.buffer);
+  }
+
+  // The cache only holds one buffer, so a thread that records events
+  // with more than one tracer, e.g., a thread pool shared by two
+  // calls to Solve, can come back to a buffer it already has.
+  const std::thread::id thread = std::this_thread::get_id();
+  ThreadBuffer* buffer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buffer_of_thread_.find(thread);
+    if (it != buffer_of_thread_.end()) {
+      buffer = it->second;
+    }
+  }
+
+  if (buffer == nullptr) {
+    std::unique_ptr<ThreadBuffer> new_buffer(new ThreadBuffer);
+    // The counters measure the thread that opens them, so they have
+    // to be opened by the thread itself.
+    new_buffer->sample_counters =
+        collect_hardware_counters_ && new_buffer->counters.Open();
+    buffer = new_buffer.get();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer->thread_id = thread_buffers_.size();
+    thread_buffers_.push_back(std::move(new_buffer));
+    buffer_of_thread_[thread] = buffer;
+  }
+
+  cached_thread_buffer.tracer_id = id_;
+  cached_thread_buffer.buffer = buffer;
+  return buffer;
+}
+
+int Tracer::Begin(ThreadBuffer* buffer, const char* name) {
+  buffer->events.emplace_back();
+  TraceEvent& event = buffer->events.back();
+  event.name = name;
+  event.thread_id = buffer->thread_id;
+  event.depth = buffer->depth++;
+  event.iteration = iteration_.load(std::memory_order_relaxed);
+  event.end_ns = 0;
+  if (buffer->sample_counters) {
+    buffer->counters.Read(event.counters);
+  } else {
+    std::fill(event.counters, event.counters + kNumHardwareCounters, -1);
+  }
+  event.start_ns = NowInNanoseconds() - start_ns_;
+  return buffer->events.size() - 1;
+}
+
+void Tracer::End(ThreadBuffer* buffer, int event_index) {
+  const int64_t end_ns = NowInNanoseconds() - start_ns_;
+  TraceEvent& event = buffer->events[event_index];
+  event.end_ns = end_ns;
+  if (buffer->sample_counters) {
+    int64_t counters[kNumHardwareCounters];
+    buffer->counters.Read(counters);
+    for (int i = 0; i < kNumHardwareCounters; ++i) {
+      event.counters[i] = counters[i] - event.counters[i];
+    }
+  }
+  --buffer->depth;
+}
+
+vector<TraceEvent> Tracer::Events() const {
+  vector<TraceEvent> events;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : thread_buffers_) {
+    events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+  }
+  std::stable_sort(events.begin(),
+                   events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) {
+                     return a.start_ns < b.start_ns ||
+                            (a.start_ns == b.start_ns && a.depth < b.depth);
+                   });
+  return events;
+}
+
+bool Tracer::hardware_counters_sampled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : thread_buffers_) {
+    if (buffer->sample_counters) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Tracer::WriteChromeTrace(const string& filename) const {
+  const vector<TraceEvent> events = Events();
+  string output = "{\"traceEvents\":[\n";
+  for (int i = 0; i < events.size(); ++i) {
+    const TraceEvent& event = events[i];
+    StringAppendF(&output,
+                  "{\"name\":\"%s\",\"cat\":\"ceres\",\"ph\":\"X\","
+                  "\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                  "\"args\":{\"iteration\":%d,\"depth\":%d",
+                  event.name,
+                  event.thread_id,
+                  event.start_ns * 1e-3,
+                  (event.end_ns - event.start_ns) * 1e-3,
+                  event.iteration,
+                  event.depth);
+    if (event.counters[0] >= 0) {
+      for (int j = 0; j < kNumHardwareCounters; ++j) {
+        StringAppendF(&output,
+                      ",\"%s\":%lld",
+                      HardwareCounterToString(static_cast<HardwareCounter>(j)),
+                      static_cast<long long>(event.counters[j]));
+      }
+    }
+    output += (i + 1 < events.size()) ? "}},\n" : "}}\n";
+  }
+  output += "],\"displayTimeUnit\":\"ms\"}\n";
+
+  FILE* file = fopen(filename.c_str(), "w");
+  if (file == nullptr) {
+    LOG(ERROR) << "Unable to open " << filename << " for writing.";
+    return false;
+  }
+  const bool ok =
+      fwrite(output.data(), 1, output.size(), file) == output.size();
+  return (fclose(file) == 0) && ok;
+}
+
+string Tracer::IterationTable() const {
+  const vector<TraceEvent> events = Events();
+  const bool with_counters = hardware_counters_sampled();
+
+  // One tree of TableNodes per iteration, rooted at a node with an
+  // empty name. Nodes are identified by their index in nodes.
+  vector<TableNode> nodes;
+  std::map<int, int> iteration_roots;
+  // For each thread, the node of the last event seen at each depth.
+  std::map<int, vector<std::pair<int, int>>> open_nodes;
+
+  for (const TraceEvent& event : events) {
+    auto root = iteration_roots.find(event.iteration);
+    if (root == iteration_roots.end()) {
+      nodes.emplace_back("");
+      root = iteration_roots.emplace(event.iteration, nodes.size() - 1).first;
+    }
+
+    vector<std::pair<int, int>>& stack = open_nodes[event.thread_id];
+    stack.resize(event.depth + 1, std::make_pair(-1, -1));
+    int parent = root->second;
+    if (event.depth > 0 && stack[event.depth - 1].first == event.iteration) {
+      parent = stack[event.depth - 1].second;
+    }
+
+    const int node = AddChild(parent, event.name, &nodes);
+    stack[event.depth] = std::make_pair(event.iteration, node);
+    TableNode& row = nodes[node];
+    ++row.calls;
+    row.time_ns += event.end_ns - event.start_ns;
+    for (int i = 0; i < kNumHardwareCounters; ++i) {
+      row.counters[i] += std::max<int64_t>(event.counters[i], 0);
+    }
+  }
+
+  int name_width = 5;
+  for (const TableNode& node : nodes) {
+    name_width = std::max<int>(name_width, 2 * node.depth + strlen(node.name));
+  }
+
+  string output;
+  for (const auto& iteration_root : iteration_roots) {
+    StringAppendF(&output,
+                  "Iteration %d\n  %-*s %8s %12s",
+                  iteration_root.first,
+                  name_width,
+                  "Event",
+                  "Calls",
+                  "Time (s)");
+    if (with_counters) {
+      for (int i = 0; i < kNumHardwareCounters; ++i) {
+        StringAppendF(&output,
+                      " %14s",
+                      HardwareCounterToString(static_cast<HardwareCounter>(i)));
+      }
+    }
+    output += "\n";
+    AppendTableRows(
+        nodes, iteration_root.second, name_width, with_counters, &output);
+  }
+  return output;
+}
+
+}  // namespace internal
+}  // namespace ceres
@@ -0,0 +1,187 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+//
+// A low overhead, hierarchical tracing facility for the solver.
+//
+// The solver is instrumented with ScopedTrace objects, each of which
+// records a named, timed event for the scope it lives in, e.g.,
+//
+//  LinearSolver::Summary SchurComplementSolver::SolveImpl(...) {
+//    ScopedTrace trace(options_.tracer, "SchurEliminator::Eliminate");
+//    ...
+//  }
+//
+// A Tracer belongs to a single call to Solve, which hands it to the
+// evaluator, the linear solver and the minimizer through their
+// options, so concurrent calls to Solve do not see each other's
+// events. A ScopedTrace with a null tracer does nothing, which costs
+// a branch.
+//
+// Each thread appends the events it records to its own buffer, so
+// recording an event does not need any locking. Events record the
+// thread they were recorded on, their nesting depth on that thread
+// and the minimizer iteration they belong to. Optionally, the tracer
+// also samples the hardware performance counters of the thread at
+// the beginning and the end of each event using perf_event_open. This
+// is only supported on Linux and requires permission to use the
+// performance counters, see /proc/sys/kernel/perf_event_paranoid.
+//
+// The recorded events can be written out in the Chrome trace event
+// format, which can be viewed using chrome://tracing or Perfetto, or
+// summarized as a table of calls, time and counters per event name
+// and minimizer iteration.
+
+#ifndef CERES_INTERNAL_TRACE_H_
+#define CERES_INTERNAL_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ceres/internal/port.h"
+
+namespace ceres {
+namespace internal {
+
+// The hardware counters sampled by the tracer, in the order in which
+// they are stored in TraceEvent::counters.
+enum HardwareCounter {
+  kCycles = 0,
+  kInstructions,
+  kCacheMisses,
+  kBranchMisses,
+  kNumHardwareCounters
+};
+
+const char* HardwareCounterToString(HardwareCounter counter);
+
+struct TraceEvent {
+  // The name of the event. It must have static storage duration.
+  const char* name;
+  // Index of the thread the event was recorded on, in the order in
+  // which threads recorded their first event.
+  int thread_id;
+  // Number of events enclosing this event on the same thread.
+  int depth;
+  // The minimizer iteration during which the event started.
+  int iteration;
+  // Start and end of the event in nanoseconds since the tracer was
+  // constructed.
+  int64_t start_ns;
+  int64_t end_ns;
+  // Change in the hardware counters of the thread over the event, or
+  // -1 if the counters were not sampled.
+  int64_t counters[kNumHardwareCounters];
+};
+
+class CERES_EXPORT_INTERNAL Tracer {
+ public:
+  // Event times are measured from the construction of the tracer.
+  // The tracer must outlive all the ScopedTrace objects using it.
+  explicit Tracer(bool collect_hardware_counters);
+  Tracer(const Tracer&) = delete;
+  void operator=(const Tracer&) = delete;
+  ~Tracer();
+
+  // The iteration recorded for events that start after this call.
+  void SetIteration(int iteration);
+
+  // All the recorded events, sorted by start time.
+  std::vector<TraceEvent> Events() const;
+
+  // Write the recorded events in the Chrome trace event format to
+  // filename. Returns false if the file could not be written.
+  bool WriteChromeTrace(const std::string& filename) const;
+
+  // For each minimizer iteration, the number of calls, the total time
+  // and the total change in the hardware counters of each event,
+  // summed over all threads. Events are indented by their nesting
+  // depth.
+  std::string IterationTable() const;
+
+  // True if the hardware counters were sampled for at least one
+  // thread.
+  bool hardware_counters_sampled() const;
+
+ private:
+  friend class ScopedTrace;
+  struct ThreadBuffer;
+
+  // Returns the buffer of the calling thread, creating it if needed.
+  ThreadBuffer* GetThreadBuffer();
+  int Begin(ThreadBuffer* buffer, const char* name);
+  void End(ThreadBuffer* buffer, int event);
+
+  const bool collect_hardware_counters_;
+  // Unique among all tracers, so that threads can tell whether the
+  // buffer they cached belongs to this tracer.
+  const uint64_t id_;
+  const int64_t start_ns_;
+  std::atomic<int> iteration_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers_;
+  std::map<std::thread::id, ThreadBuffer*> buffer_of_thread_;
+};
+
+// Records an event spanning the lifetime of the object with tracer,
+// unless it is nullptr. name must have static storage duration.
+class CERES_EXPORT_INTERNAL ScopedTrace {
+ public:
+  ScopedTrace(Tracer* tracer, const char* name) : tracer_(tracer) {
+    if (tracer_ != nullptr) {
+      buffer_ = tracer_->GetThreadBuffer();
+      event_ = tracer_->Begin(buffer_, name);
+    }
+  }
+
+  ~ScopedTrace() {
+    if (tracer_ != nullptr) {
+      tracer_->End(buffer_, event_);
+    }
+  }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  void operator=(const ScopedTrace&) = delete;
+
+ private:
+  Tracer* tracer_;
+  Tracer::ThreadBuffer* buffer_ = nullptr;
+  int event_ = -1;
+};
+
+}  // namespace internal
+}  // namespace ceres
+
+#endif  // CERES_INTERNAL_TRACE_H_
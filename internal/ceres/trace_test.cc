@@ -0,0 +1,216 @@
+// Ceres Solver - A fast non-linear least squares minimizer
+// Copyright 2026 Google Inc. All rights reserved.
+// http://ceres-solver.org/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors may be
+//   used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Author: agent@local (agent)
+
+#include "ceres/trace.h"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ceres/context_impl.h"
+#include "ceres/file.h"
+#include "ceres/parallel_for.h"
+#include "gtest/gtest.h"
+
+namespace ceres {
+namespace internal {
+
+using std::string;
+using std::vector;
+
+TEST(Trace, NullTracerRecordsNothing) {
+  ScopedTrace outer(nullptr, "Ignored");
+  { ScopedTrace inner(nullptr, "Ignored"); }
+}
+
+TEST(Trace, TracersOnlyRecordTheirOwnEvents) {
+  Tracer tracer(false);
+  Tracer other_tracer(false);
+  {
+    ScopedTrace outer(&tracer, "Outer");
+    { ScopedTrace other(&other_tracer, "Other"); }
+    { ScopedTrace inner(&tracer, "Inner"); }
+    { ScopedTrace other(&other_tracer, "Other"); }
+  }
+
+  const vector<TraceEvent> events = tracer.Events();
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_STREQ(events[0].name, "Outer");
+  EXPECT_STREQ(events[1].name, "Inner");
+  EXPECT_EQ(events[1].depth, 1);
+
+  // Switching between the tracers does not give the thread a new
+  // buffer in either of them.
+  const vector<TraceEvent> other_events = other_tracer.Events();
+  ASSERT_EQ(other_events.size(), 2);
+  for (const TraceEvent& event : other_events) {
+    EXPECT_STREQ(event.name, "Other");
+    EXPECT_EQ(event.depth, 0);
+    EXPECT_EQ(event.thread_id, 0);
+  }
+}
+
+TEST(Trace, ConcurrentTracers) {
+  const int kNumEvents = 1000;
+  Tracer tracer(false);
+  Tracer other_tracer(false);
+  std::thread other_thread([&other_tracer]() {
+    for (int i = 0; i < kNumEvents; ++i) {
+      ScopedTrace trace(&other_tracer, "Other");
+    }
+  });
+  for (int i = 0; i < kNumEvents; ++i) {
+    ScopedTrace trace(&tracer, "Event");
+  }
+  other_thread.join();
+
+  const vector<TraceEvent> events = tracer.Events();
+  ASSERT_EQ(events.size(), kNumEvents);
+  for (const TraceEvent& event : events) {
+    EXPECT_STREQ(event.name, "Event");
+  }
+  EXPECT_EQ(other_tracer.Events().size(), kNumEvents);
+}
+
+TEST(Trace, NestedEventsAndIterations) {
+  Tracer tracer(false);
+  {
+    ScopedTrace outer(&tracer, "Outer");
+    { ScopedTrace inner(&tracer, "Inner"); }
+    { ScopedTrace inner(&tracer, "Inner"); }
+  }
+  tracer.SetIteration(1);
+  { ScopedTrace outer(&tracer, "Outer"); }
+
+  const vector<TraceEvent> events = tracer.Events();
+  ASSERT_EQ(events.size(), 4);
+  EXPECT_STREQ(events[0].name, "Outer");
+  EXPECT_EQ(events[0].depth, 0);
+  EXPECT_EQ(events[0].iteration, 0);
+  for (int i = 1; i < 3; ++i) {
+    EXPECT_STREQ(events[i].name, "Inner");
+    EXPECT_EQ(events[i].depth, 1);
+    EXPECT_EQ(events[i].iteration, 0);
+    EXPECT_GE(events[i].start_ns, events[0].start_ns);
+    EXPECT_LE(events[i].end_ns, events[0].end_ns);
+    EXPECT_LE(events[i].start_ns, events[i].end_ns);
+  }
+  EXPECT_STREQ(events[3].name, "Outer");
+  EXPECT_EQ(events[3].depth, 0);
+  EXPECT_EQ(events[3].iteration, 1);
+  EXPECT_GE(events[3].start_ns, events[0].end_ns);
+
+  if (!tracer.hardware_counters_sampled()) {
+    for (const TraceEvent& event : events) {
+      for (int i = 0; i < kNumHardwareCounters; ++i) {
+        EXPECT_EQ(event.counters[i], -1);
+      }
+    }
+  }
+
+  const string table = tracer.IterationTable();
+  EXPECT_NE(table.find("Iteration 0"), string::npos);
+  EXPECT_NE(table.find("Iteration 1"), string::npos);
+  EXPECT_NE(table.find("\n  Outer "), string::npos);
+  EXPECT_NE(table.find("\n    Inner "), string::npos);
+}
+
+TEST(Trace, EventsFromMultipleThreads) {
+  ContextImpl context;
+  const int kNumThreads = 4;
+  const int kNumTasks = 64;
+  context.EnsureMinimumThreads(kNumThreads);
+
+  Tracer tracer(false);
+  {
+    ScopedTrace trace(&tracer, "ParallelFor");
+    ParallelFor(&context, 0, kNumTasks, kNumThreads, [&tracer](int i) {
+      ScopedTrace trace(&tracer, "Task");
+    });
+  }
+
+  const vector<TraceEvent> events = tracer.Events();
+  ASSERT_EQ(events.size(), kNumTasks + 1);
+  EXPECT_STREQ(events[0].name, "ParallelFor");
+  std::set<int> thread_ids;
+  for (int i = 1; i < events.size(); ++i) {
+    EXPECT_STREQ(events[i].name, "Task");
+    thread_ids.insert(events[i].thread_id);
+    // Tasks run on the calling thread are nested in the ParallelFor
+    // event, the others are not.
+    EXPECT_EQ(events[i].depth, events[i].thread_id == events[0].thread_id);
+  }
+  EXPECT_GE(thread_ids.size(), 1);
+  EXPECT_LE(thread_ids.size(), kNumThreads);
+}
+
+TEST(Trace, WriteChromeTrace) {
+  Tracer tracer(false);
+  {
+    ScopedTrace outer(&tracer, "Outer");
+    ScopedTrace inner(&tracer, "Inner");
+  }
+
+  const string filename = testing::TempDir() + "/ceres_trace_test.json";
+  ASSERT_TRUE(tracer.WriteChromeTrace(filename));
+  string contents;
+  ReadFileToStringOrDie(filename, &contents);
+  EXPECT_EQ(contents.find("{\"traceEvents\":["), 0);
+  EXPECT_NE(contents.find("\"name\":\"Outer\""), string::npos);
+  EXPECT_NE(contents.find("\"name\":\"Inner\""), string::npos);
+  EXPECT_NE(contents.find("\"ph\":\"X\""), string::npos);
+  EXPECT_NE(contents.find("\"depth\":1"), string::npos);
+}
+
+TEST(Trace, HardwareCounters) {
+  Tracer tracer(true);
+  {
+    ScopedTrace trace(&tracer, "Loop");
+    volatile double sum = 0.0;
+    for (int i = 0; i < 100000; ++i) {
+      sum += i;
+    }
+  }
+
+  const vector<TraceEvent> events = tracer.Events();
+  ASSERT_EQ(events.size(), 1);
+  if (!tracer.hardware_counters_sampled()) {
+    LOG(WARNING) << "Hardware counters are not available.";
+    EXPECT_EQ(events[0].counters[kInstructions], -1);
+    return;
+  }
+  EXPECT_GT(events[0].counters[kInstructions], 100000);
+  EXPECT_GT(events[0].counters[kCycles], 0);
+  EXPECT_NE(tracer.IterationTable().find("instructions"), string::npos);
+}
+
+}  // namespace internal
+}  // namespace ceres
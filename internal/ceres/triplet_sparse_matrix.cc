@@ -32,9 +32,13 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
 
 #include "ceres/internal/eigen.h"
 #include "ceres/internal/port.h"
+#include "ceres/memory_mapped_buffer.h"
 #include "ceres/random.h"
 #include "ceres/types.h"
 #include "glog/logging.h"
@@ -43,22 +47,50 @@ namespace ceres {
 namespace internal {
 
 TripletSparseMatrix::TripletSparseMatrix()
-    : num_rows_(0), num_cols_(0), max_num_nonzeros_(0), num_nonzeros_(0) {}
+    : num_rows_(0),
+      num_cols_(0),
+      max_num_nonzeros_(0),
+      num_nonzeros_(0),
+      values_(nullptr) {}
 
 TripletSparseMatrix::~TripletSparseMatrix() {}
 
 TripletSparseMatrix::TripletSparseMatrix(int num_rows,
                                          int num_cols,
                                          int max_num_nonzeros)
+    : TripletSparseMatrix(num_rows, num_cols, max_num_nonzeros, "") {
+  std::string error;
+  CHECK(AllocateMemory(&error)) << error;
+}
+
+std::unique_ptr<TripletSparseMatrix> TripletSparseMatrix::Create(
+    int num_rows,
+    int num_cols,
+    int max_num_nonzeros,
+    const std::string& storage_directory,
+    std::string* error) {
+  std::unique_ptr<TripletSparseMatrix> matrix(new TripletSparseMatrix(
+      num_rows, num_cols, max_num_nonzeros, storage_directory));
+  if (!matrix->AllocateMemory(error)) {
+    return nullptr;
+  }
+  return matrix;
+}
+
+TripletSparseMatrix::TripletSparseMatrix(int num_rows,
+                                         int num_cols,
+                                         int max_num_nonzeros,
+                                         const std::string& storage_directory)
     : num_rows_(num_rows),
       num_cols_(num_cols),
       max_num_nonzeros_(max_num_nonzeros),
-      num_nonzeros_(0) {
+      num_nonzeros_(0),
+      storage_directory_(storage_directory),
+      values_(nullptr) {
   // All the sizes should at least be zero
   CHECK_GE(num_rows, 0);
   CHECK_GE(num_cols, 0);
   CHECK_GE(max_num_nonzeros, 0);
-  AllocateMemory();
 }
 
 TripletSparseMatrix::TripletSparseMatrix(const int num_rows,
@@ -75,10 +107,11 @@ TripletSparseMatrix::TripletSparseMatrix(const int num_rows,
   CHECK_GE(num_cols, 0);
   CHECK_EQ(rows.size(), cols.size());
   CHECK_EQ(rows.size(), values.size());
-  AllocateMemory();
+  std::string error;
+  CHECK(AllocateMemory(&error)) << error;
   std::copy(rows.begin(), rows.end(), rows_.get());
   std::copy(cols.begin(), cols.end(), cols_.get());
-  std::copy(values.begin(), values.end(), values_.get());
+  std::copy(values.begin(), values.end(), values_);
 }
 
 TripletSparseMatrix::TripletSparseMatrix(const TripletSparseMatrix& orig)
@@ -87,7 +120,8 @@ TripletSparseMatrix::TripletSparseMatrix(const TripletSparseMatrix& orig)
       num_cols_(orig.num_cols_),
       max_num_nonzeros_(orig.max_num_nonzeros_),
       num_nonzeros_(orig.num_nonzeros_) {
-  AllocateMemory();
+  std::string error;
+  CHECK(AllocateMemory(&error)) << error;
   CopyData(orig);
 }
 
@@ -100,7 +134,9 @@ TripletSparseMatrix& TripletSparseMatrix::operator=(
   num_cols_ = rhs.num_cols_;
   num_nonzeros_ = rhs.num_nonzeros_;
   max_num_nonzeros_ = rhs.max_num_nonzeros_;
-  AllocateMemory();
+  storage_directory_.clear();
+  std::string error;
+  CHECK(AllocateMemory(&error)) << error;
   CopyData(rhs);
   return *this;
 }
@@ -116,17 +152,27 @@ bool TripletSparseMatrix::AllTripletsWithinBounds() const {
   return true;
 }
 
-void TripletSparseMatrix::Reserve(int new_max_num_nonzeros) {
+bool TripletSparseMatrix::Reserve(int new_max_num_nonzeros,
+                                  std::string* error) {
   CHECK_LE(num_nonzeros_, new_max_num_nonzeros)
       << "Reallocation will cause data loss";
 
   // Nothing to do if we have enough space already.
-  if (new_max_num_nonzeros <= max_num_nonzeros_) return;
+  if (new_max_num_nonzeros <= max_num_nonzeros_) return true;
+
+  std::unique_ptr<double[]> new_heap_values;
+  std::unique_ptr<MemoryMappedBuffer> new_mapped_values;
+  double* new_values = AllocateValues(storage_directory_,
+                                      new_max_num_nonzeros,
+                                      &new_heap_values,
+                                      &new_mapped_values,
+                                      error);
+  if (new_values == nullptr) {
+    return false;
+  }
 
   int* new_rows = new int[new_max_num_nonzeros];
   int* new_cols = new int[new_max_num_nonzeros];
-  double* new_values = new double[new_max_num_nonzeros];
-
   for (int i = 0; i < num_nonzeros_; ++i) {
     new_rows[i] = rows_[i];
     new_cols[i] = cols_[i];
@@ -135,13 +181,16 @@ void TripletSparseMatrix::Reserve(int new_max_num_nonzeros) {
 
   rows_.reset(new_rows);
   cols_.reset(new_cols);
-  values_.reset(new_values);
+  heap_values_ = std::move(new_heap_values);
+  mapped_values_ = std::move(new_mapped_values);
+  values_ = new_values;
 
   max_num_nonzeros_ = new_max_num_nonzeros;
+  return true;
 }
 
 void TripletSparseMatrix::SetZero() {
-  std::fill(values_.get(), values_.get() + max_num_nonzeros_, 0.0);
+  std::fill(values_, values_ + max_num_nonzeros_, 0.0);
   num_nonzeros_ = 0;
 }
 
@@ -151,10 +200,15 @@ void TripletSparseMatrix::set_num_nonzeros(int num_nonzeros) {
   num_nonzeros_ = num_nonzeros;
 }
 
-void TripletSparseMatrix::AllocateMemory() {
+bool TripletSparseMatrix::AllocateMemory(std::string* error) {
   rows_.reset(new int[max_num_nonzeros_]);
   cols_.reset(new int[max_num_nonzeros_]);
-  values_.reset(new double[max_num_nonzeros_]);
+  values_ = AllocateValues(storage_directory_,
+                           max_num_nonzeros_,
+                           &heap_values_,
+                           &mapped_values_,
+                           error);
+  return values_ != nullptr;
 }
 
 void TripletSparseMatrix::CopyData(const TripletSparseMatrix& orig) {
@@ -203,22 +257,24 @@ void TripletSparseMatrix::ToDenseMatrix(Matrix* dense_matrix) const {
 
 void TripletSparseMatrix::AppendRows(const TripletSparseMatrix& B) {
   CHECK_EQ(B.num_cols(), num_cols_);
-  Reserve(num_nonzeros_ + B.num_nonzeros_);
+  std::string error;
+  CHECK(Reserve(num_nonzeros_ + B.num_nonzeros_, &error)) << error;
   for (int i = 0; i < B.num_nonzeros_; ++i) {
     rows_.get()[num_nonzeros_] = B.rows()[i] + num_rows_;
     cols_.get()[num_nonzeros_] = B.cols()[i];
-    values_.get()[num_nonzeros_++] = B.values()[i];
+    values_[num_nonzeros_++] = B.values()[i];
   }
   num_rows_ = num_rows_ + B.num_rows();
 }
 
 void TripletSparseMatrix::AppendCols(const TripletSparseMatrix& B) {
   CHECK_EQ(B.num_rows(), num_rows_);
-  Reserve(num_nonzeros_ + B.num_nonzeros_);
+  std::string error;
+  CHECK(Reserve(num_nonzeros_ + B.num_nonzeros_, &error)) << error;
   for (int i = 0; i < B.num_nonzeros_; ++i, ++num_nonzeros_) {
     rows_.get()[num_nonzeros_] = B.rows()[i];
     cols_.get()[num_nonzeros_] = B.cols()[i] + num_cols_;
-    values_.get()[num_nonzeros_] = B.values()[i];
+    values_[num_nonzeros_] = B.values()[i];
   }
   num_cols_ = num_cols_ + B.num_cols();
 }
@@ -235,7 +291,7 @@ void TripletSparseMatrix::Resize(int new_num_rows, int new_num_cols) {
 
   int* r_ptr = rows_.get();
   int* c_ptr = cols_.get();
-  double* v_ptr = values_.get();
+  double* v_ptr = values_;
 
   int dropped_terms = 0;
   for (int i = 0; i < num_nonzeros_; ++i) {
@@ -32,10 +32,12 @@
 #define CERES_INTERNAL_TRIPLET_SPARSE_MATRIX_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "ceres/internal/eigen.h"
 #include "ceres/internal/port.h"
+#include "ceres/memory_mapped_buffer.h"
 #include "ceres/sparse_matrix.h"
 #include "ceres/types.h"
 
@@ -56,6 +58,21 @@ class CERES_EXPORT_INTERNAL TripletSparseMatrix : public SparseMatrix {
                       const std::vector<int>& cols,
                       const std::vector<double>& values);
 
+  // Same as TripletSparseMatrix(num_rows, num_cols, max_num_nonzeros),
+  // except that if storage_directory is not empty, the values array is
+  // stored in a memory mapped file in storage_directory instead of on
+  // the heap. The row and column indices are always stored on the heap.
+  // Returns nullptr and sets error if the file cannot be created.
+  //
+  // Growing such a matrix with Reserve creates a new file in the same
+  // directory. Copies of it are stored on the heap.
+  static std::unique_ptr<TripletSparseMatrix> Create(
+      int num_rows,
+      int num_cols,
+      int max_num_nonzeros,
+      const std::string& storage_directory,
+      std::string* error);
+
   explicit TripletSparseMatrix(const TripletSparseMatrix& orig);
 
   TripletSparseMatrix& operator=(const TripletSparseMatrix& rhs);
@@ -74,8 +91,8 @@ class CERES_EXPORT_INTERNAL TripletSparseMatrix : public SparseMatrix {
   int num_rows()        const final   { return num_rows_;     }
   int num_cols()        const final   { return num_cols_;     }
   int num_nonzeros()    const final   { return num_nonzeros_; }
-  const double* values()  const final { return values_.get(); }
-  double* mutable_values() final      { return values_.get(); }
+  const double* values()  const final { return values_;       }
+  double* mutable_values() final      { return values_;       }
   // clang-format on
   void set_num_nonzeros(int num_nonzeros);
 
@@ -84,14 +101,22 @@ class CERES_EXPORT_INTERNAL TripletSparseMatrix : public SparseMatrix {
   // than max_num_nonzeros_, then num_non_zeros should be less than or
   // equal to new_max_num_nonzeros, otherwise data loss is possible
   // and the method crashes.
-  void Reserve(int new_max_num_nonzeros);
+  //
+  // Returns false and sets error if the values are memory mapped and
+  // the new file cannot be created, in which case the matrix is
+  // unchanged.
+  bool Reserve(int new_max_num_nonzeros, std::string* error);
 
   // Append the matrix B at the bottom of this matrix. B should have
-  // the same number of columns as num_cols_.
+  // the same number of columns as num_cols_. Dies if more values need
+  // to be allocated and this fails, which callers can rule out by
+  // calling Reserve first.
   void AppendRows(const TripletSparseMatrix& B);
 
   // Append the matrix B at the right of this matrix. B should have
-  // the same number of rows as num_rows_;
+  // the same number of rows as num_rows_. Dies if more values need to
+  // be allocated and this fails, which callers can rule out by
+  // calling Reserve first.
   void AppendCols(const TripletSparseMatrix& B);
 
   // Resize the matrix. Entries which fall outside the new matrix
@@ -138,7 +163,15 @@ class CERES_EXPORT_INTERNAL TripletSparseMatrix : public SparseMatrix {
       const TripletSparseMatrix::RandomMatrixOptions& options);
 
  private:
-  void AllocateMemory();
+  // Set up the sizes of the matrix, without allocating any memory.
+  TripletSparseMatrix(int num_rows,
+                      int num_cols,
+                      int max_num_nonzeros,
+                      const std::string& storage_directory);
+
+  // Returns false and sets error if the values array cannot be
+  // allocated.
+  bool AllocateMemory(std::string* error);
   void CopyData(const TripletSparseMatrix& orig);
 
   int num_rows_;
@@ -152,7 +185,11 @@ class CERES_EXPORT_INTERNAL TripletSparseMatrix : public SparseMatrix {
   // entries corresponding to them are summed up.
   std::unique_ptr<int[]> rows_;
   std::unique_ptr<int[]> cols_;
-  std::unique_ptr<double[]> values_;
+  std::string storage_directory_;
+  // values_ is owned by exactly one of heap_values_ and mapped_values_.
+  std::unique_ptr<double[]> heap_values_;
+  std::unique_ptr<MemoryMappedBuffer> mapped_values_;
+  double* values_;
 };
 
 }  // namespace internal
@@ -31,9 +31,15 @@
 #include "ceres/triplet_sparse_matrix.h"
 
 #include <memory>
+#include <string>
 
 #include "gtest/gtest.h"
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
 namespace ceres {
 namespace internal {
 
@@ -67,13 +73,15 @@ TEST(TripletSparseMatrix, SimpleConstructorAndBasicOperations) {
   ASSERT_TRUE(m.AllTripletsWithinBounds());
 
   // We should never be able resize and lose data
-  EXPECT_DEATH_IF_SUPPORTED(m.Reserve(1), "Reallocation will cause data loss");
+  std::string error;
+  EXPECT_DEATH_IF_SUPPORTED(m.Reserve(1, &error),
+                            "Reallocation will cause data loss");
 
   // We should be able to resize while preserving data
-  m.Reserve(50);
+  EXPECT_TRUE(m.Reserve(50, &error));
   EXPECT_EQ(m.max_num_nonzeros(), 50);
 
-  m.Reserve(3);
+  EXPECT_TRUE(m.Reserve(3, &error));
   EXPECT_EQ(m.max_num_nonzeros(), 50);  // The space is already reserved.
 
   EXPECT_EQ(m.rows()[0], 0);
@@ -96,8 +104,42 @@ TEST(TripletSparseMatrix, SimpleConstructorAndBasicOperations) {
   // Remove all data and then resize the data store
   m.SetZero();
   EXPECT_EQ(m.num_nonzeros(), 0);
-  m.Reserve(1);
+  EXPECT_TRUE(m.Reserve(1, &error));
+}
+
+#ifndef _WIN32
+TEST(TripletSparseMatrix, MemoryMappedReserveFailureLeavesMatrixUnchanged) {
+  const std::string directory =
+      testing::TempDir() + "/ceres_triplet_sparse_matrix_test";
+  ASSERT_EQ(mkdir(directory.c_str(), 0700), 0);
+  std::string error;
+  std::unique_ptr<TripletSparseMatrix> m =
+      TripletSparseMatrix::Create(2, 5, 2, directory, &error);
+  ASSERT_TRUE(m != nullptr) << error;
+  m->mutable_rows()[0] = 0;
+  m->mutable_cols()[0] = 1;
+  m->mutable_values()[0] = 2.5;
+  m->set_num_nonzeros(1);
+
+  // The file backing the values is already unlinked, so the directory
+  // can be removed, after which no new file can be created in it.
+  ASSERT_EQ(rmdir(directory.c_str()), 0);
+  EXPECT_FALSE(m->Reserve(10, &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_EQ(m->max_num_nonzeros(), 2);
+  EXPECT_EQ(m->num_nonzeros(), 1);
+  EXPECT_EQ(m->rows()[0], 0);
+  EXPECT_EQ(m->cols()[0], 1);
+  EXPECT_EQ(m->values()[0], 2.5);
+
+  // Copies are stored on the heap, so they do not need the directory,
+  // and can be grown.
+  TripletSparseMatrix copy(*m);
+  EXPECT_EQ(copy.values()[0], 2.5);
+  EXPECT_TRUE(copy.Reserve(10, &error)) << error;
+  EXPECT_EQ(copy.values()[0], 2.5);
 }
+#endif  // _WIN32
 
 TEST(TripletSparseMatrix, CopyConstructor) {
   TripletSparseMatrix orig(2, 5, 4);
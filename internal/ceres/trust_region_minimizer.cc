@@ -46,6 +46,7 @@
 #include "ceres/file.h"
 #include "ceres/line_search.h"
 #include "ceres/stringprintf.h"
+#include "ceres/trace.h"
 #include "ceres/types.h"
 #include "ceres/wall_time.h"
 #include "glog/logging.h"
@@ -82,6 +83,7 @@ void TrustRegionMinimizer::Minimize(const Minimizer::Options& options,
           : 0));
 
   while (FinalizeIterationAndCheckIfMinimizerCanContinue()) {
+    ScopedTrace trace(options_.tracer, "TrustRegionMinimizer::Iteration");
     iteration_start_time_in_secs_ = WallTimeInSeconds();
 
     const double previous_gradient_norm = iteration_summary_.gradient_norm;
@@ -148,6 +150,7 @@ void TrustRegionMinimizer::Init(const Minimizer::Options& options,
   solver_summary_->termination_type = NO_CONVERGENCE;
   solver_summary_->num_successful_steps = 0;
   solver_summary_->num_unsuccessful_steps = 0;
+  solver_summary_->num_reused_linear_solves = 0;
   solver_summary_->is_constrained = options.is_constrained;
 
   CHECK(options_.evaluator != nullptr);
@@ -400,7 +403,8 @@ bool TrustRegionMinimizer::ComputeTrustRegionStep() {
   if (strategy_summary.termination_type == LINEAR_SOLVER_FATAL_ERROR) {
     solver_summary_->message =
         "Linear solver failed due to unrecoverable "
-        "non-numeric causes. Please see the error log for clues. ";
+        "non-numeric causes. Please see the error log for clues. " +
+        strategy_summary.message;
     solver_summary_->termination_type = FAILURE;
     return false;
   }
@@ -408,6 +412,9 @@ bool TrustRegionMinimizer::ComputeTrustRegionStep() {
   iteration_summary_.step_solver_time_in_seconds =
       WallTimeInSeconds() - strategy_start_time;
   iteration_summary_.linear_solver_iterations = strategy_summary.num_iterations;
+  if (strategy_summary.reused_linear_solve) {
+    ++solver_summary_->num_reused_linear_solves;
+  }
 
   if (strategy_summary.termination_type == LINEAR_SOLVER_FAILURE) {
     return true;
@@ -499,6 +506,7 @@ void TrustRegionMinimizer::DoInnerIterationsIfNeeded() {
     return;
   }
 
+  ScopedTrace trace(options_.tracer, "TrustRegionMinimizer::InnerIterations");
   double inner_iteration_start_time = WallTimeInSeconds();
   ++solver_summary_->num_inner_iteration_steps;
   inner_iteration_x_ = candidate_x_;
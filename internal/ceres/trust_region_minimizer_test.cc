@@ -36,6 +36,7 @@
 #include "ceres/trust_region_minimizer.h"
 
 #include <cmath>
+#include <string>
 
 #include "ceres/autodiff_cost_function.h"
 #include "ceres/cost_function.h"
@@ -79,7 +80,7 @@ class PowellEvaluator2 : public Evaluator {
   virtual ~PowellEvaluator2() {}
 
   // Implementation of Evaluator interface.
-  SparseMatrix* CreateJacobian() const final {
+  SparseMatrix* CreateJacobian(std::string* /* error */) const final {
     CHECK(col1 || col2 || col3 || col4);
     DenseSparseMatrix* dense_jacobian =
         new DenseSparseMatrix(NumResiduals(), NumEffectiveParameters());
@@ -242,8 +243,9 @@ void IsTrustRegionSolveSuccessful(TrustRegionStrategyType strategy_type) {
   minimizer_options.parameter_tolerance = 1e-26;
   minimizer_options.evaluator.reset(
       new PowellEvaluator2<col1, col2, col3, col4>);
+  std::string error;
   minimizer_options.jacobian.reset(
-      minimizer_options.evaluator->CreateJacobian());
+      minimizer_options.evaluator->CreateJacobian(&error));
 
   TrustRegionStrategy::Options trust_region_strategy_options;
   trust_region_strategy_options.trust_region_strategy_type = strategy_type;
@@ -147,6 +147,43 @@ bool ReorderProgram(PreprocessedProblem* pp) {
   return true;
 }
 
+// Convert the camera clustering in options.visibility_clustering,
+// which is keyed by the user's parameter blocks, into one keyed by
+// the index of the f_blocks in the reduced program, and have the
+// linear solver use it. Cameras not in the clustering are marked as
+// not clustered yet.
+void SetupCameraClustering(PreprocessedProblem* pp) {
+  const Solver::Options& options = pp->options;
+  if (options.visibility_clustering == nullptr ||
+      options.linear_solver_type != ITERATIVE_SCHUR ||
+      (options.preconditioner_type != CLUSTER_JACOBI &&
+       options.preconditioner_type != CLUSTER_TRIDIAGONAL)) {
+    return;
+  }
+
+  const VisibilityClustering& visibility_clustering =
+      *options.visibility_clustering;
+  CameraClustering* camera_clustering = &pp->camera_clustering;
+  camera_clustering->type = visibility_clustering.preconditioner_type;
+  camera_clustering->num_clusters = visibility_clustering.num_clusters;
+  camera_clustering->cluster_pairs = visibility_clustering.cluster_pairs;
+  camera_clustering->cluster_membership.clear();
+  if (!visibility_clustering.cluster_membership.empty()) {
+    const std::vector<ParameterBlock*>& parameter_blocks =
+        pp->reduced_program->parameter_blocks();
+    const int num_eliminate_blocks =
+        pp->linear_solver_options.elimination_groups[0];
+    for (int i = num_eliminate_blocks; i < parameter_blocks.size(); ++i) {
+      const auto it = visibility_clustering.cluster_membership.find(
+          parameter_blocks[i]->user_state());
+      camera_clustering->cluster_membership.push_back(
+          it == visibility_clustering.cluster_membership.end() ? -1
+                                                               : it->second);
+    }
+  }
+  pp->linear_solver_options.visibility_clustering = camera_clustering;
+}
+
 // Configure and create a linear solver object. In doing so, if a
 // sparse direct factorization based linear solver is being used, then
 // find a fill reducing ordering and reorder the program as needed
@@ -202,9 +239,15 @@ bool SetupLinearSolver(PreprocessedProblem* pp) {
       options.sparse_linear_algebra_library_type;
   pp->linear_solver_options.dense_linear_algebra_library_type =
       options.dense_linear_algebra_library_type;
+  pp->linear_solver_options.use_tiled_dense_factorization =
+      options.use_tiled_dense_factorization;
   pp->linear_solver_options.use_explicit_schur_complement =
       options.use_explicit_schur_complement;
   pp->linear_solver_options.dynamic_sparsity = options.dynamic_sparsity;
+  pp->linear_solver_options.use_matrix_free_jacobian =
+      options.use_matrix_free_jacobian;
+  pp->linear_solver_options.memory_mapped_storage_directory =
+      options.memory_mapped_storage_directory;
   pp->linear_solver_options.use_mixed_precision_solves =
       options.use_mixed_precision_solves;
   pp->linear_solver_options.max_num_refinement_iterations =
@@ -212,6 +255,7 @@ bool SetupLinearSolver(PreprocessedProblem* pp) {
   pp->linear_solver_options.num_threads = options.num_threads;
   pp->linear_solver_options.use_postordering = options.use_postordering;
   pp->linear_solver_options.context = pp->problem->context();
+  pp->linear_solver_options.tracer = pp->tracer;
 
   if (IsSchurType(pp->linear_solver_options.type)) {
     OrderingToGroupSizes(options.linear_solver_ordering.get(),
@@ -247,6 +291,7 @@ bool SetupLinearSolver(PreprocessedProblem* pp) {
     }
   }
 
+  SetupCameraClustering(pp);
   pp->linear_solver.reset(LinearSolver::Create(pp->linear_solver_options));
   return (pp->linear_solver != nullptr);
 }
@@ -255,6 +300,14 @@ bool SetupLinearSolver(PreprocessedProblem* pp) {
 bool SetupEvaluator(PreprocessedProblem* pp) {
   const Solver::Options& options = pp->options;
   pp->evaluator_options = Evaluator::Options();
+  if (options.use_matrix_free_jacobian &&
+      pp->reduced_program->mutable_evaluation_callback()) {
+    pp->error =
+        "Solver::Options::use_matrix_free_jacobian cannot be used with "
+        "EvaluationCallbacks";
+    return false;
+  }
+
   pp->evaluator_options.linear_solver_type = options.linear_solver_type;
   pp->evaluator_options.num_eliminate_blocks = 0;
   if (IsSchurType(options.linear_solver_type)) {
@@ -266,7 +319,14 @@ bool SetupEvaluator(PreprocessedProblem* pp) {
 
   pp->evaluator_options.num_threads = options.num_threads;
   pp->evaluator_options.dynamic_sparsity = options.dynamic_sparsity;
+  pp->evaluator_options.use_matrix_free_jacobian =
+      options.use_matrix_free_jacobian;
+  pp->evaluator_options.memory_mapped_storage_directory =
+      options.memory_mapped_storage_directory;
+  pp->evaluator_options.profile_cost_functions =
+      options.profile_cost_functions;
   pp->evaluator_options.context = pp->problem->context();
+  pp->evaluator_options.tracer = pp->tracer;
   pp->evaluator_options.evaluation_callback =
       pp->reduced_program->mutable_evaluation_callback();
   pp->evaluator.reset(Evaluator::Create(
@@ -329,13 +389,18 @@ bool SetupInnerIterationMinimizer(PreprocessedProblem* pp) {
 }
 
 // Configure and create a TrustRegionMinimizer object.
-void SetupMinimizerOptions(PreprocessedProblem* pp) {
+bool SetupMinimizerOptions(PreprocessedProblem* pp) {
   const Solver::Options& options = pp->options;
 
   SetupCommonMinimizerOptions(pp);
   pp->minimizer_options.is_constrained =
       pp->reduced_program->IsBoundsConstrained();
-  pp->minimizer_options.jacobian.reset(pp->evaluator->CreateJacobian());
+  std::string error;
+  pp->minimizer_options.jacobian.reset(pp->evaluator->CreateJacobian(&error));
+  if (pp->minimizer_options.jacobian == nullptr) {
+    pp->error = "Unable to create the Jacobian. " + error;
+    return false;
+  }
   pp->minimizer_options.inner_iteration_minimizer =
       pp->inner_iteration_minimizer;
 
@@ -348,9 +413,13 @@ void SetupMinimizerOptions(PreprocessedProblem* pp) {
   strategy_options.trust_region_strategy_type =
       options.trust_region_strategy_type;
   strategy_options.dogleg_type = options.dogleg_type;
+  strategy_options.use_lm_eigendecomposition =
+      options.use_lm_eigendecomposition;
+  strategy_options.tracer = pp->tracer;
   pp->minimizer_options.trust_region_strategy.reset(
       TrustRegionStrategy::Create(strategy_options));
   CHECK(pp->minimizer_options.trust_region_strategy != nullptr);
+  return true;
 }
 
 }  // namespace
@@ -388,8 +457,7 @@ bool TrustRegionPreprocessor::Preprocess(const Solver::Options& options,
     return false;
   }
 
-  SetupMinimizerOptions(pp);
-  return true;
+  return SetupMinimizerOptions(pp);
 }
 
 }  // namespace internal
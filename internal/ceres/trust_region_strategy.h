@@ -70,8 +70,17 @@ class CERES_EXPORT_INTERNAL TrustRegionStrategy {
     double min_lm_diagonal = 1e-6;
     double max_lm_diagonal = 1e32;
 
+    // If true and the Jacobian is a DenseSparseMatrix, the
+    // LevenbergMarquardtStrategy computes its steps from an
+    // eigendecomposition of the scaled normal equations which is
+    // reused across rejected steps, instead of calling linear_solver.
+    bool use_lm_eigendecomposition = false;
+
     // Further specify which dogleg method to use
     DoglegType dogleg_type = TRADITIONAL_DOGLEG;
+
+    // Records the linear solves if not nullptr.
+    Tracer* tracer = nullptr;
   };
 
   // Factory.
@@ -109,8 +118,16 @@ class CERES_EXPORT_INTERNAL TrustRegionStrategy {
     // unsuccessful step), then this would be zero.
     int num_iterations = -1;
 
+    // True if the step was computed by reusing the solution of the
+    // linear system from an earlier call to ComputeStep, in which case
+    // the linear solver was not called.
+    bool reused_linear_solve = false;
+
     // Status of the linear solver used to solve the Newton system.
     LinearSolverTerminationType termination_type = LINEAR_SOLVER_FAILURE;
+
+    // Message returned by the linear solver.
+    std::string message;
   };
 
   // Use the current radius to solve for the trust region step.
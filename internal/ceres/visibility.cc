@@ -33,93 +33,179 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
-#include <set>
-#include <unordered_map>
+#include <numeric>
 #include <utility>
 #include <vector>
 
 #include "ceres/block_structure.h"
 #include "ceres/graph.h"
-#include "ceres/pair_hash.h"
+#include "ceres/parallel_for.h"
 #include "glog/logging.h"
 
 namespace ceres {
 namespace internal {
 
-using std::make_pair;
 using std::max;
 using std::pair;
-using std::set;
 using std::vector;
 
 void ComputeVisibility(const CompressedRowBlockStructure& block_structure,
                        const int num_eliminate_blocks,
-                       vector<set<int>>* visibility) {
+                       ContextImpl* context,
+                       const int num_threads,
+                       vector<vector<int>>* visibility) {
   CHECK(visibility != nullptr);
+  const int num_f_blocks =
+      block_structure.cols.size() - num_eliminate_blocks;
+
+  // Count the number of cells in each f_block column, so that the
+  // storage for each visibility vector is allocated exactly once.
+  vector<int> num_cells(num_f_blocks, 0);
+  for (const CompressedRow& row : block_structure.rows) {
+    const vector<Cell>& cells = row.cells;
+    // If the first block is not an e_block, then skip this row block.
+    if (cells[0].block_id >= num_eliminate_blocks) {
+      continue;
+    }
+
+    for (int j = 1; j < cells.size(); ++j) {
+      const int camera_block_id = cells[j].block_id - num_eliminate_blocks;
+      DCHECK_GE(camera_block_id, 0);
+      DCHECK_LT(camera_block_id, num_f_blocks);
+      ++num_cells[camera_block_id];
+    }
+  }
 
   // Clear the visibility vector and resize it to hold a
   // vector for each camera.
   visibility->resize(0);
-  visibility->resize(block_structure.cols.size() - num_eliminate_blocks);
+  visibility->resize(num_f_blocks);
+  for (int i = 0; i < num_f_blocks; ++i) {
+    (*visibility)[i].reserve(num_cells[i]);
+  }
 
-  for (int i = 0; i < block_structure.rows.size(); ++i) {
-    const vector<Cell>& cells = block_structure.rows[i].cells;
-    int block_id = cells[0].block_id;
-    // If the first block is not an e_block, then skip this row block.
+  for (const CompressedRow& row : block_structure.rows) {
+    const vector<Cell>& cells = row.cells;
+    const int block_id = cells[0].block_id;
     if (block_id >= num_eliminate_blocks) {
       continue;
     }
 
     for (int j = 1; j < cells.size(); ++j) {
-      int camera_block_id = cells[j].block_id - num_eliminate_blocks;
-      DCHECK_GE(camera_block_id, 0);
-      DCHECK_LT(camera_block_id, visibility->size());
-      (*visibility)[camera_block_id].insert(block_id);
+      (*visibility)[cells[j].block_id - num_eliminate_blocks].push_back(
+          block_id);
     }
   }
+
+  // An e_block may co-occur with an f_block in more than one row
+  // block, and the row blocks are not required to be sorted by
+  // e_block, so sort and de-duplicate each visibility vector.
+  ParallelFor(context, 0, num_f_blocks, num_threads, [visibility](int i) {
+    vector<int>& camera_visibility = (*visibility)[i];
+    std::sort(camera_visibility.begin(), camera_visibility.end());
+    camera_visibility.erase(
+        std::unique(camera_visibility.begin(), camera_visibility.end()),
+        camera_visibility.end());
+  });
 }
 
-WeightedGraph<int>* CreateSchurComplementGraph(
-    const vector<set<int>>& visibility) {
-  const time_t start_time = time(NULL);
+void ComputeVisibilityOverlap(const vector<vector<int>>& visibility,
+                              ContextImpl* context,
+                              const int num_threads,
+                              vector<vector<pair<int, int>>>* overlap) {
+  CHECK(overlap != nullptr);
+  const int num_vertices = visibility.size();
+
   // Compute the number of e_blocks/point blocks. Since the visibility
-  // set for each e_block/camera contains the set of e_blocks/points
-  // visible to it, we find the maximum across all visibility sets.
+  // vector for each e_block/camera contains the sorted list of
+  // e_blocks/points visible to it, we find the maximum across the
+  // last entries of all visibility vectors.
   int num_points = 0;
-  for (int i = 0; i < visibility.size(); i++) {
-    if (visibility[i].size() > 0) {
-      num_points = max(num_points, (*visibility[i].rbegin()) + 1);
+  for (const vector<int>& vertex_visibility : visibility) {
+    if (!vertex_visibility.empty()) {
+      num_points = max(num_points, vertex_visibility.back() + 1);
     }
   }
 
   // Invert the visibility. The input is a camera->point mapping,
   // which tells us which points are visible in which
-  // cameras. However, to compute the sparsity structure of the Schur
-  // Complement efficiently, its better to have the point->camera
-  // mapping.
-  vector<set<int>> inverse_visibility(num_points);
-  for (int i = 0; i < visibility.size(); i++) {
-    const set<int>& visibility_set = visibility[i];
-    for (const int v : visibility_set) {
-      inverse_visibility[v].insert(i);
+  // cameras. However, to compute the overlap between cameras
+  // efficiently, its better to have the point->camera mapping. It is
+  // stored in compressed row form, and since the cameras are visited
+  // in increasing order, the cameras in each row are sorted.
+  vector<int> inverse_rows(num_points + 1, 0);
+  for (const vector<int>& vertex_visibility : visibility) {
+    for (const int point : vertex_visibility) {
+      ++inverse_rows[point + 1];
     }
   }
+  std::partial_sum(
+      inverse_rows.begin(), inverse_rows.end(), inverse_rows.begin());
+
+  vector<int> inverse_cols(inverse_rows.back());
+  vector<int> next_position(inverse_rows.begin(), inverse_rows.end() - 1);
+  for (int i = 0; i < num_vertices; ++i) {
+    for (const int point : visibility[i]) {
+      inverse_cols[next_position[point]++] = i;
+    }
+  }
+
+  overlap->resize(0);
+  overlap->resize(num_vertices);
+
+  // Each thread accumulates the overlap counts of the vertex it is
+  // working on in a dense array indexed by vertex, and keeps track of
+  // the entries it touched so that the array can be reset cheaply.
+  // The arrays are allocated lazily, so that only the threads which
+  // actually participate pay for them.
+  vector<vector<int>> counts(num_threads);
+  vector<vector<int>> touched(num_threads);
+  ParallelFor(
+      context,
+      0,
+      num_vertices,
+      num_threads,
+      [&](int thread_id, int vertex1) {
+        vector<int>& count = counts[thread_id];
+        vector<int>& touched_vertices = touched[thread_id];
+        if (count.empty()) {
+          count.resize(num_vertices, 0);
+        }
+
+        touched_vertices.clear();
+        for (const int point : visibility[vertex1]) {
+          const int* begin = inverse_cols.data() + inverse_rows[point];
+          const int* end = inverse_cols.data() + inverse_rows[point + 1];
+          // Only the pairs (vertex1, vertex2) with vertex1 < vertex2
+          // are counted, so skip over the smaller vertices.
+          for (const int* vertex2 = std::upper_bound(begin, end, vertex1);
+               vertex2 != end;
+               ++vertex2) {
+            if (count[*vertex2]++ == 0) {
+              touched_vertices.push_back(*vertex2);
+            }
+          }
+        }
+
+        std::sort(touched_vertices.begin(), touched_vertices.end());
+        vector<pair<int, int>>& vertex_overlap = (*overlap)[vertex1];
+        vertex_overlap.reserve(touched_vertices.size());
+        for (const int vertex2 : touched_vertices) {
+          vertex_overlap.emplace_back(vertex2, count[vertex2]);
+          count[vertex2] = 0;
+        }
+      });
+}
 
-  // Map from camera pairs to number of points visible to both cameras
-  // in the pair.
-  std::unordered_map<pair<int, int>, int, pair_hash> camera_pairs;
+WeightedGraph<int>* CreateSchurComplementGraph(
+    const vector<vector<int>>& visibility,
+    ContextImpl* context,
+    const int num_threads) {
+  const time_t start_time = time(NULL);
 
   // Count the number of points visible to each camera/f_block pair.
-  for (const auto& inverse_visibility_set : inverse_visibility) {
-    for (set<int>::const_iterator camera1 = inverse_visibility_set.begin();
-         camera1 != inverse_visibility_set.end();
-         ++camera1) {
-      set<int>::const_iterator camera2 = camera1;
-      for (++camera2; camera2 != inverse_visibility_set.end(); ++camera2) {
-        ++(camera_pairs[make_pair(*camera1, *camera2)]);
-      }
-    }
-  }
+  vector<vector<pair<int, int>>> camera_pairs;
+  ComputeVisibilityOverlap(visibility, context, num_threads, &camera_pairs);
 
   WeightedGraph<int>* graph = new WeightedGraph<int>;
 
@@ -133,17 +219,18 @@ WeightedGraph<int>* CreateSchurComplementGraph(
   }
 
   // Add an edge for each camera pair.
-  for (const auto& camera_pair_count : camera_pairs) {
-    const int camera1 = camera_pair_count.first.first;
-    const int camera2 = camera_pair_count.first.second;
-    const int count = camera_pair_count.second;
-    DCHECK_NE(camera1, camera2);
-    // Static cast necessary for Windows.
-    const double weight =
-        static_cast<double>(count) /
-        (sqrt(static_cast<double>(visibility[camera1].size() *
-                                  visibility[camera2].size())));
-    graph->AddEdge(camera1, camera2, weight);
+  for (int camera1 = 0; camera1 < camera_pairs.size(); ++camera1) {
+    for (const auto& camera_pair_count : camera_pairs[camera1]) {
+      const int camera2 = camera_pair_count.first;
+      const int count = camera_pair_count.second;
+      DCHECK_NE(camera1, camera2);
+      // Static cast necessary for Windows.
+      const double weight =
+          static_cast<double>(count) /
+          (sqrt(static_cast<double>(visibility[camera1].size() *
+                                    visibility[camera2].size())));
+      graph->AddEdge(camera1, camera2, weight);
+    }
   }
 
   VLOG(2) << "Schur complement graph time: " << (time(NULL) - start_time);
@@ -35,7 +35,7 @@
 #ifndef CERES_INTERNAL_VISIBILITY_H_
 #define CERES_INTERNAL_VISIBILITY_H_
 
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "ceres/graph.h"
@@ -44,6 +44,7 @@
 namespace ceres {
 namespace internal {
 
+class ContextImpl;
 struct CompressedRowBlockStructure;
 
 // Given a compressed row block structure, computes the set of
@@ -54,10 +55,29 @@ struct CompressedRowBlockStructure;
 //
 // In a structure from motion problem, e_blocks correspond to 3D
 // points and f_blocks correspond to cameras.
+//
+// The visibility of each f_block is stored as a sorted vector of
+// unique e_block ids. The work is spread over num_threads threads.
 CERES_EXPORT_INTERNAL void ComputeVisibility(
     const CompressedRowBlockStructure& block_structure,
     int num_eliminate_blocks,
-    std::vector<std::set<int>>* visibility);
+    ContextImpl* context,
+    int num_threads,
+    std::vector<std::vector<int>>* visibility);
+
+// Given a list of sorted visibility vectors, for each pair of
+// vectors (i, j) with i < j which have at least one element in
+// common, compute the number of elements they share.
+//
+// On return, (*overlap)[i] contains the pairs (j, count) for all
+// such j > i, sorted by j. The elements of the visibility vectors
+// must be non-negative integers. The work is spread over num_threads
+// threads, with each thread using O(visibility.size()) scratch space.
+CERES_EXPORT_INTERNAL void ComputeVisibilityOverlap(
+    const std::vector<std::vector<int>>& visibility,
+    ContextImpl* context,
+    int num_threads,
+    std::vector<std::vector<std::pair<int, int>>>* overlap);
 
 // Given f_block visibility as computed by the ComputeVisibility
 // function above, construct and return a graph whose vertices are
@@ -73,7 +93,9 @@ CERES_EXPORT_INTERNAL void ComputeVisibility(
 // Caller acquires ownership of the returned WeightedGraph pointer
 // (heap-allocated).
 CERES_EXPORT_INTERNAL WeightedGraph<int>* CreateSchurComplementGraph(
-    const std::vector<std::set<int>>& visibility);
+    const std::vector<std::vector<int>>& visibility,
+    ContextImpl* context,
+    int num_threads);
 
 }  // namespace internal
 }  // namespace ceres
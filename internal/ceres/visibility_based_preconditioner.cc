@@ -31,10 +31,11 @@
 #include "ceres/visibility_based_preconditioner.h"
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
-#include <iterator>
 #include <memory>
-#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -45,6 +46,7 @@
 #include "ceres/graph.h"
 #include "ceres/graph_algorithms.h"
 #include "ceres/linear_solver.h"
+#include "ceres/parallel_for.h"
 #include "ceres/schur_eliminator.h"
 #include "ceres/single_linkage_clustering.h"
 #include "ceres/visibility.h"
@@ -55,7 +57,6 @@ namespace internal {
 
 using std::make_pair;
 using std::pair;
-using std::set;
 using std::swap;
 using std::vector;
 
@@ -89,18 +90,23 @@ VisibilityBasedPreconditioner::VisibilityBasedPreconditioner(
   }
 
   const time_t start_time = time(NULL);
-  switch (options_.type) {
-    case CLUSTER_JACOBI:
-      ComputeClusterJacobiSparsity(bs);
-      break;
-    case CLUSTER_TRIDIAGONAL:
-      ComputeClusterTridiagonalSparsity(bs);
-      break;
-    default:
-      LOG(FATAL) << "Unknown preconditioner type";
+  if (!ReuseClustering(bs)) {
+    switch (options_.type) {
+      case CLUSTER_JACOBI:
+        ComputeClusterJacobiSparsity(bs);
+        break;
+      case CLUSTER_TRIDIAGONAL:
+        ComputeClusterTridiagonalSparsity(bs);
+        break;
+      default:
+        LOG(FATAL) << "Unknown preconditioner type";
+    }
   }
   const time_t structure_time = time(NULL);
   InitStorage(bs);
+  if (options_.visibility_clustering != nullptr) {
+    SaveClustering(options_.visibility_clustering);
+  }
   const time_t storage_time = time(NULL);
   InitEliminator(bs);
   const time_t eliminator_time = time(NULL);
@@ -133,8 +139,12 @@ VisibilityBasedPreconditioner::~VisibilityBasedPreconditioner() {}
 // preconditioner matrix.
 void VisibilityBasedPreconditioner::ComputeClusterJacobiSparsity(
     const CompressedRowBlockStructure& bs) {
-  vector<set<int>> visibility;
-  ComputeVisibility(bs, options_.elimination_groups[0], &visibility);
+  vector<vector<int>> visibility;
+  ComputeVisibility(bs,
+                    options_.elimination_groups[0],
+                    options_.context,
+                    options_.num_threads,
+                    &visibility);
   CHECK_EQ(num_blocks_, visibility.size());
   ClusterCameras(visibility);
   cluster_pairs_.clear();
@@ -151,8 +161,12 @@ void VisibilityBasedPreconditioner::ComputeClusterJacobiSparsity(
 // of edges in this forest are the cluster pairs.
 void VisibilityBasedPreconditioner::ComputeClusterTridiagonalSparsity(
     const CompressedRowBlockStructure& bs) {
-  vector<set<int>> visibility;
-  ComputeVisibility(bs, options_.elimination_groups[0], &visibility);
+  vector<vector<int>> visibility;
+  ComputeVisibility(bs,
+                    options_.elimination_groups[0],
+                    options_.context,
+                    options_.num_threads,
+                    &visibility);
   CHECK_EQ(num_blocks_, visibility.size());
   ClusterCameras(visibility);
 
@@ -160,7 +174,7 @@ void VisibilityBasedPreconditioner::ComputeClusterTridiagonalSparsity(
   // edges are the number of 3D points/e_blocks visible in both the
   // clusters at the ends of the edge. Return an approximate degree-2
   // maximum spanning forest of this graph.
-  vector<set<int>> cluster_visibility;
+  vector<vector<int>> cluster_visibility;
   ComputeClusterVisibility(visibility, &cluster_visibility);
   std::unique_ptr<WeightedGraph<int>> cluster_graph(
       CreateClusterGraph(cluster_visibility));
@@ -171,6 +185,262 @@ void VisibilityBasedPreconditioner::ComputeClusterTridiagonalSparsity(
   ForestToClusterPairs(*forest, &cluster_pairs_);
 }
 
+// Initialize the clustering from options_.visibility_clustering if
+// it was computed for the same preconditioner type and for at most
+// num_blocks_ cameras. Cameras which are not clustered by it are
+// assigned to clusters by ClusterNewCameras. Returns false if there
+// is no usable clustering, in which case the cameras must be
+// clustered from scratch.
+//
+// The clustering comes from the user, so a clustering whose cluster
+// ids are out of range is ignored rather than trusted.
+bool VisibilityBasedPreconditioner::ReuseClustering(
+    const CompressedRowBlockStructure& bs) {
+  const CameraClustering* clustering = options_.visibility_clustering;
+  if (clustering == nullptr) {
+    return false;
+  }
+
+  const int num_clustered_blocks = clustering->cluster_membership.size();
+  if (clustering->type != options_.type ||
+      num_clustered_blocks > num_blocks_) {
+    VLOG(2) << "Ignoring visibility clustering computed for "
+            << num_clustered_blocks << " cameras and preconditioner "
+            << PreconditionerTypeToString(clustering->type);
+    return false;
+  }
+
+  const int num_clusters = clustering->num_clusters;
+  const auto is_valid_cluster = [num_clusters](const int cluster_id) {
+    return cluster_id >= 0 && cluster_id < num_clusters;
+  };
+  int num_new_blocks = num_blocks_ - num_clustered_blocks;
+  for (const int cluster_id : clustering->cluster_membership) {
+    if (cluster_id == -1) {
+      ++num_new_blocks;
+    } else if (!is_valid_cluster(cluster_id)) {
+      VLOG(2) << "Ignoring visibility clustering with cluster id "
+              << cluster_id << " and " << num_clusters << " clusters.";
+      return false;
+    }
+  }
+  for (const auto& cluster_pair : clustering->cluster_pairs) {
+    if (!is_valid_cluster(cluster_pair.first) ||
+        !is_valid_cluster(cluster_pair.second)) {
+      VLOG(2) << "Ignoring visibility clustering with cluster pair ("
+              << cluster_pair.first << ", " << cluster_pair.second
+              << ") and " << num_clusters << " clusters.";
+      return false;
+    }
+  }
+  if (num_new_blocks == num_blocks_) {
+    return false;
+  }
+
+  num_clusters_ = num_clusters;
+  cluster_membership_ = clustering->cluster_membership;
+  cluster_membership_.resize(num_blocks_, -1);
+
+  cluster_pairs_.clear();
+  cluster_pairs_.insert(clustering->cluster_pairs.begin(),
+                        clustering->cluster_pairs.end());
+  RemoveEmptyClusters();
+  if (num_new_blocks > 0) {
+    ClusterNewCameras(bs);
+  }
+  VLOG(2) << "Reused visibility clustering. num_clusters: " << num_clusters_
+          << " new cameras: " << num_new_blocks;
+  return true;
+}
+
+// Cameras are removed from the problem between solves, which can
+// leave clusters without any cameras. Renumber the clusters which
+// still have cameras consecutively, and drop the cluster pairs
+// involving the others.
+void VisibilityBasedPreconditioner::RemoveEmptyClusters() {
+  vector<int> new_cluster_id(num_clusters_, -1);
+  for (const int cluster_id : cluster_membership_) {
+    if (cluster_id >= 0) {
+      new_cluster_id[cluster_id] = 0;
+    }
+  }
+
+  int num_nonempty_clusters = 0;
+  for (int& cluster_id : new_cluster_id) {
+    if (cluster_id == 0) {
+      cluster_id = num_nonempty_clusters++;
+    }
+  }
+  if (num_nonempty_clusters == num_clusters_) {
+    return;
+  }
+
+  for (int& cluster_id : cluster_membership_) {
+    if (cluster_id >= 0) {
+      cluster_id = new_cluster_id[cluster_id];
+    }
+  }
+
+  std::unordered_set<pair<int, int>, pair_hash> cluster_pairs;
+  for (const auto& cluster_pair : cluster_pairs_) {
+    const int cluster1 = new_cluster_id[cluster_pair.first];
+    const int cluster2 = new_cluster_id[cluster_pair.second];
+    if (cluster1 >= 0 && cluster2 >= 0) {
+      cluster_pairs.insert(make_pair(cluster1, cluster2));
+    }
+  }
+  cluster_pairs_.swap(cluster_pairs);
+  num_clusters_ = num_nonempty_clusters;
+}
+
+namespace {
+
+// Calls callback(point, camera) for every e_block/f_block pair which
+// occurs in a row block of bs, where camera is the index of the
+// f_block among the f_blocks.
+template <typename Callback>
+void ForEachObservation(const CompressedRowBlockStructure& bs,
+                        const int num_eliminate_blocks,
+                        const Callback& callback) {
+  for (const CompressedRow& row : bs.rows) {
+    const vector<Cell>& cells = row.cells;
+    const int point = cells[0].block_id;
+    if (point >= num_eliminate_blocks) {
+      continue;
+    }
+    for (int j = 1; j < cells.size(); ++j) {
+      callback(point, cells[j].block_id - num_eliminate_blocks);
+    }
+  }
+}
+
+void SortAndRemoveDuplicates(std::unordered_map<int, vector<int>>* lists) {
+  for (auto& list : *lists) {
+    vector<int>& values = list.second;
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+  }
+}
+
+}  // namespace
+
+// Assign the cameras which are not clustered yet, i.e., whose
+// cluster_membership_ is -1, to the cluster of the clustered camera
+// that they are most similar to, using the same similarity as the
+// Schur complement graph. New cameras are assigned in order, so a
+// new camera can join the cluster of a new camera before it. Cameras
+// which do not share any points with a clustered camera are each put
+// in a new cluster of their own.
+//
+// This leaves the clusters, and thus the cluster pairs, of the
+// already clustered cameras unchanged. The row blocks of bs are
+// scanned three times, but the visibility is only computed for the
+// new cameras and the cameras they share points with, and the
+// cameras seeing a point only for the points seen by the new
+// cameras. It is cheaper than, but not as good as, re-clustering all
+// the cameras, and is meant to be used when only a small number of
+// cameras are added at a time.
+void VisibilityBasedPreconditioner::ClusterNewCameras(
+    const CompressedRowBlockStructure& bs) {
+  const int num_eliminate_blocks = options_.elimination_groups[0];
+
+  // The visibility of the new cameras, and the points seen by them.
+  std::unordered_map<int, vector<int>> visibility;
+  std::unordered_map<int, vector<int>> point_to_cameras;
+  ForEachObservation(
+      bs, num_eliminate_blocks, [&](const int point, const int camera) {
+        if (cluster_membership_[camera] == -1) {
+          visibility[camera].push_back(point);
+          point_to_cameras[point];
+        }
+      });
+
+  // The cameras which see these points. The clustered ones among them
+  // are the only cameras a new camera can be similar to.
+  ForEachObservation(
+      bs, num_eliminate_blocks, [&](const int point, const int camera) {
+        auto it = point_to_cameras.find(point);
+        if (it != point_to_cameras.end()) {
+          it->second.push_back(camera);
+          if (cluster_membership_[camera] >= 0) {
+            visibility[camera];
+          }
+        }
+      });
+
+  // The visibility of the clustered cameras found above.
+  ForEachObservation(
+      bs, num_eliminate_blocks, [&](const int point, const int camera) {
+        if (cluster_membership_[camera] >= 0) {
+          auto it = visibility.find(camera);
+          if (it != visibility.end()) {
+            it->second.push_back(point);
+          }
+        }
+      });
+
+  // An e_block may co-occur with an f_block in more than one row
+  // block.
+  SortAndRemoveDuplicates(&visibility);
+  SortAndRemoveDuplicates(&point_to_cameras);
+
+  std::unordered_map<int, int> num_shared_points;
+  for (int camera1 = 0; camera1 < num_blocks_; ++camera1) {
+    if (cluster_membership_[camera1] >= 0) {
+      continue;
+    }
+
+    num_shared_points.clear();
+    const vector<int>& camera1_visibility = visibility[camera1];
+    for (const int point : camera1_visibility) {
+      for (const int camera2 : point_to_cameras[point]) {
+        if (cluster_membership_[camera2] >= 0) {
+          ++num_shared_points[camera2];
+        }
+      }
+    }
+
+    double best_similarity = 0.0;
+    int best_camera = -1;
+    for (const auto& camera_count : num_shared_points) {
+      const int camera2 = camera_count.first;
+      // Static cast necessary for Windows.
+      const double similarity =
+          static_cast<double>(camera_count.second) /
+          (sqrt(static_cast<double>(camera1_visibility.size() *
+                                    visibility[camera2].size())));
+      // Break ties by camera index, so that the result does not
+      // depend on the iteration order of the hash map.
+      if (similarity > best_similarity ||
+          (similarity == best_similarity && camera2 < best_camera)) {
+        best_similarity = similarity;
+        best_camera = camera2;
+      }
+    }
+
+    if (best_camera >= 0) {
+      cluster_membership_[camera1] = cluster_membership_[best_camera];
+    } else {
+      cluster_membership_[camera1] = num_clusters_++;
+      cluster_pairs_.insert(make_pair(cluster_membership_[camera1],
+                                      cluster_membership_[camera1]));
+    }
+  }
+}
+
+void VisibilityBasedPreconditioner::SaveClustering(
+    CameraClustering* clustering) const {
+  CHECK(clustering != nullptr);
+  clustering->type = options_.type;
+  clustering->num_clusters = num_clusters_;
+  clustering->cluster_membership = cluster_membership_;
+  clustering->cluster_pairs.assign(cluster_pairs_.begin(),
+                                   cluster_pairs_.end());
+  std::sort(clustering->cluster_pairs.begin(),
+            clustering->cluster_pairs.end());
+  clustering->block_pairs = block_pairs_;
+}
+
 // Allocate storage for the preconditioner matrix.
 void VisibilityBasedPreconditioner::InitStorage(
     const CompressedRowBlockStructure& bs) {
@@ -185,9 +455,10 @@ void VisibilityBasedPreconditioner::InitStorage(
 // The cluster_membership_ vector is updated to indicate cluster
 // memberships for each camera block.
 void VisibilityBasedPreconditioner::ClusterCameras(
-    const vector<set<int>>& visibility) {
+    const vector<vector<int>>& visibility) {
   std::unique_ptr<WeightedGraph<int>> schur_complement_graph(
-      CreateSchurComplementGraph(visibility));
+      CreateSchurComplementGraph(
+          visibility, options_.context, options_.num_threads));
   CHECK(schur_complement_graph != nullptr);
 
   std::unordered_map<int, int> membership;
@@ -198,6 +469,8 @@ void VisibilityBasedPreconditioner::ClusterCameras(
     clustering_options.size_penalty_weight = kCanonicalViewsSizePenaltyWeight;
     clustering_options.similarity_penalty_weight =
         kCanonicalViewsSimilarityPenaltyWeight;
+    clustering_options.context = options_.context;
+    clustering_options.num_threads = options_.num_threads;
     ComputeCanonicalViewsClustering(
         clustering_options, *schur_complement_graph, &centers, &membership);
     num_clusters_ = centers.size();
@@ -237,65 +510,88 @@ void VisibilityBasedPreconditioner::ClusterCameras(
 // checking membership of (cluster1, cluster2) in cluster_pairs_.
 void VisibilityBasedPreconditioner::ComputeBlockPairsInPreconditioner(
     const CompressedRowBlockStructure& bs) {
-  block_pairs_.clear();
-  for (int i = 0; i < num_blocks_; ++i) {
-    block_pairs_.insert(make_pair(i, i));
-  }
-
-  int r = 0;
   const int num_row_blocks = bs.rows.size();
   const int num_eliminate_blocks = options_.elimination_groups[0];
 
-  // Iterate over each row of the matrix. The block structure of the
-  // matrix is assumed to be sorted in order of the e_blocks/point
-  // blocks. Thus all row blocks containing an e_block/point occur
-  // contiguously. Further, if present, an e_block is always the first
-  // parameter block in each row block.  These structural assumptions
-  // are common to all Schur complement based solvers in Ceres.
+  // The block structure of the matrix is assumed to be sorted in
+  // order of the e_blocks/point blocks. Thus all row blocks
+  // containing an e_block/point occur contiguously. Further, if
+  // present, an e_block is always the first parameter block in each
+  // row block. These structural assumptions are common to all Schur
+  // complement based solvers in Ceres.
   //
-  // For each e_block/point block we identify the set of cameras
-  // seeing it. The cross product of this set with itself is the set
-  // of non-zero cells contributed by this e_block.
-  //
-  // The time complexity of this is O(nm^2) where, n is the number of
-  // 3d points and m is the maximum number of cameras seeing any
-  // point, which for most scenes is a fairly small number.
+  // Find the first row block of each e_block, so that the e_blocks
+  // can be processed independently.
+  vector<int> chunk_starts;
+  int r = 0;
   while (r < num_row_blocks) {
-    int e_block_id = bs.rows[r].cells.front().block_id;
+    const int e_block_id = bs.rows[r].cells.front().block_id;
     if (e_block_id >= num_eliminate_blocks) {
       // Skip the rows whose first block is an f_block.
       break;
     }
-
-    set<int> f_blocks;
+    chunk_starts.push_back(r);
     for (; r < num_row_blocks; ++r) {
-      const CompressedRow& row = bs.rows[r];
-      if (row.cells.front().block_id != e_block_id) {
+      if (bs.rows[r].cells.front().block_id != e_block_id) {
         break;
       }
-
-      // Iterate over the blocks in the row, ignoring the first block
-      // since it is the one to be eliminated and adding the rest to
-      // the list of f_blocks associated with this e_block.
-      for (int c = 1; c < row.cells.size(); ++c) {
-        const Cell& cell = row.cells[c];
-        const int f_block_id = cell.block_id - num_eliminate_blocks;
-        CHECK_GE(f_block_id, 0);
-        f_blocks.insert(f_block_id);
-      }
     }
+  }
+  const int num_chunks = chunk_starts.size();
+  chunk_starts.push_back(r);
 
-    for (set<int>::const_iterator block1 = f_blocks.begin();
-         block1 != f_blocks.end();
-         ++block1) {
-      set<int>::const_iterator block2 = block1;
-      ++block2;
-      for (; block2 != f_blocks.end(); ++block2) {
-        if (IsBlockPairInPreconditioner(*block1, *block2)) {
-          block_pairs_.insert(make_pair(*block1, *block2));
+  // For each e_block/point block we identify the set of cameras
+  // seeing it. The cross product of this set with itself is the set
+  // of non-zero cells contributed by this e_block. Each thread
+  // collects its pairs separately and they are merged below.
+  //
+  // The time complexity of this is O(nm^2) where, n is the number of
+  // 3d points and m is the maximum number of cameras seeing any
+  // point, which for most scenes is a fairly small number.
+  const int num_threads = std::max(1, options_.num_threads);
+  vector<vector<pair<int, int>>> thread_block_pairs(num_threads);
+  vector<vector<int>> thread_f_blocks(num_threads);
+  ParallelFor(
+      options_.context,
+      0,
+      num_chunks,
+      num_threads,
+      [&](int thread_id, int chunk) {
+        vector<int>& f_blocks = thread_f_blocks[thread_id];
+        vector<pair<int, int>>& block_pairs = thread_block_pairs[thread_id];
+        f_blocks.clear();
+        for (int i = chunk_starts[chunk]; i < chunk_starts[chunk + 1]; ++i) {
+          // Iterate over the blocks in the row, ignoring the first
+          // block since it is the one to be eliminated and adding the
+          // rest to the list of f_blocks associated with this
+          // e_block.
+          const CompressedRow& row = bs.rows[i];
+          for (int c = 1; c < row.cells.size(); ++c) {
+            const int f_block_id = row.cells[c].block_id - num_eliminate_blocks;
+            CHECK_GE(f_block_id, 0);
+            f_blocks.push_back(f_block_id);
+          }
         }
-      }
-    }
+
+        std::sort(f_blocks.begin(), f_blocks.end());
+        f_blocks.erase(std::unique(f_blocks.begin(), f_blocks.end()),
+                       f_blocks.end());
+        for (int i = 0; i < f_blocks.size(); ++i) {
+          for (int j = i + 1; j < f_blocks.size(); ++j) {
+            if (IsBlockPairInPreconditioner(f_blocks[i], f_blocks[j])) {
+              block_pairs.push_back(make_pair(f_blocks[i], f_blocks[j]));
+            }
+          }
+        }
+      });
+
+  block_pairs_.clear();
+  for (int i = 0; i < num_blocks_; ++i) {
+    block_pairs_.push_back(make_pair(i, i));
+  }
+  for (const auto& block_pairs : thread_block_pairs) {
+    block_pairs_.insert(
+        block_pairs_.end(), block_pairs.begin(), block_pairs.end());
   }
 
   // The remaining rows which do not contain any e_blocks.
@@ -308,13 +604,16 @@ void VisibilityBasedPreconditioner::ComputeBlockPairsInPreconditioner(
         const int block2 = row.cells[j].block_id - num_eliminate_blocks;
         if (block1 <= block2) {
           if (IsBlockPairInPreconditioner(block1, block2)) {
-            block_pairs_.insert(make_pair(block1, block2));
+            block_pairs_.push_back(make_pair(block1, block2));
           }
         }
       }
     }
   }
 
+  std::sort(block_pairs_.begin(), block_pairs_.end());
+  block_pairs_.erase(std::unique(block_pairs_.begin(), block_pairs_.end()),
+                     block_pairs_.end());
   VLOG(1) << "Block pair stats: " << block_pairs_.size();
 }
 
@@ -488,48 +787,58 @@ void VisibilityBasedPreconditioner::ForestToClusterPairs(
 // of all its cameras. In other words, the set of points visible to
 // any camera in the cluster.
 void VisibilityBasedPreconditioner::ComputeClusterVisibility(
-    const vector<set<int>>& visibility,
-    vector<set<int>>* cluster_visibility) const {
+    const vector<vector<int>>& visibility,
+    vector<vector<int>>* cluster_visibility) const {
   CHECK(cluster_visibility != nullptr);
-  cluster_visibility->resize(0);
-  cluster_visibility->resize(num_clusters_);
+  vector<vector<int>> cluster_cameras(num_clusters_);
   for (int i = 0; i < num_blocks_; ++i) {
-    const int cluster_id = cluster_membership_[i];
-    (*cluster_visibility)[cluster_id].insert(visibility[i].begin(),
-                                             visibility[i].end());
+    cluster_cameras[cluster_membership_[i]].push_back(i);
   }
+
+  cluster_visibility->resize(0);
+  cluster_visibility->resize(num_clusters_);
+  ParallelFor(options_.context,
+              0,
+              num_clusters_,
+              options_.num_threads,
+              [&](int cluster_id) {
+                vector<int>& points = (*cluster_visibility)[cluster_id];
+                for (const int camera : cluster_cameras[cluster_id]) {
+                  points.insert(points.end(),
+                                visibility[camera].begin(),
+                                visibility[camera].end());
+                }
+                std::sort(points.begin(), points.end());
+                points.erase(std::unique(points.begin(), points.end()),
+                             points.end());
+              });
 }
 
 // Construct a graph whose vertices are the clusters, and the edge
 // weights are the number of 3D points visible to cameras in both the
 // vertices.
 WeightedGraph<int>* VisibilityBasedPreconditioner::CreateClusterGraph(
-    const vector<set<int>>& cluster_visibility) const {
+    const vector<vector<int>>& cluster_visibility) const {
   WeightedGraph<int>* cluster_graph = new WeightedGraph<int>;
 
   for (int i = 0; i < num_clusters_; ++i) {
     cluster_graph->AddVertex(i);
   }
 
+  vector<vector<pair<int, int>>> cluster_pairs;
+  ComputeVisibilityOverlap(cluster_visibility,
+                           options_.context,
+                           options_.num_threads,
+                           &cluster_pairs);
   for (int i = 0; i < num_clusters_; ++i) {
-    const set<int>& cluster_i = cluster_visibility[i];
-    for (int j = i + 1; j < num_clusters_; ++j) {
-      vector<int> intersection;
-      const set<int>& cluster_j = cluster_visibility[j];
-      set_intersection(cluster_i.begin(),
-                       cluster_i.end(),
-                       cluster_j.begin(),
-                       cluster_j.end(),
-                       back_inserter(intersection));
-
-      if (intersection.size() > 0) {
-        // Clusters interact strongly when they share a large number
-        // of 3D points. The degree-2 maximum spanning forest
-        // algorithm, iterates on the edges in decreasing order of
-        // their weight, which is the number of points shared by the
-        // two cameras that it connects.
-        cluster_graph->AddEdge(i, j, intersection.size());
-      }
+    for (const auto& cluster_pair_count : cluster_pairs[i]) {
+      // Clusters interact strongly when they share a large number
+      // of 3D points. The degree-2 maximum spanning forest
+      // algorithm, iterates on the edges in decreasing order of
+      // their weight, which is the number of points shared by the
+      // two cameras that it connects.
+      cluster_graph->AddEdge(
+          i, cluster_pair_count.first, cluster_pair_count.second);
     }
   }
   return cluster_graph;
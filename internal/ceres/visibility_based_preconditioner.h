@@ -49,7 +49,6 @@
 #define CERES_INTERNAL_VISIBILITY_BASED_PRECONDITIONER_H_
 
 #include <memory>
-#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -124,6 +123,21 @@ class SchurEliminatorBase;
 //      *A.block_structure(), options);
 //   preconditioner.Update(A, NULL);
 //   preconditioner.RightMultiply(x, y);
+//
+// Clustering the cameras is the most expensive part of constructing
+// the preconditioner. If options.visibility_clustering is not NULL,
+// the clustering stored in it is reused (and extended to the cameras
+// it does not cluster yet), and the clustering actually used is
+// written back to it, so that a sequence of solves on a slowly
+// growing problem only pays for the clustering once:
+//
+//   CameraClustering clustering;
+//   options.visibility_clustering = &clustering;
+//   VisibilityBasedPreconditioner preconditioner1(*A1.block_structure(),
+//                                                 options);
+//   ...
+//   VisibilityBasedPreconditioner preconditioner2(*A2.block_structure(),
+//                                                 options);
 class VisibilityBasedPreconditioner : public BlockSparseMatrixPreconditioner {
  public:
   // Initialize the symbolic structure of the preconditioner. bs is
@@ -149,19 +163,23 @@ class VisibilityBasedPreconditioner : public BlockSparseMatrixPreconditioner {
   bool UpdateImpl(const BlockSparseMatrix& A, const double* D) final;
   void ComputeClusterJacobiSparsity(const CompressedRowBlockStructure& bs);
   void ComputeClusterTridiagonalSparsity(const CompressedRowBlockStructure& bs);
+  bool ReuseClustering(const CompressedRowBlockStructure& bs);
+  void RemoveEmptyClusters();
+  void ClusterNewCameras(const CompressedRowBlockStructure& bs);
+  void SaveClustering(CameraClustering* clustering) const;
   void InitStorage(const CompressedRowBlockStructure& bs);
   void InitEliminator(const CompressedRowBlockStructure& bs);
   LinearSolverTerminationType Factorize();
   void ScaleOffDiagonalCells();
 
-  void ClusterCameras(const std::vector<std::set<int>>& visibility);
+  void ClusterCameras(const std::vector<std::vector<int>>& visibility);
   void FlattenMembershipMap(const std::unordered_map<int, int>& membership_map,
                             std::vector<int>* membership_vector) const;
   void ComputeClusterVisibility(
-      const std::vector<std::set<int>>& visibility,
-      std::vector<std::set<int>>* cluster_visibility) const;
+      const std::vector<std::vector<int>>& visibility,
+      std::vector<std::vector<int>>* cluster_visibility) const;
   WeightedGraph<int>* CreateClusterGraph(
-      const std::vector<std::set<int>>& visibility) const;
+      const std::vector<std::vector<int>>& visibility) const;
   void ForestToClusterPairs(
       const WeightedGraph<int>& forest,
       std::unordered_set<std::pair<int, int>, pair_hash>* cluster_pairs) const;
@@ -183,8 +201,8 @@ class VisibilityBasedPreconditioner : public BlockSparseMatrixPreconditioner {
 
   // Non-zero camera pairs from the schur complement matrix that are
   // present in the preconditioner, sorted by row (first element of
-  // each pair), then column (second).
-  std::set<std::pair<int, int>> block_pairs_;
+  // each pair), then column (second), without duplicates.
+  std::vector<std::pair<int, int>> block_pairs_;
 
   // Set of cluster pairs (including self pairs (i,i)) in the
   // preconditioner.
@@ -30,13 +30,17 @@
 
 #include "ceres/visibility_based_preconditioner.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "Eigen/Dense"
 #include "ceres/block_random_access_dense_matrix.h"
 #include "ceres/block_random_access_sparse_matrix.h"
 #include "ceres/block_sparse_matrix.h"
 #include "ceres/casts.h"
+#include "ceres/context_impl.h"
 #include "ceres/file.h"
 #include "ceres/internal/eigen.h"
 #include "ceres/linear_least_squares_problems.h"
@@ -336,5 +340,211 @@ namespace internal {
 //   EXPECT_TRUE(PreconditionerValuesMatch());
 // }
 
+#if !defined(CERES_NO_SUITESPARSE) || defined(CERES_USE_EIGEN_SPARSE)
+
+class CameraClusteringTest
+    : public ::testing::TestWithParam<PreconditionerType> {
+ protected:
+  void SetUp() final {
+    // Two e_blocks and three f_blocks/cameras. Camera 0 sees both
+    // e_blocks, camera 1 sees e_block 0 and camera 2 sees e_block 1.
+    problem_.reset(CreateLinearLeastSquaresProblemFromId(2));
+    CHECK(problem_ != nullptr);
+    A_ = down_cast<BlockSparseMatrix*>(problem_->A.get());
+
+    options_.type = GetParam();
+#ifdef CERES_USE_EIGEN_SPARSE
+    options_.sparse_linear_algebra_library_type = EIGEN_SPARSE;
+#else
+    options_.sparse_linear_algebra_library_type = SUITE_SPARSE;
+#endif
+    options_.elimination_groups.push_back(problem_->num_eliminate_blocks);
+    options_.elimination_groups.push_back(3);
+    options_.context = &context_;
+    options_.visibility_clustering = &clustering_;
+  }
+
+  std::unique_ptr<LinearLeastSquaresProblem> problem_;
+  BlockSparseMatrix* A_ = nullptr;
+  ContextImpl context_;
+  CameraClustering clustering_;
+  Preconditioner::Options options_;
+};
+
+TEST_P(CameraClusteringTest, SavesClustering) {
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.type, GetParam());
+  ASSERT_EQ(clustering_.cluster_membership.size(), 3);
+  EXPECT_GT(clustering_.num_clusters, 0);
+  for (const int cluster_id : clustering_.cluster_membership) {
+    EXPECT_GE(cluster_id, 0);
+    EXPECT_LT(cluster_id, clustering_.num_clusters);
+  }
+  for (int i = 0; i < clustering_.num_clusters; ++i) {
+    EXPECT_TRUE(std::binary_search(clustering_.cluster_pairs.begin(),
+                                   clustering_.cluster_pairs.end(),
+                                   std::make_pair(i, i)));
+  }
+}
+
+TEST_P(CameraClusteringTest, ReusesClustering) {
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 3;
+  clustering_.cluster_membership = {2, 0, 1};
+  clustering_.cluster_pairs = {{0, 0}, {1, 1}, {2, 2}};
+  const CameraClustering expected = clustering_;
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.num_clusters, expected.num_clusters);
+  EXPECT_EQ(clustering_.cluster_membership, expected.cluster_membership);
+  EXPECT_EQ(clustering_.cluster_pairs, expected.cluster_pairs);
+}
+
+TEST_P(CameraClusteringTest, ClustersNewCameras) {
+  // Only cameras 0 and 1 are clustered. Camera 2 shares e_block 1
+  // with camera 0, so it should join the cluster of camera 0.
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 2;
+  clustering_.cluster_membership = {1, 0};
+  clustering_.cluster_pairs = {{0, 0}, {0, 1}, {1, 1}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.num_clusters, 2);
+  EXPECT_EQ(clustering_.cluster_membership, (std::vector<int>{1, 0, 1}));
+  EXPECT_EQ(clustering_.cluster_pairs,
+            (std::vector<std::pair<int, int>>{{0, 0}, {0, 1}, {1, 1}}));
+}
+
+TEST_P(CameraClusteringTest, ClustersCamerasMarkedAsNew) {
+  // Camera 1 is not clustered. It shares e_block 0 with camera 0, so
+  // it should join the cluster of camera 0.
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 2;
+  clustering_.cluster_membership = {1, -1, 0};
+  clustering_.cluster_pairs = {{0, 0}, {0, 1}, {1, 1}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.num_clusters, 2);
+  EXPECT_EQ(clustering_.cluster_membership, (std::vector<int>{1, 1, 0}));
+}
+
+TEST_P(CameraClusteringTest, RemovesEmptyClusters) {
+  // Clusters 0 and 2 lost their cameras, e.g., because the cameras
+  // were removed from the problem.
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 4;
+  clustering_.cluster_membership = {3, 1, 3};
+  clustering_.cluster_pairs = {{0, 0}, {0, 1}, {1, 1}, {1, 3}, {2, 2}, {3, 3}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.num_clusters, 2);
+  EXPECT_EQ(clustering_.cluster_membership, (std::vector<int>{1, 0, 1}));
+  EXPECT_EQ(clustering_.cluster_pairs,
+            (std::vector<std::pair<int, int>>{{0, 0}, {0, 1}, {1, 1}}));
+}
+
+TEST_P(CameraClusteringTest, SavesBlockPairs) {
+  // All the cameras are coupled in the Schur complement, but only
+  // cameras 1 and 2 are in the same cluster, and the two clusters
+  // are not connected.
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 2;
+  clustering_.cluster_membership = {0, 1, 1};
+  clustering_.cluster_pairs = {{0, 0}, {1, 1}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.block_pairs,
+            (std::vector<std::pair<int, int>>{{0, 0}, {1, 1}, {1, 2}, {2, 2}}));
+}
+
+TEST_P(CameraClusteringTest, SavesBlockPairsWithMultipleThreads) {
+  const int kNumThreads = 4;
+  context_.EnsureMinimumThreads(kNumThreads);
+  options_.num_threads = kNumThreads;
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 2;
+  clustering_.cluster_membership = {0, 1, 1};
+  clustering_.cluster_pairs = {{0, 0}, {0, 1}, {1, 1}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.block_pairs,
+            (std::vector<std::pair<int, int>>{
+                {0, 0}, {0, 1}, {0, 2}, {1, 1}, {1, 2}, {2, 2}}));
+}
+
+TEST_P(CameraClusteringTest, IgnoresIncompatibleClustering) {
+  // A clustering for more cameras than the problem has cannot be
+  // reused, and the cameras are clustered from scratch.
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 1;
+  clustering_.cluster_membership = {0, 0, 0, 0};
+  clustering_.cluster_pairs = {{0, 0}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.cluster_membership.size(), 3);
+}
+
+TEST_P(CameraClusteringTest, IgnoresInvalidClustering) {
+  // Cluster ids out of range, in the cluster membership or in the
+  // cluster pairs, cannot be reused, and the cameras are clustered
+  // from scratch.
+  const std::vector<CameraClustering> invalid_clusterings = [this] {
+    CameraClustering clustering;
+    clustering.type = GetParam();
+    clustering.num_clusters = 2;
+    clustering.cluster_membership = {0, 1, 2};
+    clustering.cluster_pairs = {{0, 0}, {1, 1}};
+    CameraClustering negative_id = clustering;
+    negative_id.cluster_membership = {0, -2, 1};
+    CameraClustering invalid_pair = clustering;
+    invalid_pair.cluster_membership = {0, 1, 1};
+    invalid_pair.cluster_pairs = {{0, 0}, {1, 1}, {1, 5}};
+    return std::vector<CameraClustering>{clustering, negative_id, invalid_pair};
+  }();
+
+  for (const CameraClustering& invalid_clustering : invalid_clusterings) {
+    clustering_ = invalid_clustering;
+    VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                                 options_);
+    ASSERT_EQ(clustering_.cluster_membership.size(), 3);
+    for (const int cluster_id : clustering_.cluster_membership) {
+      EXPECT_GE(cluster_id, 0);
+      EXPECT_LT(cluster_id, clustering_.num_clusters);
+    }
+    for (const auto& cluster_pair : clustering_.cluster_pairs) {
+      EXPECT_LT(cluster_pair.second, clustering_.num_clusters);
+    }
+  }
+}
+
+TEST_P(CameraClusteringTest, ClustersNewCamerasInOrder) {
+  // Cameras 1 and 2 are new and share no e_block with each other, so
+  // each joins the cluster of camera 0, with which it shares one.
+  clustering_.type = GetParam();
+  clustering_.num_clusters = 1;
+  clustering_.cluster_membership = {0};
+  clustering_.cluster_pairs = {{0, 0}};
+
+  VisibilityBasedPreconditioner preconditioner(*A_->block_structure(),
+                                               options_);
+  EXPECT_EQ(clustering_.num_clusters, 1);
+  EXPECT_EQ(clustering_.cluster_membership, (std::vector<int>{0, 0, 0}));
+}
+
+INSTANTIATE_TEST_SUITE_P(VisibilityBasedPreconditioner,
+                         CameraClusteringTest,
+                         ::testing::Values(CLUSTER_JACOBI,
+                                           CLUSTER_TRIDIAGONAL));
+
+#endif  // !defined(CERES_NO_SUITESPARSE) || defined(CERES_USE_EIGEN_SPARSE)
+
 }  // namespace internal
 }  // namespace ceres
@@ -32,10 +32,11 @@
 #include "ceres/visibility.h"
 
 #include <memory>
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "ceres/block_structure.h"
+#include "ceres/context_impl.h"
 #include "ceres/graph.h"
 #include "glog/logging.h"
 #include "gtest/gtest.h"
@@ -43,7 +44,7 @@
 namespace ceres {
 namespace internal {
 
-using std::set;
+using std::pair;
 using std::vector;
 
 class VisibilityTest : public ::testing::Test {};
@@ -99,15 +100,16 @@ TEST(VisibilityTest, SimpleMatrix) {
   }
   bs.cols.resize(num_cols);
 
-  vector<set<int>> visibility;
-  ComputeVisibility(bs, num_eliminate_blocks, &visibility);
+  ContextImpl context;
+  vector<vector<int>> visibility;
+  ComputeVisibility(bs, num_eliminate_blocks, &context, 1, &visibility);
   ASSERT_EQ(visibility.size(), num_cols - num_eliminate_blocks);
   for (int i = 0; i < visibility.size(); ++i) {
     ASSERT_EQ(visibility[i].size(), 1);
   }
 
   std::unique_ptr<WeightedGraph<int>> graph(
-      CreateSchurComplementGraph(visibility));
+      CreateSchurComplementGraph(visibility, &context, 1));
   EXPECT_EQ(graph->vertices().size(), visibility.size());
   for (int i = 0; i < visibility.size(); ++i) {
     EXPECT_EQ(graph->VertexWeight(i), 1.0);
@@ -174,15 +176,16 @@ TEST(VisibilityTest, NoEBlocks) {
   }
   bs.cols.resize(num_cols);
 
-  vector<set<int>> visibility;
-  ComputeVisibility(bs, num_eliminate_blocks, &visibility);
+  ContextImpl context;
+  vector<vector<int>> visibility;
+  ComputeVisibility(bs, num_eliminate_blocks, &context, 1, &visibility);
   ASSERT_EQ(visibility.size(), num_cols - num_eliminate_blocks);
   for (int i = 0; i < visibility.size(); ++i) {
     ASSERT_EQ(visibility[i].size(), 0);
   }
 
   std::unique_ptr<WeightedGraph<int>> graph(
-      CreateSchurComplementGraph(visibility));
+      CreateSchurComplementGraph(visibility, &context, 1));
   EXPECT_EQ(graph->vertices().size(), visibility.size());
   for (int i = 0; i < visibility.size(); ++i) {
     EXPECT_EQ(graph->VertexWeight(i), 1.0);
@@ -201,5 +204,22 @@ TEST(VisibilityTest, NoEBlocks) {
   }
 }
 
+TEST(VisibilityTest, OverlapIsIndependentOfNumThreads) {
+  // Four vertices with the following sorted visibility vectors.
+  vector<vector<int>> visibility = {{0, 1, 2}, {1, 2, 5}, {3}, {0, 2, 3, 5}};
+
+  ContextImpl context;
+  context.EnsureMinimumThreads(4);
+  for (int num_threads = 1; num_threads <= 4; ++num_threads) {
+    vector<vector<pair<int, int>>> overlap;
+    ComputeVisibilityOverlap(visibility, &context, num_threads, &overlap);
+    ASSERT_EQ(overlap.size(), 4);
+    EXPECT_EQ(overlap[0], (vector<pair<int, int>>{{1, 2}, {3, 2}}));
+    EXPECT_EQ(overlap[1], (vector<pair<int, int>>{{3, 2}}));
+    EXPECT_EQ(overlap[2], (vector<pair<int, int>>{{3, 1}}));
+    EXPECT_TRUE(overlap[3].empty());
+  }
+}
+
 }  // namespace internal
 }  // namespace ceres